@@ -20,6 +20,47 @@ def compare_frames(path1, path2):
         return False
 
 
+def load_frame_hashes(path):
+    names = []
+    frames = []
+    with open(path, "r") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 0:
+                continue
+            if fields[0] == "#":
+                names = fields[2:]
+                continue
+
+            frames.append(fields[1:])
+
+    return (names, frames)
+
+
+# The SPU hash covers the samples generated up to the end of each frame. The runner catches the SPU up before
+# hashing, which moves its event slightly compared to a run without -hashframes, so traces are only comparable with
+# other traces, not with frame dumps from unhashed runs.
+def compare_frame_hashes(path1, path2, name):
+    try:
+        names, frames1 = load_frame_hashes(path1)
+        _, frames2 = load_frame_hashes(path2)
+    except:
+        print("--- Failed to read frame hashes for %s" % name)
+        return False
+
+    for framenum in range(min(len(frames1), len(frames2))):
+        if frames1[framenum] != frames2[framenum]:
+            differences = [names[i] for i in range(len(names)) if frames1[framenum][i] != frames2[framenum][i]]
+            print("*** First divergence in frame %u for %s (%s)" % (framenum + 1, name, ", ".join(differences)))
+            return False
+
+    if len(frames1) != len(frames2):
+        print("--- Frame hashes for %s have %u frames, expected %u" % (name, len(frames2), len(frames1)))
+        return False
+
+    return True
+
+
 def check_regression_test(baselinedir, testdir, name):
     #print("Checking '%s'..." % name)
 
@@ -29,6 +70,16 @@ def check_regression_test(baselinedir, testdir, name):
         #print("*** %s is missing in test set" % name)
         return False
 
+    hashpath1 = os.path.join(dir1, "hashes.txt")
+    if os.path.isfile(hashpath1):
+        hashpath2 = os.path.join(dir2, "hashes.txt")
+        if not os.path.isfile(hashpath2):
+            print("--- Frame hashes for %s are missing in test set" % name)
+            return False
+
+        if not compare_frame_hashes(hashpath1, hashpath2, name):
+            return False
+
     images = glob.glob(os.path.join(dir1, "frame_*.png"))
     for imagepath in images:
         imagename = Path(imagepath).name
@@ -48,6 +99,17 @@ def check_regression_test(baselinedir, testdir, name):
             print("*** Difference in frame %u for %s" % (framenum, name))
             return False
 
+    audiopath1 = os.path.join(dir1, "audio.wav")
+    if os.path.isfile(audiopath1):
+        audiopath2 = os.path.join(dir2, "audio.wav")
+        if not os.path.isfile(audiopath2):
+            print("--- Audio for %s is missing in test set" % name)
+            return False
+
+        if not compare_frames(audiopath1, audiopath2):
+            print("*** Difference in audio for %s" % name)
+            return False
+
     return True
 
 
@@ -68,7 +130,7 @@ def check_regression_tests(baselinedir, testdir):
 
 
 if __name__ == "__main__":
-    parser = argparse.ArgumentParser(description="Check frame dump images for regression tests")
+    parser = argparse.ArgumentParser(description="Check frame dump images, audio and frame hashes for regression tests")
     parser.add_argument("-baselinedir", action="store", required=True, help="Directory containing baseline frames to check against")
     parser.add_argument("-testdir", action="store", required=True, help="Directory containing frames to check")
 
@@ -0,0 +1,105 @@
+import argparse
+import glob
+import json
+import sys
+import os
+import subprocess
+import tempfile
+
+from pathlib import Path
+
+def is_benchmark_path(path):
+    idx = path.rfind('.')
+    if idx < 0:
+        return False
+
+    extension = path[idx + 1:].strip().lower()
+    return extension in ["cue", "chd", "exe", "psexe", "psf", "minipsf"]
+
+
+def run_benchmark(runner, renderer, frames, pgxp, gamepath, resultpath):
+    args = [runner,
+            "-renderer", renderer,
+            "-log", "warning",
+            "-frames", str(frames),
+            "-benchmark", resultpath
+    ]
+    if pgxp == "memory":
+        args.append("-pgxp")
+    elif pgxp == "cpu":
+        args.append("-pgxpcpu")
+    args += ["--", gamepath]
+
+    if os.path.isfile(resultpath):
+        os.remove(resultpath)
+
+    print("Running '%s'" % (" ".join(args)))
+    subprocess.run(args)
+
+    try:
+        with open(resultpath, "r") as f:
+            return json.load(f)
+    except:
+        print("*** No results for %s" % gamepath)
+        return None
+
+
+def run_benchmarks(runner, gamedir, renderer, frames, pgxp):
+    paths = glob.glob(gamedir + "/*.*", recursive=True)
+    gamepaths = sorted(filter(is_benchmark_path, paths))
+    print("Found %u workloads" % len(gamepaths))
+
+    results = {}
+    with tempfile.TemporaryDirectory() as tempdir:
+        for game in gamepaths:
+            name = Path(game).name
+            result = run_benchmark(runner, renderer, frames, pgxp, game, os.path.join(tempdir, "result.json"))
+            if result is not None:
+                results[name] = result
+
+    return results
+
+
+def compare_results(baseline, results, threshold):
+    regressions = 0
+    for name, result in results.items():
+        if name not in baseline:
+            print("--- %s is missing in baseline" % name)
+            continue
+
+        old_fps = baseline[name]["fps"]
+        new_fps = result["fps"]
+        change = (new_fps - old_fps) / old_fps * 100.0
+        print("%s: %.2f -> %.2f FPS (%+.1f%%)" % (name, old_fps, new_fps, change))
+        if change < -threshold:
+            print("*** Performance regression in %s" % name)
+            regressions += 1
+
+    return (regressions == 0)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Run benchmark workloads and optionally check for performance regressions")
+    parser.add_argument("-runner", action="store", required=True, help="Path to DuckStation regression test runner")
+    parser.add_argument("-gamedir", action="store", required=True, help="Directory containing workload images/executables")
+    parser.add_argument("-output", action="store", required=True, help="File to write combined results to")
+    parser.add_argument("-renderer", action="store", default="software", help="Renderer to benchmark")
+    parser.add_argument("-frames", action="store", type=int, default=3600, help="Number of frames to run")
+    parser.add_argument("-pgxp", action="store", choices=["memory", "cpu"], help="Enable PGXP, tracking memory or CPU values")
+    parser.add_argument("-baseline", action="store", help="Previous results to compare against")
+    parser.add_argument("-threshold", action="store", type=float, default=5.0, help="Allowed FPS drop in percent")
+
+    args = parser.parse_args()
+
+    results = run_benchmarks(args.runner, os.path.realpath(args.gamedir), args.renderer, args.frames, args.pgxp)
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=4)
+
+    if args.baseline is not None:
+        with open(args.baseline, "r") as f:
+            baseline = json.load(f)
+
+        if not compare_results(baseline, results, args.threshold):
+            sys.exit(1)
+
+    sys.exit(0)
@@ -15,21 +15,25 @@ def is_game_path(path):
     return extension in ["cue", "chd"]
 
 
-def run_regression_test(runner, destdir, dump_interval, frames, gamepath):
+def run_regression_test(runner, destdir, dump_interval, frames, dump_audio, hash_frames, gamepath):
     args = [runner,
             "-renderer", "software",
             "-log", "verbose",
             "-dumpdir", destdir,
             "-dumpinterval", str(dump_interval),
-            "-frames", str(frames),
-            "--", gamepath
+            "-frames", str(frames)
     ]
+    if dump_audio:
+        args.append("-dumpaudio")
+    if hash_frames:
+        args.append("-hashframes")
+    args += ["--", gamepath]
 
     print("Running '%s'" % (" ".join(args)))
     subprocess.run(args)
 
 
-def run_regression_tests(runner, gamedir, destdir, dump_interval, frames, parallel=1):
+def run_regression_tests(runner, gamedir, destdir, dump_interval, frames, dump_audio=False, hash_frames=False, parallel=1):
     paths = glob.glob(gamedir + "/*.*", recursive=True)
     gamepaths = list(filter(is_game_path, paths))
 
@@ -41,10 +45,10 @@ def run_regression_tests(runner, gamedir, destdir, dump_interval, frames, parall
 
     if parallel <= 1:
         for game in gamepaths:
-            run_regression_test(runner, destdir, dump_interval, frames, game)
+            run_regression_test(runner, destdir, dump_interval, frames, dump_audio, hash_frames, game)
     else:
         print("Processing %u games on %u processors" % (len(gamepaths), parallel))
-        func = partial(run_regression_test, runner, destdir, dump_interval, frames)
+        func = partial(run_regression_test, runner, destdir, dump_interval, frames, dump_audio, hash_frames)
         pool = multiprocessing.Pool(parallel)
         pool.map(func, gamepaths)
         pool.close()
@@ -60,11 +64,13 @@ if __name__ == "__main__":
     parser.add_argument("-destdir", action="store", required=True, help="Base directory to dump frames to")
     parser.add_argument("-dumpinterval", action="store", type=int, required=True, help="Interval to dump frames at")
     parser.add_argument("-frames", action="store", type=int, default=3600, help="Number of frames to run")
+    parser.add_argument("-dumpaudio", action="store_true", help="Dump SPU output for audio hash comparison")
+    parser.add_argument("-hashframes", action="store_true", help="Write per-frame VRAM/display/SPU/RAM hashes for comparison")
     parser.add_argument("-parallel", action="store", type=int, default=1, help="Number of proceeses to run")
 
     args = parser.parse_args()
 
-    if not run_regression_tests(args.runner, os.path.realpath(args.gamedir), os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel):
+    if not run_regression_tests(args.runner, os.path.realpath(args.gamedir), os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.dumpaudio, args.hashframes, args.parallel):
         sys.exit(1)
     else:
         sys.exit(0)
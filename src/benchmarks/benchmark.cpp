@@ -0,0 +1,93 @@
+#include "benchmark.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Benchmark {
+
+namespace {
+struct Entry
+{
+  const char* name;
+  Function function;
+};
+} // namespace
+
+static std::vector<Entry>& GetEntries()
+{
+  // function-local so registrations from other translation units can't run before it's constructed
+  static std::vector<Entry> entries;
+  return entries;
+}
+
+static volatile u64 s_consumed_value;
+
+Registration::Registration(const char* name, Function function)
+{
+  GetEntries().push_back(Entry{name, function});
+}
+
+void Report(const char* label, double seconds, double count, const char* unit, double bytes /* = 0.0 */)
+{
+  if (bytes > 0.0)
+  {
+    std::printf("  %-28s %14.0f %s/sec %10.1f MB/sec\n", label, count / seconds, unit, bytes / seconds / 1048576.0);
+  }
+  else
+  {
+    std::printf("  %-28s %14.0f %s/sec\n", label, count / seconds, unit);
+  }
+}
+
+void Consume(u64 value)
+{
+  s_consumed_value = s_consumed_value + value;
+}
+
+} // namespace Benchmark
+
+static bool MatchesAnyFilter(const char* name, int argc, char* argv[])
+{
+  if (argc < 2)
+    return true;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strncmp(name, argv[i], std::strlen(argv[i])) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<Benchmark::Entry>& entries = Benchmark::GetEntries();
+  if (argc == 2 && (std::strcmp(argv[1], "-list") == 0 || std::strcmp(argv[1], "-help") == 0))
+  {
+    std::printf("Usage: %s [name prefix...]\nBenchmarks:\n", argv[0]);
+    for (const Benchmark::Entry& entry : entries)
+      std::printf("  %s\n", entry.name);
+    return 0;
+  }
+
+  u32 count = 0;
+  for (const Benchmark::Entry& entry : entries)
+  {
+    if (!MatchesAnyFilter(entry.name, argc, argv))
+      continue;
+
+    std::printf("%s\n", entry.name);
+    std::fflush(stdout);
+    entry.function();
+    count++;
+  }
+
+  if (count == 0)
+  {
+    std::fprintf(stderr, "No benchmarks match, run with -list to show them.\n");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "common/types.h"
+
+// Throughput benchmarks for the hot paths covered by common-tests and core-tests. The tests check behaviour, these only
+// time it, so they live in their own executable instead of being disabled tests.
+namespace Benchmark {
+
+using Function = void (*)();
+
+struct Registration
+{
+  Registration(const char* name, Function function);
+};
+
+/// Prints a result line for one timed section, with an optional data rate when the work has a byte size.
+void Report(const char* label, double seconds, double count, const char* unit, double bytes = 0.0);
+
+/// Consumes a result so the work producing it can't be optimized away.
+void Consume(u64 value);
+
+} // namespace Benchmark
+
+#define BENCHMARK(name)                                                                                                \
+  static void Benchmark_##name();                                                                                      \
+  static const Benchmark::Registration s_benchmark_registration_##name(#name, Benchmark_##name);                      \
+  static void Benchmark_##name()
@@ -0,0 +1,43 @@
+#include "benchmark.h"
+#include "common/cd_sector.h"
+#include "common/timer.h"
+#include <random>
+#include <vector>
+
+static constexpr u32 SECTOR_SIZE = 2352;
+
+// Runs a kernel over a few thousand sectors.
+template<typename Function>
+static void BenchmarkKernel(const char* label, Function function)
+{
+  static constexpr u32 SECTORS = 4096;
+  static constexpr u32 ITERATIONS = 20;
+
+  std::mt19937 rng(42);
+  std::vector<u8> data(SECTORS * SECTOR_SIZE);
+  for (u8& value : data)
+    value = static_cast<u8>(rng());
+
+  Common::Timer timer;
+  for (u32 iteration = 0; iteration < ITERATIONS; iteration++)
+  {
+    for (u32 i = 0; i < SECTORS; i++)
+      function(&data[i * SECTOR_SIZE]);
+  }
+
+  const double sectors = static_cast<double>(SECTORS) * ITERATIONS;
+  Benchmark::Report(label, timer.GetTimeSeconds(), sectors, "sectors", sectors * SECTOR_SIZE);
+  Benchmark::Consume(data[rng() % data.size()]);
+}
+
+BENCHMARK(CDSector)
+{
+  static u8 swap_buffer[SECTOR_SIZE];
+
+  BenchmarkKernel("CopyAndSwap16", [](u8* sector) { CDSector::CopyAndSwap16(swap_buffer, sector, SECTOR_SIZE); });
+  BenchmarkKernel("ComputeEDC", [](u8* sector) { Benchmark::Consume(CDSector::ComputeEDC(0, sector + 0x10, 0x91C)); });
+  BenchmarkKernel("ComputeECCP", [](u8* sector) { CDSector::ComputeECCP(sector); });
+  BenchmarkKernel("ComputeECCQ", [](u8* sector) { CDSector::ComputeECCQ(sector); });
+  BenchmarkKernel("GenerateMode1EDCECC", [](u8* sector) { CDSector::GenerateMode1EDCECC(sector); });
+  BenchmarkKernel("GenerateMode2Form1EDCECC", [](u8* sector) { CDSector::GenerateMode2Form1EDCECC(sector); });
+}
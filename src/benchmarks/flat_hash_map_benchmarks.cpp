@@ -0,0 +1,50 @@
+#include "benchmark.h"
+#include "common/flat_hash_map.h"
+#include "common/timer.h"
+#include <random>
+#include <unordered_map>
+
+// Replays a block lookup/invalidation pattern similar to what an overlay-loading game produces in the CPU code cache:
+// a hot working set of blocks is looked up continuously, while whole 4KB pages of blocks are invalidated and
+// recompiled.
+template<typename Map>
+static void ReplayInvalidationTrace(const char* label)
+{
+  static constexpr u32 PAGE_COUNT = 512;
+  static constexpr u32 BLOCKS_PER_PAGE = 24;
+  static constexpr u32 ITERATIONS = 200000;
+
+  Map map;
+  std::mt19937 rng(5678);
+  Common::Timer timer;
+  u32 found = 0;
+  for (u32 i = 0; i < ITERATIONS; i++)
+  {
+    const u32 page = rng() % PAGE_COUNT;
+    const u32 base = 0x80000000u | (page << 12);
+    if ((i % 64) == 0)
+    {
+      for (u32 j = 0; j < BLOCKS_PER_PAGE; j++)
+        map.erase(base + j * 0x80);
+    }
+
+    for (u32 j = 0; j < BLOCKS_PER_PAGE; j++)
+    {
+      const u32 key = base + j * 0x80;
+      auto iter = map.find(key);
+      if (iter == map.end())
+        map.emplace(key, key);
+      else
+        found++;
+    }
+  }
+
+  Benchmark::Report(label, timer.GetTimeSeconds(), static_cast<double>(ITERATIONS) * BLOCKS_PER_PAGE, "lookups");
+  Benchmark::Consume(found);
+}
+
+BENCHMARK(FlatHashMap)
+{
+  ReplayInvalidationTrace<FlatHashMap<u32, u32, 0xFFFFFFFFu>>("FlatHashMap");
+  ReplayInvalidationTrace<std::unordered_map<u32, u32>>("std::unordered_map");
+}
@@ -0,0 +1,78 @@
+#include "benchmark.h"
+#include "common/mdec_transform.h"
+#include "common/timer.h"
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using Block = std::array<s16, 64>;
+
+// The table most games upload, cos((2x + 1) * u * pi / 16) in 1.15 fixed-point, with the DC row scaled by 1/sqrt(2).
+static Block GetStandardScaleTable()
+{
+  static constexpr double pi = 3.14159265358979323846;
+  Block table;
+  for (u32 u = 0; u < 8; u++)
+  {
+    for (u32 x = 0; x < 8; x++)
+    {
+      const double scale = (u == 0) ? (1.0 / std::sqrt(2.0)) : 1.0;
+      table[u * 8 + x] = static_cast<s16>(std::lround(scale * std::cos((2 * x + 1) * u * pi / 16.0) * 32768.0));
+    }
+  }
+
+  return table;
+}
+
+// Coefficients as the run-length decoder produces them, mostly zero with a few low frequencies.
+static Block GenerateCoefficients(std::mt19937& rng, u32 num_coefficients)
+{
+  Block blk = {};
+  std::uniform_int_distribution<s32> value(-0x400, 0x3FF);
+  std::uniform_int_distribution<u32> position(0, 63);
+  for (u32 i = 0; i < num_coefficients; i++)
+    blk[(i == 0) ? 0 : position(rng)] = static_cast<s16>(value(rng));
+
+  return blk;
+}
+
+// Transforms a stream of colour macroblocks, six IDCTs then four YUV conversions each.
+BENCHMARK(MDECTransform)
+{
+  static constexpr u32 NUM_MACROBLOCKS = 1024;
+  static constexpr u32 ITERATIONS = 100;
+
+  std::mt19937 rng(42);
+  const Block scale_table = GetStandardScaleTable();
+  std::vector<Block> stream(NUM_MACROBLOCKS * 6);
+  for (u32 i = 0; i < stream.size(); i++)
+    stream[i] = GenerateCoefficients(rng, 1 + (i % 24));
+
+  std::array<Block, 6> blocks;
+  std::array<u32, 256> rgb;
+  u32 checksum = 0;
+
+  Common::Timer timer;
+  for (u32 iteration = 0; iteration < ITERATIONS; iteration++)
+  {
+    for (u32 mb = 0; mb < NUM_MACROBLOCKS; mb++)
+    {
+      for (u32 i = 0; i < 6; i++)
+      {
+        blocks[i] = stream[mb * 6 + i];
+        MDECTransform::IDCT(blocks[i].data(), scale_table.data());
+      }
+
+      MDECTransform::YUVToRGB(rgb.data(), 0, 0, blocks[0].data(), blocks[1].data(), blocks[2].data());
+      MDECTransform::YUVToRGB(rgb.data(), 8, 0, blocks[0].data(), blocks[1].data(), blocks[3].data());
+      MDECTransform::YUVToRGB(rgb.data(), 0, 8, blocks[0].data(), blocks[1].data(), blocks[4].data());
+      MDECTransform::YUVToRGB(rgb.data(), 8, 8, blocks[0].data(), blocks[1].data(), blocks[5].data());
+      checksum += rgb[mb % rgb.size()];
+    }
+  }
+
+  Benchmark::Report("IDCT + YUVToRGB", timer.GetTimeSeconds(), static_cast<double>(NUM_MACROBLOCKS) * ITERATIONS,
+                    "macroblocks");
+  Benchmark::Consume(checksum);
+}
@@ -0,0 +1,45 @@
+#include "benchmark.h"
+#include "common/pixel_conversion.h"
+#include "common/timer.h"
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Converts full 640x480 frames to each display format.
+template<typename InType, typename OutType, typename ConvertFunction>
+static void BenchmarkConversion(const char* label, ConvertFunction convert)
+{
+  static constexpr u32 WIDTH = 640;
+  static constexpr u32 HEIGHT = 480;
+  static constexpr u32 IN_PIXEL_SIZE = std::is_same_v<InType, u8> ? 3 : 1;
+  static constexpr u32 FRAMES = 500;
+
+  std::mt19937 rng(42);
+  std::vector<InType> src(WIDTH * HEIGHT * IN_PIXEL_SIZE);
+  for (InType& value : src)
+    value = static_cast<InType>(rng());
+  std::vector<OutType> dst(WIDTH * HEIGHT);
+
+  Common::Timer timer;
+  for (u32 frame = 0; frame < FRAMES; frame++)
+  {
+    for (u32 row = 0; row < HEIGHT; row++)
+      convert(&src[row * WIDTH * IN_PIXEL_SIZE], &dst[row * WIDTH], WIDTH);
+  }
+
+  Benchmark::Report(label, timer.GetTimeSeconds(), static_cast<double>(FRAMES) * WIDTH * HEIGHT, "pixels",
+                    static_cast<double>(FRAMES) * WIDTH * HEIGHT * sizeof(OutType));
+  Benchmark::Consume(dst[rng() % dst.size()]);
+}
+
+BENCHMARK(PixelConversion)
+{
+  BenchmarkConversion<u16, u16>("15-bit to RGB565", PixelConversion::Convert15BitToRGB565);
+  BenchmarkConversion<u16, u16>("15-bit to RGBA5551", PixelConversion::Convert15BitToRGBA5551);
+  BenchmarkConversion<u16, u32>("15-bit to RGBA8", PixelConversion::Convert15BitToRGBA8);
+  BenchmarkConversion<u16, u32>("15-bit to BGRA8", PixelConversion::Convert15BitToBGRA8);
+  BenchmarkConversion<u8, u16>("24-bit to RGB565", PixelConversion::Convert24BitToRGB565);
+  BenchmarkConversion<u8, u16>("24-bit to RGBA5551", PixelConversion::Convert24BitToRGBA5551);
+  BenchmarkConversion<u8, u32>("24-bit to RGBA8", PixelConversion::Convert24BitToRGBA8);
+  BenchmarkConversion<u8, u32>("24-bit to BGRA8", PixelConversion::Convert24BitToBGRA8);
+}
@@ -0,0 +1,65 @@
+#include "benchmark.h"
+#include "common/timer.h"
+#include "core/cpu_core.h"
+#include "core/timing_event.h"
+#include <array>
+#include <memory>
+#include <random>
+
+namespace {
+struct BenchmarkEvent
+{
+  std::unique_ptr<TimingEvent> event;
+  std::mt19937* rng;
+  u64* count;
+  bool reschedules;
+};
+} // namespace
+
+static void BenchmarkEventCallback(void* param, TickCount ticks, TickCount ticks_late)
+{
+  BenchmarkEvent* be = static_cast<BenchmarkEvent*>(param);
+  (*be->count)++;
+
+  // oneshot-style events pick a new deadline each time, like the CD-ROM and DMA events do
+  if (be->reschedules)
+    be->event->Schedule(static_cast<TickCount>((*be->rng)() % 2048) + 1);
+}
+
+// Runs a mix of periodic and rescheduling events, similar to a running system.
+BENCHMARK(TimingEvents)
+{
+  static constexpr u32 NUM_EVENTS = 16;
+  static constexpr u32 ITERATIONS = 4000000;
+
+  TimingEvents::Initialize();
+
+  std::mt19937 rng(42);
+  u64 count = 0;
+  std::array<BenchmarkEvent, NUM_EVENTS> events;
+  for (u32 i = 0; i < NUM_EVENTS; i++)
+  {
+    const TickCount interval = static_cast<TickCount>(64 << (i % 8));
+    events[i].rng = &rng;
+    events[i].count = &count;
+    events[i].reschedules = (i >= NUM_EVENTS / 2);
+    events[i].event =
+      TimingEvents::CreateTimingEvent("Benchmark", interval, interval, BenchmarkEventCallback, &events[i], true);
+  }
+
+  // the cpu normally runs until the next event is due, but interrupts and the like cut some slices short
+  Common::Timer timer;
+  for (u32 i = 0; i < ITERATIONS; i++)
+  {
+    CPU::AddPendingTicks(static_cast<TickCount>(rng() % 128) + 1);
+    TimingEvents::RunEvents();
+  }
+
+  const double seconds = timer.GetTimeSeconds();
+  Benchmark::Report("Slices", seconds, ITERATIONS, "slices");
+  Benchmark::Report("Events", seconds, static_cast<double>(count), "events");
+
+  for (BenchmarkEvent& event : events)
+    event.event.reset();
+  TimingEvents::Shutdown();
+}
@@ -0,0 +1,132 @@
+#include "common/audio_stream.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+class TestAudioStream final : public AudioStream
+{
+public:
+  using AudioStream::GetSamplesAvailable;
+  using AudioStream::ReadFrames;
+
+protected:
+  bool OpenDevice() override { return true; }
+  void PauseDevice(bool paused) override {}
+  void CloseDevice() override {}
+  void FramesAvailable() override {}
+};
+} // namespace
+
+static constexpr u32 TEST_BUFFER_SIZE = 64;
+
+static void WriteSequence(AudioStream* stream, u32 start, u32 num_frames)
+{
+  std::vector<s16> frames(num_frames * 2);
+  for (u32 i = 0; i < num_frames; i++)
+  {
+    frames[i * 2 + 0] = static_cast<s16>(start + i);
+    frames[i * 2 + 1] = static_cast<s16>(~(start + i));
+  }
+
+  stream->WriteFrames(frames.data(), num_frames);
+}
+
+TEST(AudioStream, ReadBackInOrder)
+{
+  TestAudioStream stream;
+  ASSERT_TRUE(stream.Reconfigure(44100, 44100, 2, TEST_BUFFER_SIZE));
+  WriteSequence(&stream, 0, TEST_BUFFER_SIZE);
+  ASSERT_EQ(stream.GetSamplesAvailable(), TEST_BUFFER_SIZE);
+
+  s16 frames[TEST_BUFFER_SIZE * 2];
+  stream.ReadFrames(frames, TEST_BUFFER_SIZE, false);
+  for (u32 i = 0; i < TEST_BUFFER_SIZE; i++)
+  {
+    ASSERT_EQ(frames[i * 2 + 0], static_cast<s16>(i));
+    ASSERT_EQ(frames[i * 2 + 1], static_cast<s16>(~i));
+  }
+  ASSERT_EQ(stream.GetSamplesAvailable(), 0u);
+  ASSERT_FALSE(stream.DidUnderflow());
+}
+
+TEST(AudioStream, UnderflowIsFlagged)
+{
+  TestAudioStream stream;
+  ASSERT_TRUE(stream.Reconfigure(44100, 44100, 2, TEST_BUFFER_SIZE));
+  WriteSequence(&stream, 0, 4);
+
+  s16 frames[TEST_BUFFER_SIZE * 2];
+  stream.ReadFrames(frames, TEST_BUFFER_SIZE, false);
+  ASSERT_TRUE(stream.DidUnderflow());
+  ASSERT_FALSE(stream.DidUnderflow());
+}
+
+TEST(AudioStream, EmptyBuffersIsAppliedOnRead)
+{
+  TestAudioStream stream;
+  ASSERT_TRUE(stream.Reconfigure(44100, 44100, 2, TEST_BUFFER_SIZE));
+  WriteSequence(&stream, 0, TEST_BUFFER_SIZE);
+  stream.EmptyBuffers();
+  WriteSequence(&stream, 1000, TEST_BUFFER_SIZE);
+
+  // only the frames written before the request are dropped
+  s16 frames[TEST_BUFFER_SIZE * 2];
+  stream.ReadFrames(frames, TEST_BUFFER_SIZE, false);
+  ASSERT_EQ(frames[0], 1000);
+  ASSERT_EQ(stream.GetSamplesAvailable(), 0u);
+}
+
+TEST(AudioStream, OverflowWithoutSyncDiscards)
+{
+  TestAudioStream stream;
+  ASSERT_TRUE(stream.Reconfigure(44100, 44100, 2, TEST_BUFFER_SIZE));
+  stream.SetSync(false);
+  for (u32 i = 0; i < 4; i++)
+    WriteSequence(&stream, i * TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+
+  // the buffer holds two batches, the last two were thrown away
+  ASSERT_EQ(stream.GetSamplesAvailable(), TEST_BUFFER_SIZE * 2);
+  s16 frames[TEST_BUFFER_SIZE * 2 * 2];
+  stream.ReadFrames(frames, TEST_BUFFER_SIZE * 2, false);
+  ASSERT_EQ(frames[(TEST_BUFFER_SIZE * 2 - 1) * 2], static_cast<s16>(TEST_BUFFER_SIZE * 2 - 1));
+}
+
+TEST(AudioStream, ProducerConsumerThreads)
+{
+  static constexpr u32 TOTAL_FRAMES = 200000;
+  static constexpr u32 WRITE_FRAMES = 37;
+  static constexpr u32 READ_FRAMES = 23;
+
+  TestAudioStream stream;
+  ASSERT_TRUE(stream.Reconfigure(44100, 44100, 2, TEST_BUFFER_SIZE));
+
+  // the producer blocks when the buffer is full, so every frame has to come out the other end
+  std::thread producer([&stream]() {
+    for (u32 i = 0; i < TOTAL_FRAMES; i += WRITE_FRAMES)
+      WriteSequence(&stream, i, std::min(WRITE_FRAMES, TOTAL_FRAMES - i));
+  });
+
+  s16 frames[READ_FRAMES * 2];
+  u32 expected = 0;
+  while (expected < TOTAL_FRAMES)
+  {
+    const u32 count = std::min(READ_FRAMES, TOTAL_FRAMES - expected);
+    if (stream.GetSamplesAvailable() < count)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    stream.ReadFrames(frames, count, false);
+    for (u32 i = 0; i < count; i++, expected++)
+    {
+      ASSERT_EQ(frames[i * 2 + 0], static_cast<s16>(expected));
+      ASSERT_EQ(frames[i * 2 + 1], static_cast<s16>(~expected));
+    }
+  }
+
+  producer.join();
+  ASSERT_FALSE(stream.DidUnderflow());
+}
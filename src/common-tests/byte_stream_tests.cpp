@@ -0,0 +1,87 @@
+#include "common/byte_stream.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// Half random and half repeating, so that the data is compressible but still crosses several chunks.
+static std::vector<u8> MakeTestData(u32 size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> data(size);
+  for (u32 i = 0; i < size; i++)
+    data[i] = ((i / 4096) & 1) ? static_cast<u8>(i) : static_cast<u8>(rng());
+  return data;
+}
+
+static void TestRoundTrip(BYTESTREAM_COMPRESSION_METHOD method, int level)
+{
+  for (u32 size : {0u, 1u, 4096u, 65536u, 65537u, 300000u})
+  {
+    const std::vector<u8> data = MakeTestData(size, size);
+    auto source = ByteStream_CreateReadOnlyMemoryStream(data.data(), size);
+    auto compressed = ByteStream_CreateGrowableMemoryStream();
+    const u32 compressed_size = ByteStream_CompressBytes(source.get(), size, compressed.get(), method, level);
+    ASSERT_GT(compressed_size, 0u) << "size " << size;
+    ASSERT_EQ(compressed_size, compressed->GetSize()) << "size " << size;
+    if (size >= 65536u)
+    {
+      ASSERT_LT(compressed_size, size) << "size " << size;
+    }
+
+    auto decompressed = ByteStream_CreateGrowableMemoryStream();
+    ASSERT_TRUE(compressed->SeekAbsolute(0));
+    ASSERT_TRUE(ByteStream_DecompressBytes(compressed.get(), compressed_size, decompressed.get(), size, method))
+      << "size " << size;
+    ASSERT_EQ(decompressed->GetSize(), size);
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), decompressed->GetMemoryPointer())) << "size " << size;
+
+    // Expecting a different size must fail, rather than truncating or overrunning.
+    for (const u32 wrong_size : {size + 1, size / 2})
+    {
+      if (wrong_size == size)
+        continue;
+
+      auto wrong = ByteStream_CreateGrowableMemoryStream();
+      ASSERT_TRUE(compressed->SeekAbsolute(0));
+      ASSERT_FALSE(ByteStream_DecompressBytes(compressed.get(), compressed_size, wrong.get(), wrong_size, method))
+        << "size " << size << " wrong size " << wrong_size;
+    }
+  }
+}
+
+TEST(ByteStream, DeflateRoundTrip)
+{
+  TestRoundTrip(BYTESTREAM_COMPRESSION_METHOD_DEFLATE, 1);
+  TestRoundTrip(BYTESTREAM_COMPRESSION_METHOD_DEFLATE, 9);
+}
+
+TEST(ByteStream, LZMARoundTrip)
+{
+  TestRoundTrip(BYTESTREAM_COMPRESSION_METHOD_LZMA, 1);
+  TestRoundTrip(BYTESTREAM_COMPRESSION_METHOD_LZMA, 9);
+}
+
+TEST(ByteStream, DecompressRejectsCorruptData)
+{
+  for (const BYTESTREAM_COMPRESSION_METHOD method :
+       {BYTESTREAM_COMPRESSION_METHOD_DEFLATE, BYTESTREAM_COMPRESSION_METHOD_LZMA})
+  {
+    const u32 size = 100000;
+    const std::vector<u8> data = MakeTestData(size, 1);
+    auto source = ByteStream_CreateReadOnlyMemoryStream(data.data(), size);
+    auto compressed = ByteStream_CreateGrowableMemoryStream();
+    const u32 compressed_size = ByteStream_CompressBytes(source.get(), size, compressed.get(), method, 5);
+    ASSERT_GT(compressed_size, 0u);
+
+    // Truncated input.
+    auto decompressed = ByteStream_CreateGrowableMemoryStream();
+    ASSERT_TRUE(compressed->SeekAbsolute(0));
+    ASSERT_FALSE(ByteStream_DecompressBytes(compressed.get(), compressed_size / 2, decompressed.get(), size, method));
+
+    // Damaged header.
+    compressed->GetMemoryPointer()[0] = 0xFF;
+    decompressed = ByteStream_CreateGrowableMemoryStream();
+    ASSERT_TRUE(compressed->SeekAbsolute(0));
+    ASSERT_FALSE(ByteStream_DecompressBytes(compressed.get(), compressed_size, decompressed.get(), size, method));
+  }
+}
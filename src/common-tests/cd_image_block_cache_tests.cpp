@@ -0,0 +1,98 @@
+#include "common/cd_image_block_cache.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+
+static constexpr u32 BLOCK_SIZE = 64;
+static constexpr u32 BLOCK_COUNT = 100;
+
+static u8 GetExpectedByte(u32 block_index, u32 offset)
+{
+  return static_cast<u8>(block_index * 7 + offset);
+}
+
+static bool ReadBlockAndCheck(CDImageBlockCache& cache, u32 block_index)
+{
+  bool matches = false;
+  const bool result = cache.ReadBlock(block_index, [block_index, &matches](const u8* data) {
+    matches = true;
+    for (u32 i = 0; i < BLOCK_SIZE; i++)
+      matches &= (data[i] == GetExpectedByte(block_index, i));
+  });
+
+  return (result && matches);
+}
+
+TEST(CDImageBlockCache, ReadsDecodedBlocks)
+{
+  CDImageBlockCache cache(2, 8);
+  cache.SetSource(BLOCK_SIZE, BLOCK_COUNT, [](u32 block_index, u8* buffer, u32 thread_index) {
+    for (u32 i = 0; i < BLOCK_SIZE; i++)
+      buffer[i] = GetExpectedByte(block_index, i);
+    return true;
+  });
+  cache.SetCacheSize(16 * BLOCK_SIZE, 2);
+
+  for (u32 i = 0; i < BLOCK_COUNT; i++)
+    ASSERT_TRUE(ReadBlockAndCheck(cache, i)) << "block " << i;
+  for (u32 i = BLOCK_COUNT; i > 0; i--)
+    ASSERT_TRUE(ReadBlockAndCheck(cache, i - 1)) << "block " << (i - 1);
+
+  std::mt19937 rng(1);
+  for (u32 i = 0; i < 1000; i++)
+  {
+    const u32 block_index = static_cast<u32>(rng() % BLOCK_COUNT);
+    ASSERT_TRUE(ReadBlockAndCheck(cache, block_index)) << "block " << block_index;
+  }
+
+  cache.Shutdown();
+}
+
+TEST(CDImageBlockCache, DecodesEachBlockOnce)
+{
+  std::mutex decode_mutex;
+  std::array<u32, BLOCK_COUNT> decode_counts = {};
+
+  CDImageBlockCache cache(2, 8);
+  cache.SetSource(BLOCK_SIZE, BLOCK_COUNT, [&](u32 block_index, u8* buffer, u32 thread_index) {
+    {
+      std::unique_lock lock(decode_mutex);
+      decode_counts[block_index]++;
+    }
+
+    for (u32 i = 0; i < BLOCK_SIZE; i++)
+      buffer[i] = GetExpectedByte(block_index, i);
+    return true;
+  });
+
+  // with room for every block, nothing is evicted, so prefetched blocks are never decoded again by the reader
+  cache.SetCacheSize(BLOCK_COUNT * BLOCK_SIZE, 4);
+  for (u32 pass = 0; pass < 2; pass++)
+  {
+    for (u32 i = 0; i < BLOCK_COUNT; i++)
+      ASSERT_TRUE(ReadBlockAndCheck(cache, i)) << "block " << i;
+  }
+
+  cache.Shutdown();
+  for (u32 i = 0; i < BLOCK_COUNT; i++)
+    ASSERT_EQ(decode_counts[i], 1u) << "block " << i;
+}
+
+TEST(CDImageBlockCache, FailedDecodeIsNotCached)
+{
+  static constexpr u32 BAD_BLOCK = 5;
+
+  CDImageBlockCache cache(2, 8);
+  cache.SetSource(BLOCK_SIZE, BLOCK_COUNT, [](u32 block_index, u8* buffer, u32 thread_index) {
+    for (u32 i = 0; i < BLOCK_SIZE; i++)
+      buffer[i] = GetExpectedByte(block_index, i);
+    return (block_index != BAD_BLOCK);
+  });
+  cache.SetCacheSize(0, 1);
+
+  ASSERT_TRUE(ReadBlockAndCheck(cache, BAD_BLOCK - 1));
+  ASSERT_FALSE(ReadBlockAndCheck(cache, BAD_BLOCK));
+  ASSERT_FALSE(ReadBlockAndCheck(cache, BAD_BLOCK));
+  ASSERT_TRUE(ReadBlockAndCheck(cache, BAD_BLOCK + 1));
+}
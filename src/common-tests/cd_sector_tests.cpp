@@ -0,0 +1,177 @@
+#include "common/cd_sector.h"
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+static constexpr u32 SECTOR_SIZE = 2352;
+using Sector = std::array<u8, SECTOR_SIZE>;
+
+// Reference implementations, following unecm.c by Neill Corlett.
+
+static u32 ReferenceEDC(const u8* src, u32 size)
+{
+  u32 edc = 0;
+  for (u32 i = 0; i < size; i++)
+  {
+    edc ^= src[i];
+    for (u32 k = 0; k < 8; k++)
+      edc = (edc >> 1) ^ ((edc & 1) ? 0xD8018001u : 0u);
+  }
+  return edc;
+}
+
+static u8 ReferenceECCMultiply2(u8 value)
+{
+  return static_cast<u8>((value << 1) ^ ((value & 0x80) ? 0x11D : 0));
+}
+
+static u8 ReferenceECCDivide3(u8 value)
+{
+  for (u32 i = 0; i < 256; i++)
+  {
+    if ((i ^ ReferenceECCMultiply2(static_cast<u8>(i))) == value)
+      return static_cast<u8>(i);
+  }
+  return 0;
+}
+
+static void ReferenceECCBlock(const u8* src, u32 major_count, u32 minor_count, u32 major_mult, u32 minor_inc,
+                              u8* dest)
+{
+  const u32 size = major_count * minor_count;
+  for (u32 major = 0; major < major_count; major++)
+  {
+    u32 index = (major >> 1) * major_mult + (major & 1);
+    u8 ecc_a = 0;
+    u8 ecc_b = 0;
+    for (u32 minor = 0; minor < minor_count; minor++)
+    {
+      const u8 temp = src[index];
+      index += minor_inc;
+      if (index >= size)
+        index -= size;
+      ecc_a ^= temp;
+      ecc_b ^= temp;
+      ecc_a = ReferenceECCMultiply2(ecc_a);
+    }
+    ecc_a = ReferenceECCDivide3(ReferenceECCMultiply2(ecc_a) ^ ecc_b);
+    dest[major] = ecc_a;
+    dest[major + major_count] = ecc_a ^ ecc_b;
+  }
+}
+
+static void WriteReferenceEDC(u8* dest, u32 edc)
+{
+  for (u32 i = 0; i < 4; i++)
+    dest[i] = static_cast<u8>(edc >> (i * 8));
+}
+
+static void ReferenceECC(u8* sector)
+{
+  ReferenceECCBlock(sector + 0xC, 86, 24, 2, 86, sector + 0x81C);
+  ReferenceECCBlock(sector + 0xC, 52, 43, 86, 88, sector + 0x8C8);
+}
+
+static Sector RandomSector(std::mt19937& rng)
+{
+  Sector sector;
+  for (u8& value : sector)
+    value = static_cast<u8>(rng());
+  return sector;
+}
+
+TEST(CDSector, CopyAndSwap16)
+{
+  std::mt19937 rng(1234);
+  std::vector<u8> src(SECTOR_SIZE + 1);
+  for (u8& value : src)
+    value = static_cast<u8>(rng());
+
+  // Every size up to a little past a few vectors, plus a whole sector, to cover both the vector and scalar paths.
+  for (u32 size = 0; size <= SECTOR_SIZE; size = (size < 100) ? (size + 1) : SECTOR_SIZE)
+  {
+    std::vector<u8> dst(SECTOR_SIZE + 1, 0xCD);
+    CDSector::CopyAndSwap16(dst.data(), src.data(), size);
+    for (u32 i = 0; i < (size & ~1u); i++)
+      ASSERT_EQ(dst[i], src[i ^ 1]) << "size " << size << " byte " << i;
+    if (size & 1)
+    {
+      ASSERT_EQ(dst[size - 1], src[size - 1]) << "size " << size;
+    }
+    for (u32 i = size; i <= SECTOR_SIZE; i++)
+      ASSERT_EQ(dst[i], 0xCD) << "size " << size << " byte " << i;
+
+    if (size == SECTOR_SIZE)
+      break;
+  }
+}
+
+TEST(CDSector, CopyAndSwap16InPlace)
+{
+  std::mt19937 rng(4321);
+  Sector src = RandomSector(rng);
+  Sector dst = src;
+  CDSector::CopyAndSwap16(dst.data(), dst.data(), SECTOR_SIZE);
+  for (u32 i = 0; i < SECTOR_SIZE; i++)
+    ASSERT_EQ(dst[i], src[i ^ 1]) << "byte " << i;
+}
+
+TEST(CDSector, ComputeEDC)
+{
+  std::mt19937 rng(5678);
+  const Sector sector = RandomSector(rng);
+  for (u32 size = 0; size <= 64; size++)
+    ASSERT_EQ(CDSector::ComputeEDC(0, sector.data(), size), ReferenceEDC(sector.data(), size)) << "size " << size;
+
+  ASSERT_EQ(CDSector::ComputeEDC(0, sector.data() + 0x10, 0x91C), ReferenceEDC(sector.data() + 0x10, 0x91C));
+
+  // Computing in pieces, misaligned, should give the same result.
+  const u32 partial = CDSector::ComputeEDC(0, sector.data() + 0x10, 0x13);
+  ASSERT_EQ(CDSector::ComputeEDC(partial, sector.data() + 0x23, 0x7F5), ReferenceEDC(sector.data() + 0x10, 0x808));
+}
+
+TEST(CDSector, GenerateMode1EDCECC)
+{
+  std::mt19937 rng(1111);
+  for (u32 iteration = 0; iteration < 16; iteration++)
+  {
+    Sector sector = RandomSector(rng);
+    Sector expected = sector;
+    WriteReferenceEDC(&expected[0x810], ReferenceEDC(expected.data(), 0x810));
+    std::memset(&expected[0x814], 0, 8);
+    ReferenceECC(expected.data());
+
+    CDSector::GenerateMode1EDCECC(sector.data());
+    ASSERT_EQ(sector, expected) << "iteration " << iteration;
+  }
+}
+
+TEST(CDSector, GenerateMode2Form1EDCECC)
+{
+  std::mt19937 rng(2222);
+  for (u32 iteration = 0; iteration < 16; iteration++)
+  {
+    Sector sector = RandomSector(rng);
+    Sector expected = sector;
+    WriteReferenceEDC(&expected[0x818], ReferenceEDC(&expected[0x10], 0x808));
+    std::memset(&expected[0xC], 0, 4);
+    ReferenceECC(expected.data());
+    std::memcpy(&expected[0xC], &sector[0xC], 4);
+
+    CDSector::GenerateMode2Form1EDCECC(sector.data());
+    ASSERT_EQ(sector, expected) << "iteration " << iteration;
+  }
+}
+
+TEST(CDSector, GenerateMode2Form2EDC)
+{
+  std::mt19937 rng(3333);
+  Sector sector = RandomSector(rng);
+  Sector expected = sector;
+  WriteReferenceEDC(&expected[0x92C], ReferenceEDC(&expected[0x10], 0x91C));
+
+  CDSector::GenerateMode2Form2EDC(sector.data());
+  ASSERT_EQ(sector, expected);
+}
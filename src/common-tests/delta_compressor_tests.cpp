@@ -0,0 +1,83 @@
+#include "common/delta_compressor.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+static std::vector<u8> MakeRandomBuffer(u32 size, u32 seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<u8> buffer(size);
+  for (u8& value : buffer)
+    value = static_cast<u8>(rng());
+  return buffer;
+}
+
+TEST(DeltaCompressor, RoundTripWithoutBase)
+{
+  DeltaCompressor dc;
+  for (u32 size : {0u, 1u, 7u, 8u, 9u, 1000u, 65539u})
+  {
+    std::vector<u8> data = MakeRandomBuffer(size, size);
+    // Leave some zero runs, which are encoded as unchanged.
+    for (u32 i = 0; i < size / 2; i++)
+      data[i] = 0;
+
+    std::vector<u8> compressed;
+    ASSERT_TRUE(dc.Compress(nullptr, data.data(), size, &compressed));
+
+    std::vector<u8> decompressed(size, 0xCD);
+    ASSERT_TRUE(dc.Decompress(nullptr, compressed.data(), compressed.size(), decompressed.data(), size));
+    ASSERT_EQ(data, decompressed) << "size " << size;
+  }
+}
+
+TEST(DeltaCompressor, RoundTripWithBase)
+{
+  static constexpr u32 SIZE = 256 * 1024 + 5;
+  const std::vector<u8> base = MakeRandomBuffer(SIZE, 1);
+  std::mt19937 rng(2);
+
+  DeltaCompressor dc;
+  std::vector<u8> compressed;
+  std::vector<u8> decompressed(SIZE);
+  for (u32 changes : {0u, 1u, 2u, 100u, 10000u, SIZE})
+  {
+    std::vector<u8> data = base;
+    for (u32 i = 0; i < changes; i++)
+      data[rng() % SIZE] ^= static_cast<u8>(rng() | 1);
+
+    ASSERT_TRUE(dc.Compress(base.data(), data.data(), SIZE, &compressed));
+    ASSERT_TRUE(dc.Decompress(base.data(), compressed.data(), compressed.size(), decompressed.data(), SIZE));
+    ASSERT_EQ(data, decompressed) << "changes " << changes;
+  }
+}
+
+TEST(DeltaCompressor, SparseChangesCompressWell)
+{
+  static constexpr u32 SIZE = 2 * 1024 * 1024;
+  const std::vector<u8> base = MakeRandomBuffer(SIZE, 3);
+  std::vector<u8> data = base;
+  for (u32 i = 0; i < SIZE; i += 4096)
+    data[i]++;
+
+  DeltaCompressor dc;
+  std::vector<u8> compressed;
+  ASSERT_TRUE(dc.Compress(base.data(), data.data(), SIZE, &compressed));
+  ASSERT_LT(compressed.size(), SIZE / 100);
+}
+
+TEST(DeltaCompressor, RejectsCorruptData)
+{
+  static constexpr u32 SIZE = 4096;
+  const std::vector<u8> base = MakeRandomBuffer(SIZE, 4);
+  const std::vector<u8> data = MakeRandomBuffer(SIZE, 5);
+
+  DeltaCompressor dc;
+  std::vector<u8> compressed;
+  ASSERT_TRUE(dc.Compress(base.data(), data.data(), SIZE, &compressed));
+
+  std::vector<u8> decompressed(SIZE);
+  ASSERT_FALSE(dc.Decompress(base.data(), compressed.data(), compressed.size() / 2, decompressed.data(), SIZE));
+  ASSERT_FALSE(dc.Decompress(base.data(), compressed.data(), compressed.size(), decompressed.data(), SIZE / 2));
+  ASSERT_TRUE(dc.Decompress(base.data(), compressed.data(), compressed.size(), decompressed.data(), SIZE));
+}
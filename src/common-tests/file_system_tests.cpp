@@ -1,4 +1,5 @@
 #include "common/file_system.h"
+#include <cstring>
 #include <gtest/gtest.h>
 
 TEST(FileSystem, IsAbsolutePath)
@@ -23,3 +24,29 @@ TEST(FileSystem, IsAbsolutePath)
   ASSERT_FALSE(FileSystem::IsAbsolutePath("path/subdirectory"));
 #endif
 }
+
+TEST(FileSystem, MapFileReadOnly)
+{
+  static constexpr const char* filename = "duckstation_map_file_test.bin";
+
+  std::vector<u8> data(100000);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 7);
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(filename, data.data(), data.size()));
+
+  std::unique_ptr<FileSystem::MappedFile> mf = FileSystem::MapFileReadOnly(filename);
+  ASSERT_TRUE(mf);
+  ASSERT_EQ(mf->GetSize(), data.size());
+  ASSERT_EQ(std::memcmp(mf->GetData(), data.data(), data.size()), 0);
+  mf.reset();
+
+  // empty files can't be mapped, but should still open
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(filename, nullptr, 0));
+  mf = FileSystem::MapFileReadOnly(filename);
+  ASSERT_TRUE(mf);
+  ASSERT_EQ(mf->GetSize(), 0u);
+  mf.reset();
+
+  ASSERT_TRUE(FileSystem::DeleteFile(filename));
+  ASSERT_FALSE(FileSystem::MapFileReadOnly(filename));
+}
@@ -0,0 +1,96 @@
+#include "common/flat_hash_map.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+
+using TestMap = FlatHashMap<u32, u32, 0xFFFFFFFFu>;
+
+TEST(FlatHashMap, EmptyMapFindsNothing)
+{
+  TestMap map;
+  ASSERT_TRUE(map.empty());
+  ASSERT_TRUE(map.find(0) == map.end());
+  ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(FlatHashMap, EmplaceDoesNotOverwrite)
+{
+  TestMap map;
+  ASSERT_TRUE(map.emplace(0x80010000, 1).second);
+  ASSERT_FALSE(map.emplace(0x80010000, 2).second);
+  ASSERT_EQ(map.find(0x80010000)->second, 1u);
+  ASSERT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMap, EraseKeepsCollidingKeysReachable)
+{
+  TestMap map;
+  for (u32 i = 0; i < 1000; i++)
+    map.emplace(i * 4, i);
+
+  for (u32 i = 0; i < 1000; i += 2)
+    ASSERT_EQ(map.erase(i * 4), 1u);
+
+  ASSERT_EQ(map.size(), 500u);
+  for (u32 i = 0; i < 1000; i++)
+  {
+    auto iter = map.find(i * 4);
+    if (i & 1)
+    {
+      ASSERT_TRUE(iter != map.end());
+      ASSERT_EQ(iter->second, i);
+    }
+    else
+    {
+      ASSERT_TRUE(iter == map.end());
+    }
+  }
+}
+
+TEST(FlatHashMap, IterationVisitsEveryEntry)
+{
+  TestMap map;
+  u64 expected_sum = 0;
+  for (u32 i = 1; i <= 300; i++)
+  {
+    map.emplace(i << 12, i);
+    expected_sum += i;
+  }
+
+  u64 sum = 0;
+  for (const auto& it : map)
+    sum += it.second;
+  ASSERT_EQ(sum, expected_sum);
+
+  map.clear();
+  ASSERT_TRUE(map.empty());
+  ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(FlatHashMap, MatchesUnorderedMap)
+{
+  TestMap map;
+  std::unordered_map<u32, u32> reference;
+  std::mt19937 rng(1234);
+  for (u32 i = 0; i < 100000; i++)
+  {
+    const u32 key = (rng() % 4096) * 4;
+    if (rng() % 3 == 0)
+    {
+      ASSERT_EQ(map.erase(key), reference.erase(key));
+    }
+    else
+    {
+      const u32 value = rng();
+      ASSERT_EQ(map.emplace(key, value).second, reference.emplace(key, value).second);
+    }
+  }
+
+  ASSERT_EQ(map.size(), reference.size());
+  for (const auto& it : reference)
+  {
+    auto iter = map.find(it.first);
+    ASSERT_TRUE(iter != map.end());
+    ASSERT_EQ(iter->second, it.second);
+  }
+}
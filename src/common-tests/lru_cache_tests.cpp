@@ -0,0 +1,36 @@
+#include "common/lru_cache.h"
+#include <gtest/gtest.h>
+
+TEST(LRUCache, EvictsLeastRecentlyUsed)
+{
+  LRUCache<int, int> cache(3);
+  cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(3, 30);
+  ASSERT_NE(cache.Lookup(1), nullptr);
+
+  // 2 is now the oldest
+  cache.Insert(4, 40);
+  ASSERT_EQ(cache.GetSize(), 3u);
+  ASSERT_EQ(cache.Lookup(2), nullptr);
+  ASSERT_EQ(*cache.Lookup(1), 10);
+  ASSERT_EQ(*cache.Lookup(3), 30);
+  ASSERT_EQ(*cache.Lookup(4), 40);
+}
+
+TEST(LRUCache, ShrinksToCapacity)
+{
+  LRUCache<int, int> cache(4);
+  for (int i = 0; i < 4; i++)
+    cache.Insert(i, i);
+
+  cache.SetMaxCapacity(2);
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(cache.Lookup(0), nullptr);
+  ASSERT_EQ(cache.Lookup(1), nullptr);
+  ASSERT_EQ(*cache.Lookup(2), 2);
+  ASSERT_EQ(*cache.Lookup(3), 3);
+
+  cache.Evict(5);
+  ASSERT_EQ(cache.GetSize(), 0u);
+}
@@ -0,0 +1,227 @@
+#include "common/mdec_transform.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using Block = std::array<s16, 64>;
+
+// Straightforward implementations from the nocash spec, which the MDEC used before.
+static void ReferenceIDCT(s16* blk, const s16* scale_table)
+{
+  std::array<s64, 64> temp_buffer;
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+    {
+      s64 sum = 0;
+      for (u32 u = 0; u < 8; u++)
+        sum += s32(blk[u * 8 + x]) * s32(scale_table[u * 8 + y]);
+      temp_buffer[x + y * 8] = sum;
+    }
+  }
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+    {
+      s64 sum = 0;
+      for (u32 u = 0; u < 8; u++)
+        sum += s64(temp_buffer[u + y * 8]) * s32(scale_table[u * 8 + x]);
+
+      blk[x + y * 8] =
+        static_cast<s16>(std::clamp<s32>(SignExtendN<9, s32>((sum >> 32) + ((sum >> 31) & 1)), -128, 127));
+    }
+  }
+}
+
+static void ReferenceYUVToRGB(u32* rgb, u32 xx, u32 yy, const s16* Crblk, const s16* Cbblk, const s16* Yblk)
+{
+  for (u32 y = 0; y < 8; y++)
+  {
+    for (u32 x = 0; x < 8; x++)
+    {
+      s16 R = Crblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
+      s16 B = Cbblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
+      s16 G = static_cast<s16>((-0.3437f * static_cast<float>(B)) + (-0.7143f * static_cast<float>(R)));
+
+      R = static_cast<s16>(1.402f * static_cast<float>(R));
+      B = static_cast<s16>(1.772f * static_cast<float>(B));
+
+      s16 Y = Yblk[x + y * 8];
+      R = static_cast<s16>(std::clamp(static_cast<int>(Y) + R, -128, 127));
+      G = static_cast<s16>(std::clamp(static_cast<int>(Y) + G, -128, 127));
+      B = static_cast<s16>(std::clamp(static_cast<int>(Y) + B, -128, 127));
+
+      R += 128;
+      G += 128;
+      B += 128;
+
+      rgb[(x + xx) + ((y + yy) * 16)] = ZeroExtend32(static_cast<u16>(R)) | (ZeroExtend32(static_cast<u16>(G)) << 8) |
+                                        (ZeroExtend32(static_cast<u16>(B)) << 16);
+    }
+  }
+}
+
+// The table most games upload, cos((2x + 1) * u * pi / 16) in 1.15 fixed-point, with the DC row scaled by 1/sqrt(2).
+static Block GetStandardScaleTable()
+{
+  static constexpr double pi = 3.14159265358979323846;
+  Block table;
+  for (u32 u = 0; u < 8; u++)
+  {
+    for (u32 x = 0; x < 8; x++)
+    {
+      const double scale = (u == 0) ? (1.0 / std::sqrt(2.0)) : 1.0;
+      table[u * 8 + x] = static_cast<s16>(std::lround(scale * std::cos((2 * x + 1) * u * pi / 16.0) * 32768.0));
+    }
+  }
+
+  return table;
+}
+
+// Coefficients as the run-length decoder produces them, mostly zero with a few low frequencies.
+static Block GenerateCoefficients(std::mt19937& rng, u32 num_coefficients)
+{
+  Block blk = {};
+  std::uniform_int_distribution<s32> value(-0x400, 0x3FF);
+  std::uniform_int_distribution<u32> position(0, 63);
+  for (u32 i = 0; i < num_coefficients; i++)
+    blk[(i == 0) ? 0 : position(rng)] = static_cast<s16>(value(rng));
+
+  return blk;
+}
+
+static void TestIDCT(const Block& input, const Block& scale_table)
+{
+  Block expected = input;
+  ReferenceIDCT(expected.data(), scale_table.data());
+
+  Block actual = input;
+  MDECTransform::IDCT(actual.data(), scale_table.data());
+  ASSERT_EQ(actual, expected);
+}
+
+TEST(MDECTransform, IDCTStandardTable)
+{
+  std::mt19937 rng(1234);
+  const Block scale_table = GetStandardScaleTable();
+  for (u32 i = 0; i < 10000; i++)
+    TestIDCT(GenerateCoefficients(rng, 1 + (i % 64)), scale_table);
+}
+
+TEST(MDECTransform, IDCTRandomTable)
+{
+  std::mt19937 rng(5678);
+  std::uniform_int_distribution<s32> coefficient(-0x400, 0x3FF);
+  std::uniform_int_distribution<s32> scale(-0x8000, 0x7FFF);
+  for (u32 i = 0; i < 10000; i++)
+  {
+    Block input, scale_table;
+    for (u32 j = 0; j < 64; j++)
+    {
+      input[j] = static_cast<s16>(coefficient(rng));
+      scale_table[j] = static_cast<s16>(scale(rng));
+    }
+
+    TestIDCT(input, scale_table);
+  }
+}
+
+TEST(MDECTransform, IDCTExtremes)
+{
+  static constexpr std::array<s16, 3> coefficients = {{-0x400, 0x3FF, 0}};
+  static constexpr std::array<s16, 4> scales = {{-0x8000, 0x7FFF, -1, 1}};
+  for (const s16 coefficient : coefficients)
+  {
+    for (const s16 scale : scales)
+    {
+      Block input, scale_table;
+      input.fill(coefficient);
+      scale_table.fill(scale);
+      TestIDCT(input, scale_table);
+
+      // alternate signs, so the sums peak in different places
+      for (u32 i = 0; i < 64; i += 2)
+        scale_table[i] = static_cast<s16>(-scale - 1);
+      TestIDCT(input, scale_table);
+    }
+  }
+}
+
+TEST(MDECTransform, YUVToRGB)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<s32> sample(-128, 127);
+  for (u32 i = 0; i < 1000; i++)
+  {
+    Block Crblk, Cbblk, Yblk;
+    for (u32 j = 0; j < 64; j++)
+    {
+      Crblk[j] = static_cast<s16>(sample(rng));
+      Cbblk[j] = static_cast<s16>(sample(rng));
+      Yblk[j] = static_cast<s16>(sample(rng));
+    }
+
+    std::array<u32, 256> expected = {}, actual = {};
+    for (u32 yy = 0; yy < 16; yy += 8)
+    {
+      for (u32 xx = 0; xx < 16; xx += 8)
+      {
+        ReferenceYUVToRGB(expected.data(), xx, yy, Crblk.data(), Cbblk.data(), Yblk.data());
+        MDECTransform::YUVToRGB(actual.data(), xx, yy, Crblk.data(), Cbblk.data(), Yblk.data());
+      }
+    }
+
+    ASSERT_EQ(actual, expected);
+  }
+}
+
+TEST(MDECTransform, YToMono)
+{
+  Block Yblk;
+  for (u32 i = 0; i < 1024; i += 64)
+  {
+    for (u32 j = 0; j < 64; j++)
+      Yblk[j] = static_cast<s16>(static_cast<s32>(i + j) - 512);
+
+    std::array<u32, 64> actual;
+    MDECTransform::YToMono(actual.data(), Yblk.data());
+    for (u32 j = 0; j < 64; j++)
+    {
+      const s16 expected = std::clamp<s16>(SignExtendN<10, s16>(Yblk[j]), -128, 127) + 128;
+      ASSERT_EQ(actual[j], static_cast<u32>(expected) & 0xFF);
+    }
+  }
+}
+
+TEST(MDECTransform, PackRGB)
+{
+  std::mt19937 rng(42);
+  std::array<u32, 256> rgb;
+  for (u32& value : rgb)
+    value = rng() & 0xFFFFFF;
+
+  for (const bool set_bit15 : {false, true})
+  {
+    std::array<u32, 128> packed;
+    MDECTransform::PackRGB15(rgb.data(), packed.data(), static_cast<u32>(rgb.size()), set_bit15);
+    for (u32 i = 0; i < rgb.size(); i++)
+    {
+      const u32 color = rgb[i];
+      const u32 expected = ((color >> 3) & 0x1F) | (((color >> 11) & 0x1F) << 5) | (((color >> 19) & 0x1F) << 10) |
+                           (set_bit15 ? 0x8000u : 0u);
+      ASSERT_EQ((packed[i / 2] >> ((i % 2) * 16)) & 0xFFFF, expected);
+    }
+  }
+
+  std::array<u32, 192> packed;
+  MDECTransform::PackRGB24(rgb.data(), packed.data(), static_cast<u32>(rgb.size()));
+  const u8* packed_bytes = reinterpret_cast<const u8*>(packed.data());
+  for (u32 i = 0; i < rgb.size(); i++)
+  {
+    const u32 value = ZeroExtend32(packed_bytes[i * 3]) | (ZeroExtend32(packed_bytes[i * 3 + 1]) << 8) |
+                      (ZeroExtend32(packed_bytes[i * 3 + 2]) << 16);
+    ASSERT_EQ(value, rgb[i]);
+  }
+}
@@ -0,0 +1,153 @@
+#include "common/pixel_conversion.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// Same expansion as VRAMConvert5To8() in core.
+static constexpr u32 Convert5To8(u32 color)
+{
+  return (((color * 527u) + 23u) >> 6);
+}
+
+static u16 Reference15BitToRGB565(u16 value)
+{
+  const u32 r = value & 0x1F, g = (value >> 5) & 0x1F, b = (value >> 10) & 0x1F;
+  return static_cast<u16>((r << 11) | (g << 6) | b);
+}
+
+static u16 Reference15BitToRGBA5551(u16 value)
+{
+  const u32 r = value & 0x1F, g = (value >> 5) & 0x1F, b = (value >> 10) & 0x1F;
+  return static_cast<u16>((r << 10) | (g << 5) | b);
+}
+
+static u32 Reference15BitToRGBA8(u16 value)
+{
+  const u32 r = value & 0x1F, g = (value >> 5) & 0x1F, b = (value >> 10) & 0x1F;
+  return Convert5To8(r) | (Convert5To8(g) << 8) | (Convert5To8(b) << 16) | ((value & 0x8000) ? 0xFF000000u : 0u);
+}
+
+static u32 Reference15BitToBGRA8(u16 value)
+{
+  const u32 r = value & 0x1F, g = (value >> 5) & 0x1F, b = (value >> 10) & 0x1F;
+  return Convert5To8(b) | (Convert5To8(g) << 8) | (Convert5To8(r) << 16) | 0xFF000000u;
+}
+
+static u16 Reference24BitToRGB565(const u8* rgb)
+{
+  return static_cast<u16>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+
+static u16 Reference24BitToRGBA5551(const u8* rgb)
+{
+  return static_cast<u16>(((rgb[0] >> 3) << 10) | ((rgb[1] >> 3) << 5) | (rgb[2] >> 3));
+}
+
+static u32 Reference24BitToRGBA8(const u8* rgb)
+{
+  return rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | 0xFF000000u;
+}
+
+static u32 Reference24BitToBGRA8(const u8* rgb)
+{
+  return rgb[2] | (rgb[1] << 8) | (rgb[0] << 16) | 0xFF000000u;
+}
+
+// Converts rows of every width up to MAX_WIDTH, so that both the vector and scalar remainder paths are covered, and
+// checks that nothing past the end of the row is written.
+static constexpr u32 MAX_WIDTH = 67;
+
+template<typename OutType, typename ConvertFunction, typename ReferenceFunction>
+static void Test15Bit(ConvertFunction convert, ReferenceFunction reference)
+{
+  std::mt19937 rng(1234);
+  std::vector<u16> src(MAX_WIDTH);
+  for (u16& value : src)
+    value = static_cast<u16>(rng());
+
+  for (u32 width = 0; width <= MAX_WIDTH; width++)
+  {
+    std::vector<OutType> dst(MAX_WIDTH + 1, static_cast<OutType>(0xCDCDCDCDu));
+    convert(src.data(), dst.data(), width);
+    for (u32 i = 0; i < width; i++)
+      ASSERT_EQ(dst[i], reference(src[i])) << "width " << width << " pixel " << i;
+    for (u32 i = width; i <= MAX_WIDTH; i++)
+      ASSERT_EQ(dst[i], static_cast<OutType>(0xCDCDCDCDu)) << "width " << width << " pixel " << i;
+  }
+}
+
+template<typename OutType, typename ConvertFunction, typename ReferenceFunction>
+static void Test24Bit(ConvertFunction convert, ReferenceFunction reference)
+{
+  std::mt19937 rng(5678);
+  for (u32 width = 0; width <= MAX_WIDTH; width++)
+  {
+    // Sized exactly, so reading past the end of the row is caught by sanitizers.
+    std::vector<u8> src(width * 3);
+    for (u8& value : src)
+      value = static_cast<u8>(rng());
+
+    std::vector<OutType> dst(MAX_WIDTH + 1, static_cast<OutType>(0xCDCDCDCDu));
+    convert(src.data(), dst.data(), width);
+    for (u32 i = 0; i < width; i++)
+      ASSERT_EQ(dst[i], reference(&src[i * 3])) << "width " << width << " pixel " << i;
+    for (u32 i = width; i <= MAX_WIDTH; i++)
+      ASSERT_EQ(dst[i], static_cast<OutType>(0xCDCDCDCDu)) << "width " << width << " pixel " << i;
+  }
+}
+
+TEST(PixelConversion, Convert15BitToRGB565)
+{
+  Test15Bit<u16>(PixelConversion::Convert15BitToRGB565, Reference15BitToRGB565);
+}
+
+TEST(PixelConversion, Convert15BitToRGBA5551)
+{
+  Test15Bit<u16>(PixelConversion::Convert15BitToRGBA5551, Reference15BitToRGBA5551);
+}
+
+TEST(PixelConversion, Convert15BitToRGBA8)
+{
+  Test15Bit<u32>(PixelConversion::Convert15BitToRGBA8, Reference15BitToRGBA8);
+}
+
+TEST(PixelConversion, Convert15BitToBGRA8)
+{
+  Test15Bit<u32>(PixelConversion::Convert15BitToBGRA8, Reference15BitToBGRA8);
+}
+
+TEST(PixelConversion, Convert15BitAllValues)
+{
+  std::vector<u16> src(0x10000);
+  for (u32 i = 0; i < 0x10000; i++)
+    src[i] = static_cast<u16>(i);
+
+  std::vector<u32> dst(src.size());
+  PixelConversion::Convert15BitToRGBA8(src.data(), dst.data(), static_cast<u32>(src.size()));
+  for (u32 i = 0; i < 0x10000; i++)
+    ASSERT_EQ(dst[i], Reference15BitToRGBA8(src[i]));
+
+  PixelConversion::Convert15BitToBGRA8(src.data(), dst.data(), static_cast<u32>(src.size()));
+  for (u32 i = 0; i < 0x10000; i++)
+    ASSERT_EQ(dst[i], Reference15BitToBGRA8(src[i]));
+}
+
+TEST(PixelConversion, Convert24BitToRGB565)
+{
+  Test24Bit<u16>(PixelConversion::Convert24BitToRGB565, Reference24BitToRGB565);
+}
+
+TEST(PixelConversion, Convert24BitToRGBA5551)
+{
+  Test24Bit<u16>(PixelConversion::Convert24BitToRGBA5551, Reference24BitToRGBA5551);
+}
+
+TEST(PixelConversion, Convert24BitToRGBA8)
+{
+  Test24Bit<u32>(PixelConversion::Convert24BitToRGBA8, Reference24BitToRGBA8);
+}
+
+TEST(PixelConversion, Convert24BitToBGRA8)
+{
+  Test24Bit<u32>(PixelConversion::Convert24BitToBGRA8, Reference24BitToBGRA8);
+}
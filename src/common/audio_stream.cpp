@@ -6,7 +6,7 @@
 #include <cstring>
 Log_SetChannel(AudioStream);
 
-AudioStream::AudioStream() = default;
+AudioStream::AudioStream() : m_buffer(std::make_unique<SampleType[]>(MaxSamples)) {}
 
 AudioStream::~AudioStream()
 {
@@ -17,8 +17,7 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
                               u32 output_sample_rate /* = DefaultOutputSampleRate */, u32 channels /* = 1 */,
                               u32 buffer_size /* = DefaultBufferSize */)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
-  std::unique_lock<std::mutex> resampler_Lock(m_resampler_mutex);
+  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
 
   DestroyResampler();
   if (IsDeviceOpen())
@@ -27,7 +26,7 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
   m_output_sample_rate = output_sample_rate;
   m_channels = channels;
   m_buffer_size = buffer_size;
-  m_buffer_filling.store(m_wait_for_buffer_fill);
+  m_buffer_filling.store(m_wait_for_buffer_fill.load());
   m_output_paused = true;
 
   if (!SetBufferSize(buffer_size))
@@ -35,7 +34,7 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
 
   if (!OpenDevice())
   {
-    LockedEmptyBuffers();
+    ResetBuffers();
     m_buffer_size = 0;
     m_output_sample_rate = 0;
     m_channels = 0;
@@ -50,7 +49,6 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
 
 void AudioStream::SetInputSampleRate(u32 sample_rate)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
   std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
 
   InternalSetInputSampleRate(sample_rate);
@@ -58,9 +56,8 @@ void AudioStream::SetInputSampleRate(u32 sample_rate)
 
 void AudioStream::SetWaitForBufferFill(bool enabled)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
-  m_wait_for_buffer_fill = enabled;
-  if (enabled && m_buffer.IsEmpty())
+  m_wait_for_buffer_fill.store(enabled);
+  if (enabled && GetBufferedSamples() == 0)
     m_buffer_filling.store(true);
 }
 
@@ -77,7 +74,6 @@ void AudioStream::InternalSetInputSampleRate(u32 sample_rate)
 
 void AudioStream::SetOutputVolume(u32 volume)
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
   m_output_volume = volume;
 }
 
@@ -100,7 +96,10 @@ void AudioStream::Shutdown()
     return;
 
   CloseDevice();
-  EmptyBuffers();
+  {
+    std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+    ResetBuffers();
+  }
   m_buffer_size = 0;
   m_output_sample_rate = 0;
   m_channels = 0;
@@ -109,37 +108,54 @@ void AudioStream::Shutdown()
 
 void AudioStream::BeginWrite(SampleType** buffer_ptr, u32* num_frames)
 {
-  m_buffer_mutex.lock();
-
   const u32 requested_frames = std::min(*num_frames, m_buffer_size);
-  EnsureBuffer(requested_frames * m_channels);
+  if (!EnsureBuffer(requested_frames * m_channels))
+  {
+    // not syncing and the consumer hasn't caught up, so throw this batch away
+    m_discarding_write = true;
+    *buffer_ptr = m_discard_buffer.data();
+    *num_frames = requested_frames;
+    return;
+  }
 
-  *buffer_ptr = m_buffer.GetWritePointer();
-  *num_frames = std::min(m_buffer_size, m_buffer.GetContiguousSpace() / m_channels);
+  const u32 offset = m_buffer_write_position.load(std::memory_order_relaxed) % MaxSamples;
+  *buffer_ptr = &m_buffer[offset];
+  *num_frames = std::min(m_buffer_size, std::min(GetBufferSpace(), MaxSamples - offset) / m_channels);
 }
 
 void AudioStream::WriteFrames(const SampleType* frames, u32 num_frames)
 {
   Assert(num_frames <= m_buffer_size);
-  const u32 num_samples = num_frames * m_channels;
+  while (num_frames > 0)
   {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex);
-    EnsureBuffer(num_samples);
-    m_buffer.PushRange(frames, num_samples);
+    SampleType* buffer_ptr;
+    u32 frames_to_write = num_frames;
+    BeginWrite(&buffer_ptr, &frames_to_write);
+    frames_to_write = std::min(frames_to_write, num_frames);
+    std::memcpy(buffer_ptr, frames, sizeof(SampleType) * frames_to_write * m_channels);
+    EndWrite(frames_to_write);
+
+    frames += frames_to_write * m_channels;
+    num_frames -= frames_to_write;
   }
-
-  FramesAvailable();
 }
 
 void AudioStream::EndWrite(u32 num_frames)
 {
-  m_buffer.AdvanceTail(num_frames * m_channels);
+  if (m_discarding_write)
+  {
+    m_discarding_write = false;
+    return;
+  }
+
+  // release so the consumer sees the samples before the new position
+  m_buffer_write_position.store(m_buffer_write_position.load(std::memory_order_relaxed) + num_frames * m_channels,
+                                std::memory_order_release);
   if (m_buffer_filling.load())
   {
-    if ((m_buffer.GetSize() / m_channels) >= m_buffer_size)
+    if ((GetBufferedSamples() / m_channels) >= m_buffer_size)
       m_buffer_filling.store(false);
   }
-  m_buffer_mutex.unlock();
   FramesAvailable();
 }
 
@@ -152,62 +168,70 @@ bool AudioStream::SetBufferSize(u32 buffer_size)
 {
   const u32 buffer_size_in_samples = buffer_size * m_channels;
   const u32 max_samples = buffer_size_in_samples * 2u;
-  if (max_samples > m_buffer.GetCapacity())
+  if (max_samples > MaxSamples)
     return false;
 
   m_buffer_size = buffer_size;
   m_max_samples = max_samples;
+  m_discard_buffer.resize(buffer_size_in_samples);
   return true;
 }
 
 u32 AudioStream::GetSamplesAvailable() const
 {
-  // TODO: Use atomic loads
-  u32 available_samples;
-  {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex);
-    available_samples = m_buffer.GetSize();
-  }
+  return GetBufferedSamples() / m_channels;
+}
 
-  return available_samples / m_channels;
+void AudioStream::PopSamples(SampleType* samples, u32 count)
+{
+  const u32 offset = m_buffer_read_position.load(std::memory_order_relaxed) % MaxSamples;
+  const u32 count_before_end = std::min(count, MaxSamples - offset);
+  std::memcpy(samples, &m_buffer[offset], sizeof(SampleType) * count_before_end);
+  if (count_before_end < count)
+    std::memcpy(samples + count_before_end, &m_buffer[0], sizeof(SampleType) * (count - count_before_end));
+
+  AdvanceReadPosition(count);
 }
 
-u32 AudioStream::GetSamplesAvailableLocked() const
+void AudioStream::AdvanceReadPosition(u32 count)
 {
-  return m_buffer.GetSize() / m_channels;
+  // release so the producer doesn't overwrite the samples before we're done with them
+  m_buffer_read_position.store(m_buffer_read_position.load(std::memory_order_relaxed) + count,
+                               std::memory_order_release);
+
+  // pairs with the fence in EnsureBuffer(): either the producer sees the space we just freed, or we see it waiting
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_buffer_draining_waiting.load(std::memory_order_relaxed))
+  {
+    std::unique_lock<std::mutex> lock(m_buffer_draining_mutex);
+    m_buffer_draining_cv.notify_one();
+  }
 }
 
 void AudioStream::ReadFrames(SampleType* samples, u32 num_frames, bool apply_volume)
 {
+  ProcessEmptyRequest();
+
   const u32 total_samples = num_frames * m_channels;
   u32 samples_copied = 0;
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
   if (!m_buffer_filling.load())
   {
     if (m_input_sample_rate == m_output_sample_rate)
     {
-      samples_copied = std::min(m_buffer.GetSize(), total_samples);
+      samples_copied = std::min(GetBufferedSamples(), total_samples);
       if (samples_copied > 0)
-        m_buffer.PopRange(samples, samples_copied);
-
-      ReleaseBufferLock(std::move(buffer_lock));
+        PopSamples(samples, samples_copied);
     }
     else
     {
       if (m_resampled_buffer.GetSize() < total_samples)
-        ResampleInput(std::move(buffer_lock));
-      else
-        ReleaseBufferLock(std::move(buffer_lock));
+        ResampleInput();
 
       samples_copied = std::min(m_resampled_buffer.GetSize(), total_samples);
       if (samples_copied > 0)
         m_resampled_buffer.PopRange(samples, samples_copied);
     }
   }
-  else
-  {
-    ReleaseBufferLock(std::move(buffer_lock));
-  }
 
   if (samples_copied < total_samples)
   {
@@ -246,7 +270,7 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames, bool apply_vol
       m_underflow_flag.store(true);
     }
 
-    m_buffer_filling.store(m_wait_for_buffer_fill);
+    m_buffer_filling.store(m_wait_for_buffer_fill.load());
   }
 
   if (apply_volume && m_output_volume != FullVolume)
@@ -261,42 +285,61 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames, bool apply_vol
   }
 }
 
-void AudioStream::EnsureBuffer(u32 size)
+bool AudioStream::EnsureBuffer(u32 size)
 {
   DebugAssert(size <= (m_buffer_size * m_channels));
   if (GetBufferSpace() >= size)
-    return;
+    return true;
 
-  if (m_sync)
-  {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex, std::adopt_lock);
-    m_buffer_draining_cv.wait(lock, [this, size]() { return GetBufferSpace() >= size; });
-    lock.release();
-  }
-  else
-  {
-    m_buffer.Remove(size);
-  }
+  if (!m_sync.load())
+    return false;
+
+  std::unique_lock<std::mutex> lock(m_buffer_draining_mutex);
+  m_buffer_draining_waiting.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  m_buffer_draining_cv.wait(lock, [this, size]() { return GetBufferSpace() >= size; });
+  m_buffer_draining_waiting.store(false, std::memory_order_relaxed);
+  return true;
 }
 
-void AudioStream::DropFrames(u32 count)
+void AudioStream::DropFrames(u32 num_frames)
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
-  m_buffer.Remove(count);
+  ProcessEmptyRequest();
+  AdvanceReadPosition(std::min(num_frames * m_channels, GetBufferedSamples()));
 }
 
 void AudioStream::EmptyBuffers()
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
+  // The read position belongs to the consumer, so it does the discard. Only samples which have been written up to now
+  // are dropped, anything the producer writes in the meantime is kept.
+  m_empty_position.store(m_buffer_write_position.load(std::memory_order_acquire), std::memory_order_relaxed);
+  m_empty_requested.store(true, std::memory_order_release);
+}
+
+void AudioStream::ProcessEmptyRequest()
+{
+  if (!m_empty_requested.load(std::memory_order_relaxed) || !m_empty_requested.exchange(false))
+    return;
+
+  // the consumer may have already read past the requested position, in which case there's nothing to drop
+  const u32 count = m_empty_position.load(std::memory_order_relaxed) -
+                    m_buffer_read_position.load(std::memory_order_relaxed);
+  if (count <= GetBufferedSamples())
+    AdvanceReadPosition(count);
+
+  m_underflow_flag.store(false);
+  m_buffer_filling.store(m_wait_for_buffer_fill.load());
+
   std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
-  LockedEmptyBuffers();
+  ResetResampler();
 }
 
-void AudioStream::LockedEmptyBuffers()
+void AudioStream::ResetBuffers()
 {
-  m_buffer.Clear();
+  m_empty_requested.store(false);
+  AdvanceReadPosition(GetBufferedSamples());
   m_underflow_flag.store(false);
-  m_buffer_filling.store(m_wait_for_buffer_fill);
+  m_buffer_filling.store(m_wait_for_buffer_fill.load());
   ResetResampler();
 }
 
@@ -324,29 +367,31 @@ void AudioStream::ResetResampler()
   src_reset(static_cast<SRC_STATE*>(m_resampler_state));
 }
 
-void AudioStream::ResampleInput(std::unique_lock<std::mutex> buffer_lock)
+void AudioStream::ResampleInput()
 {
   std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
 
   const u32 input_space_from_output = (m_resampled_buffer.GetSpace() * m_output_sample_rate) / m_input_sample_rate;
-  u32 remaining = std::min(m_buffer.GetSize(), input_space_from_output);
+  u32 remaining = std::min(GetBufferedSamples(), input_space_from_output);
   if (m_resample_in_buffer.size() < remaining)
   {
     remaining -= static_cast<u32>(m_resample_in_buffer.size());
+    const u32 count = remaining;
+    u32 read_offset = m_buffer_read_position.load(std::memory_order_relaxed) % MaxSamples;
     m_resample_in_buffer.reserve(m_resample_in_buffer.size() + remaining);
     while (remaining > 0)
     {
-      const u32 read_len = std::min(m_buffer.GetContiguousSize(), remaining);
+      const u32 read_len = std::min(MaxSamples - read_offset, remaining);
       const size_t old_pos = m_resample_in_buffer.size();
       m_resample_in_buffer.resize(m_resample_in_buffer.size() + read_len);
-      src_short_to_float_array(m_buffer.GetReadPointer(), m_resample_in_buffer.data() + old_pos,
+      src_short_to_float_array(&m_buffer[read_offset], m_resample_in_buffer.data() + old_pos,
                                static_cast<int>(read_len));
-      m_buffer.Remove(read_len);
+      read_offset = (read_offset + read_len) % MaxSamples;
       remaining -= read_len;
     }
-  }
 
-  ReleaseBufferLock(std::move(buffer_lock));
+    AdvanceReadPosition(count);
+  }
 
   const u32 potential_output_size =
     (static_cast<u32>(m_resample_in_buffer.size()) * m_input_sample_rate) / m_output_sample_rate;
@@ -8,6 +8,11 @@
 #include <vector>
 
 // Uses signed 16-bits samples.
+//
+// Samples are passed from the emulation thread to the output callback through a lock-free single-producer,
+// single-consumer ring buffer. BeginWrite()/EndWrite() must only be called from the producer side, and ReadFrames()/
+// DropFrames() only from the consumer side. The producer only sleeps when audio sync is enabled and the buffer is full,
+// and the consumer only touches a lock to wake it up again.
 
 class AudioStream
 {
@@ -30,11 +35,11 @@ public:
   u32 GetChannels() const { return m_channels; }
   u32 GetBufferSize() const { return m_buffer_size; }
   s32 GetOutputVolume() const { return m_output_volume; }
-  bool IsSyncing() const { return m_sync; }
+  bool IsSyncing() const { return m_sync.load(); }
 
   bool Reconfigure(u32 input_sample_rate = DefaultInputSampleRate, u32 output_sample_rate = DefaultOutputSampleRate,
                    u32 channels = 1, u32 buffer_size = DefaultBufferSize);
-  void SetSync(bool enable) { m_sync = enable; }
+  void SetSync(bool enable) { m_sync.store(enable); }
 
   void SetInputSampleRate(u32 sample_rate);
   void SetWaitForBufferFill(bool enabled);
@@ -42,6 +47,8 @@ public:
   virtual void SetOutputVolume(u32 volume);
 
   void PauseOutput(bool paused);
+
+  /// Discards all buffered samples. The discard is performed by the consumer on its next read.
   void EmptyBuffers();
 
   void Shutdown();
@@ -50,11 +57,7 @@ public:
   void WriteFrames(const SampleType* frames, u32 num_frames);
   void EndWrite(u32 num_frames);
 
-  bool DidUnderflow()
-  {
-    bool expected = true;
-    return m_underflow_flag.compare_exchange_strong(expected, false);
-  }
+  bool DidUnderflow() { return m_underflow_flag.exchange(false); }
 
   static std::unique_ptr<AudioStream> CreateNullAudioStream();
 
@@ -72,28 +75,32 @@ protected:
     return s16((s32(sample) * s32(volume)) / 100);
   }
 
-  ALWAYS_INLINE u32 GetBufferSpace() const { return (m_max_samples - m_buffer.GetSize()); }
-  ALWAYS_INLINE void ReleaseBufferLock(std::unique_lock<std::mutex> lock)
+  ALWAYS_INLINE u32 GetBufferedSamples() const
   {
-    // lock is released implicitly by destruction
-    m_buffer_draining_cv.notify_one();
+    return (m_buffer_write_position.load(std::memory_order_acquire) -
+            m_buffer_read_position.load(std::memory_order_acquire));
   }
+  ALWAYS_INLINE u32 GetBufferSpace() const { return (m_max_samples - GetBufferedSamples()); }
 
   bool SetBufferSize(u32 buffer_size);
   bool IsDeviceOpen() const { return (m_output_sample_rate > 0); }
 
-  void EnsureBuffer(u32 size);
-  void LockedEmptyBuffers();
+  bool EnsureBuffer(u32 size);
+  void ResetBuffers();
   u32 GetSamplesAvailable() const;
-  u32 GetSamplesAvailableLocked() const;
   void ReadFrames(SampleType* samples, u32 num_frames, bool apply_volume);
-  void DropFrames(u32 count);
+  void DropFrames(u32 num_frames);
+
+  // Consumer side of the ring buffer.
+  void PopSamples(SampleType* samples, u32 count);
+  void AdvanceReadPosition(u32 count);
+  void ProcessEmptyRequest();
 
   void CreateResampler();
   void DestroyResampler();
   void ResetResampler();
   void InternalSetInputSampleRate(u32 sample_rate);
-  void ResampleInput(std::unique_lock<std::mutex> buffer_lock);
+  void ResampleInput();
 
   u32 m_input_sample_rate = 0;
   u32 m_output_sample_rate = 0;
@@ -103,18 +110,31 @@ protected:
   // volume, 0-100
   u32 m_output_volume = FullVolume;
 
-  HeapFIFOQueue<SampleType, MaxSamples> m_buffer;
-  mutable std::mutex m_buffer_mutex;
-  std::condition_variable m_buffer_draining_cv;
+  // Positions are free-running sample counters, the buffer index is the position modulo MaxSamples. The write position
+  // is only modified by the producer, and the read position by the consumer.
+  std::unique_ptr<SampleType[]> m_buffer;
+  alignas(64) std::atomic<u32> m_buffer_write_position{0};
+  alignas(64) std::atomic<u32> m_buffer_read_position{0};
+  alignas(64) std::atomic<u32> m_empty_position{0};
+  std::atomic_bool m_empty_requested{false};
   std::vector<SampleType> m_resample_buffer;
 
+  // Used to discard a batch when the buffer is full and we're not syncing to audio.
+  std::vector<SampleType> m_discard_buffer;
+  bool m_discarding_write = false;
+
+  // Only used to put the producer to sleep when it's waiting for the buffer to drain.
+  std::mutex m_buffer_draining_mutex;
+  std::condition_variable m_buffer_draining_cv;
+  std::atomic_bool m_buffer_draining_waiting{false};
+
   std::atomic_bool m_underflow_flag{false};
   std::atomic_bool m_buffer_filling{false};
   u32 m_max_samples = 0;
 
   bool m_output_paused = true;
-  bool m_sync = true;
-  bool m_wait_for_buffer_fill = false;
+  std::atomic_bool m_sync{true};
+  std::atomic_bool m_wait_for_buffer_fill{false};
 
   // Resampling
   double m_resampler_ratio = 1.0;
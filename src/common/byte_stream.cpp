@@ -3,6 +3,7 @@
 #include "file_system.h"
 #include "log.h"
 #include "string_util.h"
+#include "zlib.h"
 #include <algorithm>
 #include <cerrno>
 #include <cstdio>
@@ -26,6 +27,10 @@
 #include <alloca.h>
 #endif
 
+#include "Alloc.h"
+#include "LzmaDec.h"
+#include "LzmaEnc.h"
+
 Log_SetChannel(ByteStream);
 
 class FileByteStream : public ByteStream
@@ -1411,3 +1416,281 @@ u32 ByteStream_CopyBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* p
 
   return byteCount - remaining;
 }
+
+static constexpr u32 COMPRESSION_CHUNK_SIZE = 64 * 1024;
+
+static u32 DeflateBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* pDestinationStream, int level)
+{
+  z_stream zs = {};
+  int err = deflateInit(&zs, level);
+  if (err != Z_OK)
+  {
+    Log_ErrorPrintf("deflateInit() failed: %d", err);
+    return 0;
+  }
+
+  std::unique_ptr<u8[]> inBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  std::unique_ptr<u8[]> outBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  u32 remaining = byteCount;
+  u32 compressedSize = 0;
+  bool success = true;
+  do
+  {
+    const u32 inSize = std::min(remaining, COMPRESSION_CHUNK_SIZE);
+    if (inSize > 0 && !pSourceStream->Read2(inBuffer.get(), inSize))
+    {
+      success = false;
+      break;
+    }
+
+    remaining -= inSize;
+    zs.next_in = inBuffer.get();
+    zs.avail_in = inSize;
+
+    const int flush = (remaining == 0) ? Z_FINISH : Z_NO_FLUSH;
+    do
+    {
+      zs.next_out = outBuffer.get();
+      zs.avail_out = COMPRESSION_CHUNK_SIZE;
+      err = deflate(&zs, flush);
+      if (err == Z_STREAM_ERROR)
+      {
+        Log_ErrorPrintf("deflate() failed: %d", err);
+        success = false;
+        break;
+      }
+
+      const u32 outSize = COMPRESSION_CHUNK_SIZE - zs.avail_out;
+      if (outSize > 0 && !pDestinationStream->Write2(outBuffer.get(), outSize))
+      {
+        success = false;
+        break;
+      }
+
+      compressedSize += outSize;
+    } while (zs.avail_out == 0);
+  } while (success && remaining > 0);
+
+  deflateEnd(&zs);
+  return success ? compressedSize : 0;
+}
+
+static bool InflateBytes(ByteStream* pSourceStream, u32 compressedSize, ByteStream* pDestinationStream,
+                         u32 uncompressedSize)
+{
+  z_stream zs = {};
+  int err = inflateInit(&zs);
+  if (err != Z_OK)
+  {
+    Log_ErrorPrintf("inflateInit() failed: %d", err);
+    return false;
+  }
+
+  std::unique_ptr<u8[]> inBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  std::unique_ptr<u8[]> outBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  u32 remaining = compressedSize;
+  u32 outputSize = 0;
+  err = Z_OK;
+  while (err != Z_STREAM_END)
+  {
+    if (zs.avail_in == 0)
+    {
+      const u32 inSize = std::min(remaining, COMPRESSION_CHUNK_SIZE);
+      if (inSize == 0 || !pSourceStream->Read2(inBuffer.get(), inSize))
+        break;
+
+      remaining -= inSize;
+      zs.next_in = inBuffer.get();
+      zs.avail_in = inSize;
+    }
+
+    zs.next_out = outBuffer.get();
+    zs.avail_out = COMPRESSION_CHUNK_SIZE;
+    err = inflate(&zs, Z_NO_FLUSH);
+    if (err != Z_OK && err != Z_STREAM_END)
+    {
+      Log_ErrorPrintf("inflate() failed: %d", err);
+      break;
+    }
+
+    const u32 outSize = COMPRESSION_CHUNK_SIZE - zs.avail_out;
+    if (outSize > (uncompressedSize - outputSize) ||
+        (outSize > 0 && !pDestinationStream->Write2(outBuffer.get(), outSize)))
+    {
+      err = Z_DATA_ERROR;
+      break;
+    }
+
+    outputSize += outSize;
+  }
+
+  inflateEnd(&zs);
+  return (err == Z_STREAM_END && outputSize == uncompressedSize);
+}
+
+namespace {
+struct LzmaInStream
+{
+  ISeqInStream vt;
+  ByteStream* stream;
+  u32 remaining;
+};
+
+struct LzmaOutStream
+{
+  ISeqOutStream vt;
+  ByteStream* stream;
+  u32 written;
+};
+} // namespace
+
+static SRes LzmaInStreamRead(const ISeqInStream* p, void* buf, size_t* size)
+{
+  LzmaInStream* is = reinterpret_cast<LzmaInStream*>(const_cast<ISeqInStream*>(p));
+  const u32 readSize = static_cast<u32>(std::min<size_t>(*size, is->remaining));
+  if (readSize > 0 && !is->stream->Read2(buf, readSize))
+    return SZ_ERROR_READ;
+
+  is->remaining -= readSize;
+  *size = readSize;
+  return SZ_OK;
+}
+
+static size_t LzmaOutStreamWrite(const ISeqOutStream* p, const void* buf, size_t size)
+{
+  LzmaOutStream* os = reinterpret_cast<LzmaOutStream*>(const_cast<ISeqOutStream*>(p));
+  if (!os->stream->Write2(buf, static_cast<u32>(size)))
+    return 0;
+
+  os->written += static_cast<u32>(size);
+  return size;
+}
+
+static u32 LzmaCompressBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* pDestinationStream, int level)
+{
+  CLzmaEncHandle enc = LzmaEnc_Create(&g_Alloc);
+  if (!enc)
+    return 0;
+
+  CLzmaEncProps props;
+  LzmaEncProps_Init(&props);
+  props.level = level;
+  props.numThreads = 1;
+  props.reduceSize = byteCount;
+
+  u8 encodedProps[LZMA_PROPS_SIZE];
+  SizeT encodedPropsSize = sizeof(encodedProps);
+  LzmaInStream is = {{LzmaInStreamRead}, pSourceStream, byteCount};
+  LzmaOutStream os = {{LzmaOutStreamWrite}, pDestinationStream, 0};
+  SRes res = LzmaEnc_SetProps(enc, &props);
+  if (res == SZ_OK)
+    res = LzmaEnc_WriteProperties(enc, encodedProps, &encodedPropsSize);
+  if (res == SZ_OK && !pDestinationStream->Write2(encodedProps, static_cast<u32>(encodedPropsSize)))
+    res = SZ_ERROR_WRITE;
+  if (res == SZ_OK)
+    res = LzmaEnc_Encode(enc, &os.vt, &is.vt, nullptr, &g_Alloc, &g_BigAlloc);
+
+  LzmaEnc_Destroy(enc, &g_Alloc, &g_BigAlloc);
+  if (res != SZ_OK || is.remaining != 0)
+  {
+    Log_ErrorPrintf("LzmaEnc_Encode() failed: %d", res);
+    return 0;
+  }
+
+  return static_cast<u32>(encodedPropsSize) + os.written;
+}
+
+static bool LzmaDecompressBytes(ByteStream* pSourceStream, u32 compressedSize, ByteStream* pDestinationStream,
+                                u32 uncompressedSize)
+{
+  u8 encodedProps[LZMA_PROPS_SIZE];
+  if (compressedSize < sizeof(encodedProps) || !pSourceStream->Read2(encodedProps, sizeof(encodedProps)))
+    return false;
+
+  CLzmaDec dec;
+  LzmaDec_Construct(&dec);
+  SRes res = LzmaDec_Allocate(&dec, encodedProps, sizeof(encodedProps), &g_Alloc);
+  if (res != SZ_OK)
+  {
+    Log_ErrorPrintf("LzmaDec_Allocate() failed: %d", res);
+    return false;
+  }
+
+  LzmaDec_Init(&dec);
+
+  std::unique_ptr<u8[]> inBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  std::unique_ptr<u8[]> outBuffer = std::make_unique<u8[]>(COMPRESSION_CHUNK_SIZE);
+  u32 remaining = compressedSize - sizeof(encodedProps);
+  u32 inPosition = 0;
+  u32 inSize = 0;
+  u32 outputSize = 0;
+  ELzmaStatus status = LZMA_STATUS_NOT_SPECIFIED;
+  while (outputSize < uncompressedSize || inPosition < inSize || remaining > 0)
+  {
+    if (inPosition == inSize)
+    {
+      inSize = std::min(remaining, COMPRESSION_CHUNK_SIZE);
+      inPosition = 0;
+      if (inSize == 0 || !pSourceStream->Read2(inBuffer.get(), inSize))
+        break;
+
+      remaining -= inSize;
+    }
+
+    SizeT inProcessed = inSize - inPosition;
+    SizeT outProcessed = std::min(uncompressedSize - outputSize, COMPRESSION_CHUNK_SIZE);
+    const ELzmaFinishMode finishMode =
+      (outProcessed == (uncompressedSize - outputSize)) ? LZMA_FINISH_END : LZMA_FINISH_ANY;
+    res = LzmaDec_DecodeToBuf(&dec, outBuffer.get(), &outProcessed, inBuffer.get() + inPosition, &inProcessed,
+                              finishMode, &status);
+    if (res != SZ_OK || (inProcessed == 0 && outProcessed == 0))
+    {
+      Log_ErrorPrintf("LzmaDec_DecodeToBuf() failed: %d", res);
+      break;
+    }
+
+    inPosition += static_cast<u32>(inProcessed);
+    if (outProcessed > 0 && !pDestinationStream->Write2(outBuffer.get(), static_cast<u32>(outProcessed)))
+      break;
+
+    outputSize += static_cast<u32>(outProcessed);
+  }
+
+  LzmaDec_Free(&dec, &g_Alloc);
+
+  // without an end marker, leftover input is the only sign that the data was larger than expected
+  return (outputSize == uncompressedSize && remaining == 0 && inPosition == inSize &&
+          status != LZMA_STATUS_NEEDS_MORE_INPUT && status != LZMA_STATUS_NOT_FINISHED);
+}
+
+u32 ByteStream_CompressBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* pDestinationStream,
+                             BYTESTREAM_COMPRESSION_METHOD method, int level)
+{
+  switch (method)
+  {
+    case BYTESTREAM_COMPRESSION_METHOD_DEFLATE:
+      return DeflateBytes(pSourceStream, byteCount, pDestinationStream, level);
+
+    case BYTESTREAM_COMPRESSION_METHOD_LZMA:
+      return LzmaCompressBytes(pSourceStream, byteCount, pDestinationStream, level);
+
+    default:
+      return 0;
+  }
+}
+
+bool ByteStream_DecompressBytes(ByteStream* pSourceStream, u32 compressedSize, ByteStream* pDestinationStream,
+                                u32 uncompressedSize, BYTESTREAM_COMPRESSION_METHOD method)
+{
+  switch (method)
+  {
+    case BYTESTREAM_COMPRESSION_METHOD_DEFLATE:
+      return InflateBytes(pSourceStream, compressedSize, pDestinationStream, uncompressedSize);
+
+    case BYTESTREAM_COMPRESSION_METHOD_LZMA:
+      return LzmaDecompressBytes(pSourceStream, compressedSize, pDestinationStream, uncompressedSize);
+
+    default:
+      return false;
+  }
+}
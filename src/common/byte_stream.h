@@ -16,6 +16,13 @@ enum BYTESTREAM_OPEN_MODE
   BYTESTREAM_OPEN_STREAMED = 256,
 };
 
+// compression methods for ByteStream_CompressBytes() and ByteStream_DecompressBytes()
+enum BYTESTREAM_COMPRESSION_METHOD
+{
+  BYTESTREAM_COMPRESSION_METHOD_DEFLATE, // zlib stream
+  BYTESTREAM_COMPRESSION_METHOD_LZMA,    // lzma properties followed by raw lzma data, without an end marker
+};
+
 // interface class used by readers, writers, etc.
 class ByteStream
 {
@@ -229,3 +236,13 @@ bool ByteStream_AppendStream(ByteStream* pSourceStream, ByteStream* pDestination
 
 // copies a number of bytes from one to another
 u32 ByteStream_CopyBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* pDestinationStream);
+
+// compresses a number of bytes from one stream to another, a chunk at a time. level ranges from 1 (fastest) to 9
+// (smallest). returns the number of compressed bytes written, or zero on failure.
+u32 ByteStream_CompressBytes(ByteStream* pSourceStream, u32 byteCount, ByteStream* pDestinationStream,
+                             BYTESTREAM_COMPRESSION_METHOD method, int level);
+
+// decompresses a number of bytes from one stream to another, a chunk at a time. fails if the compressed data does not
+// expand to exactly uncompressedSize bytes.
+bool ByteStream_DecompressBytes(ByteStream* pSourceStream, u32 compressedSize, ByteStream* pDestinationStream,
+                                u32 uncompressedSize, BYTESTREAM_COMPRESSION_METHOD method);
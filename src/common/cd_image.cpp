@@ -329,6 +329,8 @@ CDImage::PrecacheResult CDImage::Precache(ProgressCallback* progress /*= Progres
   return PrecacheResult::Unsupported;
 }
 
+void CDImage::SetReadCacheSize(u32 size) {}
+
 void CDImage::ClearTOC()
 {
   m_lba_count = 0;
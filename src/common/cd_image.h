@@ -304,6 +304,10 @@ public:
   // Returns true if the source supports precaching, which may be more optimal than an in-memory copy.
   virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
+  // Sets the amount of memory compressed images can use to keep decompressed data. When non-zero, data following the
+  // current read position is also decompressed ahead of time on a worker thread. No effect on uncompressed images.
+  virtual void SetReadCacheSize(u32 size);
+
 protected:
   void ClearTOC();
   void CopyTOC(const CDImage* image);
@@ -0,0 +1,196 @@
+#include "cd_image_block_cache.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <cinttypes>
+Log_SetChannel(CDImageBlockCache);
+
+CDImageBlockCache::CDImageBlockCache(u32 default_cached_blocks, u32 max_prefetch_blocks)
+  : m_default_cached_blocks(default_cached_blocks), m_max_prefetch_blocks(max_prefetch_blocks),
+    m_cache(default_cached_blocks)
+{
+}
+
+CDImageBlockCache::~CDImageBlockCache()
+{
+  StopPrefetchThreads();
+}
+
+void CDImageBlockCache::SetSource(u32 block_size, u32 block_count, DecodeFunction decode)
+{
+  // the prefetch threads use the decode function, so they have to be stopped while it's replaced
+  StopPrefetchThreads();
+  DebugAssert(m_pending_blocks.empty());
+
+  m_decode = std::move(decode);
+  m_block_size = block_size;
+  m_block_count = block_count;
+  m_cache.Clear();
+  m_last_block_index = INVALID_BLOCK_INDEX;
+
+  if (m_prefetch_blocks > 0)
+    StartPrefetchThreads();
+}
+
+void CDImageBlockCache::SetCacheSize(u32 size, u32 prefetch_thread_count)
+{
+  DebugAssert(m_block_size > 0);
+  const u32 blocks = std::max<u32>(size / m_block_size, m_default_cached_blocks);
+
+  // leave room for the blocks being read, so prefetching doesn't evict them
+  const u32 prefetch_blocks = (size > 0) ? std::min<u32>(blocks / 2, m_max_prefetch_blocks) : 0;
+  StopPrefetchThreads();
+  m_cache.SetMaxCapacity(blocks);
+  m_prefetch_blocks = prefetch_blocks;
+  m_prefetch_thread_count = std::max<u32>(prefetch_thread_count, 1);
+  if (prefetch_blocks > 0)
+    StartPrefetchThreads();
+
+  Log_DevPrintf("Caching %u blocks of %u bytes, prefetching %u on %zu threads", blocks, m_block_size, prefetch_blocks,
+                m_prefetch_threads.size());
+}
+
+void CDImageBlockCache::Shutdown()
+{
+  StopPrefetchThreads();
+}
+
+void CDImageBlockCache::LogStatistics(const char* filename) const
+{
+  std::unique_lock lock(m_mutex);
+  if (m_block_lookups == 0)
+    return;
+
+  Log_DevPrintf("Block cache for '%s': %" PRIu64 " lookups, %.1f%% hit, %.1f%% prefetched", filename, m_block_lookups,
+                static_cast<double>(m_block_hits) * 100.0 / static_cast<double>(m_block_lookups),
+                static_cast<double>(m_block_prefetch_hits) * 100.0 / static_cast<double>(m_block_lookups));
+}
+
+const u8* CDImageBlockCache::GetBlock(u32 block_index, std::unique_lock<std::mutex>& lock)
+{
+  CachedBlock* block = m_cache.Lookup(block_index);
+  if (block_index == m_last_block_index)
+  {
+    if (block)
+      return block->data.data();
+  }
+  else
+  {
+    // only the first read from each block is counted, the rest would always hit
+    m_block_lookups++;
+    m_block_hits += BoolToUInt64(block != nullptr);
+    m_block_prefetch_hits += BoolToUInt64(block && block->prefetched);
+    m_read_direction = (m_last_block_index != INVALID_BLOCK_INDEX && block_index < m_last_block_index) ? -1 : 1;
+    m_last_block_index = block_index;
+  }
+
+  if (!block)
+  {
+    // a prefetch thread may be decoding this block already, in which case wait for it rather than doing it twice
+    m_block_ready_cv.wait(lock, [this, block_index]() { return !IsBlockPending(block_index); });
+    block = m_cache.Lookup(block_index);
+    if (!block)
+    {
+      m_pending_blocks.push_back(block_index);
+      lock.unlock();
+      CachedBlock new_block{std::vector<u8>(m_block_size), false};
+      const bool result = m_decode(block_index, new_block.data.data(), 0);
+      lock.lock();
+      RemovePendingBlock(block_index);
+      if (!result)
+        return nullptr;
+
+      block = m_cache.Insert(block_index, std::move(new_block));
+    }
+  }
+
+  // wake the prefetch threads after we have our block, so they don't hold up the read
+  block->prefetched = false;
+  if (m_prefetch_blocks > 0)
+  {
+    m_prefetch_generation++;
+    m_prefetch_cv.notify_all();
+  }
+
+  return block->data.data();
+}
+
+bool CDImageBlockCache::IsBlockPending(u32 block_index) const
+{
+  return (std::find(m_pending_blocks.begin(), m_pending_blocks.end(), block_index) != m_pending_blocks.end());
+}
+
+void CDImageBlockCache::RemovePendingBlock(u32 block_index)
+{
+  auto iter = std::find(m_pending_blocks.begin(), m_pending_blocks.end(), block_index);
+  DebugAssert(iter != m_pending_blocks.end());
+  m_pending_blocks.erase(iter);
+  m_block_ready_cv.notify_all();
+}
+
+void CDImageBlockCache::StartPrefetchThreads()
+{
+  if (!m_decode)
+    return;
+
+  m_prefetch_thread_shutdown = false;
+  for (u32 i = 0; i < m_prefetch_thread_count; i++)
+    m_prefetch_threads.emplace_back(&CDImageBlockCache::PrefetchThreadEntryPoint, this, i + 1);
+}
+
+void CDImageBlockCache::StopPrefetchThreads()
+{
+  if (m_prefetch_threads.empty())
+    return;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_prefetch_thread_shutdown = true;
+    m_prefetch_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_prefetch_threads)
+    thread.join();
+  m_prefetch_threads.clear();
+}
+
+void CDImageBlockCache::PrefetchThreadEntryPoint(u32 thread_index)
+{
+  std::unique_lock lock(m_mutex);
+  u32 generation = m_prefetch_generation;
+  for (;;)
+  {
+    m_prefetch_cv.wait(lock, [this, generation]() {
+      return (m_prefetch_thread_shutdown || m_prefetch_generation != generation);
+    });
+    if (m_prefetch_thread_shutdown)
+      break;
+
+    // decode the blocks following the last read, in the direction the reads are going, until it moves. each thread
+    // takes the next block which isn't cached or already being decoded by another thread.
+    generation = m_prefetch_generation;
+    for (u32 i = 1; i <= m_prefetch_blocks && generation == m_prefetch_generation && !m_prefetch_thread_shutdown; i++)
+    {
+      const s64 next_block_index =
+        static_cast<s64>(m_last_block_index) + static_cast<s64>(m_read_direction) * static_cast<s64>(i);
+      if (next_block_index < 0 || next_block_index >= static_cast<s64>(m_block_count))
+        break;
+
+      // looking up blocks which are already cached keeps them from being evicted before they're read
+      const u32 block_index = static_cast<u32>(next_block_index);
+      if (m_cache.Lookup(block_index) || IsBlockPending(block_index))
+        continue;
+
+      m_pending_blocks.push_back(block_index);
+      lock.unlock();
+      CachedBlock block{std::vector<u8>(m_block_size), true};
+      const bool result = m_decode(block_index, block.data.data(), thread_index);
+      lock.lock();
+      RemovePendingBlock(block_index);
+      if (!result)
+        break;
+
+      m_cache.Insert(block_index, std::move(block));
+    }
+  }
+}
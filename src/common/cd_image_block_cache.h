@@ -0,0 +1,92 @@
+#pragma once
+#include "lru_cache.h"
+#include "types.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Caches decoded blocks of a compressed disc image, and decodes the blocks following the last read ahead of time on
+/// background threads. The image supplies a callback which decodes a single block.
+class CDImageBlockCache
+{
+public:
+  /// Decodes a block into buffer, which is the block size in bytes. Called without any lock held, from the reading
+  /// thread with thread_index 0, or a prefetch thread with thread_index 1 onwards, so decoders can keep per-thread
+  /// state. Decoders which share state between blocks have to serialize themselves.
+  using DecodeFunction = std::function<bool(u32 block_index, u8* buffer, u32 thread_index)>;
+
+  CDImageBlockCache(u32 default_cached_blocks, u32 max_prefetch_blocks);
+  ~CDImageBlockCache();
+
+  /// Replaces the blocks being cached, discarding any which were decoded from the previous source.
+  void SetSource(u32 block_size, u32 block_count, DecodeFunction decode);
+
+  /// Sizes the cache to hold size bytes, and prefetches into up to half of it with the specified number of threads.
+  void SetCacheSize(u32 size, u32 prefetch_thread_count);
+
+  /// Stops prefetching. Has to be called before anything the decode callback uses is destroyed.
+  void Shutdown();
+
+  void LogStatistics(const char* filename) const;
+
+  /// Calls func with a pointer to the block's data, decoding it first if it isn't cached. The block can be evicted
+  /// once func returns, so anything needed from it has to be copied out.
+  template<typename T>
+  bool ReadBlock(u32 block_index, const T& func)
+  {
+    std::unique_lock lock(m_mutex);
+    const u8* data = GetBlock(block_index, lock);
+    if (!data)
+      return false;
+
+    func(data);
+    return true;
+  }
+
+private:
+  enum : u32
+  {
+    INVALID_BLOCK_INDEX = 0xFFFFFFFFu
+  };
+
+  struct CachedBlock
+  {
+    std::vector<u8> data;
+    bool prefetched;
+  };
+
+  const u8* GetBlock(u32 block_index, std::unique_lock<std::mutex>& lock);
+  bool IsBlockPending(u32 block_index) const;
+  void RemovePendingBlock(u32 block_index);
+
+  void StartPrefetchThreads();
+  void StopPrefetchThreads();
+  void PrefetchThreadEntryPoint(u32 thread_index);
+
+  DecodeFunction m_decode;
+  u32 m_block_size = 0;
+  u32 m_block_count = 0;
+  u32 m_default_cached_blocks;
+  u32 m_max_prefetch_blocks;
+  u32 m_prefetch_thread_count = 0;
+
+  // decoding happens outside the lock, which protects everything below. blocks being decoded are listed as pending,
+  // so that a block is never decoded by more than one thread at once.
+  mutable std::mutex m_mutex;
+  std::condition_variable m_prefetch_cv;
+  std::condition_variable m_block_ready_cv;
+  std::vector<std::thread> m_prefetch_threads;
+  LRUCache<u32, CachedBlock> m_cache;
+  std::vector<u32> m_pending_blocks;
+  u32 m_prefetch_blocks = 0;
+  u32 m_prefetch_generation = 0;
+  u32 m_last_block_index = INVALID_BLOCK_INDEX;
+  s32 m_read_direction = 1;
+  bool m_prefetch_thread_shutdown = false;
+
+  u64 m_block_lookups = 0;
+  u64 m_block_hits = 0;
+  u64 m_block_prefetch_hits = 0;
+};
@@ -5,6 +5,8 @@
 #include "align.h"
 #include "assert.h"
 #include "cd_image.h"
+#include "cd_image_block_cache.h"
+#include "cd_sector.h"
 #include "cd_subchannel_replacement.h"
 #include "error.h"
 #include "file_system.h"
@@ -17,6 +19,7 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 Log_SetChannel(CDImageCHD);
 
@@ -53,6 +56,7 @@ public:
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
   PrecacheResult Precache(ProgressCallback* progress) override;
+  void SetReadCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -61,18 +65,22 @@ private:
   enum : u32
   {
     CHD_CD_SECTOR_DATA_SIZE = 2352 + 96,
-    CHD_CD_TRACK_ALIGNMENT = 4
+    CHD_CD_TRACK_ALIGNMENT = 4,
+    DEFAULT_CACHED_HUNKS = 4,
+    MAX_PREFETCH_HUNKS = 16
   };
 
-  bool ReadHunk(u32 hunk_index);
+  bool ReadHunk(u32 hunk_index, u8* buffer);
 
   std::FILE* m_fp = nullptr;
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
 
-  std::vector<u8> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  // chd_file isn't thread-safe, so decompression is serialized with this.
+  std::mutex m_chd_mutex;
+  CDImageBlockCache m_hunk_cache{DEFAULT_CACHED_HUNKS, MAX_PREFETCH_HUNKS};
 
   CDSubChannelReplacement m_sbi;
 };
@@ -81,6 +89,9 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  m_hunk_cache.Shutdown();
+  m_hunk_cache.LogStatistics(m_filename.c_str());
+
   if (m_chd)
     chd_close(m_chd);
   if (m_fp)
@@ -121,9 +132,11 @@ bool CDImageCHD::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  m_hunk_count = header->totalhunks;
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
   m_filename = filename;
+  m_hunk_cache.SetSource(m_hunk_size, m_hunk_count,
+                         [this](u32 hunk_index, u8* buffer, u32) { return ReadHunk(hunk_index, buffer); });
 
   u32 disc_lba = 0;
   u64 file_lba = 0;
@@ -311,48 +324,15 @@ CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
     const u32 percent = static_cast<u32>((pos * 100) / total);
     static_cast<ProgressCallback*>(param)->SetProgressValue(std::min<u32>(percent, 100));
   };
+  std::unique_lock chd_lock(m_chd_mutex);
   return (chd_precache_progress(m_chd, callback, progress) == CHDERR_NONE) ? CDImage::PrecacheResult::Success :
                                                                              CDImage::PrecacheResult::ReadError;
 }
 
-// There's probably a more efficient way of doing this with vectorization...
-ALWAYS_INLINE static void CopyAndSwap(void* dst_ptr, const u8* src_ptr, u32 data_size)
+void CDImageCHD::SetReadCacheSize(u32 size)
 {
-  u8* dst_ptr_byte = static_cast<u8*>(dst_ptr);
-#if defined(CPU_X64) || defined(CPU_AARCH64)
-  const u32 num_values = data_size / 8;
-  for (u32 i = 0; i < num_values; i++)
-  {
-    u64 value;
-    std::memcpy(&value, src_ptr, sizeof(value));
-    value = ((value >> 8) & UINT64_C(0x00FF00FF00FF00FF)) | ((value << 8) & UINT64_C(0xFF00FF00FF00FF00));
-    std::memcpy(dst_ptr_byte, &value, sizeof(value));
-    src_ptr += sizeof(value);
-    dst_ptr_byte += sizeof(value);
-  }
-#elif defined(CPU_X86) || defined(CPU_ARM)
-  const u32 num_values = data_size / 4;
-  for (u32 i = 0; i < num_values; i++)
-  {
-    u32 value;
-    std::memcpy(&value, src_ptr, sizeof(value));
-    value = ((value >> 8) & UINT32_C(0x00FF00FF)) | ((value << 8) & UINT32_C(0xFF00FF00));
-    std::memcpy(dst_ptr_byte, &value, sizeof(value));
-    src_ptr += sizeof(value);
-    dst_ptr_byte += sizeof(value);
-  }
-#else
-  const u32 num_values = data_size / sizeof(u16);
-  for (u32 i = 0; i < num_values; i++)
-  {
-    u16 value;
-    std::memcpy(&value, src_ptr, sizeof(value));
-    value = (value << 8) | (value >> 8);
-    std::memcpy(dst_ptr_byte, &value, sizeof(value));
-    src_ptr += sizeof(value);
-    dst_ptr_byte += sizeof(value);
-  }
-#endif
+  // decompression is serialized, so there's nothing to gain from more than one prefetch thread
+  m_hunk_cache.SetCacheSize(size, 1);
 }
 
 bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
@@ -362,31 +342,25 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   const u32 hunk_offset = static_cast<u32>((disc_frame % m_sectors_per_hunk) * CHD_CD_SECTOR_DATA_SIZE);
   DebugAssert((m_hunk_size - hunk_offset) >= CHD_CD_SECTOR_DATA_SIZE);
 
-  if (m_current_hunk_index != hunk_index && !ReadHunk(hunk_index))
-    return false;
-
-  // Audio data is in big-endian, so we have to swap it for little endian hosts...
-  if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
-  else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
-
-  return true;
+  return m_hunk_cache.ReadBlock(hunk_index, [buffer, hunk_offset, &index](const u8* hunk_data) {
+    // Audio data is in big-endian, so we have to swap it for little endian hosts...
+    if (index.mode == TrackMode::Audio)
+      CDSector::CopyAndSwap16(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
+    else
+      std::memcpy(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
+  });
 }
 
-bool CDImageCHD::ReadHunk(u32 hunk_index)
+bool CDImageCHD::ReadHunk(u32 hunk_index, u8* buffer)
 {
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
+  std::unique_lock chd_lock(m_chd_mutex);
+  const chd_error err = chd_read(m_chd, hunk_index, buffer);
   if (err != CHDERR_NONE)
   {
     Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
-
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
     return false;
   }
 
-  m_current_hunk_index = hunk_index;
   return true;
 }
 
@@ -1,160 +1,21 @@
 #include "assert.h"
+#include "byte_stream.h"
 #include "cd_image.h"
+#include "cd_image_block_cache.h"
+#include "cd_sector.h"
 #include "cd_subchannel_replacement.h"
 #include "error.h"
 #include "file_system.h"
 #include "log.h"
+#include <algorithm>
 #include <array>
 #include <cerrno>
-#include <map>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <mutex>
 Log_SetChannel(CDImageEcm);
 
-// unecm.c by Neill Corlett (c) 2002, GPL licensed
-
-/* LUTs used for computing ECC/EDC */
-
-static constexpr std::array<u8, 256> ComputeECCFLUT()
-{
-  std::array<u8, 256> ecc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
-    ecc_lut[i] = static_cast<u8>(j);
-  }
-  return ecc_lut;
-}
-
-static constexpr std::array<u8, 256> ComputeECCBLUT()
-{
-  std::array<u8, 256> ecc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
-    ecc_lut[i ^ j] = static_cast<u8>(i);
-  }
-  return ecc_lut;
-}
-
-static constexpr std::array<u32, 256> ComputeEDCLUT()
-{
-  std::array<u32, 256> edc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 edc = i;
-    for (u32 k = 0; k < 8; k++)
-      edc = (edc >> 1) ^ (edc & 1 ? 0xD8018001 : 0);
-    edc_lut[i] = edc;
-  }
-  return edc_lut;
-}
-
-static constexpr std::array<u8, 256> ecc_f_lut = ComputeECCFLUT();
-static constexpr std::array<u8, 256> ecc_b_lut = ComputeECCBLUT();
-static constexpr std::array<u32, 256> edc_lut = ComputeEDCLUT();
-
-/***************************************************************************/
-/*
-** Compute EDC for a block
-*/
-static u32 edc_partial_computeblock(u32 edc, const u8* src, u16 size)
-{
-  while (size--)
-    edc = (edc >> 8) ^ edc_lut[(edc ^ (*src++)) & 0xFF];
-  return edc;
-}
-
-static void edc_computeblock(const u8* src, u16 size, u8* dest)
-{
-  u32 edc = edc_partial_computeblock(0, src, size);
-  dest[0] = (edc >> 0) & 0xFF;
-  dest[1] = (edc >> 8) & 0xFF;
-  dest[2] = (edc >> 16) & 0xFF;
-  dest[3] = (edc >> 24) & 0xFF;
-}
-
-/***************************************************************************/
-/*
-** Compute ECC for a block (can do either P or Q)
-*/
-static void ecc_computeblock(u8* src, u32 major_count, u32 minor_count, u32 major_mult, u32 minor_inc, u8* dest)
-{
-  u32 size = major_count * minor_count;
-  u32 major, minor;
-  for (major = 0; major < major_count; major++)
-  {
-    u32 index = (major >> 1) * major_mult + (major & 1);
-    u8 ecc_a = 0;
-    u8 ecc_b = 0;
-    for (minor = 0; minor < minor_count; minor++)
-    {
-      u8 temp = src[index];
-      index += minor_inc;
-      if (index >= size)
-        index -= size;
-      ecc_a ^= temp;
-      ecc_b ^= temp;
-      ecc_a = ecc_f_lut[ecc_a];
-    }
-    ecc_a = ecc_b_lut[ecc_f_lut[ecc_a] ^ ecc_b];
-    dest[major] = ecc_a;
-    dest[major + major_count] = ecc_a ^ ecc_b;
-  }
-}
-
-/*
-** Generate ECC P and Q codes for a block
-*/
-static void ecc_generate(u8* sector, int zeroaddress)
-{
-  u8 address[4], i;
-  /* Save the address and zero it out */
-  if (zeroaddress)
-    for (i = 0; i < 4; i++)
-    {
-      address[i] = sector[12 + i];
-      sector[12 + i] = 0;
-    }
-  /* Compute ECC P code */
-  ecc_computeblock(sector + 0xC, 86, 24, 2, 86, sector + 0x81C);
-  /* Compute ECC Q code */
-  ecc_computeblock(sector + 0xC, 52, 43, 86, 88, sector + 0x8C8);
-  /* Restore the address */
-  if (zeroaddress)
-    for (i = 0; i < 4; i++)
-      sector[12 + i] = address[i];
-}
-
-/***************************************************************************/
-/*
-** Generate ECC/EDC information for a sector (must be 2352 = 0x930 bytes)
-** Returns 0 on success
-*/
-static void eccedc_generate(u8* sector, int type)
-{
-  switch (type)
-  {
-    case 1: /* Mode 1 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x00, 0x810, sector + 0x810);
-      /* Write out zero bytes */
-      for (u32 i = 0; i < 8; i++)
-        sector[0x814 + i] = 0;
-      /* Generate ECC P/Q codes */
-      ecc_generate(sector, 0);
-      break;
-    case 2: /* Mode 2 form 1 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x10, 0x808, sector + 0x818);
-      /* Generate ECC P/Q codes */
-      ecc_generate(sector, 1);
-      break;
-    case 3: /* Mode 2 form 2 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x10, 0x91C, sector + 0x92C);
-      break;
-  }
-}
-
 class CDImageEcm : public CDImage
 {
 public:
@@ -165,14 +26,22 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
+  void SetReadCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
-  bool ReadChunks(u32 disc_offset, u32 size);
+  enum : u32
+  {
+    INDEX_SIGNATURE = 0x494D4345, // ECMI
+    INDEX_VERSION = 1,
 
-  std::FILE* m_fp = nullptr;
+    SECTORS_PER_BLOCK = 16,
+    BLOCK_SIZE = SECTORS_PER_BLOCK * RAW_SECTOR_SIZE,
+    DEFAULT_CACHED_BLOCKS = 2,
+    MAX_PREFETCH_BLOCKS = 16
+  };
 
   enum class SectorType : u32
   {
@@ -197,18 +66,51 @@ private:
     2336, // mode2form2
   };
 
-  struct SectorEntry
+  // The index is stored next to the image, so that the ECM stream doesn't have to be walked each time it's opened.
+  // It's a header, followed by the runs in disc order, and is used in-place once mapped.
+  struct IndexHeader
   {
+    u32 signature;
+    u32 version;
+    u64 image_size;
+    u64 image_modified_time;
+    u32 disc_size;
+    u32 run_count;
+  };
+  static_assert(sizeof(IndexHeader) == 32);
+
+  // A run of data stored with the same type. Raw runs are counted in bytes, the others in sectors.
+  struct IndexRun
+  {
+    u32 disc_offset;
     u32 file_offset;
-    u32 chunk_size;
+    u32 count;
     SectorType type;
   };
+  static_assert(sizeof(IndexRun) == 16);
+
+  static u32 GetRunSize(const IndexRun& run);
 
-  using DataMap = std::map<u32, SectorEntry>;
+  bool LoadIndex(const FILESYSTEM_STAT_DATA& sd);
+  bool BuildIndex(u64 file_size, Common::Error* error);
+  void WriteIndex(const FILESYSTEM_STAT_DATA& sd);
 
-  DataMap m_data_map;
-  std::vector<u8> m_chunk_buffer;
-  u32 m_chunk_start = 0;
+  bool ReadFileData(u32 file_offset, void* buffer, u32 size);
+  bool ReadChunk(SectorType type, u32 file_offset, u8* sector, const u8** chunk_data);
+  bool ReadDiscData(u32 disc_offset, u8* buffer, u32 size);
+  bool ReadBlock(u32 block_index, u8* buffer);
+
+  std::FILE* m_fp = nullptr;
+  std::string m_index_filename;
+  std::unique_ptr<FileSystem::MappedFile> m_index_file;
+  std::vector<IndexRun> m_built_runs;
+  const IndexRun* m_runs = nullptr;
+  u32 m_run_count = 0;
+  u32 m_disc_size = 0;
+
+  // the file position is shared, so reconstruction is serialized with this.
+  std::mutex m_file_mutex;
+  CDImageBlockCache m_block_cache{DEFAULT_CACHED_BLOCKS, MAX_PREFETCH_BLOCKS};
 
   CDSubChannelReplacement m_sbi;
 };
@@ -217,6 +119,9 @@ CDImageEcm::CDImageEcm() = default;
 
 CDImageEcm::~CDImageEcm()
 {
+  m_block_cache.Shutdown();
+  m_block_cache.LogStatistics(m_filename.c_str());
+
   if (m_fp)
     std::fclose(m_fp);
 }
@@ -234,9 +139,8 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     return false;
   }
 
-  s64 file_size;
-  if (FileSystem::FSeek64(m_fp, 0, SEEK_END) != 0 || (file_size = FileSystem::FTell64(m_fp)) <= 0 ||
-      FileSystem::FSeek64(m_fp, 0, SEEK_SET) != 0)
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(m_fp, &sd) || sd.Size == 0)
   {
     Log_ErrorPrintf("Get file size failed: errno %d", errno);
     if (error)
@@ -256,18 +160,153 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     return false;
   }
 
-  // build sector map
-  u32 file_offset = static_cast<u32>(std::ftell(m_fp));
+  m_index_filename = m_filename + ".idx";
+  if (!LoadIndex(sd))
+  {
+    if (!BuildIndex(sd.Size, error))
+      return false;
+
+    WriteIndex(sd);
+  }
+
+  m_lba_count = m_disc_size / RAW_SECTOR_SIZE;
+  m_block_cache.SetSource(BLOCK_SIZE, (m_disc_size + (BLOCK_SIZE - 1)) / BLOCK_SIZE,
+                          [this](u32 block_index, u8* buffer, u32) { return ReadBlock(block_index, buffer); });
+  if ((m_disc_size % RAW_SECTOR_SIZE) != 0)
+    Log_WarningPrintf("ECM image is misaligned with offset %u", m_disc_size);
+  if (m_lba_count == 0)
+    return false;
+
+  SubChannelQ::Control control = {};
+  TrackMode mode = TrackMode::Mode2Raw;
+  control.data = mode != TrackMode::Audio;
+
+  // Two seconds default pregap.
+  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
+  Index pregap_index = {};
+  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
+  pregap_index.start_lba_on_disc = 0;
+  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
+  pregap_index.length = pregap_frames;
+  pregap_index.track_number = 1;
+  pregap_index.index_number = 0;
+  pregap_index.mode = mode;
+  pregap_index.control.bits = control.bits;
+  pregap_index.is_pregap = true;
+  m_indices.push_back(pregap_index);
+
+  // Data index.
+  Index data_index = {};
+  data_index.file_index = 0;
+  data_index.file_offset = 0;
+  data_index.file_sector_size = RAW_SECTOR_SIZE;
+  data_index.start_lba_on_disc = pregap_index.length;
+  data_index.track_number = 1;
+  data_index.index_number = 1;
+  data_index.start_lba_in_track = 0;
+  data_index.length = m_lba_count;
+  data_index.mode = mode;
+  data_index.control.bits = control.bits;
+  m_indices.push_back(data_index);
+
+  // Assume a single track.
+  m_tracks.push_back(
+    Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode, control});
+
+  AddLeadOutIndex();
+
+  m_sbi.LoadSBIFromImagePath(filename);
+
+  return Seek(1, Position{0, 0, 0});
+}
+
+u32 CDImageEcm::GetRunSize(const IndexRun& run)
+{
+  return (run.type == SectorType::Raw) ? run.count : (run.count * s_chunk_sizes[static_cast<u32>(run.type)]);
+}
+
+bool CDImageEcm::LoadIndex(const FILESYSTEM_STAT_DATA& sd)
+{
+  m_index_file = FileSystem::MapFileReadOnly(m_index_filename.c_str());
+  if (!m_index_file)
+    return false;
+
+  IndexHeader header;
+  const u8* data = m_index_file->GetData();
+  const size_t size = m_index_file->GetSize();
+  if (size < sizeof(header))
+  {
+    Log_WarningPrintf("Index '%s' is truncated", m_index_filename.c_str());
+    m_index_file.reset();
+    return false;
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+  if (header.signature != INDEX_SIGNATURE || header.version != INDEX_VERSION || header.image_size != sd.Size ||
+      header.image_modified_time != static_cast<u64>(sd.ModificationTime.AsUnixTimestamp()) ||
+      header.run_count == 0 || (size - sizeof(header)) != (static_cast<size_t>(header.run_count) * sizeof(IndexRun)))
+  {
+    Log_WarningPrintf("Index '%s' is out of date", m_index_filename.c_str());
+    m_index_file.reset();
+    return false;
+  }
+
+  // runs have to be contiguous and within the image, since reads trust them
+  const IndexRun* runs = reinterpret_cast<const IndexRun*>(data + sizeof(header));
   u32 disc_offset = 0;
+  for (u32 i = 0; i < header.run_count; i++)
+  {
+    const IndexRun& run = runs[i];
+    if (run.disc_offset != disc_offset || run.type >= SectorType::Count || run.count == 0 ||
+        (run.type != SectorType::Raw && run.count > (header.disc_size / s_chunk_sizes[static_cast<u32>(run.type)])))
+    {
+      Log_WarningPrintf("Index '%s' is corrupted at run %u", m_index_filename.c_str(), i);
+      m_index_file.reset();
+      return false;
+    }
+
+    const u64 stored_size = (run.type == SectorType::Raw) ?
+                              run.count :
+                              (static_cast<u64>(run.count) * s_sector_sizes[static_cast<u32>(run.type)]);
+    const u64 run_size = GetRunSize(run);
+    if ((run.file_offset + stored_size) > sd.Size || (disc_offset + run_size) > header.disc_size)
+    {
+      Log_WarningPrintf("Index '%s' is corrupted at run %u", m_index_filename.c_str(), i);
+      m_index_file.reset();
+      return false;
+    }
+
+    disc_offset += static_cast<u32>(run_size);
+  }
+
+  if (disc_offset != header.disc_size)
+  {
+    Log_WarningPrintf("Index '%s' does not cover the image", m_index_filename.c_str());
+    m_index_file.reset();
+    return false;
+  }
+
+  m_runs = runs;
+  m_run_count = header.run_count;
+  m_disc_size = header.disc_size;
+  Log_DevPrintf("Loaded %u runs from index '%s'", m_run_count, m_index_filename.c_str());
+  return true;
+}
+
+bool CDImageEcm::BuildIndex(u64 file_size, Common::Error* error)
+{
+  // build sector map
+  u64 file_offset = static_cast<u64>(std::ftell(m_fp));
+  u64 disc_offset = 0;
 
   for (;;)
   {
     int bits = std::fgetc(m_fp);
     if (bits == EOF)
     {
-      Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_data_map.size());
+      Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_built_runs.size());
       if (error)
-        error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_data_map.size());
+        error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_built_runs.size());
 
       return false;
     }
@@ -281,9 +320,9 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       bits = std::fgetc(m_fp);
       if (bits == EOF)
       {
-        Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_data_map.size());
+        Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_built_runs.size());
         if (error)
-          error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_data_map.size());
+          error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_built_runs.size());
 
         return false;
       }
@@ -301,220 +340,229 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
 
     if (count >= 0x80000000u)
     {
-      Log_ErrorPrintf("Corrupted header after %zu chunks", m_data_map.size());
+      Log_ErrorPrintf("Corrupted header after %zu chunks", m_built_runs.size());
       if (error)
-        error->SetFormattedMessage("Corrupted header after %zu chunks", m_data_map.size());
+        error->SetFormattedMessage("Corrupted header after %zu chunks", m_built_runs.size());
 
       return false;
     }
 
-    if (type == SectorType::Raw)
-    {
-      while (count > 0)
-      {
-        const u32 size = std::min<u32>(count, 2352);
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, size, type});
-        disc_offset += size;
-        file_offset += size;
-        count -= size;
-
-        if (static_cast<s64>(file_offset) > file_size)
-        {
-          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_data_map.size());
-          if (error)
-            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_data_map.size());
-        }
-      }
-    }
-    else
+    const IndexRun run{static_cast<u32>(disc_offset), static_cast<u32>(file_offset), count, type};
+    const u64 stored_size =
+      (type == SectorType::Raw) ? count : (static_cast<u64>(count) * s_sector_sizes[static_cast<u32>(type)]);
+    const u64 run_size =
+      (type == SectorType::Raw) ? count : (static_cast<u64>(count) * s_chunk_sizes[static_cast<u32>(type)]);
+    m_built_runs.push_back(run);
+    disc_offset += run_size;
+    file_offset += stored_size;
+
+    if (file_offset > file_size || disc_offset > std::numeric_limits<u32>::max())
     {
-      const u32 size = s_sector_sizes[static_cast<u32>(type)];
-      const u32 chunk_size = s_chunk_sizes[static_cast<u32>(type)];
-      for (u32 i = 0; i < count; i++)
-      {
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, chunk_size, type});
-        disc_offset += chunk_size;
-        file_offset += size;
-
-        if (static_cast<s64>(file_offset) > file_size)
-        {
-          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_data_map.size());
-          if (error)
-            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_data_map.size());
-        }
-      }
+      Log_ErrorPrintf("Out of file bounds after %zu chunks", m_built_runs.size());
+      if (error)
+        error->SetFormattedMessage("Out of file bounds after %zu chunks", m_built_runs.size());
+
+      return false;
     }
 
-    if (std::fseek(m_fp, file_offset, SEEK_SET) != 0)
+    if (FileSystem::FSeek64(m_fp, static_cast<s64>(file_offset), SEEK_SET) != 0)
     {
-      Log_ErrorPrintf("Failed to seek to offset %u after %zu chunks", file_offset, m_data_map.size());
+      Log_ErrorPrintf("Failed to seek to offset %" PRIu64 " after %zu chunks", file_offset, m_built_runs.size());
       if (error)
-        error->SetFormattedMessage("Failed to seek to offset %u after %zu chunks", file_offset, m_data_map.size());
+      {
+        error->SetFormattedMessage("Failed to seek to offset %" PRIu64 " after %zu chunks", file_offset,
+                                   m_built_runs.size());
+      }
 
       return false;
     }
   }
 
-  if (m_data_map.empty())
+  if (m_built_runs.empty())
   {
-    Log_ErrorPrintf("No data in image '%s'", filename);
+    Log_ErrorPrintf("No data in image '%s'", m_filename.c_str());
     if (error)
-      error->SetFormattedMessage("No data in image '%s'", filename);
+      error->SetFormattedMessage("No data in image '%s'", m_filename.c_str());
 
     return false;
   }
 
-  m_lba_count = disc_offset / RAW_SECTOR_SIZE;
-  if ((disc_offset % RAW_SECTOR_SIZE) != 0)
-    Log_WarningPrintf("ECM image is misaligned with offset %u", disc_offset);
-  if (m_lba_count == 0)
+  m_runs = m_built_runs.data();
+  m_run_count = static_cast<u32>(m_built_runs.size());
+  m_disc_size = static_cast<u32>(disc_offset);
+  return true;
+}
+
+void CDImageEcm::WriteIndex(const FILESYSTEM_STAT_DATA& sd)
+{
+  IndexHeader header;
+  header.signature = INDEX_SIGNATURE;
+  header.version = INDEX_VERSION;
+  header.image_size = sd.Size;
+  header.image_modified_time = static_cast<u64>(sd.ModificationTime.AsUnixTimestamp());
+  header.disc_size = m_disc_size;
+  header.run_count = m_run_count;
+
+  // not being able to write next to the image (e.g. read-only media) just means it's indexed again next time
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(m_index_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                     BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                     BYTESTREAM_OPEN_STREAMED);
+  if (!stream || !stream->Write2(&header, sizeof(header)) ||
+      !stream->Write2(m_runs, static_cast<u32>(m_run_count * sizeof(IndexRun))) || !stream->Commit())
+  {
+    Log_WarningPrintf("Failed to write index '%s'", m_index_filename.c_str());
+    if (stream)
+      stream->Discard();
+
+    return;
+  }
+
+  Log_DevPrintf("Wrote %u runs to index '%s'", m_run_count, m_index_filename.c_str());
+}
+
+bool CDImageEcm::ReadFileData(u32 file_offset, void* buffer, u32 size)
+{
+  if (FileSystem::FSeek64(m_fp, file_offset, SEEK_SET) != 0 || std::fread(buffer, size, 1, m_fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to read %u bytes at offset %u: errno %d", size, file_offset, errno);
     return false;
+  }
 
-  SubChannelQ::Control control = {};
-  TrackMode mode = TrackMode::Mode2Raw;
-  control.data = mode != TrackMode::Audio;
+  return true;
+}
 
-  // Two seconds default pregap.
-  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
-  Index pregap_index = {};
-  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
-  pregap_index.start_lba_on_disc = 0;
-  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
-  pregap_index.length = pregap_frames;
-  pregap_index.track_number = 1;
-  pregap_index.index_number = 0;
-  pregap_index.mode = mode;
-  pregap_index.control.bits = control.bits;
-  pregap_index.is_pregap = true;
-  m_indices.push_back(pregap_index);
+bool CDImageEcm::ReadChunk(SectorType type, u32 file_offset, u8* sector, const u8** chunk_data)
+{
+  std::memset(sector, 0, RAW_SECTOR_SIZE);
+  std::memset(sector + 1, 0xFF, 10);
 
-  // Data index.
-  Index data_index = {};
-  data_index.file_index = 0;
-  data_index.file_offset = 0;
-  data_index.file_sector_size = RAW_SECTOR_SIZE;
-  data_index.start_lba_on_disc = pregap_index.length;
-  data_index.track_number = 1;
-  data_index.index_number = 1;
-  data_index.start_lba_in_track = 0;
-  data_index.length = m_lba_count;
-  data_index.mode = mode;
-  data_index.control.bits = control.bits;
-  m_indices.push_back(data_index);
+  switch (type)
+  {
+    case SectorType::Mode1:
+    {
+      sector[0x0F] = 0x01;
+      if (!ReadFileData(file_offset, sector + 0x00C, 0x003) ||
+          !ReadFileData(file_offset + 0x003, sector + 0x010, 0x800))
+      {
+        return false;
+      }
 
-  // Assume a single track.
-  m_tracks.push_back(
-    Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode, control});
+      CDSector::GenerateMode1EDCECC(sector);
+      *chunk_data = sector;
+    }
+    break;
 
-  AddLeadOutIndex();
+    case SectorType::Mode2Form1:
+    {
+      sector[0x0F] = 0x02;
+      if (!ReadFileData(file_offset, sector + 0x014, 0x804))
+        return false;
 
-  m_sbi.LoadSBIFromImagePath(filename);
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-  m_chunk_buffer.reserve(RAW_SECTOR_SIZE * 2);
-  return Seek(1, Position{0, 0, 0});
+      CDSector::GenerateMode2Form1EDCECC(sector);
+      *chunk_data = sector + 0x10;
+    }
+    break;
+
+    case SectorType::Mode2Form2:
+    {
+      sector[0x0F] = 0x02;
+      if (!ReadFileData(file_offset, sector + 0x014, 0x918))
+        return false;
+
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
+
+      CDSector::GenerateMode2Form2EDC(sector);
+      *chunk_data = sector + 0x10;
+    }
+    break;
+
+    default:
+      UnreachableCode();
+      return false;
+  }
+
+  return true;
 }
 
-bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
+bool CDImageEcm::ReadDiscData(u32 disc_offset, u8* buffer, u32 size)
 {
-  DataMap::iterator next =
-    m_data_map.lower_bound((disc_offset > RAW_SECTOR_SIZE) ? (disc_offset - RAW_SECTOR_SIZE) : 0);
-  DataMap::iterator current = m_data_map.begin();
-  while (next != m_data_map.end() && next->first <= disc_offset)
-    current = next++;
-
-  // extra bytes if we need to buffer some at the start
-  m_chunk_start = current->first;
-  m_chunk_buffer.clear();
-  if (m_chunk_start < disc_offset)
-    size += (disc_offset - current->first);
-
-  u32 total_bytes_read = 0;
-  while (total_bytes_read < size)
+  const IndexRun* const runs_end = m_runs + m_run_count;
+  const IndexRun* run = std::upper_bound(m_runs, runs_end, disc_offset,
+                                         [](u32 offset, const IndexRun& rhs) { return offset < rhs.disc_offset; });
+  if (run == m_runs)
+    return false;
+  --run;
+
+  while (size > 0)
   {
-    if (current == m_data_map.end() || std::fseek(m_fp, current->second.file_offset, SEEK_SET) != 0)
+    if (run == runs_end)
       return false;
 
-    const u32 chunk_size = current->second.chunk_size;
-    const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
-    m_chunk_buffer.resize(chunk_start + chunk_size);
+    const u32 run_offset = disc_offset - run->disc_offset;
+    if (run_offset >= GetRunSize(*run))
+    {
+      ++run;
+      continue;
+    }
 
-    if (current->second.type == SectorType::Raw)
+    u32 copy_size;
+    if (run->type == SectorType::Raw)
     {
-      if (std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
+      copy_size = std::min(size, run->count - run_offset);
+      if (!ReadFileData(run->file_offset + run_offset, buffer, copy_size))
         return false;
-
-      total_bytes_read += chunk_size;
     }
     else
     {
-      // u8* sector = &m_chunk_buffer[chunk_start];
+      const u32 chunk_size = s_chunk_sizes[static_cast<u32>(run->type)];
+      const u32 chunk_index = run_offset / chunk_size;
+      const u32 chunk_offset = run_offset % chunk_size;
       u8 sector[RAW_SECTOR_SIZE];
-
-      // TODO: needed?
-      std::memset(sector, 0, RAW_SECTOR_SIZE);
-      std::memset(sector + 1, 0xFF, 10);
-
-      u32 skip;
-      switch (current->second.type)
+      const u8* chunk_data;
+      if (!ReadChunk(run->type, run->file_offset + chunk_index * s_sector_sizes[static_cast<u32>(run->type)], sector,
+                     &chunk_data))
       {
-        case SectorType::Mode1:
-        {
-          sector[0x0F] = 0x01;
-          if (std::fread(sector + 0x00C, 0x003, 1, m_fp) != 1 || std::fread(sector + 0x010, 0x800, 1, m_fp) != 1)
-            return false;
-
-          eccedc_generate(sector, 1);
-          skip = 0;
-        }
-        break;
-
-        case SectorType::Mode2Form1:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x804, 1, m_fp) != 1)
-            return false;
-
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
-
-          eccedc_generate(sector, 2);
-          skip = 0x10;
-        }
-        break;
-
-        case SectorType::Mode2Form2:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x918, 1, m_fp) != 1)
-            return false;
-
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
-
-          eccedc_generate(sector, 3);
-          skip = 0x10;
-        }
-        break;
-
-        default:
-          UnreachableCode();
-          return false;
+        return false;
       }
 
-      std::memcpy(&m_chunk_buffer[chunk_start], sector + skip, chunk_size);
-      total_bytes_read += chunk_size;
+      copy_size = std::min(size, chunk_size - chunk_offset);
+      std::memcpy(buffer, chunk_data + chunk_offset, copy_size);
     }
 
-    ++current;
+    buffer += copy_size;
+    disc_offset += copy_size;
+    size -= copy_size;
   }
 
   return true;
 }
 
+bool CDImageEcm::ReadBlock(u32 block_index, u8* buffer)
+{
+  std::unique_lock file_lock(m_file_mutex);
+  const u32 block_start = block_index * BLOCK_SIZE;
+  const u32 size = std::min<u32>(m_disc_size - block_start, BLOCK_SIZE);
+  if (!ReadDiscData(block_start, buffer, size))
+  {
+    Log_ErrorPrintf("Failed to reconstruct block %u", block_index);
+    return false;
+  }
+
+  if (size < BLOCK_SIZE)
+    std::memset(buffer + size, 0, BLOCK_SIZE - size);
+
+  return true;
+}
+
 bool CDImageEcm::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   if (m_sbi.GetReplacementSubChannelQ(index.start_lba_on_disc + lba_in_index, subq))
@@ -528,22 +576,22 @@ bool CDImageEcm::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0);
 }
 
-bool CDImageEcm::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+void CDImageEcm::SetReadCacheSize(u32 size)
 {
-  const u32 file_start = static_cast<u32>(index.file_offset) + (lba_in_index * index.file_sector_size);
-  const u32 file_end = file_start + RAW_SECTOR_SIZE;
-
-  if (file_start < m_chunk_start || file_end > (m_chunk_start + m_chunk_buffer.size()))
-  {
-    if (!ReadChunks(file_start, RAW_SECTOR_SIZE))
-      return false;
-  }
-
-  DebugAssert(file_start >= m_chunk_start && file_end <= (m_chunk_start + m_chunk_buffer.size()));
+  // reconstruction is serialized, so there's nothing to gain from more than one prefetch thread
+  m_block_cache.SetCacheSize(size, 1);
+}
 
-  const size_t chunk_offset = static_cast<size_t>(file_start - m_chunk_start);
-  std::memcpy(buffer, &m_chunk_buffer[chunk_offset], RAW_SECTOR_SIZE);
-  return true;
+bool CDImageEcm::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+{
+  const u32 disc_offset = static_cast<u32>(index.file_offset) + (lba_in_index * index.file_sector_size);
+  const u32 block_index = disc_offset / BLOCK_SIZE;
+  const u32 block_offset = disc_offset % BLOCK_SIZE;
+  DebugAssert((BLOCK_SIZE - block_offset) >= RAW_SECTOR_SIZE);
+
+  return m_block_cache.ReadBlock(block_index, [buffer, block_offset](const u8* block_data) {
+    std::memcpy(buffer, &block_data[block_offset], RAW_SECTOR_SIZE);
+  });
 }
 
 std::unique_ptr<CDImage> CDImage::OpenEcmImage(const char* filename, Common::Error* error)
@@ -26,6 +26,7 @@ public:
   u32 GetCurrentSubImage() const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
   bool SwitchSubImage(u32 index, Common::Error* error) override;
+  void SetReadCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -41,6 +42,7 @@ private:
   std::vector<Entry> m_entries;
   std::unique_ptr<CDImage> m_current_image;
   u32 m_current_image_index = UINT32_C(0xFFFFFFFF);
+  u32 m_read_cache_size = 0;
 };
 
 CDImageM3u::CDImageM3u() = default;
@@ -137,6 +139,9 @@ bool CDImageM3u::SwitchSubImage(u32 index, Common::Error* error)
     return false;
   }
 
+  if (m_read_cache_size > 0)
+    new_image->SetReadCacheSize(m_read_cache_size);
+
   CopyTOC(new_image.get());
   m_current_image = std::move(new_image);
   m_current_image_index = index;
@@ -146,6 +151,14 @@ bool CDImageM3u::SwitchSubImage(u32 index, Common::Error* error)
   return true;
 }
 
+void CDImageM3u::SetReadCacheSize(u32 size)
+{
+  // applied to each disc as it's opened
+  m_read_cache_size = size;
+  if (m_current_image)
+    m_current_image->SetReadCacheSize(size);
+}
+
 std::string CDImageM3u::GetSubImageMetadata(u32 index, const std::string_view& type) const
 {
   if (index > m_entries.size())
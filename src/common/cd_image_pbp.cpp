@@ -1,5 +1,6 @@
 #include "assert.h"
 #include "cd_image.h"
+#include "cd_image_block_cache.h"
 #include "cd_subchannel_replacement.h"
 #include "error.h"
 #include "file_system.h"
@@ -8,8 +9,11 @@
 #include "string.h"
 #include "string_util.h"
 #include "zlib.h"
+#include <algorithm>
 #include <array>
 #include <cstdio>
+#include <mutex>
+#include <thread>
 #include <vector>
 Log_SetChannel(CDImagePBP);
 
@@ -34,17 +38,31 @@ public:
   bool SwitchSubImage(u32 index, Common::Error* error) override;
   std::string GetMetadata(const std::string_view& type) const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
+  void SetReadCacheSize(u32 size) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  enum : u32
+  {
+    DEFAULT_CACHED_BLOCKS = 2,
+    MAX_PREFETCH_BLOCKS = 16,
+    MAX_PREFETCH_THREADS = 4
+  };
+
   struct BlockInfo
   {
     u32 offset; // Absolute offset from start of file
     u16 size;
   };
 
+  struct InflateState
+  {
+    z_stream stream;
+    std::vector<u8> compressed_block;
+  };
+
 #if _DEBUG
   static void PrintPBPHeaderInfo(const PBPHeader& pbp_header);
   static void PrintSFOHeaderInfo(const SFOHeader& sfo_header);
@@ -59,8 +77,8 @@ private:
 
   bool IsValidEboot(Common::Error* error);
 
-  bool InitDecompressionStream();
-  bool DecompressBlock(const BlockInfo& block_info);
+  static bool InitDecompressionStream(z_stream* stream);
+  bool DecompressBlock(u32 block_index, InflateState* state, u8* buffer);
 
   bool OpenDisc(u32 index, Common::Error* error);
 
@@ -82,11 +100,13 @@ private:
 
   std::array<TOCEntry, TOC_NUM_ENTRIES> m_toc;
 
-  u32 m_current_block = static_cast<u32>(-1);
-  std::array<u8, DECOMPRESSED_BLOCK_SIZE> m_decompressed_block;
-  std::vector<u8> m_compressed_block;
+  // indexed by the block cache's thread index, i.e. the reading thread followed by each prefetch thread
+  std::array<InflateState, MAX_PREFETCH_THREADS + 1> m_inflate_states = {};
 
-  z_stream m_inflate_stream;
+  // the file is only read with this held, and blocks are inflated outside of it, so several threads can inflate at
+  // once.
+  std::mutex m_file_mutex;
+  CDImageBlockCache m_block_cache{DEFAULT_CACHED_BLOCKS, MAX_PREFETCH_BLOCKS};
 
   CDSubChannelReplacement m_sbi;
 };
@@ -120,10 +140,14 @@ static void SwapByteOrder(T& val)
 
 CDImagePBP::~CDImagePBP()
 {
+  m_block_cache.Shutdown();
+  m_block_cache.LogStatistics(m_filename.c_str());
+
   if (m_file)
     fclose(m_file);
 
-  inflateEnd(&m_inflate_stream);
+  for (InflateState& state : m_inflate_states)
+    inflateEnd(&state.stream);
 }
 
 bool CDImagePBP::LoadPBPHeader()
@@ -448,11 +472,10 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
     return false;
   }
 
-  m_current_block = static_cast<u32>(-1);
+  // the prefetch threads use the block table, so they have to be stopped while it's replaced
+  m_block_cache.SetSource(DECOMPRESSED_BLOCK_SIZE, 0, {});
   m_blockinfo_table.fill({});
   m_toc.fill({});
-  m_decompressed_block.fill(0x00);
-  m_compressed_block.clear();
 
   // Go to ISO header
   const u32 iso_header_start = m_disc_offsets[index];
@@ -665,11 +688,15 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
 
   AddLeadOutIndex();
 
-  // Initialize zlib stream
-  if (!InitDecompressionStream())
+  // Initialize zlib streams
+  for (InflateState& state : m_inflate_states)
   {
-    Log_ErrorPrint("Failed to initialize zlib decompression stream");
-    return false;
+    inflateEnd(&state.stream);
+    if (!InitDecompressionStream(&state.stream))
+    {
+      Log_ErrorPrint("Failed to initialize zlib decompression stream");
+      return false;
+    }
   }
 
   if (m_disc_offsets.size() > 1)
@@ -682,6 +709,11 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
     m_sbi.LoadSBI(FileSystem::ReplaceExtension(m_filename, "sbi").c_str());
 
   m_current_disc = index;
+  m_block_cache.SetSource(DECOMPRESSED_BLOCK_SIZE, BLOCK_TABLE_NUM_ENTRIES,
+                          [this](u32 block_index, u8* buffer, u32 thread_index) {
+                            return DecompressBlock(block_index, &m_inflate_states[thread_index], buffer);
+                          });
+
   return Seek(1, Position{0, 0, 0});
 }
 
@@ -698,48 +730,59 @@ const std::string* CDImagePBP::LookupStringSFOTableEntry(const char* key, const
   return &std::get<std::string>(data_value);
 }
 
-bool CDImagePBP::InitDecompressionStream()
+bool CDImagePBP::InitDecompressionStream(z_stream* stream)
 {
-  m_inflate_stream = {};
-  m_inflate_stream.next_in = Z_NULL;
-  m_inflate_stream.avail_in = 0;
-  m_inflate_stream.zalloc = Z_NULL;
-  m_inflate_stream.zfree = Z_NULL;
-  m_inflate_stream.opaque = Z_NULL;
-
-  int ret = inflateInit2(&m_inflate_stream, -MAX_WBITS);
+  *stream = {};
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  stream->zalloc = Z_NULL;
+  stream->zfree = Z_NULL;
+  stream->opaque = Z_NULL;
+
+  int ret = inflateInit2(stream, -MAX_WBITS);
   return ret == Z_OK;
 }
 
-bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+bool CDImagePBP::DecompressBlock(u32 block_index, InflateState* state, u8* buffer)
 {
-  if (FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
+  // the table can end before the disc does, which stops prefetching there
+  const BlockInfo& block_info = m_blockinfo_table[block_index];
+  if (block_info.size == 0)
     return false;
 
   // Compression level 0 has compressed size == decompressed size.
-  if (block_info.size == m_decompressed_block.size())
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
   {
-    return (fread(m_decompressed_block.data(), sizeof(u8), m_decompressed_block.size(), m_file) ==
-            m_decompressed_block.size());
+    std::unique_lock file_lock(m_file_mutex);
+    return (FSeek64(m_file, block_info.offset, SEEK_SET) == 0 &&
+            fread(buffer, sizeof(u8), DECOMPRESSED_BLOCK_SIZE, m_file) == DECOMPRESSED_BLOCK_SIZE);
   }
 
-  m_compressed_block.resize(block_info.size);
+  std::vector<u8>& compressed_block = state->compressed_block;
+  compressed_block.resize(block_info.size);
 
-  if (fread(m_compressed_block.data(), sizeof(u8), m_compressed_block.size(), m_file) != m_compressed_block.size())
-    return false;
+  {
+    std::unique_lock file_lock(m_file_mutex);
+    if (FSeek64(m_file, block_info.offset, SEEK_SET) != 0 ||
+        fread(compressed_block.data(), sizeof(u8), compressed_block.size(), m_file) != compressed_block.size())
+    {
+      return false;
+    }
+  }
 
-  m_inflate_stream.next_in = m_compressed_block.data();
-  m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+  z_stream* stream = &state->stream;
+  stream->next_in = compressed_block.data();
+  stream->avail_in = static_cast<uInt>(compressed_block.size());
+  stream->next_out = buffer;
+  stream->avail_out = DECOMPRESSED_BLOCK_SIZE;
 
-  if (inflateReset(&m_inflate_stream) != Z_OK)
+  if (inflateReset(stream) != Z_OK)
     return false;
 
-  int err = inflate(&m_inflate_stream, Z_FINISH);
+  int err = inflate(stream, Z_FINISH);
   if (err != Z_STREAM_END)
   {
-    Log_ErrorPrintf("Inflate error %d", err);
+    Log_ErrorPrintf("Inflate error %d in block %u", err, block_index);
     return false;
   }
 
@@ -773,16 +816,25 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi))
+  const bool result = m_block_cache.ReadBlock(requested_block, [buffer, offset_in_block](const u8* block_data) {
+    std::memcpy(buffer, &block_data[offset_in_block], RAW_SECTOR_SIZE);
+  });
+  if (!result)
   {
     Log_ErrorPrintf("Failed to decompress block %u", requested_block);
     return false;
   }
 
-  std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
   return true;
 }
 
+void CDImagePBP::SetReadCacheSize(u32 size)
+{
+  // each prefetch thread has its own inflate stream, so several blocks can be inflated at once
+  const u32 thread_count = std::clamp<u32>(std::thread::hardware_concurrency() / 2, 1, MAX_PREFETCH_THREADS);
+  m_block_cache.SetCacheSize(size, thread_count);
+}
+
 #if _DEBUG
 void CDImagePBP::PrintPBPHeaderInfo(const PBPHeader& pbp_header)
 {
@@ -0,0 +1,288 @@
+#include "cd_sector.h"
+#include "align.h"
+#include "platform.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace CDSector {
+
+// The EDC is a reflected CRC with the polynomial 0xD8018001. Neither the SSE4.2 nor the ARMv8 CRC instructions
+// support it (they're fixed to CRC-32C and CRC-32), so it's computed eight bytes at a time with slicing tables.
+static constexpr u32 EDC_POLYNOMIAL = 0xD8018001;
+static constexpr u32 EDC_SLICES = 8;
+
+// ECC symbols are elements of GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1.
+static constexpr u32 ECC_POLYNOMIAL = 0x11D;
+
+static constexpr u32 ECC_OFFSET = 0x00C;
+static constexpr u32 ECC_P_OFFSET = 0x81C;
+static constexpr u32 ECC_Q_OFFSET = 0x8C8;
+
+// P parity: 86 columns of 24 symbols, each column a byte within rows of 86 bytes.
+static constexpr u32 ECC_P_COLUMNS = 86;
+static constexpr u32 ECC_P_ROWS = 24;
+
+// Q parity: 52 diagonals of 43 symbols, over the same data and the P parity. Treating that as 26 rows of 43 words,
+// symbol k of word diagonal d is at row (d + k) % 26, column k, i.e. the byte pair at ((d + k) % 26) * 43 + k.
+static constexpr u32 ECC_Q_DIAGONALS = 52;
+static constexpr u32 ECC_Q_SYMBOLS = 43;
+static constexpr u32 ECC_Q_WORD_ROWS = 26;
+
+using EDCTable = std::array<std::array<u32, 256>, EDC_SLICES>;
+
+static constexpr EDCTable ComputeEDCTable()
+{
+  EDCTable table{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    u32 edc = i;
+    for (u32 k = 0; k < 8; k++)
+      edc = (edc >> 1) ^ ((edc & 1) ? EDC_POLYNOMIAL : 0);
+    table[0][i] = edc;
+  }
+
+  for (u32 slice = 1; slice < EDC_SLICES; slice++)
+  {
+    for (u32 i = 0; i < 256; i++)
+      table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+  }
+
+  return table;
+}
+
+/// Multiplication by two (x) in GF(2^8).
+static constexpr std::array<u8, 256> ComputeECCForwardLUT()
+{
+  std::array<u8, 256> lut{};
+  for (u32 i = 0; i < 256; i++)
+    lut[i] = static_cast<u8>((i << 1) ^ ((i & 0x80) ? ECC_POLYNOMIAL : 0));
+  return lut;
+}
+
+/// Division by three (x + 1) in GF(2^8).
+static constexpr std::array<u8, 256> ComputeECCBackwardLUT()
+{
+  std::array<u8, 256> lut{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    const u32 j = (i << 1) ^ ((i & 0x80) ? ECC_POLYNOMIAL : 0);
+    lut[i ^ j] = static_cast<u8>(i);
+  }
+  return lut;
+}
+
+static constexpr EDCTable s_edc_table = ComputeEDCTable();
+static constexpr std::array<u8, 256> s_ecc_f_lut = ComputeECCForwardLUT();
+static constexpr std::array<u8, 256> s_ecc_b_lut = ComputeECCBackwardLUT();
+
+void CopyAndSwap16(void* dst, const void* src, u32 size)
+{
+  const u8* src_ptr = static_cast<const u8*>(src);
+  u8* dst_ptr = static_cast<u8*>(dst);
+  u32 pos = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_size = Common::AlignDownPow2(size, 32);
+  for (; pos < aligned_size; pos += 32)
+  {
+    const __m128i value0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + pos));
+    const __m128i value1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + pos + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + pos),
+                     _mm_or_si128(_mm_slli_epi16(value0, 8), _mm_srli_epi16(value0, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + pos + 16),
+                     _mm_or_si128(_mm_slli_epi16(value1, 8), _mm_srli_epi16(value1, 8)));
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_size = Common::AlignDownPow2(size, 32);
+  for (; pos < aligned_size; pos += 32)
+  {
+    const uint8x16_t value0 = vld1q_u8(src_ptr + pos);
+    const uint8x16_t value1 = vld1q_u8(src_ptr + pos + 16);
+    vst1q_u8(dst_ptr + pos, vrev16q_u8(value0));
+    vst1q_u8(dst_ptr + pos + 16, vrev16q_u8(value1));
+  }
+#endif
+
+  for (; (pos + sizeof(u16)) <= size; pos += sizeof(u16))
+  {
+    u16 value;
+    std::memcpy(&value, src_ptr + pos, sizeof(value));
+    value = static_cast<u16>((value << 8) | (value >> 8));
+    std::memcpy(dst_ptr + pos, &value, sizeof(value));
+  }
+
+  if (pos < size)
+    dst_ptr[pos] = src_ptr[pos];
+}
+
+u32 ComputeEDC(u32 edc, const void* data, u32 size)
+{
+  const u8* ptr = static_cast<const u8*>(data);
+
+  for (; size >= EDC_SLICES; size -= EDC_SLICES, ptr += EDC_SLICES)
+  {
+    u32 low, high;
+    std::memcpy(&low, ptr, sizeof(low));
+    std::memcpy(&high, ptr + sizeof(low), sizeof(high));
+    low ^= edc;
+    edc = s_edc_table[7][low & 0xFF] ^ s_edc_table[6][(low >> 8) & 0xFF] ^ s_edc_table[5][(low >> 16) & 0xFF] ^
+          s_edc_table[4][low >> 24] ^ s_edc_table[3][high & 0xFF] ^ s_edc_table[2][(high >> 8) & 0xFF] ^
+          s_edc_table[1][(high >> 16) & 0xFF] ^ s_edc_table[0][high >> 24];
+  }
+
+  for (; size > 0; size--)
+    edc = (edc >> 8) ^ s_edc_table[0][(edc ^ *(ptr++)) & 0xFF];
+
+  return edc;
+}
+
+static void WriteEDC(u8* dest, u32 edc)
+{
+  dest[0] = static_cast<u8>(edc);
+  dest[1] = static_cast<u8>(edc >> 8);
+  dest[2] = static_cast<u8>(edc >> 16);
+  dest[3] = static_cast<u8>(edc >> 24);
+}
+
+#if defined(CPU_X64)
+
+/// Multiplies each byte by two in GF(2^8).
+static ALWAYS_INLINE __m128i ECCMultiply2(__m128i value)
+{
+  const __m128i overflow = _mm_cmpgt_epi8(_mm_setzero_si128(), value);
+  return _mm_xor_si128(_mm_add_epi8(value, value), _mm_and_si128(overflow, _mm_set1_epi8(ECC_POLYNOMIAL & 0xFF)));
+}
+
+#elif defined(CPU_AARCH64)
+
+/// Multiplies each byte by two in GF(2^8).
+static ALWAYS_INLINE uint8x16_t ECCMultiply2(uint8x16_t value)
+{
+  const uint8x16_t overflow = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(value), 7));
+  return veorq_u8(vshlq_n_u8(value, 1), vandq_u8(overflow, vdupq_n_u8(ECC_POLYNOMIAL & 0xFF)));
+}
+
+#endif
+
+/// Computes the parity of width codewords, where row i holds symbol i of every codeword. The two parity symbols of
+/// codeword n are written to dest[n] and dest[n + width].
+static void ComputeECCParity(const u8* rows, u32 row_count, u32 row_stride, u32 width, u8* dest)
+{
+  // Horner's rule over the symbols: a accumulates sum(s_i * x^(n - i)), b the plain sum.
+  std::array<u8, ECC_P_COLUMNS> sums_a, sums_b;
+
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  // Columns are independent, so the last block can overlap the previous one instead of needing a scalar tail.
+  for (u32 start = 0; start < width; start += 16)
+  {
+    const u32 column = std::min(start, width - 16);
+#if defined(CPU_X64)
+    __m128i a = _mm_setzero_si128();
+    __m128i b = _mm_setzero_si128();
+    for (u32 row = 0; row < row_count; row++)
+    {
+      const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + row * row_stride + column));
+      a = ECCMultiply2(_mm_xor_si128(a, value));
+      b = _mm_xor_si128(b, value);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&sums_a[column]), _mm_xor_si128(ECCMultiply2(a), b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&sums_b[column]), b);
+#else
+    uint8x16_t a = vdupq_n_u8(0);
+    uint8x16_t b = vdupq_n_u8(0);
+    for (u32 row = 0; row < row_count; row++)
+    {
+      const uint8x16_t value = vld1q_u8(rows + row * row_stride + column);
+      a = ECCMultiply2(veorq_u8(a, value));
+      b = veorq_u8(b, value);
+    }
+    vst1q_u8(&sums_a[column], veorq_u8(ECCMultiply2(a), b));
+    vst1q_u8(&sums_b[column], b);
+#endif
+  }
+#else
+  for (u32 column = 0; column < width; column++)
+  {
+    u8 a = 0;
+    u8 b = 0;
+    for (u32 row = 0; row < row_count; row++)
+    {
+      const u8 value = rows[row * row_stride + column];
+      a = s_ecc_f_lut[a ^ value];
+      b ^= value;
+    }
+    sums_a[column] = s_ecc_f_lut[a] ^ b;
+    sums_b[column] = b;
+  }
+#endif
+
+  for (u32 column = 0; column < width; column++)
+  {
+    const u8 parity = s_ecc_b_lut[sums_a[column]];
+    dest[column] = parity;
+    dest[column + width] = parity ^ sums_b[column];
+  }
+}
+
+void ComputeECCP(u8* sector)
+{
+  ComputeECCParity(sector + ECC_OFFSET, ECC_P_ROWS, ECC_P_COLUMNS, ECC_P_COLUMNS, sector + ECC_P_OFFSET);
+}
+
+void ComputeECCQ(u8* sector)
+{
+  // Gather the diagonals into rows, so that they can be processed like the P columns. Symbol k of successive
+  // diagonals walks down word column k from row k % 26, wrapping around to the first row.
+  std::array<u8, ECC_Q_SYMBOLS * ECC_Q_DIAGONALS> rows;
+  const u8* src = sector + ECC_OFFSET;
+  for (u32 symbol = 0; symbol < ECC_Q_SYMBOLS; symbol++)
+  {
+    u8* row = &rows[symbol * ECC_Q_DIAGONALS];
+    const u32 first_row = symbol % ECC_Q_WORD_ROWS;
+    const u8* column = src + symbol * 2;
+    for (u32 word_row = first_row; word_row < ECC_Q_WORD_ROWS; word_row++, row += 2)
+      std::memcpy(row, column + word_row * ECC_P_COLUMNS, 2);
+    for (u32 word_row = 0; word_row < first_row; word_row++, row += 2)
+      std::memcpy(row, column + word_row * ECC_P_COLUMNS, 2);
+  }
+
+  ComputeECCParity(rows.data(), ECC_Q_SYMBOLS, ECC_Q_DIAGONALS, ECC_Q_DIAGONALS, sector + ECC_Q_OFFSET);
+}
+
+void GenerateMode1EDCECC(u8* sector)
+{
+  WriteEDC(sector + 0x810, ComputeEDC(0, sector, 0x810));
+  std::memset(sector + 0x814, 0, 8);
+  ComputeECCP(sector);
+  ComputeECCQ(sector);
+}
+
+void GenerateMode2Form1EDCECC(u8* sector)
+{
+  WriteEDC(sector + 0x818, ComputeEDC(0, sector + 0x10, 0x808));
+
+  u8 address[4];
+  std::memcpy(address, sector + ECC_OFFSET, sizeof(address));
+  std::memset(sector + ECC_OFFSET, 0, sizeof(address));
+  ComputeECCP(sector);
+  ComputeECCQ(sector);
+  std::memcpy(sector + ECC_OFFSET, address, sizeof(address));
+}
+
+void GenerateMode2Form2EDC(u8* sector)
+{
+  WriteEDC(sector + 0x92C, ComputeEDC(0, sector + 0x10, 0x91C));
+}
+
+} // namespace CDSector
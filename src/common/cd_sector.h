@@ -0,0 +1,32 @@
+#pragma once
+#include "types.h"
+
+// Routines for processing raw (2352 byte) CD sectors, shared by the image readers. Sector offsets follow the
+// ECMA-130 layout: sync and header at 0x000, user data at 0x010 (mode 1) or subheader at 0x010 (mode 2).
+namespace CDSector {
+
+/// Copies size bytes from src to dst, swapping the bytes in each 16-bit word, e.g. for big-endian audio data.
+/// Any odd trailing byte is copied as-is. src and dst may be the same buffer, but must not otherwise overlap.
+void CopyAndSwap16(void* dst, const void* src, u32 size);
+
+/// Updates a running EDC (the 32-bit CRC stored in data sectors) with size bytes of data. Start with zero.
+u32 ComputeEDC(u32 edc, const void* data, u32 size);
+
+/// Computes the ECC P parity (0x81C-0x8C7) for a mode 1 or mode 2 form 1 sector, from bytes 0x00C-0x81B.
+void ComputeECCP(u8* sector);
+
+/// Computes the ECC Q parity (0x8C8-0x92F) for a mode 1 or mode 2 form 1 sector, from bytes 0x00C-0x8C7.
+/// Must be computed after the P parity, since it covers it.
+void ComputeECCQ(u8* sector);
+
+/// Regenerates the EDC, the zero fill, and the ECC of a mode 1 sector from its header and user data.
+void GenerateMode1EDCECC(u8* sector);
+
+/// Regenerates the EDC and ECC of a mode 2 form 1 sector from its subheader and user data.
+/// The header address is treated as zero for the ECC, as the standard requires.
+void GenerateMode2Form1EDCECC(u8* sector);
+
+/// Regenerates the EDC of a mode 2 form 2 sector from its subheader and user data.
+void GenerateMode2Form2EDC(u8* sector);
+
+} // namespace CDSector
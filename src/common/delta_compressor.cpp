@@ -0,0 +1,235 @@
+#include "delta_compressor.h"
+#include "assert.h"
+#include "log.h"
+#include "zlib.h"
+#include <cstring>
+Log_SetChannel(DeltaCompressor);
+
+// Runs are stored as a sequence of records, each made up of the number of unchanged words, the number of changed
+// words, and the changed words XORed with the base. Any bytes after the last whole word follow the records, also
+// XORed with the base. A single unchanged word between changed words is stored as changed, since a new record would
+// be larger than the word itself.
+
+static constexpr u32 WORD_SIZE = sizeof(u64);
+static constexpr u32 RECORD_HEADER_SIZE = sizeof(u32) * 2;
+
+static u32 GetMaxRunsSize(u32 size)
+{
+  // Apart from the first and last, every record covers at least three words.
+  return size + ((size / WORD_SIZE) / 2 + 2) * RECORD_HEADER_SIZE;
+}
+
+template<bool has_base>
+static ALWAYS_INLINE u64 GetWordDifference(const u8* base, const u8* data, u32 index)
+{
+  u64 data_word;
+  std::memcpy(&data_word, data + index * WORD_SIZE, sizeof(data_word));
+  if constexpr (!has_base)
+    return data_word;
+
+  u64 base_word;
+  std::memcpy(&base_word, base + index * WORD_SIZE, sizeof(base_word));
+  return data_word ^ base_word;
+}
+
+template<bool has_base>
+static u8* EncodeRunsT(const u8* base, const u8* data, u32 size, u8* out)
+{
+  const u32 words = size / WORD_SIZE;
+  u32 pos = 0;
+  while (pos < words)
+  {
+    const u32 unchanged_start = pos;
+    while (pos < words && GetWordDifference<has_base>(base, data, pos) == 0)
+      pos++;
+
+    const u32 changed_start = pos;
+    while (pos < words)
+    {
+      if (GetWordDifference<has_base>(base, data, pos) != 0)
+        pos++;
+      else if ((pos + 1) < words && GetWordDifference<has_base>(base, data, pos + 1) != 0)
+        pos += 2;
+      else
+        break;
+    }
+
+    const u32 header[2] = {changed_start - unchanged_start, pos - changed_start};
+    std::memcpy(out, header, sizeof(header));
+    out += sizeof(header);
+
+    for (u32 i = changed_start; i < pos; i++)
+    {
+      const u64 difference = GetWordDifference<has_base>(base, data, i);
+      std::memcpy(out, &difference, sizeof(difference));
+      out += sizeof(difference);
+    }
+  }
+
+  for (u32 i = words * WORD_SIZE; i < size; i++)
+    *(out++) = has_base ? (data[i] ^ base[i]) : data[i];
+
+  return out;
+}
+
+DeltaCompressor::DeltaCompressor() = default;
+
+DeltaCompressor::~DeltaCompressor()
+{
+  if (m_deflate_stream)
+    deflateEnd(m_deflate_stream.get());
+  if (m_inflate_stream)
+    inflateEnd(m_inflate_stream.get());
+}
+
+void DeltaCompressor::EncodeRuns(const u8* base, const u8* data, u32 size)
+{
+  m_runs.resize(GetMaxRunsSize(size));
+
+  u8* const out_start = m_runs.data();
+  u8* const out_end =
+    base ? EncodeRunsT<true>(base, data, size, out_start) : EncodeRunsT<false>(base, data, size, out_start);
+  DebugAssert(static_cast<size_t>(out_end - out_start) <= m_runs.size());
+  m_runs.resize(static_cast<size_t>(out_end - out_start));
+}
+
+bool DeltaCompressor::DecodeRuns(const u8* base, u8* data, u32 size) const
+{
+  const u8* in = m_runs.data();
+  const u8* const in_end = in + m_runs.size();
+  const u32 words = size / WORD_SIZE;
+  u32 pos = 0;
+  while (pos < words)
+  {
+    u32 header[2];
+    if (static_cast<size_t>(in_end - in) < sizeof(header))
+      return false;
+    std::memcpy(header, in, sizeof(header));
+    in += sizeof(header);
+
+    const u32 unchanged = header[0];
+    const u32 changed = header[1];
+    if (unchanged > (words - pos) || changed > (words - pos - unchanged) ||
+        static_cast<size_t>(in_end - in) < (static_cast<size_t>(changed) * WORD_SIZE))
+    {
+      return false;
+    }
+
+    if (base)
+      std::memcpy(data + pos * WORD_SIZE, base + pos * WORD_SIZE, unchanged * WORD_SIZE);
+    else
+      std::memset(data + pos * WORD_SIZE, 0, unchanged * WORD_SIZE);
+    pos += unchanged;
+
+    for (u32 i = 0; i < changed; i++, pos++)
+    {
+      u64 word;
+      std::memcpy(&word, in, sizeof(word));
+      in += sizeof(word);
+
+      if (base)
+      {
+        u64 base_word;
+        std::memcpy(&base_word, base + pos * WORD_SIZE, sizeof(base_word));
+        word ^= base_word;
+      }
+
+      std::memcpy(data + pos * WORD_SIZE, &word, sizeof(word));
+    }
+  }
+
+  const u32 tail_size = size - (words * WORD_SIZE);
+  if (static_cast<size_t>(in_end - in) != tail_size)
+    return false;
+
+  for (u32 i = words * WORD_SIZE; i < size; i++)
+    data[i] = base ? (*(in++) ^ base[i]) : *(in++);
+
+  return true;
+}
+
+bool DeltaCompressor::Compress(const void* base, const void* data, u32 size, std::vector<u8>* out)
+{
+  EncodeRuns(static_cast<const u8*>(base), static_cast<const u8*>(data), size);
+
+  if (!m_deflate_stream)
+  {
+    m_deflate_stream = std::make_unique<z_stream>();
+    const int err = deflateInit(m_deflate_stream.get(), Z_BEST_SPEED);
+    if (err != Z_OK)
+    {
+      Log_ErrorPrintf("deflateInit() failed: %d", err);
+      m_deflate_stream.reset();
+      return false;
+    }
+  }
+  else
+  {
+    deflateReset(m_deflate_stream.get());
+  }
+
+  const u32 runs_size = static_cast<u32>(m_runs.size());
+  out->resize(sizeof(runs_size) + deflateBound(m_deflate_stream.get(), runs_size));
+  std::memcpy(out->data(), &runs_size, sizeof(runs_size));
+
+  z_stream* zs = m_deflate_stream.get();
+  zs->next_in = m_runs.data();
+  zs->avail_in = runs_size;
+  zs->next_out = out->data() + sizeof(runs_size);
+  zs->avail_out = static_cast<uInt>(out->size() - sizeof(runs_size));
+
+  const int err = deflate(zs, Z_FINISH);
+  if (err != Z_STREAM_END)
+  {
+    Log_ErrorPrintf("deflate() failed: %d", err);
+    return false;
+  }
+
+  out->resize(sizeof(runs_size) + zs->total_out);
+  return true;
+}
+
+bool DeltaCompressor::Decompress(const void* base, const void* compressed, size_t compressed_size, void* data,
+                                 u32 size)
+{
+  u32 runs_size;
+  if (compressed_size < sizeof(runs_size))
+    return false;
+
+  std::memcpy(&runs_size, compressed, sizeof(runs_size));
+  if (runs_size > GetMaxRunsSize(size))
+    return false;
+
+  if (!m_inflate_stream)
+  {
+    m_inflate_stream = std::make_unique<z_stream>();
+    const int err = inflateInit(m_inflate_stream.get());
+    if (err != Z_OK)
+    {
+      Log_ErrorPrintf("inflateInit() failed: %d", err);
+      m_inflate_stream.reset();
+      return false;
+    }
+  }
+  else
+  {
+    inflateReset(m_inflate_stream.get());
+  }
+
+  m_runs.resize(runs_size);
+
+  z_stream* zs = m_inflate_stream.get();
+  zs->next_in = static_cast<Bytef*>(const_cast<void*>(compressed)) + sizeof(runs_size);
+  zs->avail_in = static_cast<uInt>(compressed_size - sizeof(runs_size));
+  zs->next_out = m_runs.data();
+  zs->avail_out = runs_size;
+
+  const int err = inflate(zs, Z_FINISH);
+  if (err != Z_STREAM_END || zs->total_out != runs_size)
+  {
+    Log_ErrorPrintf("inflate() failed: %d", err);
+    return false;
+  }
+
+  return DecodeRuns(static_cast<const u8*>(base), static_cast<u8*>(data), size);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "types.h"
+#include <memory>
+#include <vector>
+
+struct z_stream_s;
+
+/// Compresses buffers as the difference from a base buffer of the same size, e.g. successive save states.
+/// The difference is first reduced to runs of unchanged 64-bit words and changed words (XORed with the base), which
+/// keeps the data passed to zlib small when only a fraction of the buffer has changed. Without a base buffer, the data
+/// is compressed as-is. Scratch memory and zlib state are kept between calls, so one instance should be reused.
+class DeltaCompressor
+{
+public:
+  DeltaCompressor();
+  ~DeltaCompressor();
+
+  /// Compresses size bytes of data, relative to base if it is not null, replacing the contents of out.
+  bool Compress(const void* base, const void* data, u32 size, std::vector<u8>* out);
+
+  /// Decompresses data produced by Compress() with the same base and size. Returns false if the data is corrupt.
+  bool Decompress(const void* base, const void* compressed, size_t compressed_size, void* data, u32 size);
+
+private:
+  void EncodeRuns(const u8* base, const u8* data, u32 size);
+  bool DecodeRuns(const u8* base, u8* data, u32 size) const;
+
+  std::unique_ptr<z_stream_s> m_deflate_stream;
+  std::unique_ptr<z_stream_s> m_inflate_stream;
+  std::vector<u8> m_runs;
+};
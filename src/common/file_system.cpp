@@ -38,7 +38,9 @@
 #else
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -2501,4 +2503,93 @@ bool SetWorkingDirectory(const char* path)
 
 #endif
 
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile()
+{
+  if (!m_mapped)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), m_size);
+#endif
+}
+
+std::unique_ptr<MappedFile> MapFileReadOnly(const char* filename)
+{
+  std::unique_ptr<MappedFile> mf(new MappedFile());
+
+#if defined(_WIN32) && !defined(_UWP)
+  const std::wstring wfilename(StringUtil::UTF8StringToWideString(filename));
+  const HANDLE file = CreateFileW(wfilename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file != INVALID_HANDLE_VALUE)
+  {
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+        static_cast<u64>(size.QuadPart) <= std::numeric_limits<size_t>::max())
+    {
+      // the view keeps the mapping alive, so the handles aren't needed once it's created
+      const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping)
+      {
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view)
+        {
+          mf->m_data = static_cast<const u8*>(view);
+          mf->m_size = static_cast<size_t>(size.QuadPart);
+          mf->m_mapped = true;
+        }
+
+        CloseHandle(mapping);
+      }
+    }
+
+    CloseHandle(file);
+    if (mf->m_mapped)
+      return mf;
+  }
+#elif !defined(_WIN32)
+  const int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd >= 0)
+  {
+#if defined(__HAIKU__) || defined(__APPLE__) || defined(__FreeBSD__)
+    struct stat sysStatData;
+    const bool stat_result = (fstat(fd, &sysStatData) == 0);
+#else
+    struct stat64 sysStatData;
+    const bool stat_result = (fstat64(fd, &sysStatData) == 0);
+#endif
+    if (stat_result && S_ISREG(sysStatData.st_mode) && sysStatData.st_size > 0 &&
+        static_cast<u64>(sysStatData.st_size) <= std::numeric_limits<size_t>::max())
+    {
+      const size_t size = static_cast<size_t>(sysStatData.st_size);
+      void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (view != MAP_FAILED)
+      {
+        mf->m_data = static_cast<const u8*>(view);
+        mf->m_size = size;
+        mf->m_mapped = true;
+      }
+    }
+
+    close(fd);
+    if (mf->m_mapped)
+      return mf;
+  }
+#endif
+
+  // empty files can't be mapped, and some platforms (UWP, Android content URIs) can't map at all
+  std::optional<std::vector<u8>> data = ReadBinaryFile(filename);
+  if (!data.has_value())
+    return {};
+
+  mf->m_buffer = std::move(data.value());
+  mf->m_data = mf->m_buffer.data();
+  mf->m_size = mf->m_buffer.size();
+  return mf;
+}
+
 } // namespace FileSystem
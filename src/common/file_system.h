@@ -117,6 +117,29 @@ protected:
   bool m_recursiveWatch;
 };
 
+/// Read-only view of the contents of a file. Where the platform supports it, the file is memory-mapped, so only the
+/// pages which are accessed are read from disk. Otherwise, the whole file is read into memory.
+class MappedFile
+{
+public:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const u8* GetData() const { return m_data; }
+  size_t GetSize() const { return m_size; }
+
+private:
+  friend std::unique_ptr<MappedFile> MapFileReadOnly(const char* filename);
+
+  MappedFile();
+
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_mapped = false;
+  std::vector<u8> m_buffer;
+};
+
 // create a change notifier
 std::unique_ptr<ChangeNotifier> CreateChangeNotifier(const char* path, bool recursiveWatch);
 
@@ -196,6 +219,9 @@ s64 FTell64(std::FILE* fp);
 
 std::optional<std::vector<u8>> ReadBinaryFile(const char* filename);
 std::optional<std::vector<u8>> ReadBinaryFile(std::FILE* fp);
+
+/// Opens a file for reading through a MappedFile. Returns null if the file could not be opened.
+std::unique_ptr<MappedFile> MapFileReadOnly(const char* filename);
 std::optional<std::string> ReadFileToString(const char* filename);
 std::optional<std::string> ReadFileToString(std::FILE* fp);
 bool WriteBinaryFile(const char* filename, const void* data, size_t data_length);
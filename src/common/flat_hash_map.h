@@ -0,0 +1,243 @@
+#pragma once
+#include "types.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Open-addressing hash map with linear probing, for integer keys.
+/// Entries are stored inline in a single array, so lookups touch at most a couple of cache lines. One key value must be
+/// reserved to mark empty slots, and can never be inserted. Erasing uses backward shifting instead of tombstones, so
+/// erasing invalidates iterators, and must not be done while iterating.
+template<typename K, typename V, K EMPTY_KEY>
+class FlatHashMap
+{
+  static_assert(std::is_integral_v<K>, "Key must be an integer");
+
+public:
+  using value_type = std::pair<K, V>;
+  using size_type = std::size_t;
+
+  template<typename ValueType>
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ValueType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueType*;
+    using reference = ValueType&;
+
+    Iterator() = default;
+    Iterator(pointer ptr, pointer end) : m_ptr(ptr), m_end(end) { SkipEmpty(); }
+
+    reference operator*() const { return *m_ptr; }
+    pointer operator->() const { return m_ptr; }
+
+    Iterator& operator++()
+    {
+      m_ptr++;
+      SkipEmpty();
+      return *this;
+    }
+
+    bool operator==(const Iterator& rhs) const { return m_ptr == rhs.m_ptr; }
+    bool operator!=(const Iterator& rhs) const { return m_ptr != rhs.m_ptr; }
+
+  private:
+    friend class FlatHashMap;
+
+    void SkipEmpty()
+    {
+      while (m_ptr != m_end && m_ptr->first == EMPTY_KEY)
+        m_ptr++;
+    }
+
+    pointer m_ptr = nullptr;
+    pointer m_end = nullptr;
+  };
+
+  using iterator = Iterator<value_type>;
+  using const_iterator = Iterator<const value_type>;
+
+  FlatHashMap() = default;
+  FlatHashMap(const FlatHashMap&) = default;
+  FlatHashMap(FlatHashMap&&) = default;
+  ~FlatHashMap() = default;
+
+  FlatHashMap& operator=(const FlatHashMap&) = default;
+  FlatHashMap& operator=(FlatHashMap&&) = default;
+
+  size_type size() const { return m_size; }
+  size_type capacity() const { return m_slots.size(); }
+  bool empty() const { return (m_size == 0); }
+
+  iterator begin() { return iterator(m_slots.data(), m_slots.data() + m_slots.size()); }
+  iterator end() { return iterator(m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()); }
+  const_iterator begin() const { return const_iterator(m_slots.data(), m_slots.data() + m_slots.size()); }
+  const_iterator end() const
+  {
+    return const_iterator(m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size());
+  }
+
+  void clear()
+  {
+    for (value_type& slot : m_slots)
+    {
+      if (slot.first != EMPTY_KEY)
+        slot = value_type(EMPTY_KEY, V());
+    }
+    m_size = 0;
+  }
+
+  void reserve(size_type count)
+  {
+    size_type new_capacity = MIN_CAPACITY;
+    while ((count * 2) > new_capacity)
+      new_capacity *= 2;
+    if (new_capacity > m_slots.size())
+      Rehash(new_capacity);
+  }
+
+  iterator find(K key)
+  {
+    const size_type index = FindSlot(key);
+    return (index != INVALID_INDEX) ? MakeIterator(index) : end();
+  }
+
+  const_iterator find(K key) const
+  {
+    const size_type index = FindSlot(key);
+    return (index != INVALID_INDEX) ?
+             const_iterator(m_slots.data() + index, m_slots.data() + m_slots.size()) :
+             end();
+  }
+
+  size_type count(K key) const { return (FindSlot(key) != INVALID_INDEX) ? 1 : 0; }
+
+  /// Inserts the value if the key is not already present. Returns the existing or new entry.
+  std::pair<iterator, bool> emplace(K key, V value)
+  {
+    if (((m_size + 1) * 2) > m_slots.size())
+      Rehash(std::max<size_type>(m_slots.size() * 2, MIN_CAPACITY));
+
+    const size_type mask = m_slots.size() - 1;
+    size_type index = GetIdealSlot(key);
+    for (;;)
+    {
+      value_type& slot = m_slots[index];
+      if (slot.first == key)
+        return std::make_pair(MakeIterator(index), false);
+
+      if (slot.first == EMPTY_KEY)
+      {
+        slot.first = key;
+        slot.second = std::move(value);
+        m_size++;
+        return std::make_pair(MakeIterator(index), true);
+      }
+
+      index = (index + 1) & mask;
+    }
+  }
+
+  void erase(iterator iter) { EraseSlot(static_cast<size_type>(iter.m_ptr - m_slots.data())); }
+
+  size_type erase(K key)
+  {
+    const size_type index = FindSlot(key);
+    if (index == INVALID_INDEX)
+      return 0;
+
+    EraseSlot(index);
+    return 1;
+  }
+
+private:
+  static constexpr size_type MIN_CAPACITY = 16;
+  static constexpr size_type INVALID_INDEX = static_cast<size_type>(-1);
+
+  ALWAYS_INLINE size_type GetIdealSlot(K key) const
+  {
+    // Fibonacci hashing, so keys with zero low bits (e.g. aligned addresses) still spread across the table.
+    const u64 hash = static_cast<u64>(key) * UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_type>(hash >> m_shift);
+  }
+
+  ALWAYS_INLINE iterator MakeIterator(size_type index)
+  {
+    return iterator(m_slots.data() + index, m_slots.data() + m_slots.size());
+  }
+
+  size_type FindSlot(K key) const
+  {
+    if (m_slots.empty())
+      return INVALID_INDEX;
+
+    const size_type mask = m_slots.size() - 1;
+    size_type index = GetIdealSlot(key);
+    for (;;)
+    {
+      const K slot_key = m_slots[index].first;
+      if (slot_key == key)
+        return index;
+      else if (slot_key == EMPTY_KEY)
+        return INVALID_INDEX;
+
+      index = (index + 1) & mask;
+    }
+  }
+
+  void EraseSlot(size_type index)
+  {
+    // Shift back any following entries which would no longer be reachable from their ideal slot.
+    const size_type mask = m_slots.size() - 1;
+    size_type hole = index;
+    size_type next = index;
+    for (;;)
+    {
+      next = (next + 1) & mask;
+      if (m_slots[next].first == EMPTY_KEY)
+        break;
+
+      const size_type ideal = GetIdealSlot(m_slots[next].first);
+      const bool can_move = (hole <= next) ? (ideal <= hole || ideal > next) : (ideal <= hole && ideal > next);
+      if (can_move)
+      {
+        m_slots[hole] = std::move(m_slots[next]);
+        hole = next;
+      }
+    }
+
+    m_slots[hole] = value_type(EMPTY_KEY, V());
+    m_size--;
+  }
+
+  void Rehash(size_type new_capacity)
+  {
+    std::vector<value_type> old_slots(new_capacity, value_type(EMPTY_KEY, V()));
+    old_slots.swap(m_slots);
+
+    m_shift = 64;
+    for (size_type i = new_capacity; i > 1; i >>= 1)
+      m_shift--;
+
+    const size_type mask = new_capacity - 1;
+    for (value_type& old_slot : old_slots)
+    {
+      if (old_slot.first == EMPTY_KEY)
+        continue;
+
+      size_type index = GetIdealSlot(old_slot.first);
+      while (m_slots[index].first != EMPTY_KEY)
+        index = (index + 1) & mask;
+      m_slots[index] = std::move(old_slot);
+    }
+  }
+
+  std::vector<value_type> m_slots;
+  size_type m_size = 0;
+  u32 m_shift = 64;
+};
@@ -64,7 +64,7 @@ public:
 
   void Evict(std::size_t count = 1)
   {
-    while (m_items.size() >= count)
+    for (; count > 0 && !m_items.empty(); count--)
     {
       typename MapType::iterator lowest = m_items.end();
       for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
@@ -0,0 +1,373 @@
+#include "mdec_transform.h"
+#include "platform.h"
+#include <algorithm>
+#include <array>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace MDECTransform {
+
+#if defined(CPU_X64)
+
+/// Multiplies a row of eight 16-bit values against the scale table, i.e. sum(row[u] * scale[u][x]) for each x. The
+/// scale rows are interleaved in pairs, so each multiply-add covers two rows.
+static ALWAYS_INLINE void MultiplyScaleRows(__m128i row, const __m128i* scale_lo, const __m128i* scale_hi,
+                                            __m128i* out_lo, __m128i* out_hi)
+{
+  const __m128i r0 = _mm_shuffle_epi32(row, _MM_SHUFFLE(0, 0, 0, 0));
+  const __m128i r1 = _mm_shuffle_epi32(row, _MM_SHUFFLE(1, 1, 1, 1));
+  const __m128i r2 = _mm_shuffle_epi32(row, _MM_SHUFFLE(2, 2, 2, 2));
+  const __m128i r3 = _mm_shuffle_epi32(row, _MM_SHUFFLE(3, 3, 3, 3));
+  *out_lo = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(scale_lo[0], r0), _mm_madd_epi16(scale_lo[1], r1)),
+                          _mm_add_epi32(_mm_madd_epi16(scale_lo[2], r2), _mm_madd_epi16(scale_lo[3], r3)));
+  *out_hi = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(scale_hi[0], r0), _mm_madd_epi16(scale_hi[1], r1)),
+                          _mm_add_epi32(_mm_madd_epi16(scale_hi[2], r2), _mm_madd_epi16(scale_hi[3], r3)));
+}
+
+void IDCT(s16* blk, const s16* scale_table)
+{
+  // Rows of the block and scale table, interleaved in pairs (2p, 2p+1) for multiply-adds.
+  __m128i blk_lo[4], blk_hi[4], scale_lo[4], scale_hi[4];
+  alignas(16) std::array<std::array<s32, 8>, 4> scale_pairs;
+  for (u32 p = 0; p < 4; p++)
+  {
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[(p * 2 + 0) * 8]));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[(p * 2 + 1) * 8]));
+    blk_lo[p] = _mm_unpacklo_epi16(b0, b1);
+    blk_hi[p] = _mm_unpackhi_epi16(b0, b1);
+
+    const __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&scale_table[(p * 2 + 0) * 8]));
+    const __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&scale_table[(p * 2 + 1) * 8]));
+    scale_lo[p] = _mm_unpacklo_epi16(s0, s1);
+    scale_hi[p] = _mm_unpackhi_epi16(s0, s1);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&scale_pairs[p][0]), scale_lo[p]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&scale_pairs[p][4]), scale_hi[p]);
+  }
+
+  for (u32 y = 0; y < 8; y++)
+  {
+    // First pass, temp[y][x] = sum(blk[u][x] * scale[u][y]). At most 2^28 in magnitude, so exact in 32 bits.
+    __m128i temp_lo = _mm_setzero_si128();
+    __m128i temp_hi = _mm_setzero_si128();
+    for (u32 p = 0; p < 4; p++)
+    {
+      const __m128i scale = _mm_set1_epi32(scale_pairs[p][y]);
+      temp_lo = _mm_add_epi32(temp_lo, _mm_madd_epi16(blk_lo[p], scale));
+      temp_hi = _mm_add_epi32(temp_hi, _mm_madd_epi16(blk_hi[p], scale));
+    }
+
+    // The second pass needs up to 47 bits. Split temp into a signed high part and two unsigned 8-bit parts, so each
+    // product sum fits in 32 bits, then recombine just the bits needed for (sum >> 31).
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i part_hi = _mm_packs_epi32(_mm_srai_epi32(temp_lo, 16), _mm_srai_epi32(temp_hi, 16));
+    const __m128i part_mid = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(temp_lo, 8), byte_mask),
+                                             _mm_and_si128(_mm_srli_epi32(temp_hi, 8), byte_mask));
+    const __m128i part_low = _mm_packs_epi32(_mm_and_si128(temp_lo, byte_mask), _mm_and_si128(temp_hi, byte_mask));
+
+    __m128i sum_hi_lo, sum_hi_hi, sum_mid_lo, sum_mid_hi, sum_low_lo, sum_low_hi;
+    MultiplyScaleRows(part_hi, scale_lo, scale_hi, &sum_hi_lo, &sum_hi_hi);
+    MultiplyScaleRows(part_mid, scale_lo, scale_hi, &sum_mid_lo, &sum_mid_hi);
+    MultiplyScaleRows(part_low, scale_lo, scale_hi, &sum_low_lo, &sum_low_hi);
+
+    // (sum >> 16) = sum_hi + ((sum_mid + (sum_low >> 8)) >> 8), then round on bit 31 and wrap to 9 bits.
+    __m128i result[2];
+    for (u32 half = 0; half < 2; half++)
+    {
+      const __m128i sum_hi = half ? sum_hi_hi : sum_hi_lo;
+      const __m128i sum_mid = half ? sum_mid_hi : sum_mid_lo;
+      const __m128i sum_low = half ? sum_low_hi : sum_low_lo;
+      const __m128i sum_shifted =
+        _mm_add_epi32(sum_hi, _mm_srai_epi32(_mm_add_epi32(sum_mid, _mm_srai_epi32(sum_low, 8)), 8));
+      const __m128i q = _mm_srai_epi32(sum_shifted, 15);
+      const __m128i rounded = _mm_add_epi32(_mm_srai_epi32(q, 1), _mm_and_si128(q, _mm_set1_epi32(1)));
+      result[half] = _mm_srai_epi32(_mm_slli_epi32(rounded, 23), 23);
+    }
+
+    const __m128i clamped = _mm_max_epi16(_mm_min_epi16(_mm_packs_epi32(result[0], result[1]), _mm_set1_epi16(127)),
+                                          _mm_set1_epi16(-128));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&blk[y * 8]), clamped);
+  }
+}
+
+#elif defined(CPU_AARCH64)
+
+void IDCT(s16* blk, const s16* scale_table)
+{
+  // NEON has widening 32x32->64 multiply-adds, so the second pass can use the full precision directly.
+  int16x8_t blk_rows[8];
+  int32x4_t scale_rows_lo[8], scale_rows_hi[8];
+  for (u32 u = 0; u < 8; u++)
+  {
+    blk_rows[u] = vld1q_s16(&blk[u * 8]);
+    const int16x8_t scale = vld1q_s16(&scale_table[u * 8]);
+    scale_rows_lo[u] = vmovl_s16(vget_low_s16(scale));
+    scale_rows_hi[u] = vmovl_s16(vget_high_s16(scale));
+  }
+
+  for (u32 y = 0; y < 8; y++)
+  {
+    // First pass, temp[y][x] = sum(blk[u][x] * scale[u][y]). At most 2^28 in magnitude, so exact in 32 bits.
+    int32x4_t temp_lo = vdupq_n_s32(0);
+    int32x4_t temp_hi = vdupq_n_s32(0);
+    for (u32 u = 0; u < 8; u++)
+    {
+      const s16 scale = scale_table[u * 8 + y];
+      temp_lo = vmlal_n_s16(temp_lo, vget_low_s16(blk_rows[u]), scale);
+      temp_hi = vmlal_n_s16(temp_hi, vget_high_s16(blk_rows[u]), scale);
+    }
+
+    alignas(16) std::array<s32, 8> temp;
+    vst1q_s32(&temp[0], temp_lo);
+    vst1q_s32(&temp[4], temp_hi);
+
+    // Second pass, sum(temp[y][u] * scale[u][x]) in 64 bits.
+    int64x2_t sum[4] = {vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0)};
+    for (u32 u = 0; u < 8; u++)
+    {
+      sum[0] = vmlal_n_s32(sum[0], vget_low_s32(scale_rows_lo[u]), temp[u]);
+      sum[1] = vmlal_n_s32(sum[1], vget_high_s32(scale_rows_lo[u]), temp[u]);
+      sum[2] = vmlal_n_s32(sum[2], vget_low_s32(scale_rows_hi[u]), temp[u]);
+      sum[3] = vmlal_n_s32(sum[3], vget_high_s32(scale_rows_hi[u]), temp[u]);
+    }
+
+    // Round on bit 31 and wrap to 9 bits.
+    int16x4_t result[2];
+    for (u32 half = 0; half < 2; half++)
+    {
+      const int32x4_t q = vcombine_s32(vmovn_s64(vshrq_n_s64(sum[half * 2 + 0], 31)),
+                                       vmovn_s64(vshrq_n_s64(sum[half * 2 + 1], 31)));
+      const int32x4_t rounded = vaddq_s32(vshrq_n_s32(q, 1), vandq_s32(q, vdupq_n_s32(1)));
+      result[half] = vqmovn_s32(vshrq_n_s32(vshlq_n_s32(rounded, 23), 23));
+    }
+
+    const int16x8_t clamped =
+      vmaxq_s16(vminq_s16(vcombine_s16(result[0], result[1]), vdupq_n_s16(127)), vdupq_n_s16(-128));
+    vst1q_s16(&blk[y * 8], clamped);
+  }
+}
+
+#else
+
+void IDCT(s16* blk, const s16* scale_table)
+{
+  std::array<s64, 64> temp_buffer;
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+    {
+      s64 sum = 0;
+      for (u32 u = 0; u < 8; u++)
+        sum += s32(blk[u * 8 + x]) * s32(scale_table[u * 8 + y]);
+      temp_buffer[x + y * 8] = sum;
+    }
+  }
+  for (u32 x = 0; x < 8; x++)
+  {
+    for (u32 y = 0; y < 8; y++)
+    {
+      s64 sum = 0;
+      for (u32 u = 0; u < 8; u++)
+        sum += s64(temp_buffer[u + y * 8]) * s32(scale_table[u * 8 + x]);
+
+      blk[x + y * 8] =
+        static_cast<s16>(std::clamp<s32>(SignExtendN<9, s32>((sum >> 32) + ((sum >> 31) & 1)), -128, 127));
+    }
+  }
+}
+
+#endif
+
+void YUVToRGB(u32* rgb, u32 xx, u32 yy, const s16* Crblk, const s16* Cbblk, const s16* Yblk)
+{
+  // TODO: Signed output. Every path below biases the clamped components by 128, regardless of the output mode.
+
+  // Each chroma sample covers 2x2 pixels, so only compute the 4x4 samples for this block once.
+  alignas(16) std::array<s16, 16> chroma_r, chroma_g, chroma_b;
+  for (u32 cy = 0; cy < 4; cy++)
+  {
+    for (u32 cx = 0; cx < 4; cx++)
+    {
+      s16 R = Crblk[(cx + xx / 2) + (cy + yy / 2) * 8];
+      s16 B = Cbblk[(cx + xx / 2) + (cy + yy / 2) * 8];
+      const s16 G = static_cast<s16>((-0.3437f * static_cast<float>(B)) + (-0.7143f * static_cast<float>(R)));
+
+      R = static_cast<s16>(1.402f * static_cast<float>(R));
+      B = static_cast<s16>(1.772f * static_cast<float>(B));
+
+      chroma_r[cx + cy * 4] = R;
+      chroma_g[cx + cy * 4] = G;
+      chroma_b[cx + cy * 4] = B;
+    }
+  }
+
+  for (u32 y = 0; y < 8; y++)
+  {
+    u32* out_ptr = &rgb[xx + (y + yy) * 16];
+    const u32 chroma_row = (y / 2) * 4;
+
+#if defined(CPU_X64)
+    const __m128i min = _mm_set1_epi16(-128);
+    const __m128i max = _mm_set1_epi16(127);
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[y * 8]));
+    const __m128i R = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&chroma_r[chroma_row]));
+    const __m128i G = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&chroma_g[chroma_row]));
+    const __m128i B = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&chroma_b[chroma_row]));
+
+    const __m128i out_r = _mm_add_epi16(
+      _mm_max_epi16(_mm_min_epi16(_mm_adds_epi16(Y, _mm_unpacklo_epi16(R, R)), max), min), bias);
+    const __m128i out_g = _mm_add_epi16(
+      _mm_max_epi16(_mm_min_epi16(_mm_adds_epi16(Y, _mm_unpacklo_epi16(G, G)), max), min), bias);
+    const __m128i out_b = _mm_add_epi16(
+      _mm_max_epi16(_mm_min_epi16(_mm_adds_epi16(Y, _mm_unpacklo_epi16(B, B)), max), min), bias);
+
+    const __m128i out_rg = _mm_or_si128(out_r, _mm_slli_epi16(out_g, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_ptr[0]), _mm_unpacklo_epi16(out_rg, out_b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_ptr[4]), _mm_unpackhi_epi16(out_rg, out_b));
+#elif defined(CPU_AARCH64)
+    const int16x8_t min = vdupq_n_s16(-128);
+    const int16x8_t max = vdupq_n_s16(127);
+    const int16x8_t bias = vdupq_n_s16(128);
+    const int16x8_t Y = vld1q_s16(&Yblk[y * 8]);
+    const int16x4_t R = vld1_s16(&chroma_r[chroma_row]);
+    const int16x4_t G = vld1_s16(&chroma_g[chroma_row]);
+    const int16x4_t B = vld1_s16(&chroma_b[chroma_row]);
+
+    const uint16x8_t out_r = vreinterpretq_u16_s16(
+      vaddq_s16(vmaxq_s16(vminq_s16(vqaddq_s16(Y, vcombine_s16(vzip1_s16(R, R), vzip2_s16(R, R))), max), min), bias));
+    const uint16x8_t out_g = vreinterpretq_u16_s16(
+      vaddq_s16(vmaxq_s16(vminq_s16(vqaddq_s16(Y, vcombine_s16(vzip1_s16(G, G), vzip2_s16(G, G))), max), min), bias));
+    const uint16x8_t out_b = vreinterpretq_u16_s16(
+      vaddq_s16(vmaxq_s16(vminq_s16(vqaddq_s16(Y, vcombine_s16(vzip1_s16(B, B), vzip2_s16(B, B))), max), min), bias));
+
+    const uint16x8_t out_rg = vorrq_u16(out_r, vshlq_n_u16(out_g, 8));
+    vst1q_u32(&out_ptr[0], vreinterpretq_u32_u16(vzip1q_u16(out_rg, out_b)));
+    vst1q_u32(&out_ptr[4], vreinterpretq_u32_u16(vzip2q_u16(out_rg, out_b)));
+#else
+    for (u32 x = 0; x < 8; x++)
+    {
+      const s32 Y = Yblk[x + y * 8];
+      const u32 chroma_index = chroma_row + x / 2;
+
+        const u32 R = static_cast<u32>(std::clamp(Y + chroma_r[chroma_index], -128, 127) + 128);
+      const u32 G = static_cast<u32>(std::clamp(Y + chroma_g[chroma_index], -128, 127) + 128);
+      const u32 B = static_cast<u32>(std::clamp(Y + chroma_b[chroma_index], -128, 127) + 128);
+      out_ptr[x] = R | (G << 8) | (B << 16);
+    }
+#endif
+  }
+}
+
+void YToMono(u32* out, const s16* Yblk)
+{
+  u32 i = 0;
+
+#if defined(CPU_X64)
+  for (; i < 64; i += 8)
+  {
+    __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[i]));
+    Y = _mm_srai_epi16(_mm_slli_epi16(Y, 6), 6);
+    Y = _mm_max_epi16(_mm_min_epi16(Y, _mm_set1_epi16(127)), _mm_set1_epi16(-128));
+    Y = _mm_and_si128(_mm_add_epi16(Y, _mm_set1_epi16(128)), _mm_set1_epi16(0xFF));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i + 0]), _mm_unpacklo_epi16(Y, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i + 4]), _mm_unpackhi_epi16(Y, _mm_setzero_si128()));
+  }
+#elif defined(CPU_AARCH64)
+  for (; i < 64; i += 8)
+  {
+    int16x8_t Y = vld1q_s16(&Yblk[i]);
+    Y = vshrq_n_s16(vshlq_n_s16(Y, 6), 6);
+    Y = vmaxq_s16(vminq_s16(Y, vdupq_n_s16(127)), vdupq_n_s16(-128));
+    const uint16x8_t mono = vandq_u16(vreinterpretq_u16_s16(vaddq_s16(Y, vdupq_n_s16(128))), vdupq_n_u16(0xFF));
+    vst1q_u32(&out[i + 0], vmovl_u16(vget_low_u16(mono)));
+    vst1q_u32(&out[i + 4], vmovl_u16(vget_high_u16(mono)));
+  }
+#endif
+
+  for (; i < 64; i++)
+  {
+    s16 Y = Yblk[i];
+    Y = SignExtendN<10, s16>(Y);
+    Y = std::clamp<s16>(Y, -128, 127);
+    Y += 128;
+    out[i] = static_cast<u32>(Y) & 0xFF;
+  }
+}
+
+void PackRGB15(const u32* rgb, u32* out, u32 count, bool set_bit15)
+{
+  const u32 a = set_bit15 ? 0x8000u : 0u;
+  u32 i = 0;
+
+#if defined(CPU_X64)
+  const __m128i alpha = _mm_set1_epi32(static_cast<s32>(a));
+  for (; i < count; i += 8)
+  {
+    __m128i color[2];
+    for (u32 j = 0; j < 2; j++)
+    {
+      const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rgb[i + j * 4]));
+      const __m128i r = _mm_and_si128(_mm_srli_epi32(value, 3), _mm_set1_epi32(0x1F));
+      const __m128i g = _mm_and_si128(_mm_srli_epi32(value, 6), _mm_set1_epi32(0x3E0));
+      const __m128i b = _mm_and_si128(_mm_srli_epi32(value, 9), _mm_set1_epi32(0x7C00));
+      color[j] = _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, alpha));
+
+      // sign-extend so the saturating pack doesn't clamp bit 15
+      color[j] = _mm_srai_epi32(_mm_slli_epi32(color[j], 16), 16);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i / 2]), _mm_packs_epi32(color[0], color[1]));
+  }
+#elif defined(CPU_AARCH64)
+  const uint32x4_t alpha = vdupq_n_u32(a);
+  for (; i < count; i += 8)
+  {
+    uint16x4_t color[2];
+    for (u32 j = 0; j < 2; j++)
+    {
+      const uint32x4_t value = vld1q_u32(&rgb[i + j * 4]);
+      const uint32x4_t r = vandq_u32(vshrq_n_u32(value, 3), vdupq_n_u32(0x1F));
+      const uint32x4_t g = vandq_u32(vshrq_n_u32(value, 6), vdupq_n_u32(0x3E0));
+      const uint32x4_t b = vandq_u32(vshrq_n_u32(value, 9), vdupq_n_u32(0x7C00));
+      color[j] = vmovn_u32(vorrq_u32(vorrq_u32(r, g), vorrq_u32(b, alpha)));
+    }
+
+    vst1q_u32(&out[i / 2], vreinterpretq_u32_u16(vcombine_u16(color[0], color[1])));
+  }
+#endif
+
+  for (; i < count; i += 2)
+  {
+    u32 color = rgb[i];
+    const u32 color15a = ((color >> 3) & 0x1Fu) | (((color >> 11) & 0x1Fu) << 5) | (((color >> 19) & 0x1Fu) << 10) | a;
+
+    color = rgb[i + 1];
+    const u32 color15b = ((color >> 3) & 0x1Fu) | (((color >> 11) & 0x1Fu) << 5) | (((color >> 19) & 0x1Fu) << 10) | a;
+
+    out[i / 2] = color15a | (color15b << 16);
+  }
+}
+
+void PackRGB24(const u32* rgb, u32* out, u32 count)
+{
+  for (u32 i = 0; i < count; i += 4)
+  {
+    const u32 p0 = rgb[i + 0] & 0xFFFFFFu;
+    const u32 p1 = rgb[i + 1] & 0xFFFFFFu;
+    const u32 p2 = rgb[i + 2] & 0xFFFFFFu;
+    const u32 p3 = rgb[i + 3] & 0xFFFFFFu;
+    *(out++) = p0 | (p1 << 24);         // RGBR
+    *(out++) = (p1 >> 8) | (p2 << 16);  // GBRG
+    *(out++) = (p2 >> 16) | (p3 << 8);  // BRGB
+  }
+}
+
+} // namespace MDECTransform
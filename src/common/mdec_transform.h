@@ -0,0 +1,26 @@
+#pragma once
+#include "types.h"
+
+// Transforms used by the MDEC to turn dequantized coefficient blocks into pixels. Blocks are 8x8 in row-major order,
+// and output pixels are 24-bit RGB (or 8-bit luma) in the low bits of each word, matching the MDEC's output buffer.
+// All vectorized paths are bit-exact with the console's fixed-point arithmetic.
+namespace MDECTransform {
+
+/// Inverse DCT of a block in place, using the scale table set by the game. Coefficients must be in the range
+/// [-1024, 1023] produced by the run-length decoder. Output samples are clamped to [-128, 127].
+void IDCT(s16* blk, const s16* scale_table);
+
+/// Converts a luma block and the matching quarter of the chroma blocks to RGB, writing it to the 16x16 macroblock at
+/// (xx, yy), where each coordinate is 0 or 8.
+void YUVToRGB(u32* rgb, u32 xx, u32 yy, const s16* Crblk, const s16* Cbblk, const s16* Yblk);
+
+/// Converts a luma block to 8-bit monochrome.
+void YToMono(u32* out, const s16* Yblk);
+
+/// Packs RGB pixels to 15-bit, two pixels per word. The pixel count must be a multiple of 8.
+void PackRGB15(const u32* rgb, u32* out, u32 count, bool set_bit15);
+
+/// Packs RGB pixels tightly to 24-bit, four pixels in three words. The pixel count must be a multiple of 4.
+void PackRGB24(const u32* rgb, u32* out, u32 count);
+
+} // namespace MDECTransform
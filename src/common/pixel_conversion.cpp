@@ -0,0 +1,393 @@
+#include "pixel_conversion.h"
+#include "align.h"
+#include "platform.h"
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace PixelConversion {
+
+static ALWAYS_INLINE u32 Convert5To8(u32 color)
+{
+  return (((color * 527u) + 23u) >> 6);
+}
+
+static ALWAYS_INLINE u16 Convert15BitPixelToRGB565(u16 value)
+{
+  return ((value & 0x3E0) << 1) | ((value & 0x20) << 1) | ((value >> 10) & 0x1F) | ((value & 0x1F) << 11);
+}
+
+static ALWAYS_INLINE u16 Convert15BitPixelToRGBA5551(u16 value)
+{
+  return (value & 0x3E0) | ((value >> 10) & 0x1F) | ((value & 0x1F) << 10);
+}
+
+static ALWAYS_INLINE u32 Convert15BitPixelToRGBA8(u16 value)
+{
+  const u32 value32 = ZeroExtend32(value);
+  const u32 r = Convert5To8(value32 & 31u);
+  const u32 g = Convert5To8((value32 >> 5) & 31u);
+  const u32 b = Convert5To8((value32 >> 10) & 31u);
+  const u32 a = ((value32 >> 15) != 0) ? 255 : 0;
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+static ALWAYS_INLINE u32 Convert15BitPixelToBGRA8(u16 value)
+{
+  const u32 value32 = ZeroExtend32(value);
+  const u32 r = Convert5To8(value32 & 31u);
+  const u32 g = Convert5To8((value32 >> 5) & 31u);
+  const u32 b = Convert5To8((value32 >> 10) & 31u);
+  return b | (g << 8) | (r << 16) | 0xFF000000u;
+}
+
+#if defined(CPU_X64)
+
+/// Expands the 5-bit channels in each 16-bit lane to 8 bits, matching Convert5To8().
+static ALWAYS_INLINE __m128i Convert5To8(__m128i color)
+{
+  return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(color, _mm_set1_epi16(527)), _mm_set1_epi16(23)), 6);
+}
+
+/// Loads four packed 24-bit pixels into 32-bit lanes. Reads 16 bytes, i.e. four past the last pixel.
+static ALWAYS_INLINE __m128i Load24BitPixels(const u8* src)
+{
+  const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i p01 = _mm_unpacklo_epi32(value, _mm_srli_si128(value, 3));
+  const __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(value, 6), _mm_srli_si128(value, 9));
+  return _mm_and_si128(_mm_unpacklo_epi64(p01, p23), _mm_set1_epi32(0x00FFFFFF));
+}
+
+/// Truncates the 32-bit lanes of both vectors to 16 bits. SSE2 only has a saturating pack, so sign-extend first.
+static ALWAYS_INLINE __m128i Narrow32To16(__m128i low, __m128i high)
+{
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+}
+
+#endif
+
+void Convert15BitToRGB565(const u16* src, u16* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    src += 8;
+    __m128i a = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0)))), 1);
+    __m128i b = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x20)))), 1);
+    __m128i c = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
+    __m128i d = _mm_slli_epi16(_mm_and_si128(value, single_mask), 11);
+    value = _mm_or_si128(_mm_or_si128(_mm_or_si128(a, b), c), d);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    uint16x8_t value = vld1q_u16(src);
+    src += 8;
+    uint16x8_t a = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x3E0)), 1); // (value & 0x3E0) << 1
+    uint16x8_t b = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x20)), 1);  // (value & 0x20) << 1
+    uint16x8_t c = vandq_u16(vshrq_n_u16(value, 10), single_mask);       // ((value >> 10) & 0x1F)
+    uint16x8_t d = vshlq_n_u16(vandq_u16(value, single_mask), 11);       // ((value & 0x1F) << 11)
+    value = vorrq_u16(vorrq_u16(vorrq_u16(a, b), c), d);
+    vst1q_u16(dst, value);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst++) = Convert15BitPixelToRGB565(*(src++));
+}
+
+void Convert15BitToRGBA5551(const u16* src, u16* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    src += 8;
+    __m128i a = _mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0))));
+    __m128i b = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
+    __m128i c = _mm_slli_epi16(_mm_and_si128(value, single_mask), 10);
+    value = _mm_or_si128(_mm_or_si128(a, b), c);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+    uint16x8_t value = vld1q_u16(src);
+    src += 8;
+    uint16x8_t a = vandq_u16(value, vdupq_n_u16(0x3E0));
+    uint16x8_t b = vandq_u16(vshrq_n_u16(value, 10), single_mask);
+    uint16x8_t c = vshlq_n_u16(vandq_u16(value, single_mask), 10);
+    value = vorrq_u16(vorrq_u16(a, b), c);
+    vst1q_u16(dst, value);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst++) = Convert15BitPixelToRGBA5551(*(src++));
+}
+
+void Convert15BitToRGBA8(const u16* src, u32* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    src += 8;
+    const __m128i r = Convert5To8(_mm_and_si128(value, single_mask));
+    const __m128i g = Convert5To8(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask));
+    const __m128i b = Convert5To8(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask));
+    const __m128i a = _mm_and_si128(_mm_srai_epi16(value, 15), _mm_set1_epi16(static_cast<s16>(0xFF00)));
+    const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    const __m128i ba = _mm_or_si128(b, a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(rg, ba));
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src);
+    src += 8;
+    uint8x8x4_t rgba;
+    rgba.val[0] = vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(value, single_mask), 527), 6));
+    rgba.val[1] =
+      vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(vshrq_n_u16(value, 5), single_mask), 527), 6));
+    rgba.val[2] =
+      vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(vshrq_n_u16(value, 10), single_mask), 527), 6));
+    rgba.val[3] = vmovn_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(value), 15)));
+    vst4_u8(reinterpret_cast<u8*>(dst), rgba);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst++) = Convert15BitPixelToRGBA8(*(src++));
+}
+
+void Convert15BitToBGRA8(const u16* src, u32* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    src += 8;
+    const __m128i r = Convert5To8(_mm_and_si128(value, single_mask));
+    const __m128i g = Convert5To8(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask));
+    const __m128i b = Convert5To8(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask));
+    const __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+    const __m128i ra = _mm_or_si128(r, _mm_set1_epi16(static_cast<s16>(0xFF00)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(bg, ra));
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src);
+    src += 8;
+    uint8x8x4_t bgra;
+    bgra.val[0] =
+      vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(vshrq_n_u16(value, 10), single_mask), 527), 6));
+    bgra.val[1] =
+      vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(vshrq_n_u16(value, 5), single_mask), 527), 6));
+    bgra.val[2] = vmovn_u16(vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), vandq_u16(value, single_mask), 527), 6));
+    bgra.val[3] = vdup_n_u8(0xFF);
+    vst4_u8(reinterpret_cast<u8*>(dst), bgra);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst++) = Convert15BitPixelToBGRA8(*(src++));
+}
+
+void Convert24BitToRGB565(const u8* src, u16* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  // Stop early enough that the last load doesn't read past the end of the row.
+  for (; (col + 10) <= width; col += 8)
+  {
+    __m128i rgb[2] = {Load24BitPixels(src), Load24BitPixels(src + 12)};
+    src += 24;
+    for (__m128i& value : rgb)
+    {
+      const __m128i r = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(value, 3), _mm_set1_epi32(0x1F)), 11);
+      const __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(value, 10), _mm_set1_epi32(0x3F)), 5);
+      const __m128i b = _mm_and_si128(_mm_srli_epi32(value, 19), _mm_set1_epi32(0x1F));
+      value = _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), Narrow32To16(rgb[0], rgb[1]));
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src);
+    src += 24;
+    const uint16x8_t r = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[0], 3)), 11);
+    const uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[1], 2)), 5);
+    const uint16x8_t b = vmovl_u8(vshr_n_u8(rgb.val[2], 3));
+    vst1q_u16(dst, vorrq_u16(vorrq_u16(r, g), b));
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst++) = ((static_cast<u16>(src[0]) >> 3) << 11) | ((static_cast<u16>(src[1]) >> 2) << 5) |
+               (static_cast<u16>(src[2]) >> 3);
+    src += 3;
+  }
+}
+
+void Convert24BitToRGBA5551(const u8* src, u16* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  // Stop early enough that the last load doesn't read past the end of the row.
+  for (; (col + 10) <= width; col += 8)
+  {
+    __m128i rgb[2] = {Load24BitPixels(src), Load24BitPixels(src + 12)};
+    src += 24;
+    for (__m128i& value : rgb)
+    {
+      const __m128i r = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(value, 3), _mm_set1_epi32(0x1F)), 10);
+      const __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(value, 11), _mm_set1_epi32(0x1F)), 5);
+      const __m128i b = _mm_and_si128(_mm_srli_epi32(value, 19), _mm_set1_epi32(0x1F));
+      value = _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), Narrow32To16(rgb[0], rgb[1]));
+    dst += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src);
+    src += 24;
+    const uint16x8_t r = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[0], 3)), 10);
+    const uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[1], 3)), 5);
+    const uint16x8_t b = vmovl_u8(vshr_n_u8(rgb.val[2], 3));
+    vst1q_u16(dst, vorrq_u16(vorrq_u16(r, g), b));
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst++) = ((static_cast<u16>(src[0]) >> 3) << 10) | ((static_cast<u16>(src[1]) >> 3) << 5) |
+               (static_cast<u16>(src[2]) >> 3);
+    src += 3;
+  }
+}
+
+void Convert24BitToRGBA8(const u8* src, u32* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  // Stop early enough that the last load doesn't read past the end of the row.
+  for (; (col + 6) <= width; col += 4)
+  {
+    const __m128i value = _mm_or_si128(Load24BitPixels(src), _mm_set1_epi32(static_cast<s32>(0xFF000000u)));
+    src += 12;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+    dst += 4;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src);
+    src += 24;
+    const uint8x8x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdup_n_u8(0xFF)}};
+    vst4_u8(reinterpret_cast<u8*>(dst), rgba);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst++) = ZeroExtend32(src[0]) | (ZeroExtend32(src[1]) << 8) | (ZeroExtend32(src[2]) << 16) | 0xFF000000u;
+    src += 3;
+  }
+}
+
+void Convert24BitToBGRA8(const u8* src, u32* dst, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  // Stop early enough that the last load doesn't read past the end of the row.
+  for (; (col + 6) <= width; col += 4)
+  {
+    const __m128i value = Load24BitPixels(src);
+    src += 12;
+    const __m128i rb = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0xFF)), 16),
+                                    _mm_and_si128(_mm_srli_epi32(value, 16), _mm_set1_epi32(0xFF)));
+    const __m128i ga = _mm_or_si128(_mm_and_si128(value, _mm_set1_epi32(0xFF00)),
+                                    _mm_set1_epi32(static_cast<s32>(0xFF000000u)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(rb, ga));
+    dst += 4;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src);
+    src += 24;
+    const uint8x8x4_t bgra = {{rgb.val[2], rgb.val[1], rgb.val[0], vdup_n_u8(0xFF)}};
+    vst4_u8(reinterpret_cast<u8*>(dst), bgra);
+    dst += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst++) = ZeroExtend32(src[2]) | (ZeroExtend32(src[1]) << 8) | (ZeroExtend32(src[0]) << 16) | 0xFF000000u;
+    src += 3;
+  }
+}
+
+} // namespace PixelConversion
@@ -0,0 +1,19 @@
+#pragma once
+#include "types.h"
+
+// Row conversion routines for presenting PS1 VRAM on the host. Source rows are either 15-bit pixels in the console's
+// layout (red in the low bits, mask/alpha in bit 15), or packed 24-bit RGB. Destination formats are named after the
+// host display formats, and are stored in native (little-endian) order.
+namespace PixelConversion {
+
+void Convert15BitToRGB565(const u16* src, u16* dst, u32 width);
+void Convert15BitToRGBA5551(const u16* src, u16* dst, u32 width);
+void Convert15BitToRGBA8(const u16* src, u32* dst, u32 width);
+void Convert15BitToBGRA8(const u16* src, u32* dst, u32 width);
+
+void Convert24BitToRGB565(const u8* src, u16* dst, u32 width);
+void Convert24BitToRGBA5551(const u8* src, u16* dst, u32 width);
+void Convert24BitToRGBA8(const u8* src, u32* dst, u32 width);
+void Convert24BitToBGRA8(const u8* src, u32* dst, u32 width);
+
+} // namespace PixelConversion
@@ -0,0 +1,330 @@
+#include "core/gpu_sw_backend.h"
+#include "core/settings.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+class BackendSet
+{
+public:
+  ~BackendSet()
+  {
+    for (const auto& backend : m_backends)
+      backend->Shutdown();
+  }
+
+  void Add(u32 thread_count, bool vector_spans = true)
+  {
+    g_settings.gpu_use_thread = false;
+    g_settings.gpu_sw_threads = thread_count;
+
+    std::unique_ptr<GPU_SW_Backend> backend = std::make_unique<GPU_SW_Backend>();
+    ASSERT_TRUE(backend->Initialize(false));
+    backend->SetVectorSpansEnabled(vector_spans);
+    m_backends.push_back(std::move(backend));
+  }
+
+  /// Calls func with each backend, so they all receive the same command.
+  template<typename T>
+  void Push(const T& func)
+  {
+    for (const auto& backend : m_backends)
+      func(backend.get());
+  }
+
+  /// Returns true if every backend has the same VRAM contents as the first.
+  bool CompareVRAM()
+  {
+    for (const auto& backend : m_backends)
+      backend->Sync(true);
+
+    for (size_t i = 1; i < m_backends.size(); i++)
+    {
+      if (std::memcmp(m_backends[0]->GetVRAM(), m_backends[i]->GetVRAM(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16)) !=
+          0)
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  std::vector<std::unique_ptr<GPU_SW_Backend>> m_backends;
+};
+} // namespace
+
+static u32 RandomBelow(std::mt19937& rng, u32 n)
+{
+  return static_cast<u32>(rng() % n);
+}
+
+static void SetDrawCommandState(GPUBackendDrawCommand* cmd, GPUBackendCommandParameters params, GPURenderCommand rc,
+                                u16 draw_mode, u16 palette, const GPUTextureWindow& window)
+{
+  cmd->params.bits = params.bits;
+  cmd->rc.bits = rc.bits;
+  cmd->draw_mode.bits = draw_mode;
+  cmd->palette.bits = palette;
+  cmd->window = window;
+}
+
+static void SetDrawingArea(BackendSet& set, const Common::Rectangle<u32>& area)
+{
+  set.Push([&area](GPU_SW_Backend* backend) {
+    GPUBackendSetDrawingAreaCommand* cmd = backend->NewSetDrawingAreaCommand();
+    cmd->params.bits = 0;
+    cmd->new_area = area;
+    backend->PushCommand(cmd);
+  });
+}
+
+static void FillVRAMWithNoise(BackendSet& set, std::mt19937& rng)
+{
+  std::vector<u16> data(VRAM_WIDTH * VRAM_HEIGHT);
+  for (u16& value : data)
+    value = static_cast<u16>(rng());
+
+  set.Push([&data](GPU_SW_Backend* backend) {
+    GPUBackendUpdateVRAMCommand* cmd = backend->NewUpdateVRAMCommand(VRAM_WIDTH * VRAM_HEIGHT);
+    cmd->params.bits = 0;
+    cmd->x = 0;
+    cmd->y = 0;
+    cmd->width = VRAM_WIDTH;
+    cmd->height = VRAM_HEIGHT;
+    std::memcpy(cmd->data, data.data(), data.size() * sizeof(u16));
+    backend->PushCommand(cmd);
+  });
+}
+
+/// Pushes a random VRAM transfer, drawing area change, or primitive. Primitives occasionally have coordinates far
+/// outside VRAM, so that wrapping and clipping are exercised.
+static void PushRandomCommand(BackendSet& set, std::mt19937& rng)
+{
+  const u32 kind = RandomBelow(rng, 100);
+  const GPUBackendCommandParameters params{static_cast<u8>(RandomBelow(rng, 16))};
+  const u16 draw_mode = static_cast<u16>(rng());
+  const u16 palette = static_cast<u16>(rng()) & GPUTexturePaletteReg::MASK;
+  const GPUTextureWindow window = {static_cast<u8>(RandomBelow(rng, 2) ? 0xFF : rng()),
+                                   static_cast<u8>(RandomBelow(rng, 2) ? 0xFF : rng()),
+                                   static_cast<u8>(RandomBelow(rng, 4) ? 0 : rng()),
+                                   static_cast<u8>(RandomBelow(rng, 4) ? 0 : rng())};
+  const s32 origin_x = static_cast<s32>(RandomBelow(rng, VRAM_WIDTH));
+  const s32 origin_y = static_cast<s32>(RandomBelow(rng, VRAM_HEIGHT));
+  const s32 spread = RandomBelow(rng, 10) ? 64 : 700;
+  const auto random_position = [&rng, spread](s32 origin) {
+    return origin + static_cast<s32>(RandomBelow(rng, static_cast<u32>(spread * 2))) - spread;
+  };
+
+  if (kind < 2)
+  {
+    const u32 left = RandomBelow(rng, VRAM_WIDTH);
+    const u32 top = RandomBelow(rng, VRAM_HEIGHT);
+    const Common::Rectangle<u32> area(left, top, std::min<u32>(VRAM_WIDTH - 1, left + RandomBelow(rng, VRAM_WIDTH)),
+                                      std::min<u32>(VRAM_HEIGHT - 1, top + RandomBelow(rng, VRAM_HEIGHT)));
+    SetDrawingArea(set, area);
+  }
+  else if (kind < 4)
+  {
+    const u16 x = static_cast<u16>(RandomBelow(rng, VRAM_WIDTH) & ~0xFu);
+    const u16 y = static_cast<u16>(RandomBelow(rng, VRAM_HEIGHT));
+    const u16 width = static_cast<u16>((RandomBelow(rng, 256) + 16) & ~0xFu);
+    const u16 height = static_cast<u16>(RandomBelow(rng, 256) + 1);
+    const u32 color = rng();
+    set.Push([&](GPU_SW_Backend* backend) {
+      GPUBackendFillVRAMCommand* cmd = backend->NewFillVRAMCommand();
+      cmd->params.bits = 0;
+      cmd->x = x;
+      cmd->y = y;
+      cmd->width = width;
+      cmd->height = height;
+      cmd->color = color;
+      backend->PushCommand(cmd);
+    });
+  }
+  else if (kind < 6)
+  {
+    const u16 src_x = static_cast<u16>(RandomBelow(rng, VRAM_WIDTH));
+    const u16 src_y = static_cast<u16>(RandomBelow(rng, VRAM_HEIGHT));
+    const u16 dst_x = static_cast<u16>(RandomBelow(rng, VRAM_WIDTH));
+    const u16 dst_y = static_cast<u16>(RandomBelow(rng, VRAM_HEIGHT));
+    const u16 width = static_cast<u16>(RandomBelow(rng, 128) + 1);
+    const u16 height = static_cast<u16>(RandomBelow(rng, 128) + 1);
+    set.Push([&](GPU_SW_Backend* backend) {
+      GPUBackendCopyVRAMCommand* cmd = backend->NewCopyVRAMCommand();
+      cmd->params.bits = params.bits;
+      cmd->src_x = src_x;
+      cmd->src_y = src_y;
+      cmd->dst_x = dst_x;
+      cmd->dst_y = dst_y;
+      cmd->width = width;
+      cmd->height = height;
+      backend->PushCommand(cmd);
+    });
+  }
+  else if (kind < 60)
+  {
+    const bool quad = (RandomBelow(rng, 2) != 0);
+    const u32 num_vertices = quad ? 4 : 3;
+    GPURenderCommand rc{static_cast<u32>(rng())};
+    rc.primitive = GPUPrimitive::Polygon;
+    rc.quad_polygon = quad;
+
+    std::array<GPUBackendDrawPolygonCommand::Vertex, 4> vertices;
+    for (u32 i = 0; i < num_vertices; i++)
+    {
+      s32 x = random_position(origin_x);
+      if (RandomBelow(rng, 50) == 0)
+        x += RandomBelow(rng, 2) ? 1100 : -1100;
+
+      vertices[i].Set(x, random_position(origin_y), rng(), static_cast<u16>(rng()));
+    }
+
+    set.Push([&](GPU_SW_Backend* backend) {
+      GPUBackendDrawPolygonCommand* cmd = backend->NewDrawPolygonCommand(num_vertices);
+      SetDrawCommandState(cmd, params, rc, draw_mode, palette, window);
+      std::memcpy(cmd->vertices, vertices.data(), sizeof(vertices[0]) * num_vertices);
+      backend->PushCommand(cmd);
+    });
+  }
+  else if (kind < 85)
+  {
+    GPURenderCommand rc{static_cast<u32>(rng())};
+    rc.primitive = GPUPrimitive::Rectangle;
+
+    const s32 x = TruncateGPUVertexPosition(origin_x + static_cast<s32>(RandomBelow(rng, 100)) - 50);
+    const s32 y = TruncateGPUVertexPosition(origin_y + static_cast<s32>(RandomBelow(rng, 100)) - 50);
+    const u16 width = static_cast<u16>(RandomBelow(rng, 4) ? RandomBelow(rng, 64) : RandomBelow(rng, 1023));
+    const u16 height = static_cast<u16>(RandomBelow(rng, 4) ? RandomBelow(rng, 64) : RandomBelow(rng, 511));
+    const u16 texcoord = static_cast<u16>(rng());
+    const u32 color = rng() & 0xFFFFFFu;
+    set.Push([&](GPU_SW_Backend* backend) {
+      GPUBackendDrawRectangleCommand* cmd = backend->NewDrawRectangleCommand();
+      SetDrawCommandState(cmd, params, rc, draw_mode, palette, window);
+      cmd->x = x;
+      cmd->y = y;
+      cmd->width = width;
+      cmd->height = height;
+      cmd->texcoord = texcoord;
+      cmd->color = color;
+      backend->PushCommand(cmd);
+    });
+  }
+  else
+  {
+    const u32 num_vertices = RandomBelow(rng, 6) + 2;
+    GPURenderCommand rc{static_cast<u32>(rng())};
+    rc.primitive = GPUPrimitive::Line;
+
+    std::array<GPUBackendDrawLineCommand::Vertex, 8> vertices;
+    for (u32 i = 0; i < num_vertices; i++)
+    {
+      s32 x = random_position(origin_x);
+      if (RandomBelow(rng, 30) == 0)
+        x -= 1500;
+
+      vertices[i].Set(x, random_position(origin_y), rng());
+    }
+
+    set.Push([&](GPU_SW_Backend* backend) {
+      GPUBackendDrawLineCommand* cmd = backend->NewDrawLineCommand(num_vertices);
+      SetDrawCommandState(cmd, params, rc, draw_mode, palette, window);
+      std::memcpy(cmd->vertices, vertices.data(), sizeof(vertices[0]) * num_vertices);
+      backend->PushCommand(cmd);
+    });
+  }
+}
+
+TEST(GPU_SW_Backend, TileParallelMatchesSingleThreaded)
+{
+  static constexpr u32 NUM_COMMANDS = 20000;
+  static constexpr u32 COMPARE_INTERVAL = 1000;
+
+  BackendSet set;
+  set.Add(1);
+  set.Add(4);
+
+  std::mt19937 rng(42);
+  FillVRAMWithNoise(set, rng);
+
+  for (u32 i = 0; i < NUM_COMMANDS; i++)
+  {
+    PushRandomCommand(set, rng);
+    if ((i % COMPARE_INTERVAL) == (COMPARE_INTERVAL - 1))
+    {
+      ASSERT_TRUE(set.CompareVRAM()) << "VRAM differs after command " << i;
+    }
+  }
+}
+
+TEST(GPU_SW_Backend, VectorSpansMatchScalar)
+{
+  static constexpr u32 TRIANGLES_PER_STATE = 2;
+
+  BackendSet set;
+  set.Add(1, false);
+  set.Add(1, true);
+
+  std::mt19937 rng(1234);
+  FillVRAMWithNoise(set, rng);
+  SetDrawingArea(set, Common::Rectangle<u32>(0, 0, VRAM_WIDTH - 1, VRAM_HEIGHT - 1));
+
+  // Textures and CLUTs are read from the top-left of VRAM and drawn to the bottom-right, so that the spans don't
+  // sample from themselves and are eligible for the vector path.
+  for (u32 rc_flags = 0; rc_flags < 32; rc_flags++)
+  {
+    for (u32 draw_mode_bits = 0; draw_mode_bits < 32; draw_mode_bits++)
+    {
+      for (u32 mask_bits = 0; mask_bits < 4; mask_bits++)
+      {
+        for (u32 window_index = 0; window_index < 2; window_index++)
+        {
+          GPURenderCommand rc{0};
+          rc.primitive = GPUPrimitive::Polygon;
+          rc.shading_enable = (rc_flags & 1u) != 0;
+          rc.texture_enable = (rc_flags & 2u) != 0;
+          rc.raw_texture_enable = (rc_flags & 4u) != 0;
+          rc.transparency_enable = (rc_flags & 8u) != 0;
+
+          GPUDrawModeReg draw_mode{0};
+          draw_mode.transparency_mode = static_cast<GPUTransparencyMode>(draw_mode_bits & 3u);
+          draw_mode.texture_mode = static_cast<GPUTextureMode>((draw_mode_bits >> 2) & 3u);
+          draw_mode.dither_enable = (rc_flags & 16u) != 0;
+          draw_mode.texture_page_x_base = static_cast<u8>((draw_mode_bits >> 4) & 1u);
+
+          const GPUBackendCommandParameters params{static_cast<u8>(mask_bits << 2)};
+          const GPUTextureWindow window = (window_index == 0) ? GPUTextureWindow{0xFF, 0xFF, 0x00, 0x00} :
+                                                                GPUTextureWindow{0xE7, 0xF3, 0x08, 0x04};
+          const u16 palette = static_cast<u16>((RandomBelow(rng, 64) << 6) | RandomBelow(rng, 4));
+
+          for (u32 i = 0; i < TRIANGLES_PER_STATE; i++)
+          {
+            std::array<GPUBackendDrawPolygonCommand::Vertex, 3> vertices;
+            for (GPUBackendDrawPolygonCommand::Vertex& vertex : vertices)
+            {
+              vertex.Set(static_cast<s32>(512 + RandomBelow(rng, 512)), static_cast<s32>(256 + RandomBelow(rng, 256)),
+                         static_cast<u32>(rng()), static_cast<u16>(rng()));
+            }
+
+            set.Push([&](GPU_SW_Backend* backend) {
+              GPUBackendDrawPolygonCommand* cmd = backend->NewDrawPolygonCommand(3);
+              SetDrawCommandState(cmd, params, rc, draw_mode.bits, palette, window);
+              std::memcpy(cmd->vertices, vertices.data(), sizeof(vertices));
+              backend->PushCommand(cmd);
+            });
+          }
+
+          ASSERT_TRUE(set.CompareVRAM()) << "VRAM differs with rc flags " << rc_flags << ", draw mode "
+                                         << draw_mode.bits << ", mask bits " << mask_bits << ", window "
+                                         << window_index;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#include "core/cpu_core.h"
+#include "core/timing_event.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+struct EventRecorder
+{
+  std::vector<u32>* order;
+  u32 id;
+};
+} // namespace
+
+static void RecordEvent(void* param, TickCount ticks, TickCount ticks_late)
+{
+  const EventRecorder* recorder = static_cast<const EventRecorder*>(param);
+  recorder->order->push_back(recorder->id);
+}
+
+static void RunTicks(TickCount ticks)
+{
+  CPU::AddPendingTicks(ticks);
+  TimingEvents::RunEvents();
+}
+
+TEST(TimingEvents, SameTimeEventsRunInCreationOrder)
+{
+  static constexpr u32 NUM_EVENTS = 8;
+  static constexpr TickCount INTERVAL = 100;
+
+  TimingEvents::Initialize();
+
+  std::vector<u32> order;
+  std::array<EventRecorder, NUM_EVENTS> recorders;
+  std::array<std::unique_ptr<TimingEvent>, NUM_EVENTS> events;
+  for (u32 i = 0; i < NUM_EVENTS; i++)
+  {
+    recorders[i] = {&order, i};
+    events[i] = TimingEvents::CreateTimingEvent("Event", INTERVAL, INTERVAL, RecordEvent, &recorders[i], true);
+  }
+
+  // reschedule them in a scrambled order, so the heap's layout differs from the creation order
+  std::mt19937 rng(1);
+  for (u32 i = 0; i < 32; i++)
+    events[rng() % NUM_EVENTS]->Schedule(static_cast<TickCount>(rng() % (INTERVAL / 2)) + 1);
+  for (u32 i = NUM_EVENTS; i > 0; i--)
+    events[i - 1]->Schedule(INTERVAL);
+
+  for (u32 pass = 0; pass < 4; pass++)
+  {
+    order.clear();
+    RunTicks(INTERVAL);
+    ASSERT_EQ(order.size(), NUM_EVENTS) << "pass " << pass;
+    for (u32 i = 0; i < NUM_EVENTS; i++)
+      ASSERT_EQ(order[i], i) << "pass " << pass;
+  }
+
+  for (std::unique_ptr<TimingEvent>& event : events)
+    event.reset();
+  TimingEvents::Shutdown();
+}
@@ -7,9 +7,11 @@
 #include "dma.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "profiler.h"
 #include "settings.h"
 #include "spu.h"
 #include "system.h"
+#include <cinttypes>
 #include <cmath>
 Log_SetChannel(CDROM);
 
@@ -950,6 +952,7 @@ void CDROM::AbortCommand()
 
 void CDROM::ExecuteCommand(TickCount ticks_late)
 {
+  Profiler::ScopedSection profile(Profiler::Section::CDROM);
   const CommandInfo& ci = s_command_info[static_cast<u8>(m_command)];
   Log_DevPrintf("CDROM executing command 0x%02X (%s), stat = 0x%02X", static_cast<u8>(m_command), ci.name,
                 m_secondary_status.bits);
@@ -1626,6 +1629,7 @@ void CDROM::ExecuteTestCommand(u8 subcommand)
 
 void CDROM::ExecuteCommandSecondResponse(TickCount ticks_late)
 {
+  Profiler::ScopedSection profile(Profiler::Section::CDROM);
   switch (m_command_second_response)
   {
     case Command::GetID:
@@ -1675,6 +1679,7 @@ void CDROM::UpdateCommandEvent()
 
 void CDROM::ExecuteDrive(TickCount ticks_late)
 {
+  Profiler::ScopedSection profile(Profiler::Section::CDROM);
   switch (m_drive_state)
   {
     case DriveState::ShellOpening:
@@ -2753,6 +2758,13 @@ void CDROM::DrawDebugWindow()
       ImGui::Text("Disc Position: MSF[%02u:%02u:%02u] LBA[%u]", disc_position.minute, disc_position.second,
                   disc_position.frame, disc_position.ToLBA());
 
+      if (m_reader.IsUsingThread())
+      {
+        const CDROMAsyncReader::Stats stats = m_reader.GetStats();
+        ImGui::Text("Readahead: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " wasted of %" PRIu64 " reads",
+                    stats.hits, stats.misses, stats.wasted_reads, stats.reads);
+      }
+
       if (media->GetTrackNumber() > media->GetTrackCount())
       {
         ImGui::Text("Track Position: Lead-out");
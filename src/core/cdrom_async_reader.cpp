@@ -2,6 +2,8 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/timer.h"
+#include <algorithm>
+#include <cinttypes>
 Log_SetChannel(CDROMAsyncReader);
 
 CDROMAsyncReader::CDROMAsyncReader() = default;
@@ -16,13 +18,21 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
   if (IsUsingThread())
     StopThread();
 
-  m_buffers.clear();
-  m_buffers.resize(readahead_count);
-  EmptyBuffers();
+  m_max_depth = std::max<u32>(readahead_count, MIN_WINDOW_DEPTH);
+  for (Window& window : m_windows)
+  {
+    window = {};
+    window.buffers.resize(m_max_depth);
+  }
+  m_pending_window = INVALID_WINDOW;
+  m_read_pending = false;
+  m_seek_error = false;
+  m_buffered_count.store(0);
 
-  m_shutdown_flag.store(false);
+  m_shutdown_flag = false;
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
-  Log_InfoPrintf("Read thread started with readahead of %u sectors", readahead_count);
+  Log_InfoPrintf("Read thread started with readahead of up to %u sectors in %u windows", m_max_depth,
+                 static_cast<u32>(MAX_WINDOWS));
 }
 
 void CDROMAsyncReader::StopThread()
@@ -31,14 +41,26 @@ void CDROMAsyncReader::StopThread()
     return;
 
   {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    m_shutdown_flag.store(true);
+    std::unique_lock lock(m_mutex);
+    m_shutdown_flag = true;
     m_do_read_cv.notify_one();
   }
 
   m_read_thread.join();
-  EmptyBuffers();
-  m_buffers.clear();
+  LogStats();
+
+  // the last sector read is kept in m_current, so the non-threaded path can carry on from it
+  if (m_read_pending)
+  {
+    m_read_pending = false;
+    ReadSectorNonThreaded(m_pending_lba);
+  }
+
+  for (Window& window : m_windows)
+    window = {};
+  m_pending_window = INVALID_WINDOW;
+  m_buffered_count.store(0);
+  m_max_depth = 0;
 }
 
 void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
@@ -47,13 +69,19 @@ void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
     CancelReadahead();
 
   m_media = std::move(media);
+  m_current_valid = false;
 }
 
 std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
 {
   if (IsUsingThread())
+  {
     CancelReadahead();
+    LogStats();
+    ResetStats();
+  }
 
+  m_current_valid = false;
   return std::move(m_media);
 }
 
@@ -65,37 +93,97 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     return;
   }
 
-  const u32 buffer_count = m_buffer_count.load();
-  if (buffer_count > 0)
+  // don't re-read the same sector if it was the last one we read
+  // the CDC code does this when seeking->reading
+  if (m_read_pending ? (m_pending_lba == lba) : (m_current_valid && m_current.lba == lba))
+  {
+    Log_DebugPrintf("Skipping re-reading same sector %u", lba);
+    return;
+  }
+
+  std::unique_lock lock(m_mutex);
+  m_seek_error = false;
+
+  // is the sector already buffered in one of the windows?
+  for (u32 i = 0; i < MAX_WINDOWS; i++)
+  {
+    Window& window = m_windows[i];
+    if (!window.active || window.count == 0 || lba >= window.next_lba || lba < (window.next_lba - window.count))
+      continue;
+
+    // great, don't need a seek, but still kick the thread to top the window back up
+    const u32 skipped = window.count - (window.next_lba - lba);
+    if (skipped > 0)
+    {
+      // sectors were skipped over, so we're reading ahead further than needed
+      DiscardSectors(window, skipped);
+      window.depth = std::max<u32>(window.depth - 1, MIN_WINDOW_DEPTH);
+    }
+
+    Log_DebugPrintf("Readahead buffer hit for sector %u in window %u", lba, i);
+    window.last_used = ++m_window_use_counter;
+    PopSector(window);
+    m_pending_window = INVALID_WINDOW;
+    m_read_pending = false;
+    m_stats.hits++;
+    m_do_read_cv.notify_one();
+    return;
+  }
+
+  m_stats.misses++;
+
+  // is it the next sector of a window which is still reading?
+  Window* window = nullptr;
+  for (Window& it : m_windows)
   {
-    // don't re-read the same sector if it was the last one we read
-    // the CDC code does this when seeking->reading
-    const u32 buffer_front = m_buffer_front.load();
-    if (m_buffers[buffer_front].lba == lba)
+    if (it.active && it.next_lba == lba)
     {
-      Log_DebugPrintf("Skipping re-reading same sector %u", lba);
-      return;
+      window = &it;
+      break;
     }
+  }
 
-    // did we readahead to the correct sector?
-    const u32 next_buffer = (buffer_front + 1) % static_cast<u32>(m_buffers.size());
-    if (m_buffer_count > 1 && m_buffers[next_buffer].lba == lba)
+  if (window)
+  {
+    if (window->count == 0)
+    {
+      // the reads couldn't keep up with the requests, so buffer further ahead
+      window->depth = std::min(window->depth * 2, m_max_depth);
+      Log_DebugPrintf("Readahead buffer underrun for sector %u, increasing depth to %u", lba, window->depth);
+    }
+    else
     {
-      // great, don't need a seek, but still kick the thread to start reading ahead again
-      Log_DebugPrintf("Readahead buffer hit for sector %u", lba);
-      m_buffer_front.store(next_buffer);
-      m_buffer_count.fetch_sub(1);
-      m_can_readahead.store(true);
-      m_do_read_cv.notify_one();
-      return;
+      Log_DebugPrintf("Readahead buffer skipped %u sectors to %u, decreasing depth", window->count, lba);
+      DiscardSectors(*window, window->count);
+      window->depth = std::max<u32>(window->depth / 2, MIN_WINDOW_DEPTH);
+    }
+  }
+  else
+  {
+    // we need to start a new stream, replace the least recently used one
+    window = &m_windows[0];
+    for (Window& it : m_windows)
+    {
+      if (!it.active)
+      {
+        window = &it;
+        break;
+      }
+      else if (it.last_used < window->last_used)
+      {
+        window = &it;
+      }
     }
+
+    Log_DebugPrintf("Readahead buffer miss, queueing seek to %u in window %u", lba,
+                    static_cast<u32>(window - m_windows.data()));
+    ResetWindow(*window, lba);
   }
 
-  // we need to toss away our readahead and start fresh
-  Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_next_position_set.store(true);
-  m_next_position = lba;
+  window->last_used = ++m_window_use_counter;
+  m_pending_window = static_cast<u32>(window - m_windows.data());
+  m_pending_lba = lba;
+  m_read_pending = true;
   m_do_read_cv.notify_one();
 }
 
@@ -107,18 +195,10 @@ bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ
   std::unique_lock lock(m_mutex);
 
   // wait until the read thread is idle
-  m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading.load(); });
-
-  // read while the lock is held so it has to wait
-  const CDImage::LBA prev_lba = m_media->GetPositionOnDisc();
-  const bool result = InternalReadSectorUncached(lba, subq, data);
-  if (!m_media->Seek(prev_lba))
-  {
-    Log_ErrorPrintf("Failed to re-seek to cached position %u", prev_lba);
-    m_can_readahead.store(false);
-  }
+  m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading; });
 
-  return result;
+  // read while the lock is held so it has to wait, it'll seek back to the window position itself
+  return InternalReadSectorUncached(lba, subq, data);
 }
 
 bool CDROMAsyncReader::InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
@@ -140,32 +220,38 @@ bool CDROMAsyncReader::InternalReadSectorUncached(CDImage::LBA lba, CDImage::Sub
 
 bool CDROMAsyncReader::WaitForReadToComplete()
 {
-  // Safe without locking with memory_order_seq_cst.
-  if (!m_next_position_set.load() && m_buffer_count.load() > 0)
+  // Only the CPU thread touches the current sector, so this doesn't need the lock.
+  if (!m_read_pending)
   {
-    Log_TracePrintf("Returning sector %u", m_buffers[m_buffer_front.load()].lba);
-    return m_buffers[m_buffer_front.load()].result;
+    Log_TracePrintf("Returning sector %u", m_current.lba);
+    return m_current.result;
   }
 
   Common::Timer wait_timer;
   Log_DebugPrintf("Sector read pending, waiting");
 
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_notify_read_complete_cv.wait(
-    lock, [this]() { return (m_buffer_count.load() > 0 || m_seek_error.load()) && !m_next_position_set.load(); });
-  if (m_seek_error.load())
+  std::unique_lock lock(m_mutex);
+  Window& window = m_windows[m_pending_window];
+  m_notify_read_complete_cv.wait(lock, [this, &window]() { return (window.count > 0 || m_seek_error); });
+  m_pending_window = INVALID_WINDOW;
+  m_read_pending = false;
+
+  const double wait_time = wait_timer.GetTimeMilliseconds();
+  m_stats.wait_time_ms += wait_time;
+
+  if (m_seek_error)
   {
-    m_seek_error.store(false);
+    m_seek_error = false;
+    m_current_valid = false;
     return false;
   }
 
-  const u32 front = m_buffer_front.load();
-  const double wait_time = wait_timer.GetTimeMilliseconds();
+  PopSector(window);
   if (wait_time > 1.0f)
-    Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_buffers[front].lba);
+    Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_current.lba);
 
-  Log_TracePrintf("Returning sector %u after waiting", m_buffers[front].lba);
-  return m_buffers[front].result;
+  Log_TracePrintf("Returning sector %u after waiting", m_current.lba);
+  return m_current.result;
 }
 
 void CDROMAsyncReader::WaitForIdle()
@@ -173,83 +259,161 @@ void CDROMAsyncReader::WaitForIdle()
   if (!IsUsingThread())
     return;
 
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_notify_read_complete_cv.wait(lock, [this]() { return (!m_is_reading.load() && !m_next_position_set.load()); });
+  std::unique_lock lock(m_mutex);
+  m_notify_read_complete_cv.wait(lock, [this]() {
+    return (!m_is_reading &&
+            (m_pending_window == INVALID_WINDOW || m_windows[m_pending_window].count > 0 || m_seek_error));
+  });
 }
 
-void CDROMAsyncReader::EmptyBuffers()
+CDROMAsyncReader::Stats CDROMAsyncReader::GetStats()
 {
-  m_buffer_front.store(0);
-  m_buffer_back.store(0);
-  m_buffer_count.store(0);
+  std::unique_lock lock(m_mutex);
+  return m_stats;
 }
 
-bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
+void CDROMAsyncReader::ResetStats()
 {
-  Common::Timer timer;
+  std::unique_lock lock(m_mutex);
+  m_stats = {};
+}
+
+void CDROMAsyncReader::LogStats()
+{
+  const Stats stats = GetStats();
+  const u64 requests = stats.hits + stats.misses;
+  if (requests == 0)
+    return;
+
+  Log_DevPrintf("Readahead: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate), %" PRIu64 " wasted of %" PRIu64
+                " reads, %.2f msec reading, %.2f msec waiting",
+                stats.hits, stats.misses, static_cast<double>(stats.hits) * 100.0 / static_cast<double>(requests),
+                stats.wasted_reads, stats.reads, stats.read_time_ms, stats.wait_time_ms);
+}
+
+void CDROMAsyncReader::ResetWindow(Window& window, CDImage::LBA lba)
+{
+  DiscardSectors(window, window.count);
+  window.front = 0;
+  window.depth = std::min<u32>(INITIAL_WINDOW_DEPTH, m_max_depth);
+  window.generation++;
+  window.next_lba = lba;
+  window.active = true;
+}
+
+void CDROMAsyncReader::DiscardSectors(Window& window, u32 count)
+{
+  DebugAssert(count <= window.count);
+  window.front = (window.front + count) % static_cast<u32>(window.buffers.size());
+  window.count -= count;
+  m_buffered_count.fetch_sub(count);
+  m_stats.wasted_reads += count;
+}
+
+void CDROMAsyncReader::PopSector(Window& window)
+{
+  DebugAssert(window.count > 0);
+  m_current = window.buffers[window.front];
+  m_current_valid = true;
+  window.front = (window.front + 1) % static_cast<u32>(window.buffers.size());
+  window.count--;
+  m_buffered_count.fetch_sub(1);
+}
 
-  const u32 slot = m_buffer_back.load();
-  m_buffer_back.store((slot + 1) % static_cast<u32>(m_buffers.size()));
+CDROMAsyncReader::Window* CDROMAsyncReader::GetWindowToRead()
+{
+  // the most recently used window is the one being read from, or waited on, so it takes priority
+  Window* best = nullptr;
+  for (Window& window : m_windows)
+  {
+    if (window.active && window.count < window.depth && (!best || window.last_used > best->last_used))
+      best = &window;
+  }
+
+  return best;
+}
 
-  BufferSlot& buffer = m_buffers[slot];
-  buffer.lba = m_media->GetPositionOnDisc();
-  m_is_reading.store(true);
+void CDROMAsyncReader::ReadSectorIntoWindow(Window& window, std::unique_lock<std::mutex>& lock)
+{
+  const CDImage::LBA lba = window.next_lba;
+  const u32 generation = window.generation;
+  m_is_reading = true;
   lock.unlock();
 
-  Log_TracePrintf("Reading LBA %u...", buffer.lba);
+  // seek and read without the lock held in case it takes time
+  Common::Timer timer;
+  BufferSlot slot;
+  slot.lba = lba;
+  const bool seek_result = (m_media->GetPositionOnDisc() == lba || m_media->Seek(lba));
+  if (seek_result)
+  {
+    Log_TracePrintf("Reading LBA %u...", lba);
+    slot.result = m_media->ReadRawSector(slot.data.data(), &slot.subq);
+    if (!slot.result)
+      Log_ErrorPrintf("Read of LBA %u failed", lba);
+  }
+
+  const double read_time = timer.GetTimeMilliseconds();
+  if (read_time > 1.0f)
+    Log_DevPrintf("Read LBA %u took %.2f msec", lba, read_time);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
-  if (buffer.result)
+  lock.lock();
+  m_is_reading = false;
+  m_stats.reads++;
+  m_stats.read_time_ms += read_time;
+
+  // was the window moved elsewhere while we were reading?
+  if (window.generation != generation)
   {
-    const double read_time = timer.GetTimeMilliseconds();
-    if (read_time > 1.0f)
-      Log_DevPrintf("Read LBA %u took %.2f msec", buffer.lba, read_time);
+    m_stats.wasted_reads++;
+  }
+  else if (!seek_result)
+  {
+    // add the error result if it's being waited on, and don't try to read ahead
+    Log_WarningPrintf("Seek to LBA %u failed", lba);
+    window.active = false;
+    if (m_pending_window != INVALID_WINDOW && &m_windows[m_pending_window] == &window)
+      m_seek_error = true;
   }
   else
   {
-    Log_ErrorPrintf("Read of LBA %u failed", buffer.lba);
+    window.buffers[(window.front + window.count) % static_cast<u32>(window.buffers.size())] = slot;
+    window.count++;
+    window.next_lba++;
+    m_buffered_count.fetch_add(1);
   }
 
-  lock.lock();
-  m_is_reading.store(false);
-  m_buffer_count.fetch_add(1);
   m_notify_read_complete_cv.notify_all();
-  return true;
 }
 
 void CDROMAsyncReader::ReadSectorNonThreaded(CDImage::LBA lba)
 {
   Common::Timer timer;
 
-  m_buffers.resize(1);
-  m_seek_error.store(false);
-  EmptyBuffers();
-
+  m_current.lba = lba;
+  m_current_valid = false;
   if (m_media->GetPositionOnDisc() != lba && !m_media->Seek(lba))
   {
     Log_WarningPrintf("Seek to LBA %u failed", lba);
-    m_seek_error.store(true);
+    m_current.result = false;
     return;
   }
 
-  BufferSlot& buffer = m_buffers.front();
-  buffer.lba = m_media->GetPositionOnDisc();
-
-  Log_TracePrintf("Reading LBA %u...", buffer.lba);
+  Log_TracePrintf("Reading LBA %u...", lba);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
-  if (buffer.result)
+  m_current.result = m_media->ReadRawSector(m_current.data.data(), &m_current.subq);
+  if (m_current.result)
   {
     const double read_time = timer.GetTimeMilliseconds();
     if (read_time > 1.0f)
-      Log_DevPrintf("Read LBA %u took %.2f msec", buffer.lba, read_time);
+      Log_DevPrintf("Read LBA %u took %.2f msec", lba, read_time);
   }
   else
   {
-    Log_ErrorPrintf("Read of LBA %u failed", buffer.lba);
+    Log_ErrorPrintf("Read of LBA %u failed", lba);
   }
 
-  m_buffer_count.fetch_add(1);
+  m_current_valid = true;
 }
 
 void CDROMAsyncReader::CancelReadahead()
@@ -259,82 +423,38 @@ void CDROMAsyncReader::CancelReadahead()
   std::unique_lock lock(m_mutex);
 
   // wait until the read thread is idle
-  m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading.load(); });
+  m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading; });
 
   // prevent it from doing any more when it re-acquires the lock
-  m_can_readahead.store(false);
-  EmptyBuffers();
+  for (Window& window : m_windows)
+  {
+    window.front = 0;
+    window.count = 0;
+    window.generation++;
+    window.active = false;
+  }
+
+  m_pending_window = INVALID_WINDOW;
+  m_read_pending = false;
+  m_current_valid = false;
+  m_seek_error = false;
+  m_buffered_count.store(0);
 }
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
   std::unique_lock lock(m_mutex);
 
-  for (;;)
+  while (!m_shutdown_flag)
   {
-    m_do_read_cv.wait(
-      lock, [this]() { return (m_shutdown_flag.load() || m_next_position_set.load() || m_can_readahead.load()); });
-    if (m_shutdown_flag.load())
-      break;
-
-    for (;;)
+    // top up the most recently used window which isn't full, or sleep until a request comes in
+    Window* window = GetWindowToRead();
+    if (!window)
     {
-      if (m_next_position_set.load())
-      {
-        // discard buffers, we're seeking to a new location
-        const CDImage::LBA seek_location = m_next_position.load();
-        EmptyBuffers();
-        m_next_position_set.store(false);
-        m_seek_error.store(false);
-        m_is_reading.store(true);
-        lock.unlock();
-
-        // seek without lock held in case it takes time
-        Log_DebugPrintf("Seeking to LBA %u...", seek_location);
-        const bool seek_result = (m_media->GetPositionOnDisc() == seek_location || m_media->Seek(seek_location));
-
-        lock.lock();
-        m_is_reading.store(false);
-
-        // did another request come in? abort if so
-        if (m_next_position_set.load())
-          continue;
-
-        // did we fail the seek?
-        if (!seek_result)
-        {
-          // add the error result, and don't try to read ahead
-          Log_WarningPrintf("Seek to LBA %u failed", seek_location);
-          m_seek_error.store(true);
-          m_notify_read_complete_cv.notify_all();
-          break;
-        }
-
-        // go go read ahead!
-        m_can_readahead.store(true);
-      }
-
-      if (!m_can_readahead.load())
-        break;
-
-      // readahead time! read as many sectors as we have space for
-      Log_DebugPrintf("Reading ahead %u sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
-      {
-        if (m_next_position_set.load())
-        {
-          // a seek request came in while we're reading, so bail out
-          break;
-        }
-
-        // stop reading if we hit the end or get an error
-        if (!ReadSectorIntoBuffer(lock))
-          break;
-      }
-
-      // readahead buffer is full or errored at this point
-      m_can_readahead.store(false);
-      break;
+      m_do_read_cv.wait(lock);
+      continue;
     }
+
+    ReadSectorIntoWindow(*window, lock);
   }
 }
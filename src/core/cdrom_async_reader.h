@@ -4,7 +4,9 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 class CDROMAsyncReader
 {
@@ -19,15 +21,26 @@ public:
     bool result;
   };
 
+  /// Counters for tuning readahead against the backing store.
+  struct Stats
+  {
+    u64 hits;            // sectors which were already buffered when requested
+    u64 misses;          // sectors which had to be waited for
+    u64 wasted_reads;    // sectors which were read ahead, but thrown away before being requested
+    u64 reads;           // sectors read from the image by the read thread
+    double read_time_ms; // total time spent reading from the image
+    double wait_time_ms; // total time spent waiting for misses
+  };
+
   CDROMAsyncReader();
   ~CDROMAsyncReader();
 
-  const CDImage::LBA GetLastReadSector() const { return m_buffers[m_buffer_front.load()].lba; }
-  const SectorBuffer& GetSectorBuffer() const { return m_buffers[m_buffer_front.load()].data; }
-  const CDImage::SubChannelQ& GetSectorSubQ() const { return m_buffers[m_buffer_front.load()].subq; }
-  const u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
-  const bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
-  const u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  const CDImage::LBA GetLastReadSector() const { return m_current.lba; }
+  const SectorBuffer& GetSectorBuffer() const { return m_current.data; }
+  const CDImage::SubChannelQ& GetSectorSubQ() const { return m_current.subq; }
+  const u32 GetBufferedSectorCount() const { return m_buffered_count.load(); }
+  const bool HasBufferedSectors() const { return (m_buffered_count.load() > 0); }
+  const u32 GetReadaheadCount() const { return m_max_depth; }
 
   const bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
@@ -48,12 +61,42 @@ public:
   /// Bypasses the sector cache and reads directly from the image.
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
+  Stats GetStats();
+  void ResetStats();
+
 private:
-  void EmptyBuffers();
-  bool ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock);
+  enum : u32
+  {
+    // Games which stream from more than one place at once (e.g. XA audio and data) get a window each.
+    MAX_WINDOWS = 4,
+    MIN_WINDOW_DEPTH = 2,
+    INITIAL_WINDOW_DEPTH = 4,
+    INVALID_WINDOW = 0xFFFFFFFFu
+  };
+
+  /// A run of sectors read ahead from one position on the disc. The depth is how many sectors it tries to keep
+  /// buffered, which grows when requests have to wait for it, and shrinks when buffered sectors go unused.
+  struct Window
+  {
+    std::vector<BufferSlot> buffers;
+    u32 front;
+    u32 count;
+    u32 depth;
+    u32 generation;
+    u64 last_used;
+    CDImage::LBA next_lba;
+    bool active;
+  };
+
+  void ResetWindow(Window& window, CDImage::LBA lba);
+  void DiscardSectors(Window& window, u32 count);
+  void PopSector(Window& window);
+  Window* GetWindowToRead();
+  void ReadSectorIntoWindow(Window& window, std::unique_lock<std::mutex>& lock);
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
   void CancelReadahead();
+  void LogStats();
 
   void WorkerThreadEntryPoint();
 
@@ -64,16 +107,21 @@ private:
   std::condition_variable m_do_read_cv;
   std::condition_variable m_notify_read_complete_cv;
 
-  std::atomic<CDImage::LBA> m_next_position{};
-  std::atomic_bool m_next_position_set{false};
-  std::atomic_bool m_shutdown_flag{true};
-
-  std::atomic_bool m_is_reading{false};
-  std::atomic_bool m_can_readahead{false};
-  std::atomic_bool m_seek_error{false};
-
-  std::vector<BufferSlot> m_buffers;
-  std::atomic<u32> m_buffer_front{0};
-  std::atomic<u32> m_buffer_back{0};
-  std::atomic<u32> m_buffer_count{0};
+  // only accessed by the CPU thread
+  BufferSlot m_current = {};
+  bool m_current_valid = false;
+  bool m_read_pending = false;
+
+  // protected by the mutex
+  std::array<Window, MAX_WINDOWS> m_windows = {};
+  u32 m_pending_window = INVALID_WINDOW;
+  CDImage::LBA m_pending_lba = 0;
+  u64 m_window_use_counter = 0;
+  u32 m_max_depth = 0;
+  bool m_shutdown_flag = true;
+  bool m_is_reading = false;
+  bool m_seek_error = false;
+  Stats m_stats = {};
+
+  std::atomic<u32> m_buffered_count{0};
 };
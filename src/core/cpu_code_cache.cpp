@@ -1,13 +1,19 @@
 #include "cpu_code_cache.h"
 #include "bus.h"
 #include "common/assert.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/flat_hash_map.h"
 #include "common/log.h"
+#include "common/timer.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "settings.h"
 #include "system.h"
+#include "imgui.h"
 #include "timing_event.h"
+#include <unordered_set>
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -23,6 +29,21 @@ static constexpr u32 RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER = 100;
 static constexpr u32 RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER = 20;
 static constexpr u32 INVALIDATE_THRESHOLD_TO_DISABLE_LINKING = 10;
 
+// Baseline tier blocks are interpreted until they have been entered this many times, then compiled to host code.
+static constexpr u32 TIER_UP_EXECUTION_THRESHOLD = 256;
+
+// Persistent block cache file format and limits.
+static constexpr u32 BLOCK_CACHE_SIGNATURE = 0x43424B44; // DKBC
+static constexpr u32 BLOCK_CACHE_VERSION = 1;
+static constexpr u32 BLOCK_CACHE_MAX_BLOCKS = 65536;
+static constexpr u32 BLOCK_CACHE_MAX_BLOCK_INSTRUCTIONS = 4096;
+
+// Number of instruction words compared against memory per frame when looking for cached blocks to precompile.
+static constexpr u32 BLOCK_CACHE_VALIDATE_WORDS_PER_FRAME = 65536;
+
+// Cached blocks which haven't matched memory in this many sessions are dropped from the file.
+static constexpr u32 BLOCK_CACHE_MAX_UNSEEN_SESSIONS = 8;
+
 #ifdef WITH_RECOMPILER
 
 // Currently remapping the code buffer doesn't work in macOS or Haiku.
@@ -80,6 +101,7 @@ static CodeBlock::HostCodePointer* OffsetFastMapPointer(FastMapTable fake_ptr, u
 
 static void CompileDispatcher();
 static void FastCompileBlockFunction();
+static void InterpretBaselineBlock(CodeBlock& block);
 static void InvalidCodeFunction();
 
 static constexpr u32 GetTableCount(u32 start, u32 end)
@@ -186,8 +208,81 @@ static void SetFastMap(u32 pc, CodeBlock::HostCodePointer function)
 
 #endif
 
-using BlockMap = std::unordered_map<u32, CodeBlock*>;
-using HostCodeMap = std::map<CodeBlock::HostCodePointer, CodeBlock*>;
+// Block keys never have bit 1 set, so all ones can be used as the empty key.
+using BlockMap = FlatHashMap<u32, CodeBlock*, 0xFFFFFFFFu>;
+
+/// Host code start address -> block, for finding the block which contains a faulting instruction.
+/// Host code is allocated linearly from the code buffer, so insertions are almost always appends. Removed entries are
+/// left as tombstones and compacted in bulk, since blocks are removed from the middle on every recompile.
+class HostCodeMap
+{
+public:
+  void Insert(CodeBlock::HostCodePointer code, CodeBlock* block)
+  {
+    if (m_entries.empty() || m_entries.back().first < code)
+    {
+      m_entries.emplace_back(code, block);
+      return;
+    }
+
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), code,
+                                 [](const Entry& lhs, CodeBlock::HostCodePointer rhs) { return lhs.first < rhs; });
+    if (iter != m_entries.end() && iter->first == code)
+    {
+      Assert(!iter->second);
+      iter->second = block;
+      m_tombstones--;
+      return;
+    }
+
+    m_entries.emplace(iter, code, block);
+  }
+
+  void Remove(CodeBlock::HostCodePointer code)
+  {
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), code,
+                                 [](const Entry& lhs, CodeBlock::HostCodePointer rhs) { return lhs.first < rhs; });
+    Assert(iter != m_entries.end() && iter->first == code && iter->second);
+    iter->second = nullptr;
+    m_tombstones++;
+
+    if (m_tombstones > COMPACT_THRESHOLD && m_tombstones > (m_entries.size() / 2))
+    {
+      m_entries.erase(
+        std::remove_if(m_entries.begin(), m_entries.end(), [](const Entry& entry) { return !entry.second; }),
+        m_entries.end());
+      m_tombstones = 0;
+    }
+  }
+
+  /// Returns the block with the highest start address which is not greater than code, or null.
+  CodeBlock* Lookup(const void* code) const
+  {
+    auto iter = std::upper_bound(m_entries.begin(), m_entries.end(), code,
+                                 [](const void* lhs, const Entry& rhs) {
+                                   return lhs < reinterpret_cast<const void*>(rhs.first);
+                                 });
+    if (iter == m_entries.begin())
+      return nullptr;
+
+    --iter;
+    return iter->second;
+  }
+
+  void Clear()
+  {
+    m_entries.clear();
+    m_tombstones = 0;
+  }
+
+private:
+  using Entry = std::pair<CodeBlock::HostCodePointer, CodeBlock*>;
+
+  static constexpr size_t COMPACT_THRESHOLD = 64;
+
+  std::vector<Entry> m_entries;
+  size_t m_tombstones = 0;
+};
 
 void LogCurrentState();
 
@@ -202,6 +297,8 @@ static CodeBlock* LookupBlock(CodeBlockKey key);
 static bool RevalidateBlock(CodeBlock* block);
 
 static bool CompileBlock(CodeBlock* block);
+static bool CompileBlockHostCode(CodeBlock* block);
+static void UpdateBlockICacheInfo(CodeBlock* block);
 static void RemoveReferencesToBlock(CodeBlock* block);
 static void AddBlockToPageMap(CodeBlock* block);
 static void RemoveBlockFromPageMap(CodeBlock* block);
@@ -214,12 +311,51 @@ static void UnlinkBlock(CodeBlock* block);
 
 static void ClearState();
 
+/// Blocks are recycled rather than deleted, since they're frequently freed and allocated again when code is flushed.
+static CodeBlock* AllocateBlock(CodeBlockKey key);
+static void FreeBlock(CodeBlock* block);
+static void DestroyBlockPool();
+
+struct CachedBlock
+{
+  CodeBlockKey key;
+  u32 unseen_sessions;
+  std::vector<CodeBlockInstruction> instructions;
+};
+
+static void PrecompileCachedBlocks();
+static bool ValidateCachedBlock(const CachedBlock& cb);
+static bool PrecompileCachedBlock(CachedBlock& cb);
+static void RetireBlocksToBlockCache();
+
+static CodeBlockTier GetInitialBlockTier();
+
+struct TierStats
+{
+  // Baseline blocks aren't compiled, they're interpreted until they tier up.
+  u32 baseline_blocks_created;
+  u32 optimized_compiles;
+  double optimized_compile_time_ms;
+};
+
 static BlockMap s_blocks;
 static std::array<std::vector<CodeBlock*>, Bus::RAM_8MB_CODE_PAGE_COUNT> m_ram_block_map;
+static std::vector<CodeBlock*> s_free_blocks;
+
+static std::string s_block_cache_path;
+static std::vector<CachedBlock> s_block_cache_pending;
+static std::unordered_map<u32, CachedBlock> s_block_cache_retired;
+static size_t s_block_cache_position = 0;
+static BlockCacheStats s_block_cache_stats = {};
+
+static TierStats s_tier_stats = {};
+static u32 s_tier_up_count = 0;
 
 #ifdef WITH_RECOMPILER
 static HostCodeMap s_host_code_map;
 
+static bool RecompileBlockOptimized(CodeBlock* block);
+
 static void AddBlockToHostCodeMap(CodeBlock* block);
 static void RemoveBlockFromHostCodeMap(CodeBlock* block);
 
@@ -264,16 +400,22 @@ void Initialize()
 
 void ClearState()
 {
+  if (!s_block_cache_path.empty())
+    RetireBlocksToBlockCache();
+
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
 
   for (const auto& it : s_blocks)
-    delete it.second;
+  {
+    if (it.second)
+      FreeBlock(it.second);
+  }
 
   s_blocks.clear();
 #ifdef WITH_RECOMPILER
-  s_host_code_map.clear();
+  s_host_code_map.Clear();
   s_code_buffer.Reset();
   ResetFastMap();
 #endif
@@ -281,7 +423,23 @@ void ClearState()
 
 void Shutdown()
 {
+  if (s_tier_stats.baseline_blocks_created > 0 || s_tier_stats.optimized_compiles > 0)
+  {
+    Log_InfoPrintf("Created %u interpreted baseline blocks, compiled %u optimized blocks in %.2f ms, %u tier-ups",
+                   s_tier_stats.baseline_blocks_created, s_tier_stats.optimized_compiles,
+                   s_tier_stats.optimized_compile_time_ms, s_tier_up_count);
+  }
+
+  if (!s_block_cache_path.empty())
+  {
+    SaveBlockCache();
+    s_block_cache_path.clear();
+    s_block_cache_pending.clear();
+    s_block_cache_retired.clear();
+  }
+
   ClearState();
+  DestroyBlockPool();
 #ifdef WITH_RECOMPILER
   ShutdownFastmem();
   FreeFastMap();
@@ -289,6 +447,51 @@ void Shutdown()
 #endif
 }
 
+CodeBlock* AllocateBlock(CodeBlockKey key)
+{
+  if (s_free_blocks.empty())
+    return new CodeBlock(key);
+
+  CodeBlock* block = s_free_blocks.back();
+  s_free_blocks.pop_back();
+
+  // keep the storage from the vectors, the contents were cleared when the block was freed
+  std::vector<CodeBlockInstruction> instructions = std::move(block->instructions);
+  std::vector<CodeBlock::LinkInfo> link_predecessors = std::move(block->link_predecessors);
+  std::vector<CodeBlock::LinkInfo> link_successors = std::move(block->link_successors);
+#ifdef WITH_RECOMPILER
+  std::vector<Recompiler::LoadStoreBackpatchInfo> loadstore_backpatch_info =
+    std::move(block->loadstore_backpatch_info);
+#endif
+
+  *block = CodeBlock(key);
+  block->instructions = std::move(instructions);
+  block->link_predecessors = std::move(link_predecessors);
+  block->link_successors = std::move(link_successors);
+#ifdef WITH_RECOMPILER
+  block->loadstore_backpatch_info = std::move(loadstore_backpatch_info);
+#endif
+  return block;
+}
+
+void FreeBlock(CodeBlock* block)
+{
+  block->instructions.clear();
+  block->link_predecessors.clear();
+  block->link_successors.clear();
+#ifdef WITH_RECOMPILER
+  block->loadstore_backpatch_info.clear();
+#endif
+  s_free_blocks.push_back(block);
+}
+
+void DestroyBlockPool()
+{
+  for (CodeBlock* block : s_free_blocks)
+    delete block;
+  s_free_blocks = {};
+}
+
 template<PGXPMode pgxp_mode>
 static void ExecuteImpl()
 {
@@ -297,6 +500,9 @@ static void ExecuteImpl()
   g_using_interpreter = false;
   g_state.frame_done = false;
 
+  if (!s_block_cache_pending.empty())
+    PrecompileCachedBlocks();
+
   while (!g_state.frame_done)
   {
     if (HasPendingInterrupt())
@@ -432,6 +638,9 @@ void ExecuteRecompiler()
   g_using_interpreter = false;
   g_state.frame_done = false;
 
+  if (!s_block_cache_pending.empty())
+    PrecompileCachedBlocks();
+
 #if 0
   while (!g_state.frame_done)
   {
@@ -534,7 +743,7 @@ static void FallbackExistingBlockToInterpreter(CodeBlock* block)
 {
   // Replace with null so we don't try to compile it again.
   s_blocks.emplace(block->key.bits, nullptr);
-  delete block;
+  FreeBlock(block);
 }
 
 CodeBlock* LookupBlock(CodeBlockKey key)
@@ -554,8 +763,11 @@ CodeBlock* LookupBlock(CodeBlockKey key)
       return nullptr;
   }
 
-  CodeBlock* block = new CodeBlock(key);
+  CodeBlock* block = AllocateBlock(key);
   block->recompile_frame_number = System::GetFrameNumber();
+  block->tier = GetInitialBlockTier();
+  if (!s_block_cache_path.empty())
+    s_block_cache_stats.misses++;
 
   if (CompileBlock(block))
   {
@@ -570,7 +782,7 @@ CodeBlock* LookupBlock(CodeBlockKey key)
   else
   {
     Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
-    delete block;
+    FreeBlock(block);
     block = nullptr;
   }
 
@@ -668,13 +880,6 @@ bool CompileBlock(CodeBlock* block)
     __debugbreak();
 #endif
 
-  block->icache_line_count = 0;
-  block->uncached_fetch_ticks = 0;
-  block->contains_double_branches = false;
-  block->contains_loadstore_instructions = false;
-
-  u32 last_cache_line = ICACHE_LINES;
-
   for (;;)
   {
     CodeBlockInstruction cbi = {};
@@ -693,20 +898,6 @@ bool CompileBlock(CodeBlock* block)
     cbi.can_trap = CanInstructionTrap(cbi.instruction, InUserMode());
     cbi.is_direct_branch_instruction = IsDirectBranchInstruction(cbi.instruction);
 
-    if (g_settings.cpu_recompiler_icache)
-    {
-      const u32 icache_line = GetICacheLine(pc);
-      if (icache_line != last_cache_line)
-      {
-        block->icache_line_count++;
-        last_cache_line = icache_line;
-      }
-      block->uncached_fetch_ticks += GetInstructionReadTicks(pc);
-    }
-
-    block->contains_loadstore_instructions |= cbi.is_load_instruction;
-    block->contains_loadstore_instructions |= cbi.is_store_instruction;
-
     pc += sizeof(cbi.instruction.bits);
 
     if (is_branch_delay_slot && cbi.is_branch_instruction)
@@ -768,9 +959,51 @@ bool CompileBlock(CodeBlock* block)
     return false;
   }
 
+  return CompileBlockHostCode(block);
+}
+
+void UpdateBlockICacheInfo(CodeBlock* block)
+{
+  block->icache_line_count = 0;
+  block->uncached_fetch_ticks = 0;
+  block->contains_double_branches = false;
+  block->contains_loadstore_instructions = false;
+
+  u32 last_cache_line = ICACHE_LINES;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    if (g_settings.cpu_recompiler_icache)
+    {
+      const u32 icache_line = GetICacheLine(cbi.pc);
+      if (icache_line != last_cache_line)
+      {
+        block->icache_line_count++;
+        last_cache_line = icache_line;
+      }
+      block->uncached_fetch_ticks += GetInstructionReadTicks(cbi.pc);
+    }
+
+    block->contains_loadstore_instructions |= cbi.is_load_instruction;
+    block->contains_loadstore_instructions |= cbi.is_store_instruction;
+  }
+}
+
+bool CompileBlockHostCode(CodeBlock* block)
+{
+  UpdateBlockICacheInfo(block);
+
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
   {
+    // Baseline blocks are interpreted by FastCompileBlockFunction until they're hot, so they don't need host code.
+    if (block->tier == CodeBlockTier::Baseline)
+    {
+      block->host_code = FastCompileBlockFunction;
+      block->host_code_size = 0;
+      s_tier_stats.baseline_blocks_created++;
+      return true;
+    }
+
     // Ensure we're not going to run out of space while compiling this block.
     if (s_code_buffer.GetFreeCodeSpace() <
           (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
@@ -781,11 +1014,15 @@ bool CompileBlock(CodeBlock* block)
       Flush();
     }
 
+    Common::Timer compile_timer;
     s_code_buffer.WriteProtect(false);
     Recompiler::CodeGenerator codegen(&s_code_buffer);
     const bool compile_result = codegen.CompileBlock(block, &block->host_code, &block->host_code_size);
     s_code_buffer.WriteProtect(true);
 
+    s_tier_stats.optimized_compiles++;
+    s_tier_stats.optimized_compile_time_ms += compile_timer.GetTimeMilliseconds();
+
     if (!compile_result)
     {
       Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
@@ -802,6 +1039,18 @@ bool CompileBlock(CodeBlock* block)
 void FastCompileBlockFunction()
 {
   CodeBlock* block = LookupBlock(GetNextBlockKey());
+  if (block && block->tier == CodeBlockTier::Baseline)
+  {
+    if (++block->execution_count < TIER_UP_EXECUTION_THRESHOLD)
+    {
+      InterpretBaselineBlock(*block);
+      return;
+    }
+
+    if (!RecompileBlockOptimized(block))
+      block = nullptr;
+  }
+
   if (block)
   {
     s_single_block_asm_dispatcher(block->host_code);
@@ -821,6 +1070,24 @@ void FastCompileBlockFunction()
   }
 }
 
+void InterpretBaselineBlock(CodeBlock& block)
+{
+  if (g_settings.cpu_recompiler_icache)
+    CheckAndUpdateICacheTags(block.icache_line_count, block.uncached_fetch_ticks);
+
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretCachedBlock<PGXPMode::CPU>(block);
+    else
+      InterpretCachedBlock<PGXPMode::Memory>(block);
+  }
+  else
+  {
+    InterpretCachedBlock<PGXPMode::Disabled>(block);
+  }
+}
+
 void InvalidCodeFunction()
 {
   Log_ErrorPrintf("Trying to execute invalid code at 0x%08X", g_state.regs.pc);
@@ -950,7 +1217,10 @@ void RemoveBlockFromPageMap(CodeBlock* block)
     auto& page_blocks = m_ram_block_map[page];
     auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
     Assert(page_block_iter != page_blocks.end());
-    page_blocks.erase(page_block_iter);
+
+    // order within a page doesn't matter, so avoid shifting the remaining blocks down
+    *page_block_iter = page_blocks.back();
+    page_blocks.pop_back();
   }
 }
 
@@ -1036,25 +1306,365 @@ void UnlinkBlock(CodeBlock* block)
 #endif
 }
 
+static bool ReadU32(ByteStream* stream, u32* dest)
+{
+  return stream->Read2(dest, sizeof(u32));
+}
+
+static bool WriteU32(ByteStream* stream, u32 value)
+{
+  return stream->Write2(&value, sizeof(u32));
+}
+
+void LoadBlockCache(std::string path)
+{
+  s_block_cache_path = std::move(path);
+  s_block_cache_pending.clear();
+  s_block_cache_retired.clear();
+  s_block_cache_position = 0;
+  s_block_cache_stats = {};
+
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(s_block_cache_path.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+  {
+    Log_InfoPrintf("No block cache found at '%s'", s_block_cache_path.c_str());
+    return;
+  }
+
+  ByteStream* bs = stream.get();
+  u32 signature, version, instruction_size, block_count;
+  if (!ReadU32(bs, &signature) || signature != BLOCK_CACHE_SIGNATURE || !ReadU32(bs, &version) ||
+      version != BLOCK_CACHE_VERSION || !ReadU32(bs, &instruction_size) ||
+      instruction_size != sizeof(CodeBlockInstruction) || !ReadU32(bs, &block_count) ||
+      block_count > BLOCK_CACHE_MAX_BLOCKS)
+  {
+    Log_WarningPrintf("Block cache '%s' has an invalid header, ignoring", s_block_cache_path.c_str());
+    return;
+  }
+
+  s_block_cache_pending.reserve(block_count);
+  for (u32 i = 0; i < block_count; i++)
+  {
+    CachedBlock cb;
+    u32 instruction_count;
+    if (!ReadU32(bs, &cb.key.bits) || !ReadU32(bs, &cb.unseen_sessions) || !ReadU32(bs, &instruction_count) ||
+        instruction_count == 0 ||
+        instruction_count > BLOCK_CACHE_MAX_BLOCK_INSTRUCTIONS)
+    {
+      Log_WarningPrintf("Block cache '%s' is corrupted, ignoring", s_block_cache_path.c_str());
+      s_block_cache_pending.clear();
+      return;
+    }
+
+    cb.instructions.resize(instruction_count);
+    const u32 size = instruction_count * static_cast<u32>(sizeof(CodeBlockInstruction));
+    if (!bs->Read2(cb.instructions.data(), size))
+    {
+      Log_WarningPrintf("Block cache '%s' is truncated, ignoring", s_block_cache_path.c_str());
+      s_block_cache_pending.clear();
+      return;
+    }
+
+    s_block_cache_pending.push_back(std::move(cb));
+  }
+
+  s_block_cache_stats.loaded_blocks = static_cast<u32>(s_block_cache_pending.size());
+  Log_InfoPrintf("Loaded %u blocks from block cache '%s'", s_block_cache_stats.loaded_blocks,
+                 s_block_cache_path.c_str());
+}
+
+void SaveBlockCache()
+{
+  if (s_block_cache_path.empty())
+    return;
+
+  Log_InfoPrintf("Block cache: %u loaded, %u hits, %u misses, %u stale", s_block_cache_stats.loaded_blocks,
+                 s_block_cache_stats.hits, s_block_cache_stats.misses, s_block_cache_stats.stale);
+
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(s_block_cache_path.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                       BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                       BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open block cache '%s' for writing", s_block_cache_path.c_str());
+    return;
+  }
+
+  // Live blocks take priority, followed by blocks which were flushed, and finally ones we haven't seen yet.
+  std::unordered_set<u32> keys;
+  std::vector<CachedBlock> blocks;
+  for (const auto& it : s_blocks)
+  {
+    const CodeBlock* block = it.second;
+    if (block && !block->invalidated && keys.insert(block->key.bits).second)
+      blocks.push_back(CachedBlock{block->key, 0, block->instructions});
+  }
+  for (auto& it : s_block_cache_retired)
+  {
+    if (keys.insert(it.first).second)
+      blocks.push_back(std::move(it.second));
+  }
+  s_block_cache_retired.clear();
+  for (const CachedBlock& cb : s_block_cache_pending)
+  {
+    if ((cb.unseen_sessions + 1) < BLOCK_CACHE_MAX_UNSEEN_SESSIONS && keys.insert(cb.key.bits).second)
+      blocks.push_back(CachedBlock{cb.key, cb.unseen_sessions + 1, cb.instructions});
+  }
+  if (blocks.size() > BLOCK_CACHE_MAX_BLOCKS)
+    blocks.resize(BLOCK_CACHE_MAX_BLOCKS);
+
+  ByteStream* bs = stream.get();
+  bool result = WriteU32(bs, BLOCK_CACHE_SIGNATURE) && WriteU32(bs, BLOCK_CACHE_VERSION) &&
+                WriteU32(bs, static_cast<u32>(sizeof(CodeBlockInstruction))) &&
+                WriteU32(bs, static_cast<u32>(blocks.size()));
+  for (const CachedBlock& cb : blocks)
+  {
+    if (!result)
+      break;
+
+    const u32 size = static_cast<u32>(cb.instructions.size() * sizeof(CodeBlockInstruction));
+    result = WriteU32(bs, cb.key.bits) && WriteU32(bs, cb.unseen_sessions) &&
+             WriteU32(bs, static_cast<u32>(cb.instructions.size())) && bs->Write2(cb.instructions.data(), size);
+  }
+
+  if (!result || !stream->Commit())
+  {
+    Log_ErrorPrintf("Failed to write block cache '%s'", s_block_cache_path.c_str());
+    stream->Discard();
+    return;
+  }
+
+  Log_InfoPrintf("Wrote %zu blocks to block cache '%s'", blocks.size(), s_block_cache_path.c_str());
+}
+
+const BlockCacheStats& GetBlockCacheStats()
+{
+  return s_block_cache_stats;
+}
+
+void RetireBlocksToBlockCache()
+{
+  for (const auto& it : s_blocks)
+  {
+    const CodeBlock* block = it.second;
+    if (block && !block->invalidated)
+      s_block_cache_retired.insert_or_assign(it.first, CachedBlock{block->key, 0, block->instructions});
+  }
+}
+
+bool ValidateCachedBlock(const CachedBlock& cb)
+{
+  for (const CodeBlockInstruction& cbi : cb.instructions)
+  {
+    u32 code = 0;
+    if (!SafeReadInstruction(cbi.pc, &code) || code != cbi.instruction.bits)
+      return false;
+  }
+
+  return true;
+}
+
+bool PrecompileCachedBlock(CachedBlock& cb)
+{
+  CodeBlock* block = AllocateBlock(cb.key);
+  block->recompile_frame_number = System::GetFrameNumber();
+  block->tier = GetInitialBlockTier();
+  block->instructions = std::move(cb.instructions);
+  if (!CompileBlockHostCode(block))
+  {
+    Log_WarningPrintf("Failed to precompile cached block at 0x%08X", block->GetPC());
+    FreeBlock(block);
+    return false;
+  }
+
+  AddBlockToPageMap(block);
+
+#ifdef WITH_RECOMPILER
+  SetFastMap(block->GetPC(), block->host_code);
+  AddBlockToHostCodeMap(block);
+#endif
+
+  s_blocks.emplace(block->key.bits, block);
+  return true;
+}
+
+void PrecompileCachedBlocks()
+{
+  if (!g_settings.IsUsingCodeCache())
+    return;
+
+  // Blocks stay pending until memory contains the same code, e.g. the game executable has been loaded.
+  u32 words_remaining = BLOCK_CACHE_VALIDATE_WORDS_PER_FRAME;
+  size_t blocks_remaining = s_block_cache_pending.size();
+  size_t index = s_block_cache_position;
+  while (words_remaining > 0 && blocks_remaining > 0 && !s_block_cache_pending.empty())
+  {
+    blocks_remaining--;
+    if (index >= s_block_cache_pending.size())
+      index = 0;
+
+    CachedBlock& cb = s_block_cache_pending[index];
+    words_remaining -= std::min(words_remaining, static_cast<u32>(cb.instructions.size()));
+
+    const BlockMap::iterator iter = s_blocks.find(cb.key.bits);
+    if (iter != s_blocks.end())
+    {
+      // Already compiled on demand. If it's different code, the cached copy is out of date.
+      if (!ValidateCachedBlock(cb))
+        s_block_cache_stats.stale++;
+    }
+    else if (!ValidateCachedBlock(cb))
+    {
+      index++;
+      continue;
+    }
+    else if (PrecompileCachedBlock(cb))
+    {
+      s_block_cache_stats.hits++;
+    }
+    else
+    {
+      s_block_cache_stats.stale++;
+    }
+
+    s_block_cache_pending[index] = std::move(s_block_cache_pending.back());
+    s_block_cache_pending.pop_back();
+  }
+
+  s_block_cache_position = index;
+}
+
+CodeBlockTier GetInitialBlockTier()
+{
+  return (g_settings.IsUsingRecompiler() && g_settings.cpu_recompiler_tiered) ? CodeBlockTier::Baseline :
+                                                                                CodeBlockTier::Optimized;
+}
+
+void DrawDebugStateWindow()
+{
+  const float framebuffer_scale = ImGui::GetIO().DisplayFramebufferScale.x;
+
+  ImGui::SetNextWindowSize(ImVec2(400.0f * framebuffer_scale, 300.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Code Cache State", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
+
+  std::array<u32, 2> tier_block_counts = {};
+  u32 interpreter_block_count = 0;
+  for (const auto& it : s_blocks)
+  {
+    if (it.second)
+      tier_block_counts[static_cast<u32>(it.second->tier)]++;
+    else
+      interpreter_block_count++;
+  }
+
+  if (ImGui::CollapsingHeader("Blocks", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    ImGui::Columns(4);
+    ImGui::TextUnformatted("Tier");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("Blocks");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("Created/Compiled");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("Compile Time");
+    ImGui::NextColumn();
+
+    // baseline blocks are interpreted, so there's no compile time to show for them
+    ImGui::TextUnformatted("Baseline (Interpreted)");
+    ImGui::NextColumn();
+    ImGui::Text("%u", tier_block_counts[static_cast<u32>(CodeBlockTier::Baseline)]);
+    ImGui::NextColumn();
+    ImGui::Text("%u", s_tier_stats.baseline_blocks_created);
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("-");
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Optimized");
+    ImGui::NextColumn();
+    ImGui::Text("%u", tier_block_counts[static_cast<u32>(CodeBlockTier::Optimized)]);
+    ImGui::NextColumn();
+    ImGui::Text("%u", s_tier_stats.optimized_compiles);
+    ImGui::NextColumn();
+    ImGui::Text("%.2f ms", s_tier_stats.optimized_compile_time_ms);
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+    ImGui::Text("Tier-ups: %u", s_tier_up_count);
+    ImGui::Text("Blocks falling back to interpreter: %u", interpreter_block_count);
+#ifdef WITH_RECOMPILER
+    if (g_settings.IsUsingRecompiler())
+    {
+      ImGui::Text("Free code space: %u KB near, %u KB far", s_code_buffer.GetFreeCodeSpace() / 1024,
+                  s_code_buffer.GetFreeFarCodeSpace() / 1024);
+    }
+#endif
+  }
+
+  if (ImGui::CollapsingHeader("Persistent Block Cache", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    if (s_block_cache_path.empty())
+    {
+      ImGui::TextUnformatted("Not enabled.");
+    }
+    else
+    {
+      ImGui::Text("Loaded: %u", s_block_cache_stats.loaded_blocks);
+      ImGui::Text("Pending: %zu", s_block_cache_pending.size());
+      ImGui::Text("Hits: %u", s_block_cache_stats.hits);
+      ImGui::Text("Misses: %u", s_block_cache_stats.misses);
+      ImGui::Text("Stale: %u", s_block_cache_stats.stale);
+    }
+  }
+
+  ImGui::End();
+}
+
 #ifdef WITH_RECOMPILER
 
 void AddBlockToHostCodeMap(CodeBlock* block)
 {
-  if (!g_settings.IsUsingRecompiler())
+  if (!g_settings.IsUsingRecompiler() || block->tier == CodeBlockTier::Baseline)
     return;
 
-  auto ir = s_host_code_map.emplace(block->host_code, block);
-  Assert(ir.second);
+  s_host_code_map.Insert(block->host_code, block);
 }
 
 void RemoveBlockFromHostCodeMap(CodeBlock* block)
 {
-  if (!g_settings.IsUsingRecompiler())
+  if (!g_settings.IsUsingRecompiler() || block->tier == CodeBlockTier::Baseline)
     return;
 
-  HostCodeMap::iterator hc_iter = s_host_code_map.find(block->host_code);
-  Assert(hc_iter != s_host_code_map.end());
-  s_host_code_map.erase(hc_iter);
+  s_host_code_map.Remove(block->host_code);
+}
+
+bool RecompileBlockOptimized(CodeBlock* block)
+{
+  Log_DebugPrintf("Block 0x%08X executed %u times, compiling host code", block->GetPC(), block->execution_count);
+
+  // Compiling can flush the cache, so take the block out of the lookup tables first like RevalidateBlock does.
+  RemoveReferencesToBlock(block);
+  block->tier = CodeBlockTier::Optimized;
+  block->loadstore_backpatch_info.clear();
+
+  if (!CompileBlockHostCode(block))
+  {
+    Log_PerfPrintf("Failed to compile hot block 0x%08X, falling back to interpreter.", block->GetPC());
+    FallbackExistingBlockToInterpreter(block);
+    return false;
+  }
+
+  AddBlockToPageMap(block);
+  SetFastMap(block->GetPC(), block->host_code);
+  AddBlockToHostCodeMap(block);
+  s_blocks.emplace(block->key.bits, block);
+  s_tier_up_count++;
+  return true;
 }
 
 bool InitializeFastmem()
@@ -1106,17 +1716,12 @@ Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc,
   Log_DevPrintf("Page fault handler invoked at PC=%p Address=%p %s, fastmem offset 0x%08X", exception_pc, fault_address,
                 is_write ? "(write)" : "(read)", fastmem_address);
 
-  // use upper_bound to find the next block after the pc
-  HostCodeMap::iterator upper_iter =
-    s_host_code_map.upper_bound(reinterpret_cast<CodeBlock::HostCodePointer>(exception_pc));
-  if (upper_iter == s_host_code_map.begin())
+  // find the block which starts closest before the pc, which is (hopefully) the block we want
+  CodeBlock* block = s_host_code_map.Lookup(exception_pc);
+  if (!block)
     return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
 
-  // then decrement it by one to (hopefully) get the block we want
-  upper_iter--;
-
   // find the loadstore info in the code block
-  CodeBlock* block = upper_iter->second;
   for (auto bpi_iter = block->loadstore_backpatch_info.begin(); bpi_iter != block->loadstore_backpatch_info.end();
        ++bpi_iter)
   {
@@ -1169,17 +1774,12 @@ Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc,
 
 Common::PageFaultHandler::HandlerResult LUTPageFaultHandler(void* exception_pc, void* fault_address, bool is_write)
 {
-  // use upper_bound to find the next block after the pc
-  HostCodeMap::iterator upper_iter =
-    s_host_code_map.upper_bound(reinterpret_cast<CodeBlock::HostCodePointer>(exception_pc));
-  if (upper_iter == s_host_code_map.begin())
+  // find the block which starts closest before the pc, which is (hopefully) the block we want
+  CodeBlock* block = s_host_code_map.Lookup(exception_pc);
+  if (!block)
     return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
 
-  // then decrement it by one to (hopefully) get the block we want
-  upper_iter--;
-
   // find the loadstore info in the code block
-  CodeBlock* block = upper_iter->second;
   for (auto bpi_iter = block->loadstore_backpatch_info.begin(); bpi_iter != block->loadstore_backpatch_info.end();
        ++bpi_iter)
   {
@@ -1221,8 +1821,13 @@ void CPU::Recompiler::Thunks::ResolveBranch(CodeBlock* block, void* host_pc, voi
 
   CodeBlockKey key = GetNextBlockKey();
   CodeBlock* successor_block = LookupBlock(key);
-  if (!successor_block || (successor_block->invalidated && !RevalidateBlock(successor_block)) || !block->can_link ||
-      !successor_block->can_link)
+  if (successor_block && successor_block->tier == CodeBlockTier::Baseline)
+  {
+    // leave the branch going through the resolver, so it gets linked once the successor has host code
+    return;
+  }
+  else if (!successor_block || (successor_block->invalidated && !RevalidateBlock(successor_block)) ||
+           !block->can_link || !successor_block->can_link)
   {
     // just turn it into a return to the dispatcher instead.
     s_code_buffer.WriteProtect(false);
@@ -7,6 +7,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -56,6 +57,12 @@ struct CodeBlockInstruction
   bool can_trap : 1;
 };
 
+enum class CodeBlockTier : u8
+{
+  Baseline,
+  Optimized
+};
+
 struct CodeBlock
 {
   using HostCodePointer = void (*)();
@@ -94,6 +101,10 @@ struct CodeBlock
   u32 recompile_count = 0;
   u32 invalidate_frame_number = 0;
 
+  // Incremented each time a baseline tier block is interpreted, used to decide when to compile host code.
+  u32 execution_count = 0;
+  CodeBlockTier tier = CodeBlockTier::Optimized;
+
   const u32 GetPC() const { return key.GetPC(); }
   const u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
   const u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE); }
@@ -119,6 +130,14 @@ enum : u32
 
 using FastMapTable = CodeBlock::HostCodePointer*;
 
+struct BlockCacheStats
+{
+  u32 loaded_blocks;
+  u32 hits;
+  u32 misses;
+  u32 stale;
+};
+
 void Initialize();
 void Shutdown();
 void Execute();
@@ -143,6 +162,18 @@ void InvalidateBlocksWithPageIndex(u32 page_index);
 /// Invalidates all blocks in the cache.
 void InvalidateAll();
 
+/// Loads the list of blocks compiled in previous sessions from the specified file. Blocks are precompiled once the
+/// contents of memory match what was recorded, and the list is written back to the same file on shutdown.
+void LoadBlockCache(std::string path);
+
+/// Writes the currently-compiled blocks, and any cached blocks which haven't been seen yet, to the block cache file.
+void SaveBlockCache();
+
+/// Returns hit/miss counters for the persistent block cache.
+const BlockCacheStats& GetBlockCacheStats();
+
+void DrawDebugStateWindow();
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block);
 
@@ -2,6 +2,7 @@
 #include "common/bitfield.h"
 #include "cpu_types.h"
 #include "gte_types.h"
+#include "pgxp.h"
 #include "types.h"
 #include <array>
 #include <optional>
@@ -76,7 +77,10 @@ struct State
   // GTE registers are stored here so we can access them on ARM with a single instruction
   GTE::Regs gte_regs = {};
 
-  // 4 bytes of padding here on x64
+  // PGXP values for the GPRs are stored here so the recompiler can propagate them inline
+  PGXP::PGXP_value pgxp_gpr[PGXP::NUM_CPU_REGS] = {};
+
+  // followed by 3 bytes of padding on 64-bit hosts, the PGXP values above end on a 4 byte boundary
   bool use_debug_dispatcher = false;
 
   u8* fastmem_base = nullptr;
@@ -88,8 +92,16 @@ struct State
 
   static constexpr u32 GPRRegisterOffset(u32 index) { return offsetof(State, regs.r) + (sizeof(u32) * index); }
   static constexpr u32 GTERegisterOffset(u32 index) { return offsetof(State, gte_regs.r32) + (sizeof(u32) * index); }
+  static constexpr u32 PGXPRegisterOffset(u32 index)
+  {
+    return offsetof(State, pgxp_gpr) + (sizeof(PGXP::PGXP_value) * index);
+  }
 };
 
+// The x64 recompiler accesses the PGXP values inline a dword at a time.
+static_assert((offsetof(State, pgxp_gpr) % sizeof(u32)) == 0, "PGXP GPR values are dword aligned");
+static_assert((sizeof(PGXP::PGXP_value) % sizeof(u32)) == 0, "PGXP values are a whole number of dwords");
+
 extern State g_state;
 extern bool g_using_interpreter;
 
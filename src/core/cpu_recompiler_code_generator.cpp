@@ -1471,7 +1471,7 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
     {
       result = EmitLoadGuestMemory(cbi, address, address_spec, RegSize_32);
       if (g_settings.gpu_pgxp_enable)
-        EmitFunctionCall(nullptr, PGXP::CPU_LW, Value::FromConstantU32(cbi.instruction.bits), result, address);
+        EmitPGXPLoadWord(cbi, address, result);
 
       if (address_spec)
         value_spec = SpeculativeReadMemory(*address_spec);
@@ -1572,7 +1572,7 @@ bool CodeGenerator::Compile_Store(const CodeBlockInstruction& cbi)
     case InstructionOp::sw:
     {
       if (g_settings.gpu_pgxp_enable)
-        EmitFunctionCall(nullptr, PGXP::CPU_SW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+        EmitPGXPStoreWord(cbi, address, value);
 
       EmitStoreGuestMemory(cbi, address, address_spec, RegSize_32, value);
 
@@ -1850,17 +1850,9 @@ bool CodeGenerator::Compile_Add(const CodeBlockInstruction& cbi)
 
   // detect register moves and handle them for pgxp
   if (g_settings.gpu_pgxp_enable && rhs.HasConstantValue(0))
-  {
-    EmitFunctionCall(nullptr, &PGXP::CPU_MOVE,
-                     Value::FromConstantU32((static_cast<u32>(dest) << 8) | (static_cast<u32>(lhs_src))), lhs);
-  }
+    EmitPGXPMove(dest, lhs_src, lhs);
   else if (g_settings.UsingPGXPCPUMode())
-  {
-    if (cbi.instruction.op != InstructionOp::funct)
-      EmitFunctionCall(nullptr, &PGXP::CPU_ADDI, Value::FromConstantU32(cbi.instruction.bits), lhs);
-    else
-      EmitFunctionCall(nullptr, &PGXP::CPU_ADD, Value::FromConstantU32(cbi.instruction.bits), lhs, rhs);
-  }
+    EmitPGXPAddSub(cbi, lhs, rhs);
 
   Value result = AddValues(lhs, rhs, check_overflow);
   if (check_overflow)
@@ -1891,7 +1883,7 @@ bool CodeGenerator::Compile_Subtract(const CodeBlockInstruction& cbi)
   SpeculativeValue rhs_spec = SpeculativeReadReg(cbi.instruction.r.rt);
 
   if (g_settings.UsingPGXPCPUMode())
-    EmitFunctionCall(nullptr, &PGXP::CPU_SUB, Value::FromConstantU32(cbi.instruction.bits), lhs, rhs);
+    EmitPGXPAddSub(cbi, lhs, rhs);
 
   Value result = SubValues(lhs, rhs, check_overflow);
   if (check_overflow)
@@ -81,6 +81,10 @@ public:
   void EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr);
   void EmitStoreGlobal(void* ptr, const Value& value);
   void EmitLoadGlobalAddress(HostReg host_reg, const void* ptr);
+#if defined(CPU_X64)
+  void EmitLoadHostMemory(HostReg host_reg, RegSize size, HostReg base_reg, u32 offset);
+  void EmitStoreHostMemory(HostReg base_reg, u32 offset, const Value& value);
+#endif
 
   // Automatically generates an exception handler.
   Value GetFastmemLoadBase();
@@ -215,6 +219,17 @@ private:
   Value DoGTERegisterRead(u32 index);
   void DoGTERegisterWrite(u32 index, const Value& value);
 
+  // PGXP value propagation. On x64 the common cases are emitted inline, anything else calls the C implementation.
+  void EmitPGXPMove(Reg dest, Reg src, const Value& src_value);
+  void EmitPGXPLoadWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitPGXPStoreWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitPGXPAddSub(const CodeBlockInstruction& cbi, const Value& lhs, const Value& rhs);
+#if defined(CPU_X64)
+  void EmitPGXPValidate(Reg reg, const Value& value);
+  void EmitPGXPGetShadowPage(const Value& address, const Value& page, const Value& flags_ptr, const Value& temp,
+                             LabelType* not_ram, LabelType* no_page);
+#endif
+
   //////////////////////////////////////////////////////////////////////////
   // Instruction Code Generators
   //////////////////////////////////////////////////////////////////////////
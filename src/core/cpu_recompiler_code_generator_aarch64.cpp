@@ -2304,11 +2304,10 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->Bind(&no_interrupt);
 
   // TimingEvents::UpdateCPUDowncount:
-  // x8 <- head event->downcount
+  // w8 <- next event downcount
   // downcount <- x8
-  EmitLoadGlobalAddress(8, TimingEvents::GetHeadEventPtr());
-  m_emit->ldr(a64::x8, a64::MemOperand(a64::x8));
-  m_emit->ldr(a64::w8, a64::MemOperand(a64::x8, offsetof(TimingEvent, m_downcount)));
+  EmitLoadGlobalAddress(8, TimingEvents::GetNextEventDowncountPtr());
+  m_emit->ldr(a64::w8, a64::MemOperand(a64::x8));
   m_emit->str(a64::w8, a64::MemOperand(GetHostReg64(RCPUPTR), offsetof(State, downcount)));
 
   // main dispatch loop
@@ -2345,9 +2344,8 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
 
   // check events then for frame done
   m_emit->ldr(a64::w8, a64::MemOperand(GetHostReg64(RCPUPTR), offsetof(State, pending_ticks)));
-  EmitLoadGlobalAddress(9, TimingEvents::GetHeadEventPtr());
-  m_emit->ldr(a64::x9, a64::MemOperand(a64::x9));
-  m_emit->ldr(a64::w9, a64::MemOperand(a64::x9, offsetof(TimingEvent, m_downcount)));
+  EmitLoadGlobalAddress(9, TimingEvents::GetNextEventDowncountPtr());
+  m_emit->ldr(a64::w9, a64::MemOperand(a64::x9));
   m_emit->cmp(a64::w8, a64::w9);
   m_emit->b(&frame_done_loop, a64::lt);
   EmitCall(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
@@ -160,6 +160,38 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
 }
 
+#ifndef CPU_X64
+
+// PGXP is only emitted inline on x64, other architectures call the C implementation for everything.
+
+void CodeGenerator::EmitPGXPMove(Reg dest, Reg src, const Value& src_value)
+{
+  EmitFunctionCall(nullptr, &PGXP::CPU_MOVE,
+                   Value::FromConstantU32((static_cast<u32>(dest) << 8) | (static_cast<u32>(src))), src_value);
+}
+
+void CodeGenerator::EmitPGXPLoadWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  EmitFunctionCall(nullptr, &PGXP::CPU_LW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+}
+
+void CodeGenerator::EmitPGXPStoreWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  EmitFunctionCall(nullptr, &PGXP::CPU_SW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+}
+
+void CodeGenerator::EmitPGXPAddSub(const CodeBlockInstruction& cbi, const Value& lhs, const Value& rhs)
+{
+  if (cbi.instruction.op != InstructionOp::funct)
+    EmitFunctionCall(nullptr, &PGXP::CPU_ADDI, Value::FromConstantU32(cbi.instruction.bits), lhs);
+  else if (cbi.instruction.r.funct == InstructionFunct::sub || cbi.instruction.r.funct == InstructionFunct::subu)
+    EmitFunctionCall(nullptr, &PGXP::CPU_SUB, Value::FromConstantU32(cbi.instruction.bits), lhs, rhs);
+  else
+    EmitFunctionCall(nullptr, &PGXP::CPU_ADD, Value::FromConstantU32(cbi.instruction.bits), lhs, rhs);
+}
+
+#endif
+
 #if 0 // Not used
 
 void CodeGenerator::EmitICacheCheckAndUpdate()
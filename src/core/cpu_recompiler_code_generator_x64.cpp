@@ -1701,6 +1701,83 @@ void CodeGenerator::EmitStoreCPUStructField(u32 offset, const Value& value)
   }
 }
 
+void CodeGenerator::EmitLoadHostMemory(HostReg host_reg, RegSize size, HostReg base_reg, u32 offset)
+{
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->mov(GetHostReg8(host_reg), m_emit->byte[GetHostReg64(base_reg) + offset]);
+      break;
+
+    case RegSize_16:
+      m_emit->mov(GetHostReg16(host_reg), m_emit->word[GetHostReg64(base_reg) + offset]);
+      break;
+
+    case RegSize_32:
+      m_emit->mov(GetHostReg32(host_reg), m_emit->dword[GetHostReg64(base_reg) + offset]);
+      break;
+
+    case RegSize_64:
+      m_emit->mov(GetHostReg64(host_reg), m_emit->qword[GetHostReg64(base_reg) + offset]);
+      break;
+
+    default:
+    {
+      UnreachableCode();
+    }
+    break;
+  }
+}
+
+void CodeGenerator::EmitStoreHostMemory(HostReg base_reg, u32 offset, const Value& value)
+{
+  DebugAssert(value.IsInHostRegister() || (value.IsConstant() && Xbyak::inner::IsInInt32(value.constant_value)));
+  switch (value.size)
+  {
+    case RegSize_8:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->byte[GetHostReg64(base_reg) + offset], value.constant_value);
+      else
+        m_emit->mov(m_emit->byte[GetHostReg64(base_reg) + offset], GetHostReg8(value.host_reg));
+    }
+    break;
+
+    case RegSize_16:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->word[GetHostReg64(base_reg) + offset], value.constant_value);
+      else
+        m_emit->mov(m_emit->word[GetHostReg64(base_reg) + offset], GetHostReg16(value.host_reg));
+    }
+    break;
+
+    case RegSize_32:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->dword[GetHostReg64(base_reg) + offset], value.constant_value);
+      else
+        m_emit->mov(m_emit->dword[GetHostReg64(base_reg) + offset], GetHostReg32(value.host_reg));
+    }
+    break;
+
+    case RegSize_64:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->qword[GetHostReg64(base_reg) + offset], value.constant_value);
+      else
+        m_emit->mov(m_emit->qword[GetHostReg64(base_reg) + offset], GetHostReg64(value.host_reg));
+    }
+    break;
+
+    default:
+    {
+      UnreachableCode();
+    }
+    break;
+  }
+}
+
 void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
 {
   DebugAssert(value.IsInHostRegister() || value.IsConstant());
@@ -2694,6 +2771,414 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)], GetHostReg32(RRETURN));
 }
 
+void CodeGenerator::EmitPGXPValidate(Reg reg, const Value& value)
+{
+  // flags are cleared when the value no longer matches the register
+  const u32 offset = State::PGXPRegisterOffset(static_cast<u32>(reg));
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+  LabelType valid;
+
+  m_register_cache.InhibitAllocation();
+  EmitLoadCPUStructField(temp.GetHostRegister(), RegSize_32, offset + offsetof(PGXP::PGXP_value, value));
+  EmitConditionalBranch(Condition::Equal, false, temp.GetHostRegister(), value, &valid);
+  EmitLoadCPUStructField(temp.GetHostRegister(), RegSize_32, offset + offsetof(PGXP::PGXP_value, flags));
+  EmitAnd(temp.GetHostRegister(), temp.GetHostRegister(), Value::FromConstantU32(~PGXP::VALUE_VALID_ALL));
+  EmitStoreCPUStructField(offset + offsetof(PGXP::PGXP_value, flags), temp);
+  EmitBindLabel(&valid);
+  m_register_cache.UninhibitAllocation();
+}
+
+void CodeGenerator::EmitPGXPMove(Reg dest, Reg src, const Value& src_value)
+{
+  EmitPGXPValidate(src, src_value);
+  if (dest == src)
+    return;
+
+  const u32 dest_offset = State::PGXPRegisterOffset(static_cast<u32>(dest));
+  const u32 src_offset = State::PGXPRegisterOffset(static_cast<u32>(src));
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+  for (u32 i = 0; i < sizeof(PGXP::PGXP_value); i += sizeof(u32))
+  {
+    EmitLoadCPUStructField(temp.GetHostRegister(), RegSize_32, src_offset + i);
+    EmitStoreCPUStructField(dest_offset + i, temp);
+  }
+}
+
+void CodeGenerator::EmitPGXPLoadWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  // only RAM is handled inline, the scratchpad and anything unmapped goes through the C implementation
+  if (address.IsConstant() &&
+      !Bus::IsRAMAddress(static_cast<u32>(address.constant_value) & PHYSICAL_MEMORY_ADDRESS_MASK))
+  {
+    EmitFunctionCall(nullptr, &PGXP::CPU_LW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+    return;
+  }
+
+  const Reg rt = cbi.instruction.i.rt;
+  const u32 reg_offset = State::PGXPRegisterOffset(static_cast<u32>(rt));
+  Value page = m_register_cache.AllocateScratch(HostPointerSize);
+  Value flags_ptr = m_register_cache.AllocateScratch(HostPointerSize);
+  Value data = m_register_cache.AllocateScratch(RegSize_32);
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+  LabelType slow_path, no_page, invalid, copy_fields, done;
+
+  m_register_cache.InhibitAllocation();
+  EmitPGXPGetShadowPage(address, page, flags_ptr, temp, &slow_path, &no_page);
+
+  // validate against the loaded value, and write the flags back so later loads see the result
+  EmitLoadHostMemory(data.GetHostRegister(), RegSize_32, page.GetHostRegister(), offsetof(PGXP::ShadowPage, value));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, value), data);
+  EmitCmp(data.GetHostRegister(), value);
+  m_emit->jne(invalid, Xbyak::CodeGenerator::T_NEAR);
+  EmitLoadHostMemory(data.GetHostRegister(), RegSize_8, flags_ptr.GetHostRegister(),
+                     offsetof(PGXP::ShadowPage, flags));
+  EmitZeroExtend(data.GetHostRegister(), RegSize_32, data.GetHostRegister(), RegSize_8);
+  EmitShl(temp.GetHostRegister(), data.GetHostRegister(), RegSize_32, Value::FromConstantU32(7));
+  EmitOr(data.GetHostRegister(), data.GetHostRegister(), temp);
+  EmitShl(temp.GetHostRegister(), data.GetHostRegister(), RegSize_32, Value::FromConstantU32(14));
+  EmitOr(data.GetHostRegister(), data.GetHostRegister(), temp);
+  EmitAnd(data.GetHostRegister(), data.GetHostRegister(), Value::FromConstantU32(PGXP::VALUE_VALID_ALL));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, flags), data);
+  m_emit->jmp(copy_fields, Xbyak::CodeGenerator::T_NEAR);
+
+  EmitBindLabel(&invalid);
+  EmitStoreHostMemory(flags_ptr.GetHostRegister(), offsetof(PGXP::ShadowPage, flags), Value::FromConstantU8(0));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, flags), Value::FromConstantU32(0));
+
+  EmitBindLabel(&copy_fields);
+  EmitLoadHostMemory(data.GetHostRegister(), RegSize_32, page.GetHostRegister(), offsetof(PGXP::ShadowPage, x));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, x), data);
+  EmitLoadHostMemory(data.GetHostRegister(), RegSize_32, page.GetHostRegister(), offsetof(PGXP::ShadowPage, y));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, y), data);
+  EmitLoadHostMemory(data.GetHostRegister(), RegSize_32, page.GetHostRegister(), offsetof(PGXP::ShadowPage, z));
+  EmitStoreCPUStructField(reg_offset + offsetof(PGXP::PGXP_value, z), data);
+  m_emit->jmp(done, Xbyak::CodeGenerator::T_NEAR);
+
+  // unallocated pages are zero, which is the same as invalid
+  EmitBindLabel(&no_page);
+  for (u32 i = 0; i < sizeof(PGXP::PGXP_value); i += sizeof(u32))
+    EmitStoreCPUStructField(reg_offset + i, Value::FromConstantU32(0));
+
+  if (!address.IsConstant())
+  {
+    m_emit->jmp(done, Xbyak::CodeGenerator::T_NEAR);
+    EmitBindLabel(&slow_path);
+    EmitFunctionCall(nullptr, &PGXP::CPU_LW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+  }
+
+  EmitBindLabel(&done);
+  m_register_cache.UninhibitAllocation();
+}
+
+void CodeGenerator::EmitPGXPStoreWord(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  if (address.IsConstant() &&
+      !Bus::IsRAMAddress(static_cast<u32>(address.constant_value) & PHYSICAL_MEMORY_ADDRESS_MASK))
+  {
+    EmitFunctionCall(nullptr, &PGXP::CPU_SW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+    return;
+  }
+
+  const Reg rt = cbi.instruction.i.rt;
+  const u32 reg_offset = State::PGXPRegisterOffset(static_cast<u32>(rt));
+  EmitPGXPValidate(rt, value);
+
+  Value page = m_register_cache.AllocateScratch(HostPointerSize);
+  Value flags_ptr = m_register_cache.AllocateScratch(HostPointerSize);
+  Value data = m_register_cache.AllocateScratch(RegSize_32);
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+  LabelType slow_path, done;
+
+  // writes which need a new page go through the C implementation, which allocates it
+  m_register_cache.InhibitAllocation();
+  EmitPGXPGetShadowPage(address, page, flags_ptr, temp, &slow_path, &slow_path);
+
+  EmitLoadCPUStructField(data.GetHostRegister(), RegSize_32, reg_offset + offsetof(PGXP::PGXP_value, x));
+  EmitStoreHostMemory(page.GetHostRegister(), offsetof(PGXP::ShadowPage, x), data);
+  EmitLoadCPUStructField(data.GetHostRegister(), RegSize_32, reg_offset + offsetof(PGXP::PGXP_value, y));
+  EmitStoreHostMemory(page.GetHostRegister(), offsetof(PGXP::ShadowPage, y), data);
+  EmitLoadCPUStructField(data.GetHostRegister(), RegSize_32, reg_offset + offsetof(PGXP::PGXP_value, z));
+  EmitStoreHostMemory(page.GetHostRegister(), offsetof(PGXP::ShadowPage, z), data);
+  EmitLoadCPUStructField(data.GetHostRegister(), RegSize_32, reg_offset + offsetof(PGXP::PGXP_value, value));
+  EmitStoreHostMemory(page.GetHostRegister(), offsetof(PGXP::ShadowPage, value), data);
+
+  // pack the valid bit of each component into the low nibble
+  EmitLoadCPUStructField(data.GetHostRegister(), RegSize_32, reg_offset + offsetof(PGXP::PGXP_value, flags));
+  EmitShr(temp.GetHostRegister(), data.GetHostRegister(), RegSize_32, Value::FromConstantU32(7));
+  EmitOr(data.GetHostRegister(), data.GetHostRegister(), temp);
+  EmitShr(temp.GetHostRegister(), data.GetHostRegister(), RegSize_32, Value::FromConstantU32(14));
+  EmitOr(data.GetHostRegister(), data.GetHostRegister(), temp);
+  EmitStoreHostMemory(flags_ptr.GetHostRegister(), offsetof(PGXP::ShadowPage, flags),
+                      Value::FromHostReg(&m_register_cache, data.GetHostRegister(), RegSize_8));
+  m_emit->jmp(done, Xbyak::CodeGenerator::T_NEAR);
+
+  EmitBindLabel(&slow_path);
+  EmitFunctionCall(nullptr, &PGXP::CPU_SW, Value::FromConstantU32(cbi.instruction.bits), value, address);
+
+  EmitBindLabel(&done);
+  m_register_cache.UninhibitAllocation();
+}
+
+void CodeGenerator::EmitPGXPGetShadowPage(const Value& address, const Value& page, const Value& flags_ptr,
+                                          const Value& temp, LabelType* not_ram, LabelType* no_page)
+{
+  // page = table[paddr >> (SHADOW_PAGE_SHIFT + 2)] + word offset, flags_ptr = page + word index, so both can be
+  // addressed with the offset of the array in ShadowPage
+  const HostReg offset = temp.GetHostRegister();
+  EmitCopyValue(offset, address);
+  EmitAnd(offset, offset, Value::FromConstantU32(PHYSICAL_MEMORY_ADDRESS_MASK));
+  if (!address.IsConstant())
+  {
+    EmitCmp(offset, Value::FromConstantU32(Bus::RAM_MIRROR_END));
+    m_emit->jae(*not_ram, Xbyak::CodeGenerator::T_NEAR);
+  }
+
+  // RAM size can't change without flushing the code cache
+  EmitAnd(offset, offset, Value::FromConstantU32(Bus::g_ram_mask & ~UINT32_C(3)));
+  EmitShr(flags_ptr.GetHostRegister(), offset, RegSize_32, Value::FromConstantU32(PGXP::SHADOW_PAGE_SHIFT + 2));
+  EmitShl(flags_ptr.GetHostRegister(), flags_ptr.GetHostRegister(), RegSize_32, Value::FromConstantU32(3));
+  EmitLoadGlobalAddress(page.GetHostRegister(), PGXP::GetRAMShadowPageTable());
+  EmitAdd(page.GetHostRegister(), page.GetHostRegister(),
+          Value::FromHostReg(&m_register_cache, flags_ptr.GetHostRegister(), HostPointerSize), false);
+  EmitLoadHostMemory(page.GetHostRegister(), HostPointerSize, page.GetHostRegister(), 0);
+  m_emit->test(GetHostReg64(page), GetHostReg64(page));
+  m_emit->jz(*no_page, Xbyak::CodeGenerator::T_NEAR);
+
+  EmitAnd(offset, offset, Value::FromConstantU32(PGXP::SHADOW_PAGE_MASK << 2));
+  EmitShr(flags_ptr.GetHostRegister(), offset, RegSize_32, Value::FromConstantU32(2));
+  EmitAdd(flags_ptr.GetHostRegister(), flags_ptr.GetHostRegister(), page, false);
+  EmitAdd(page.GetHostRegister(), page.GetHostRegister(),
+          Value::FromHostReg(&m_register_cache, offset, HostPointerSize), false);
+}
+
+void CodeGenerator::EmitPGXPAddSub(const CodeBlockInstruction& cbi, const Value& lhs, const Value& rhs)
+{
+  // Inline version of PGXP::CPU_ADD/CPU_SUB/CPU_ADDI. The float operations are done in the same order and precision
+  // as the compiled C code, so the results are bit-identical.
+  const bool immediate = (cbi.instruction.op != InstructionOp::funct);
+  const bool subtract = (!immediate && (cbi.instruction.r.funct == InstructionFunct::sub ||
+                                        cbi.instruction.r.funct == InstructionFunct::subu));
+  const Reg rs = cbi.instruction.r.rs;
+  const Reg rt = cbi.instruction.r.rt;
+  const Reg dest = immediate ? static_cast<Reg>(cbi.instruction.i.rt) : static_cast<Reg>(cbi.instruction.r.rd);
+
+  EmitPGXPValidate(rs, lhs);
+  if (!immediate)
+    EmitPGXPValidate(rt, rhs);
+
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp2 = m_register_cache.AllocateScratch(RegSize_32);
+  const Xbyak::Reg64 temp64 = GetHostReg64(temp);
+  const Xbyak::Reg32 temp32 = GetHostReg32(temp);
+  const Xbyak::Reg32 temp2_32 = GetHostReg32(temp2);
+  const auto field = [this](Reg reg, u32 offset) {
+    return m_emit->dword[GetCPUPtrReg() + (State::PGXPRegisterOffset(static_cast<u32>(reg)) + offset)];
+  };
+  const auto float_bits = [](float value) {
+    u32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  };
+  const auto load_float = [this, temp32, &float_bits](const Xbyak::Xmm& reg, float value) {
+    m_emit->mov(temp32, float_bits(value));
+    m_emit->movd(reg, temp32);
+  };
+  const auto load_double = [this, temp64](const Xbyak::Xmm& reg, double value) {
+    u64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    m_emit->mov(temp64, bits);
+    m_emit->movq(reg, temp64);
+  };
+
+  // x = (x >= 0) ? x : (x + 65535.0 + 1.0), in double precision
+  const auto f16_unsign = [this, &load_double](const Xbyak::Xmm& reg) {
+    Xbyak::Label positive;
+    m_emit->xorps(m_emit->xmm4, m_emit->xmm4);
+    m_emit->comiss(reg, m_emit->xmm4);
+    m_emit->jae(positive);
+    m_emit->cvtss2sd(reg, reg);
+    load_double(m_emit->xmm4, 65535.0);
+    m_emit->addsd(reg, m_emit->xmm4);
+    load_double(m_emit->xmm4, 1.0);
+    m_emit->addsd(reg, m_emit->xmm4);
+    m_emit->cvtsd2ss(reg, reg);
+    m_emit->L(positive);
+  };
+
+  // xy = (s16)value, (s16)(value >> 16), unless both are already valid
+  const auto make_valid = [&](Reg reg, const Value& value) {
+    Xbyak::Label already_valid;
+    m_emit->mov(temp32, field(reg, offsetof(PGXP::PGXP_value, flags)));
+    m_emit->and_(temp32, PGXP::VALUE_VALID_XY);
+    m_emit->cmp(temp32, PGXP::VALUE_VALID_XY);
+    m_emit->je(already_valid, Xbyak::CodeGenerator::T_NEAR);
+    if (value.IsConstant())
+    {
+      const u32 cv = static_cast<u32>(value.constant_value);
+      m_emit->mov(field(reg, offsetof(PGXP::PGXP_value, x)),
+                  float_bits(static_cast<float>(static_cast<s16>(Truncate16(cv)))));
+      m_emit->mov(field(reg, offsetof(PGXP::PGXP_value, y)),
+                  float_bits(static_cast<float>(static_cast<s16>(Truncate16(cv >> 16)))));
+      m_emit->mov(field(reg, offsetof(PGXP::PGXP_value, value)), cv);
+    }
+    else
+    {
+      m_emit->movsx(temp32, GetHostReg16(value));
+      m_emit->cvtsi2ss(m_emit->xmm0, temp32);
+      m_emit->movss(field(reg, offsetof(PGXP::PGXP_value, x)), m_emit->xmm0);
+      m_emit->mov(temp32, GetHostReg32(value));
+      m_emit->sar(temp32, 16);
+      m_emit->cvtsi2ss(m_emit->xmm0, temp32);
+      m_emit->movss(field(reg, offsetof(PGXP::PGXP_value, y)), m_emit->xmm0);
+      m_emit->mov(field(reg, offsetof(PGXP::PGXP_value, value)), GetHostReg32(value));
+    }
+    m_emit->mov(field(reg, offsetof(PGXP::PGXP_value, z)), 0);
+    m_emit->or_(field(reg, offsetof(PGXP::PGXP_value, flags)), PGXP::VALUE_VALID_XY);
+    m_emit->L(already_valid);
+  };
+
+  m_register_cache.InhibitAllocation();
+
+  Xbyak::Label rt_zero, done;
+  if (!immediate)
+  {
+    // adding zero copies rs
+    if (!subtract && !rhs.IsConstant())
+    {
+      m_emit->test(GetHostReg32(rhs), GetHostReg32(rhs));
+      m_emit->jz(rt_zero, Xbyak::CodeGenerator::T_NEAR);
+    }
+
+    // only one valid input, so make both valid
+    Xbyak::Label same_validity;
+    m_emit->mov(temp32, field(rs, offsetof(PGXP::PGXP_value, flags)));
+    m_emit->and_(temp32, PGXP::VALUE_VALID_XY);
+    m_emit->cmp(temp32, PGXP::VALUE_VALID_XY);
+    m_emit->sete(temp32.cvt8());
+    m_emit->mov(temp2_32, field(rt, offsetof(PGXP::PGXP_value, flags)));
+    m_emit->and_(temp2_32, PGXP::VALUE_VALID_XY);
+    m_emit->cmp(temp2_32, PGXP::VALUE_VALID_XY);
+    m_emit->sete(temp2_32.cvt8());
+    m_emit->cmp(temp32.cvt8(), temp2_32.cvt8());
+    m_emit->je(same_validity, Xbyak::CodeGenerator::T_NEAR);
+    make_valid(rs, lhs);
+    make_valid(rt, rhs);
+    m_emit->L(same_validity);
+  }
+
+  // x = f16Unsign(rs.x) +/- f16Unsign(rt.x)
+  m_emit->movss(m_emit->xmm0, field(rs, offsetof(PGXP::PGXP_value, x)));
+  f16_unsign(m_emit->xmm0);
+  if (immediate)
+  {
+    load_float(m_emit->xmm1, static_cast<float>(Truncate16(cbi.instruction.i.imm_sext32())));
+  }
+  else
+  {
+    m_emit->movss(m_emit->xmm1, field(rt, offsetof(PGXP::PGXP_value, x)));
+    f16_unsign(m_emit->xmm1);
+  }
+  if (subtract)
+    m_emit->subss(m_emit->xmm0, m_emit->xmm1);
+  else
+    m_emit->addss(m_emit->xmm0, m_emit->xmm1);
+
+  // carry = (x > 65535) ? 1 : (x < 0) ? -1 : 0
+  Xbyak::Label no_overflow, carry_done;
+  m_emit->xorps(m_emit->xmm3, m_emit->xmm3);
+  load_float(m_emit->xmm2, 65535.0f);
+  m_emit->comiss(m_emit->xmm0, m_emit->xmm2);
+  m_emit->jbe(no_overflow);
+  load_float(m_emit->xmm3, 1.0f);
+  m_emit->jmp(carry_done);
+  m_emit->L(no_overflow);
+  m_emit->xorps(m_emit->xmm2, m_emit->xmm2);
+  m_emit->comiss(m_emit->xmm2, m_emit->xmm0);
+  m_emit->jbe(carry_done);
+  load_float(m_emit->xmm3, -1.0f);
+  m_emit->L(carry_done);
+
+  // x = f16Sign(x), the conversion to u32 goes through s64
+  m_emit->cvtss2sd(m_emit->xmm0, m_emit->xmm0);
+  load_double(m_emit->xmm2, 65536.0);
+  m_emit->mulsd(m_emit->xmm0, m_emit->xmm2);
+  m_emit->cvttsd2si(temp64, m_emit->xmm0);
+  m_emit->cvtsi2sd(m_emit->xmm0, temp32);
+  load_double(m_emit->xmm2, 1.0 / 65536.0);
+  m_emit->mulsd(m_emit->xmm0, m_emit->xmm2);
+  m_emit->cvtsd2ss(m_emit->xmm0, m_emit->xmm0);
+
+  // y = rs.y + (rt.y + carry), or rs.y - (rt.y - carry)
+  m_emit->movss(m_emit->xmm1, field(rs, offsetof(PGXP::PGXP_value, y)));
+  if (immediate)
+    load_float(m_emit->xmm2, static_cast<float>(static_cast<s16>(Truncate16(cbi.instruction.i.imm_sext32() >> 16))));
+  else
+    m_emit->movss(m_emit->xmm2, field(rt, offsetof(PGXP::PGXP_value, y)));
+  if (subtract)
+  {
+    m_emit->subss(m_emit->xmm2, m_emit->xmm3);
+    m_emit->subss(m_emit->xmm1, m_emit->xmm2);
+  }
+  else
+  {
+    m_emit->addss(m_emit->xmm2, m_emit->xmm3);
+    m_emit->addss(m_emit->xmm1, m_emit->xmm2);
+  }
+
+  // y += (y > 32767) ? -65536 : (y < -32768) ? 65536 : 0
+  Xbyak::Label no_wrap_high, wrap_done;
+  m_emit->xorps(m_emit->xmm3, m_emit->xmm3);
+  load_float(m_emit->xmm2, 32767.0f);
+  m_emit->comiss(m_emit->xmm1, m_emit->xmm2);
+  m_emit->jbe(no_wrap_high);
+  load_float(m_emit->xmm3, -65536.0f);
+  m_emit->jmp(wrap_done);
+  m_emit->L(no_wrap_high);
+  load_float(m_emit->xmm2, -32768.0f);
+  m_emit->comiss(m_emit->xmm2, m_emit->xmm1);
+  m_emit->jbe(wrap_done);
+  load_float(m_emit->xmm3, 65536.0f);
+  m_emit->L(wrap_done);
+  m_emit->addss(m_emit->xmm1, m_emit->xmm3);
+
+  // xy are only valid if they were valid in both inputs, z and w come from rs
+  m_emit->mov(temp32, field(rs, offsetof(PGXP::PGXP_value, flags)));
+  if (!immediate)
+  {
+    m_emit->mov(temp2_32, field(rt, offsetof(PGXP::PGXP_value, flags)));
+    m_emit->or_(temp2_32, 0xFFFF0000u);
+    m_emit->and_(temp32, temp2_32);
+  }
+  m_emit->mov(temp2_32, field(rs, offsetof(PGXP::PGXP_value, z)));
+  m_emit->movss(field(dest, offsetof(PGXP::PGXP_value, x)), m_emit->xmm0);
+  m_emit->movss(field(dest, offsetof(PGXP::PGXP_value, y)), m_emit->xmm1);
+  m_emit->mov(field(dest, offsetof(PGXP::PGXP_value, z)), temp2_32);
+  m_emit->mov(field(dest, offsetof(PGXP::PGXP_value, flags)), temp32);
+
+  EmitCopyValue(temp.GetHostRegister(), lhs);
+  if (subtract)
+    EmitSub(temp.GetHostRegister(), temp.GetHostRegister(), rhs, false);
+  else
+    EmitAdd(temp.GetHostRegister(), temp.GetHostRegister(), rhs, false);
+
+  if (!subtract && !immediate && !rhs.IsConstant())
+  {
+    m_emit->jmp(done, Xbyak::CodeGenerator::T_NEAR);
+
+    m_emit->L(rt_zero);
+    for (u32 i = 0; i < offsetof(PGXP::PGXP_value, value); i += sizeof(u32))
+    {
+      m_emit->mov(temp32, field(rs, i));
+      m_emit->mov(field(dest, i), temp32);
+    }
+    EmitCopyValue(temp.GetHostRegister(), lhs);
+  }
+
+  m_emit->L(done);
+  m_emit->mov(field(dest, offsetof(PGXP::PGXP_value, value)), temp32);
+  m_register_cache.UninhibitAllocation();
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
@@ -3047,11 +3532,10 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->L(no_interrupt);
 
   // TimingEvents::UpdateCPUDowncount:
-  // eax <- head event->downcount
+  // eax <- next event downcount
   // downcount <- eax
-  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetHeadEventPtr());
-  m_emit->mov(m_emit->rax, m_emit->qword[m_emit->rax]);
-  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax + offsetof(TimingEvent, m_downcount)]);
+  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetNextEventDowncountPtr());
+  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax]);
   m_emit->mov(m_emit->dword[m_emit->rbp + offsetof(State, downcount)], m_emit->eax);
 
   // main dispatch loop
@@ -3086,9 +3570,8 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->L(downcount_hit);
 
   // check events then for frame done
-  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetHeadEventPtr());
-  m_emit->mov(m_emit->rax, m_emit->qword[m_emit->rax]);
-  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax + offsetof(TimingEvent, m_downcount)]);
+  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetNextEventDowncountPtr());
+  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax]);
   m_emit->cmp(m_emit->eax, m_emit->dword[m_emit->rbp + offsetof(State, pending_ticks)]);
   m_emit->jg(frame_done_loop);
   EmitCall(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
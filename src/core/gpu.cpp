@@ -9,6 +9,7 @@
 #include "host_interface.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "profiler.h"
 #include "settings.h"
 #include "stb_image_write.h"
 #include "system.h"
@@ -813,6 +814,8 @@ bool GPU::IsCommandCompletionPending() const
 
 void GPU::CRTCTickEvent(TickCount ticks)
 {
+  Profiler::ScopedSection profile(Profiler::Section::GPU);
+
   // convert cpu/master clock to GPU ticks, accounting for partial cycles because of the non-integer divider
   {
     const TickCount gpu_ticks = SystemTicksToCRTCTicks(ticks, &m_crtc_state.fractional_ticks);
@@ -1495,6 +1498,12 @@ void GPU::SetTextureWindow(u32 value)
   m_draw_mode.texture_window_changed = true;
 }
 
+const u16* GPU::ReadbackVRAM()
+{
+  ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  return m_vram_ptr;
+}
+
 bool GPU::DumpVRAMToFile(const char* filename)
 {
   ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
@@ -175,6 +175,9 @@ public:
   // Dumps raw VRAM to a file.
   bool DumpVRAMToFile(const char* filename);
 
+  // Reads back all of VRAM from the renderer, returning a pointer to the copy. Slow on the hardware renderers.
+  const u16* ReadbackVRAM();
+
 protected:
   TickCount CRTCTicksToSystemTicks(TickCount crtc_ticks, TickCount fractional_ticks) const;
   TickCount SystemTicksToCRTCTicks(TickCount sysclk_ticks, TickCount* fractional_ticks) const;
@@ -3,6 +3,7 @@
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "common/timer.h"
+#include "profiler.h"
 #include "settings.h"
 Log_SetChannel(GPUBackend);
 
@@ -148,7 +149,10 @@ void GPUBackend::PushCommand(GPUBackendCommand* cmd)
   {
     // single-thread mode
     if (cmd->type != GPUBackendCommandType::Sync)
+    {
+      Profiler::ScopedSection profile(Profiler::Section::GPUBackend);
       HandleCommand(cmd);
+    }
   }
   else
   {
@@ -191,8 +195,14 @@ void GPUBackend::StopGPUThread()
 
 void GPUBackend::Sync(bool allow_sleep)
 {
+  // called on the CPU thread. without a GPU thread this is the rendering itself, otherwise it's the time spent
+  // waiting for the GPU thread to catch up.
+  Profiler::ScopedSection profile(Profiler::Section::GPUBackend);
   if (!m_use_gpu_thread)
+  {
+    FlushRender();
     return;
+  }
 
   GPUBackendSyncCommand* cmd =
     static_cast<GPUBackendSyncCommand*>(AllocateCommand(GPUBackendCommandType::Sync, sizeof(GPUBackendSyncCommand)));
@@ -233,6 +243,7 @@ void GPUBackend::RunGPULoop()
     if (write_ptr < read_ptr)
       write_ptr = COMMAND_QUEUE_SIZE;
 
+    Profiler::ScopedThreadSection profile(Profiler::Section::GPUBackend);
     bool allow_sleep = false;
     while (read_ptr < write_ptr)
     {
@@ -252,6 +263,7 @@ void GPUBackend::RunGPULoop()
         case GPUBackendCommandType::Sync:
         {
           DebugAssert(read_ptr == write_ptr);
+          FlushRender();
           m_sync_event.Signal();
           allow_sleep = static_cast<const GPUBackendSyncCommand*>(cmd)->allow_sleep;
         }
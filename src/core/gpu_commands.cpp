@@ -3,6 +3,7 @@
 #include "common/string_util.h"
 #include "gpu.h"
 #include "interrupt_controller.h"
+#include "profiler.h"
 #include "system.h"
 #include "texture_replacements.h"
 Log_SetChannel(GPU);
@@ -24,6 +25,7 @@ static constexpr u32 ReplaceZero(u32 value, u32 value_for_zero)
 
 void GPU::ExecuteCommands()
 {
+  Profiler::ScopedSection profile(Profiler::Section::GPU);
   m_syncing = true;
 
   for (;;)
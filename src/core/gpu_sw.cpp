@@ -3,22 +3,12 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/make_array.h"
-#include "common/platform.h"
+#include "common/pixel_conversion.h"
 #include "host_display.h"
 #include "system.h"
 #include <algorithm>
 Log_SetChannel(GPU_SW);
 
-#if defined(CPU_X64)
-#include <emmintrin.h>
-#elif defined(CPU_AARCH64)
-#ifdef _MSC_VER
-#include <arm64_neon.h>
-#else
-#include <arm_neon.h>
-#endif
-#endif
-
 template<typename T>
 ALWAYS_INLINE static constexpr std::tuple<T, T> MinMax(T v1, T v2)
 {
@@ -131,95 +121,25 @@ ALWAYS_INLINE u32 VRAM16ToOutput<HostDisplayPixelFormat::BGRA8, u32>(u16 value)
 template<>
 ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGBA5551, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
 {
-  u32 col = 0;
-
-#if defined(CPU_X64)
-  const u32 aligned_width = Common::AlignDownPow2(width, 8);
-  for (; col < aligned_width; col += 8)
-  {
-    const __m128i single_mask = _mm_set1_epi16(0x1F);
-    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
-    src_ptr += 8;
-    __m128i a = _mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0))));
-    __m128i b = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
-    __m128i c = _mm_slli_epi16(_mm_and_si128(value, single_mask), 10);
-    value = _mm_or_si128(_mm_or_si128(a, b), c);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
-    dst_ptr += 8;
-  }
-#elif defined(CPU_AARCH64)
-  const u32 aligned_width = Common::AlignDownPow2(width, 8);
-  for (; col < aligned_width; col += 8)
-  {
-    const uint16x8_t single_mask = vdupq_n_u16(0x1F);
-    uint16x8_t value = vld1q_u16(src_ptr);
-    src_ptr += 8;
-    uint16x8_t a = vandq_u16(value, vdupq_n_u16(0x3E0));
-    uint16x8_t b = vandq_u16(vshrq_n_u16(value, 10), single_mask);
-    uint16x8_t c = vshlq_n_u16(vandq_u16(value, single_mask), 10);
-    value = vorrq_u16(vorrq_u16(a, b), c);
-    vst1q_u16(dst_ptr, value);
-    dst_ptr += 8;
-  }
-#endif
-
-  for (; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGBA5551, u16>(*(src_ptr++));
+  PixelConversion::Convert15BitToRGBA5551(src_ptr, dst_ptr, width);
 }
 
 template<>
 ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGB565, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
 {
-  u32 col = 0;
-
-#if defined(CPU_X64)
-  const u32 aligned_width = Common::AlignDownPow2(width, 8);
-  for (; col < aligned_width; col += 8)
-  {
-    const __m128i single_mask = _mm_set1_epi16(0x1F);
-    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
-    src_ptr += 8;
-    __m128i a = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0)))), 1);
-    __m128i b = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x20)))), 1);
-    __m128i c = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
-    __m128i d = _mm_slli_epi16(_mm_and_si128(value, single_mask), 11);
-    value = _mm_or_si128(_mm_or_si128(_mm_or_si128(a, b), c), d);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
-    dst_ptr += 8;
-  }
-#elif defined(CPU_AARCH64)
-  const u32 aligned_width = Common::AlignDownPow2(width, 8);
-  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
-  for (; col < aligned_width; col += 8)
-  {
-    uint16x8_t value = vld1q_u16(src_ptr);
-    src_ptr += 8;
-    uint16x8_t a = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x3E0)), 1); // (value & 0x3E0) << 1
-    uint16x8_t b = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x20)), 1);  // (value & 0x20) << 1
-    uint16x8_t c = vandq_u16(vshrq_n_u16(value, 10), single_mask);       // ((value >> 10) & 0x1F)
-    uint16x8_t d = vshlq_n_u16(vandq_u16(value, single_mask), 11);       // ((value & 0x1F) << 11)
-    value = vorrq_u16(vorrq_u16(vorrq_u16(a, b), c), d);
-    vst1q_u16(dst_ptr, value);
-    dst_ptr += 8;
-  }
-#endif
-
-  for (; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGB565, u16>(*(src_ptr++));
+  PixelConversion::Convert15BitToRGB565(src_ptr, dst_ptr, width);
 }
 
 template<>
 ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGBA8, u32>(*(src_ptr++));
+  PixelConversion::Convert15BitToRGBA8(src_ptr, dst_ptr, width);
 }
 
 template<>
 ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::BGRA8, u32>(*(src_ptr++));
+  PixelConversion::Convert15BitToBGRA8(src_ptr, dst_ptr, width);
 }
 
 template<HostDisplayPixelFormat display_format>
@@ -352,52 +272,13 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
     for (u32 row = 0; row < rows; row++)
     {
       if constexpr (display_format == HostDisplayPixelFormat::RGBA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = 0xFF;
-        }
-      }
+        PixelConversion::Convert24BitToRGBA8(src_ptr, reinterpret_cast<u32*>(dst_ptr), width);
       else if constexpr (display_format == HostDisplayPixelFormat::BGRA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = src_row_ptr[2];
-          *(dst_row_ptr++) = src_row_ptr[1];
-          *(dst_row_ptr++) = src_row_ptr[0];
-          *(dst_row_ptr++) = 0xFF;
-          src_row_ptr += 3;
-        }
-      }
+        PixelConversion::Convert24BitToBGRA8(src_ptr, reinterpret_cast<u32*>(dst_ptr), width);
       else if constexpr (display_format == HostDisplayPixelFormat::RGB565)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 11) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 2) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
+        PixelConversion::Convert24BitToRGB565(src_ptr, reinterpret_cast<u16*>(dst_ptr), width);
       else if constexpr (display_format == HostDisplayPixelFormat::RGBA5551)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 10) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 3) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
+        PixelConversion::Convert24BitToRGBA5551(src_ptr, reinterpret_cast<u16*>(dst_ptr), width);
 
       src_ptr += src_stride;
       dst_ptr += dst_stride;
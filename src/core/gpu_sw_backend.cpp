@@ -1,12 +1,27 @@
 #include "gpu_sw_backend.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/platform.h"
 #include "gpu_sw_backend.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
+#include <cstring>
 Log_SetChannel(GPU_SW_Backend);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define GPU_SW_VECTOR_SPANS 1
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define GPU_SW_VECTOR_SPANS 1
+#endif
+
 GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
 {
   m_vram.fill(0);
@@ -17,7 +32,34 @@ GPU_SW_Backend::~GPU_SW_Backend() = default;
 
 bool GPU_SW_Backend::Initialize(bool force_thread)
 {
-  return GPUBackend::Initialize(force_thread);
+  if (!GPUBackend::Initialize(force_thread))
+    return false;
+
+  const u32 worker_count = GetConfiguredWorkerCount();
+  if (worker_count > 0)
+    StartWorkers(worker_count);
+
+  return true;
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+
+  // Restarting joins and respawns every worker thread, so leave the pool alone unless the thread count changed.
+  const u32 worker_count = GetConfiguredWorkerCount();
+  if (worker_count == static_cast<u32>(m_workers.size()))
+    return;
+
+  StopWorkers();
+  if (worker_count > 0)
+    StartWorkers(worker_count);
+}
+
+u32 GPU_SW_Backend::GetConfiguredWorkerCount()
+{
+  // The thread which executes commands also rasterizes tiles, so one fewer worker is needed.
+  return (g_settings.gpu_sw_threads > 1) ? (g_settings.gpu_sw_threads - 1) : 0;
 }
 
 void GPU_SW_Backend::Reset(bool clear_vram)
@@ -28,7 +70,49 @@ void GPU_SW_Backend::Reset(bool clear_vram)
     m_vram.fill(0);
 }
 
+void GPU_SW_Backend::Shutdown()
+{
+  GPUBackend::Shutdown();
+  StopWorkers();
+}
+
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  if (IsBinning())
+  {
+    const Common::Rectangle<u32> bounds = GetPolygonBounds(cmd);
+    if (!bounds.Valid() || BinCommand(cmd, bounds))
+      return;
+  }
+
+  DrawPolygon(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  if (IsBinning())
+  {
+    const Common::Rectangle<u32> bounds = GetRectangleBounds(cmd);
+    if (!bounds.Valid() || BinCommand(cmd, bounds))
+      return;
+  }
+
+  DrawRectangle(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  if (IsBinning())
+  {
+    const Common::Rectangle<u32> bounds = GetLineBounds(cmd);
+    if (!bounds.Valid() || BinCommand(cmd, bounds))
+      return;
+  }
+
+  DrawLine(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& area)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
@@ -36,30 +120,335 @@ void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
 
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2], area);
   if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3], area);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& area)
 {
   const GPURenderCommand rc{cmd->rc.bits};
 
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
 
-  (this->*DrawFunction)(cmd);
+  (this->*DrawFunction)(cmd, area);
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& area)
 {
   const DrawLineFunction DrawFunction =
     GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
 
   for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i], area);
+}
+
+/// Returns the areas of VRAM which a textured primitive can sample from, accounting for wrapping.
+static void GetTextureReadRectangles(const GPUBackendDrawCommand* cmd, Common::Rectangle<u32>* page_rect,
+                                     Common::Rectangle<u32>* palette_rect)
+{
+  *page_rect = cmd->draw_mode.GetTexturePageRectangle();
+  if (page_rect->right > VRAM_WIDTH)
+  {
+    page_rect->left = 0;
+    page_rect->right = VRAM_WIDTH;
+  }
+
+  if (cmd->draw_mode.IsUsingPalette())
+  {
+    const u32 palette_width = (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit) ? 16 : 256;
+    *palette_rect =
+      Common::Rectangle<u32>::FromExtents(cmd->palette.GetXBase(), cmd->palette.GetYBase(), palette_width, 1);
+    if (palette_rect->right > VRAM_WIDTH)
+    {
+      palette_rect->left = 0;
+      palette_rect->right = VRAM_WIDTH;
+    }
+  }
+  else
+  {
+    palette_rect->SetInvalid();
+  }
+}
+
+#ifdef GPU_SW_VECTOR_SPANS
+
+// Thin wrappers over the 128-bit integer vector operations used by the span shader, so the kernel is shared between
+// SSE2 and NEON. VecU16 holds eight 16-bit lanes, VecU32 holds four 32-bit lanes.
+#if defined(CPU_X64)
+
+using VecU16 = __m128i;
+using VecU32 = __m128i;
+
+static ALWAYS_INLINE VecU16 LoadU16(const u16* ptr)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+static ALWAYS_INLINE void StoreU16(u16* ptr, VecU16 v)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v);
+}
+static ALWAYS_INLINE VecU32 LoadU32(const u32* ptr)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+static ALWAYS_INLINE VecU16 SplatU16(u16 value)
+{
+  return _mm_set1_epi16(static_cast<s16>(value));
+}
+static ALWAYS_INLINE VecU32 SplatU32(u32 value)
+{
+  return _mm_set1_epi32(static_cast<s32>(value));
+}
+static ALWAYS_INLINE VecU16 AddU16(VecU16 a, VecU16 b)
+{
+  return _mm_add_epi16(a, b);
+}
+static ALWAYS_INLINE VecU16 MulU16(VecU16 a, VecU16 b)
+{
+  return _mm_mullo_epi16(a, b);
+}
+static ALWAYS_INLINE VecU16 AndU16(VecU16 a, VecU16 b)
+{
+  return _mm_and_si128(a, b);
+}
+static ALWAYS_INLINE VecU16 OrU16(VecU16 a, VecU16 b)
+{
+  return _mm_or_si128(a, b);
+}
+static ALWAYS_INLINE VecU16 CmpEqU16(VecU16 a, VecU16 b)
+{
+  return _mm_cmpeq_epi16(a, b);
+}
+static ALWAYS_INLINE VecU16 SelectU16(VecU16 mask, VecU16 a, VecU16 b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+static ALWAYS_INLINE VecU16 ClampS16(VecU16 v, s16 min, s16 max)
+{
+  return _mm_min_epi16(_mm_max_epi16(v, _mm_set1_epi16(min)), _mm_set1_epi16(max));
+}
+template<int n>
+static ALWAYS_INLINE VecU16 ShlU16(VecU16 v)
+{
+  return _mm_slli_epi16(v, n);
+}
+template<int n>
+static ALWAYS_INLINE VecU16 ShrU16(VecU16 v)
+{
+  return _mm_srli_epi16(v, n);
+}
+template<int n>
+static ALWAYS_INLINE VecU16 SarS16(VecU16 v)
+{
+  return _mm_srai_epi16(v, n);
+}
+static ALWAYS_INLINE VecU32 AddU32(VecU32 a, VecU32 b)
+{
+  return _mm_add_epi32(a, b);
+}
+static ALWAYS_INLINE VecU32 SubU32(VecU32 a, VecU32 b)
+{
+  return _mm_sub_epi32(a, b);
+}
+static ALWAYS_INLINE VecU32 AndU32(VecU32 a, VecU32 b)
+{
+  return _mm_and_si128(a, b);
+}
+static ALWAYS_INLINE VecU32 OrU32(VecU32 a, VecU32 b)
+{
+  return _mm_or_si128(a, b);
+}
+static ALWAYS_INLINE VecU32 XorU32(VecU32 a, VecU32 b)
+{
+  return _mm_xor_si128(a, b);
+}
+template<int n>
+static ALWAYS_INLINE VecU32 ShrU32(VecU32 v)
+{
+  return _mm_srli_epi32(v, n);
+}
+static ALWAYS_INLINE VecU32 WidenLowU16(VecU16 v)
+{
+  return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+static ALWAYS_INLINE VecU32 WidenHighU16(VecU16 v)
+{
+  return _mm_unpackhi_epi16(v, _mm_setzero_si128());
+}
+static ALWAYS_INLINE VecU16 NarrowU32(VecU32 low, VecU32 high)
+{
+  // SSE2 only has a saturating pack, so sign-extend the low halves first to make it truncate.
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+}
+
+#elif defined(CPU_AARCH64)
+
+using VecU16 = uint16x8_t;
+using VecU32 = uint32x4_t;
+
+static ALWAYS_INLINE VecU16 LoadU16(const u16* ptr)
+{
+  return vld1q_u16(ptr);
+}
+static ALWAYS_INLINE void StoreU16(u16* ptr, VecU16 v)
+{
+  vst1q_u16(ptr, v);
+}
+static ALWAYS_INLINE VecU32 LoadU32(const u32* ptr)
+{
+  return vld1q_u32(ptr);
+}
+static ALWAYS_INLINE VecU16 SplatU16(u16 value)
+{
+  return vdupq_n_u16(value);
+}
+static ALWAYS_INLINE VecU32 SplatU32(u32 value)
+{
+  return vdupq_n_u32(value);
+}
+static ALWAYS_INLINE VecU16 AddU16(VecU16 a, VecU16 b)
+{
+  return vaddq_u16(a, b);
+}
+static ALWAYS_INLINE VecU16 MulU16(VecU16 a, VecU16 b)
+{
+  return vmulq_u16(a, b);
+}
+static ALWAYS_INLINE VecU16 AndU16(VecU16 a, VecU16 b)
+{
+  return vandq_u16(a, b);
+}
+static ALWAYS_INLINE VecU16 OrU16(VecU16 a, VecU16 b)
+{
+  return vorrq_u16(a, b);
+}
+static ALWAYS_INLINE VecU16 CmpEqU16(VecU16 a, VecU16 b)
+{
+  return vceqq_u16(a, b);
+}
+static ALWAYS_INLINE VecU16 SelectU16(VecU16 mask, VecU16 a, VecU16 b)
+{
+  return vbslq_u16(mask, a, b);
+}
+static ALWAYS_INLINE VecU16 ClampS16(VecU16 v, s16 min, s16 max)
+{
+  return vreinterpretq_u16_s16(
+    vminq_s16(vmaxq_s16(vreinterpretq_s16_u16(v), vdupq_n_s16(min)), vdupq_n_s16(max)));
+}
+template<int n>
+static ALWAYS_INLINE VecU16 ShlU16(VecU16 v)
+{
+  return vshlq_n_u16(v, n);
+}
+template<int n>
+static ALWAYS_INLINE VecU16 ShrU16(VecU16 v)
+{
+  return vshrq_n_u16(v, n);
+}
+template<int n>
+static ALWAYS_INLINE VecU16 SarS16(VecU16 v)
+{
+  return vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(v), n));
+}
+static ALWAYS_INLINE VecU32 AddU32(VecU32 a, VecU32 b)
+{
+  return vaddq_u32(a, b);
+}
+static ALWAYS_INLINE VecU32 SubU32(VecU32 a, VecU32 b)
+{
+  return vsubq_u32(a, b);
+}
+static ALWAYS_INLINE VecU32 AndU32(VecU32 a, VecU32 b)
+{
+  return vandq_u32(a, b);
+}
+static ALWAYS_INLINE VecU32 OrU32(VecU32 a, VecU32 b)
+{
+  return vorrq_u32(a, b);
+}
+static ALWAYS_INLINE VecU32 XorU32(VecU32 a, VecU32 b)
+{
+  return veorq_u32(a, b);
+}
+template<int n>
+static ALWAYS_INLINE VecU32 ShrU32(VecU32 v)
+{
+  return vshrq_n_u32(v, n);
+}
+static ALWAYS_INLINE VecU32 WidenLowU16(VecU16 v)
+{
+  return vmovl_u16(vget_low_u16(v));
+}
+static ALWAYS_INLINE VecU32 WidenHighU16(VecU16 v)
+{
+  return vmovl_u16(vget_high_u16(v));
+}
+static ALWAYS_INLINE VecU16 NarrowU32(VecU32 low, VecU32 high)
+{
+  return vcombine_u16(vmovn_u32(low), vmovn_u32(high));
+}
+
+#endif
+
+/// Vector version of the blending in ShadePixel(), applied to four pixels in 32-bit lanes.
+static ALWAYS_INLINE VecU32 BlendPixels(GPUTransparencyMode mode, VecU32 bg_bits, VecU32 fg_bits)
+{
+  switch (mode)
+  {
+    case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+    {
+      bg_bits = OrU32(bg_bits, SplatU32(0x8000u));
+      return ShrU32<1>(
+        SubU32(AddU32(fg_bits, bg_bits), AndU32(XorU32(fg_bits, bg_bits), SplatU32(0x0421u))));
+    }
+
+    case GPUTransparencyMode::BackgroundPlusForeground:
+    {
+      bg_bits = AndU32(bg_bits, SplatU32(0x7FFFu));
+
+      const VecU32 sum = AddU32(fg_bits, bg_bits);
+      const VecU32 carry =
+        AndU32(SubU32(sum, AndU32(XorU32(fg_bits, bg_bits), SplatU32(0x8421u))), SplatU32(0x8420u));
+      return OrU32(SubU32(sum, carry), SubU32(carry, ShrU32<5>(carry)));
+    }
+
+    case GPUTransparencyMode::BackgroundMinusForeground:
+    {
+      bg_bits = OrU32(bg_bits, SplatU32(0x8000u));
+      fg_bits = AndU32(fg_bits, SplatU32(0x7FFFu));
+
+      const VecU32 diff = AddU32(SubU32(bg_bits, fg_bits), SplatU32(0x108420u));
+      const VecU32 borrow =
+        AndU32(SubU32(diff, AndU32(XorU32(bg_bits, fg_bits), SplatU32(0x108420u))), SplatU32(0x108420u));
+      return AndU32(SubU32(diff, borrow), SubU32(borrow, ShrU32<5>(borrow)));
+    }
+
+    case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+    default:
+    {
+      bg_bits = AndU32(bg_bits, SplatU32(0x7FFFu));
+      fg_bits = OrU32(AndU32(ShrU32<2>(fg_bits), SplatU32(0x1CE7u)), SplatU32(0x8000u));
+
+      const VecU32 sum = AddU32(fg_bits, bg_bits);
+      const VecU32 carry =
+        AndU32(SubU32(sum, AndU32(XorU32(fg_bits, bg_bits), SplatU32(0x8421u))), SplatU32(0x8420u));
+      return OrU32(SubU32(sum, carry), SubU32(carry, ShrU32<5>(carry)));
+    }
+  }
+}
+
+/// Sets up a vector of the interpolant for four consecutive pixels, starting at the specified pixel.
+static ALWAYS_INLINE VecU32 MakeInterpolant(u32 value, u32 step, u32 first)
+{
+  const u32 start = value + step * first;
+  const u32 values[4] = {start, start + step, start + step * 2, start + step * 3};
+  return LoadU32(values);
 }
 
+#endif // GPU_SW_VECTOR_SPANS
+
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 {
   DitherLUT lut = {};
@@ -79,6 +468,38 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
+u16 ALWAYS_INLINE_RELEASE GPU_SW_Backend::FetchTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x,
+                                                     u8 texcoord_y) const
+{
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
+    {
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
+
+    case GPUTextureMode::Palette8Bit:
+    {
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
+
+    default:
+    {
+      return GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+    }
+  }
+}
+
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
 void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
                                                       u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
@@ -91,38 +512,7 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
     texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
     VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
-    {
-      case GPUTextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
-
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
-
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
-
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-      }
-      break;
-    }
+    texture_color.bits = FetchTexel(cmd, texcoord_x, texcoord_y);
 
     if (texture_color.bits == 0)
       return;
@@ -220,7 +610,7 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
 }
 
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& area)
 {
   const s32 origin_x = cmd->x;
   const s32 origin_y = cmd->y;
@@ -230,7 +620,7 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
   for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
+    if (y < static_cast<s32>(area.top) || y > static_cast<s32>(area.bottom) ||
         (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
     {
       continue;
@@ -241,7 +631,7 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
     for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
     {
       const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
+      if (x < static_cast<s32>(area.left) || x > static_cast<s32>(area.right))
         continue;
 
       const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
@@ -358,10 +748,170 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
   }
 }
 
+#ifdef GPU_SW_VECTOR_SPANS
+
+template<bool texture_enable>
+bool ALWAYS_INLINE_RELEASE GPU_SW_Backend::CanShadeSpanVector(const GPUBackendDrawCommand* cmd, u32 x, u32 y,
+                                                             u32 count)
+{
+  if constexpr (!texture_enable)
+  {
+    return true;
+  }
+  else
+  {
+    // All eight texels are fetched before any pixel is written, so the span can't sample from itself.
+    Common::Rectangle<u32> page_rect, palette_rect;
+    GetTextureReadRectangles(cmd, &page_rect, &palette_rect);
+
+    const Common::Rectangle<u32> span_rect = Common::Rectangle<u32>::FromExtents(x, y, count, 1);
+    return !span_rect.Intersects(page_rect) && !span_rect.Intersects(palette_rect);
+  }
+}
+
+template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+         bool dithering_enable>
+void GPU_SW_Backend::ShadeSpanVector(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 count, const i_group& ig,
+                                     const i_deltas& idl)
+{
+  constexpr int FRAC_BITS = COORD_FBS + COORD_POST_PADDING;
+
+  // Interpolants are kept at full precision in 32-bit lanes, and narrowed to 8 bits for shading.
+  VecU32 r_low, r_high, g_low, g_high, b_low, b_high, r_step, g_step, b_step;
+  VecU16 r8, g8, b8;
+  if constexpr (shading_enable)
+  {
+    r_low = MakeInterpolant(ig.r, idl.dr_dx, 0);
+    r_high = MakeInterpolant(ig.r, idl.dr_dx, 4);
+    g_low = MakeInterpolant(ig.g, idl.dg_dx, 0);
+    g_high = MakeInterpolant(ig.g, idl.dg_dx, 4);
+    b_low = MakeInterpolant(ig.b, idl.db_dx, 0);
+    b_high = MakeInterpolant(ig.b, idl.db_dx, 4);
+    r_step = SplatU32(idl.dr_dx * VECTOR_SPAN_PIXELS);
+    g_step = SplatU32(idl.dg_dx * VECTOR_SPAN_PIXELS);
+    b_step = SplatU32(idl.db_dx * VECTOR_SPAN_PIXELS);
+  }
+  else
+  {
+    r8 = SplatU16(static_cast<u16>(Truncate8(ig.r >> FRAC_BITS)));
+    g8 = SplatU16(static_cast<u16>(Truncate8(ig.g >> FRAC_BITS)));
+    b8 = SplatU16(static_cast<u16>(Truncate8(ig.b >> FRAC_BITS)));
+  }
+
+  VecU32 u_low, u_high, v_low, v_high, u_step, v_step;
+  if constexpr (texture_enable)
+  {
+    u_low = MakeInterpolant(ig.u, idl.du_dx, 0);
+    u_high = MakeInterpolant(ig.u, idl.du_dx, 4);
+    v_low = MakeInterpolant(ig.v, idl.dv_dx, 0);
+    v_high = MakeInterpolant(ig.v, idl.dv_dx, 4);
+    u_step = SplatU32(idl.du_dx * VECTOR_SPAN_PIXELS);
+    v_step = SplatU32(idl.dv_dx * VECTOR_SPAN_PIXELS);
+  }
+
+  // x advances by a multiple of four, so the dither pattern is the same for every group of pixels.
+  u16 dither_offsets[VECTOR_SPAN_PIXELS];
+  for (u32 i = 0; i < VECTOR_SPAN_PIXELS; i++)
+  {
+    const s32 offset = dithering_enable ? DITHER_MATRIX[y & 3u][(x + i) & 3u] : DITHER_MATRIX[2][3];
+    dither_offsets[i] = static_cast<u16>(static_cast<s16>(offset));
+  }
+  const VecU16 dither = LoadU16(dither_offsets);
+  const auto dither_channel = [&dither](VecU16 value) { return ClampS16(SarS16<3>(AddU16(value, dither)), 0, 31); };
+
+  const VecU16 zero = SplatU16(0);
+  const VecU16 channel_mask = SplatU16(0x1F);
+  const VecU16 transparent_bit = SplatU16(0x8000u);
+  const VecU16 mask_and = SplatU16(cmd->params.GetMaskAND());
+  const VecU16 mask_or = SplatU16(cmd->params.GetMaskOR());
+  const GPUTransparencyMode transparency_mode = cmd->draw_mode.transparency_mode;
+
+  for (u32 i = 0; i < count; i += VECTOR_SPAN_PIXELS, x += VECTOR_SPAN_PIXELS)
+  {
+    if constexpr (shading_enable)
+    {
+      r8 = AndU16(NarrowU32(ShrU32<FRAC_BITS>(r_low), ShrU32<FRAC_BITS>(r_high)), SplatU16(0xFF));
+      g8 = AndU16(NarrowU32(ShrU32<FRAC_BITS>(g_low), ShrU32<FRAC_BITS>(g_high)), SplatU16(0xFF));
+      b8 = AndU16(NarrowU32(ShrU32<FRAC_BITS>(b_low), ShrU32<FRAC_BITS>(b_high)), SplatU16(0xFF));
+      r_low = AddU32(r_low, r_step);
+      r_high = AddU32(r_high, r_step);
+      g_low = AddU32(g_low, g_step);
+      g_high = AddU32(g_high, g_step);
+      b_low = AddU32(b_low, b_step);
+      b_high = AddU32(b_high, b_step);
+    }
+
+    u16* const dst = GetPixelPtr(x, y);
+    const VecU16 bg = LoadU16(dst);
+    VecU16 write_mask = CmpEqU16(AndU16(bg, mask_and), zero);
+    VecU16 color;
+
+    if constexpr (texture_enable)
+    {
+      // Apply texture window
+      const VecU16 u = OrU16(AndU16(NarrowU32(ShrU32<FRAC_BITS>(u_low), ShrU32<FRAC_BITS>(u_high)),
+                                    SplatU16(cmd->window.and_x)),
+                             SplatU16(cmd->window.or_x));
+      const VecU16 v = OrU16(AndU16(NarrowU32(ShrU32<FRAC_BITS>(v_low), ShrU32<FRAC_BITS>(v_high)),
+                                    SplatU16(cmd->window.and_y)),
+                             SplatU16(cmd->window.or_y));
+      u_low = AddU32(u_low, u_step);
+      u_high = AddU32(u_high, u_step);
+      v_low = AddU32(v_low, v_step);
+      v_high = AddU32(v_high, v_step);
+
+      // There's no gather for 16-bit lanes, so texels are fetched individually.
+      u16 texcoords_x[VECTOR_SPAN_PIXELS], texcoords_y[VECTOR_SPAN_PIXELS], texels[VECTOR_SPAN_PIXELS];
+      StoreU16(texcoords_x, u);
+      StoreU16(texcoords_y, v);
+      for (u32 j = 0; j < VECTOR_SPAN_PIXELS; j++)
+        texels[j] = FetchTexel(cmd, static_cast<u8>(texcoords_x[j]), static_cast<u8>(texcoords_y[j]));
+
+      const VecU16 texel = LoadU16(texels);
+      write_mask = SelectU16(CmpEqU16(texel, zero), zero, write_mask);
+
+      if constexpr (raw_texture_enable)
+      {
+        color = texel;
+      }
+      else
+      {
+        const VecU16 tex_r = AndU16(texel, channel_mask);
+        const VecU16 tex_g = AndU16(ShrU16<5>(texel), channel_mask);
+        const VecU16 tex_b = AndU16(ShrU16<10>(texel), channel_mask);
+        color = OrU16(OrU16(dither_channel(ShrU16<4>(MulU16(tex_r, r8))),
+                            ShlU16<5>(dither_channel(ShrU16<4>(MulU16(tex_g, g8))))),
+                      OrU16(ShlU16<10>(dither_channel(ShrU16<4>(MulU16(tex_b, b8)))), AndU16(texel, transparent_bit)));
+      }
+    }
+    else
+    {
+      // Non-textured transparent polygons don't set bit 15, but are treated as transparent.
+      color = OrU16(OrU16(dither_channel(r8), ShlU16<5>(dither_channel(g8))), ShlU16<10>(dither_channel(b8)));
+      if constexpr (transparency_enable)
+        color = OrU16(color, transparent_bit);
+    }
+
+    if constexpr (transparency_enable)
+    {
+      const VecU16 blended = NarrowU32(BlendPixels(transparency_mode, WidenLowU16(bg), WidenLowU16(color)),
+                                       BlendPixels(transparency_mode, WidenHighU16(bg), WidenHighU16(color)));
+      if constexpr (texture_enable)
+        color = SelectU16(CmpEqU16(AndU16(color, transparent_bit), transparent_bit), blended, color);
+      else
+        color = AndU16(blended, SplatU16(0x7FFFu));
+    }
+
+    StoreU16(dst, SelectU16(write_mask, OrU16(color, mask_or), bg));
+  }
+}
+
+#endif // GPU_SW_VECTOR_SPANS
+
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
 void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                              const i_deltas& idl)
+                              const i_deltas& idl, const Common::Rectangle<u32>& area)
 {
   if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
     return;
@@ -370,16 +920,16 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   s32 w = x_bound - x_start;
   s32 x = TruncateGPUVertexPosition(x_start);
 
-  if (x < static_cast<s32>(m_drawing_area.left))
+  if (x < static_cast<s32>(area.left))
   {
-    s32 delta = static_cast<s32>(m_drawing_area.left) - x;
+    s32 delta = static_cast<s32>(area.left) - x;
     x_ig_adjust += delta;
     x += delta;
     w -= delta;
   }
 
-  if ((x + w) > (static_cast<s32>(m_drawing_area.right) + 1))
-    w = static_cast<s32>(m_drawing_area.right) + 1 - x;
+  if ((x + w) > (static_cast<s32>(area.right) + 1))
+    w = static_cast<s32>(area.right) + 1 - x;
 
   if (w <= 0)
     return;
@@ -387,6 +937,24 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
+#ifdef GPU_SW_VECTOR_SPANS
+  const s32 vector_width = w & ~static_cast<s32>(VECTOR_SPAN_PIXELS - 1);
+  if (vector_width > 0 && m_vector_spans_enabled &&
+      CanShadeSpanVector<texture_enable>(cmd, static_cast<u32>(x), static_cast<u32>(y),
+                                         static_cast<u32>(vector_width)))
+  {
+    ShadeSpanVector<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      cmd, static_cast<u32>(x), static_cast<u32>(y), static_cast<u32>(vector_width), ig, idl);
+
+    w -= vector_width;
+    if (w == 0)
+      return;
+
+    x += vector_width;
+    AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, static_cast<u32>(vector_width));
+  }
+#endif
+
   do
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -409,7 +977,8 @@ template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool
 void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
-                                  const GPUBackendDrawPolygonCommand::Vertex* v2)
+                                  const GPUBackendDrawPolygonCommand::Vertex* v2,
+                                  const Common::Rectangle<u32>& area)
 {
   u32 core_vertex;
   {
@@ -564,14 +1133,14 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
 
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y < static_cast<s32>(m_drawing_area.top))
+        if (y < static_cast<s32>(area.top))
           break;
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(area.bottom))
           continue;
 
         DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl, area);
       }
     }
     else
@@ -580,14 +1149,14 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
       {
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(area.bottom))
           break;
 
-        if (y >= static_cast<s32>(m_drawing_area.top))
+        if (y >= static_cast<s32>(area.top))
         {
 
           DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl, area);
         }
 
         yi++;
@@ -633,7 +1202,7 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
 void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+                              const GPUBackendDrawLineCommand::Vertex* p1, const Common::Rectangle<u32>& area)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -693,8 +1262,8 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
     const s32 y = (cur_point.y >> Line_XY_FractBits) & 2047;
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
-        x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        x >= static_cast<s32>(area.left) && x <= static_cast<s32>(area.right) &&
+        y >= static_cast<s32>(area.top) && y <= static_cast<s32>(area.bottom))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
@@ -870,10 +1439,239 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
   }
 }
 
-void GPU_SW_Backend::FlushRender() {}
+void GPU_SW_Backend::FlushRender()
+{
+  if (m_batch_command_count == 0)
+    return;
+
+  m_next_batch_tile.store(0);
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_generation++;
+    m_workers_busy = static_cast<u32>(m_workers.size());
+  }
+  m_worker_wake_cv.notify_all();
+
+  RasterizeTiles();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_done_cv.wait(lock, [this]() { return m_workers_busy == 0; });
+  }
+
+  for (const u32 tile : m_batch_tiles)
+    m_tile_bins[tile].clear();
+  m_batch_tiles.clear();
+  m_batch_data.clear();
+  m_batch_command_count = 0;
+  m_batch_bounds.SetInvalid();
+}
 
 void GPU_SW_Backend::DrawingAreaChanged() {}
 
+static Common::Rectangle<u32> ClipToDrawingArea(const Common::Rectangle<u32>& drawing_area, s32 left, s32 top,
+                                                s32 right, s32 bottom)
+{
+  // bounds are inclusive, the returned rectangle is exclusive
+  left = std::max(left, static_cast<s32>(drawing_area.left));
+  top = std::max(top, static_cast<s32>(drawing_area.top));
+  right = std::min(right, static_cast<s32>(drawing_area.right));
+  bottom = std::min(bottom, static_cast<s32>(drawing_area.bottom));
+  if (left > right || top > bottom)
+    return {};
+
+  return Common::Rectangle<u32>(static_cast<u32>(left), static_cast<u32>(top), static_cast<u32>(right) + 1,
+                                static_cast<u32>(bottom) + 1);
+}
+
+template<typename T>
+static Common::Rectangle<u32> GetVertexBounds(const Common::Rectangle<u32>& drawing_area, const T* vertices,
+                                              u32 num_vertices)
+{
+  s32 min_x = vertices[0].x;
+  s32 max_x = vertices[0].x;
+  s32 min_y = vertices[0].y;
+  s32 max_y = vertices[0].y;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    min_x = std::min(min_x, vertices[i].x);
+    max_x = std::max(max_x, vertices[i].x);
+    min_y = std::min(min_y, vertices[i].y);
+    max_y = std::max(max_y, vertices[i].y);
+  }
+
+  // The rasterizers wrap coordinates to 11 bits, so anything near the edge of that range could end up anywhere.
+  // Edge stepping can also round a pixel outside of the vertices, hence the padding.
+  static constexpr s32 PADDING = 2;
+  if (min_x < (-1024 + PADDING) || max_x > (1023 - PADDING) || min_y < (-1024 + PADDING) ||
+      max_y > (1023 - PADDING))
+  {
+    return ClipToDrawingArea(drawing_area, 0, 0, VRAM_WIDTH - 1, VRAM_HEIGHT - 1);
+  }
+
+  return ClipToDrawingArea(drawing_area, min_x - PADDING, min_y - PADDING, max_x + PADDING, max_y + PADDING);
+}
+
+Common::Rectangle<u32> GPU_SW_Backend::GetPolygonBounds(const GPUBackendDrawPolygonCommand* cmd) const
+{
+  return GetVertexBounds(m_drawing_area, cmd->vertices, cmd->num_vertices);
+}
+
+Common::Rectangle<u32> GPU_SW_Backend::GetLineBounds(const GPUBackendDrawLineCommand* cmd) const
+{
+  return GetVertexBounds(m_drawing_area, cmd->vertices, cmd->num_vertices);
+}
+
+Common::Rectangle<u32> GPU_SW_Backend::GetRectangleBounds(const GPUBackendDrawRectangleCommand* cmd) const
+{
+  if (cmd->width == 0 || cmd->height == 0)
+    return {};
+
+  return ClipToDrawingArea(m_drawing_area, cmd->x, cmd->y, cmd->x + static_cast<s32>(cmd->width) - 1,
+                           cmd->y + static_cast<s32>(cmd->height) - 1);
+}
+
+bool GPU_SW_Backend::BinCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& bounds)
+{
+  if (cmd->type != GPUBackendCommandType::DrawLine && cmd->rc.texture_enable)
+  {
+    // Texels can't be sampled from tiles which another worker is still drawing to. Lines are never textured.
+    Common::Rectangle<u32> page_rect, palette_rect;
+    GetTextureReadRectangles(cmd, &page_rect, &palette_rect);
+
+    // If the primitive samples from where it draws, only drawing it in order with a single thread gives the same
+    // result, since texels can be overwritten part way through.
+    if (page_rect.Intersects(bounds) || palette_rect.Intersects(bounds))
+    {
+      FlushRender();
+      return false;
+    }
+
+    if (page_rect.Intersects(m_batch_bounds) || palette_rect.Intersects(m_batch_bounds))
+      FlushRender();
+  }
+
+  const u32 offset = static_cast<u32>(m_batch_data.size());
+  m_batch_data.resize(offset + cmd->size);
+  std::memcpy(&m_batch_data[offset], cmd, cmd->size);
+  m_batch_bounds.Include(bounds);
+  m_batch_command_count++;
+
+  const u32 first_tile_x = bounds.left / TILE_WIDTH;
+  const u32 last_tile_x = (bounds.right - 1) / TILE_WIDTH;
+  const u32 first_tile_y = bounds.top / TILE_HEIGHT;
+  const u32 last_tile_y = (bounds.bottom - 1) / TILE_HEIGHT;
+  for (u32 tile_y = first_tile_y; tile_y <= last_tile_y; tile_y++)
+  {
+    for (u32 tile_x = first_tile_x; tile_x <= last_tile_x; tile_x++)
+    {
+      const u32 tile = tile_y * TILES_X + tile_x;
+      std::vector<u32>& bin = m_tile_bins[tile];
+      if (bin.empty())
+        m_batch_tiles.push_back(tile);
+      bin.push_back(offset);
+    }
+  }
+
+  if (m_batch_command_count >= MAX_BATCH_COMMANDS || m_batch_data.size() >= MAX_BATCH_SIZE)
+    FlushRender();
+
+  return true;
+}
+
+void GPU_SW_Backend::DrawBinnedCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& area)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+      DrawPolygon(static_cast<const GPUBackendDrawPolygonCommand*>(cmd), area);
+      break;
+
+    case GPUBackendCommandType::DrawRectangle:
+      DrawRectangle(static_cast<const GPUBackendDrawRectangleCommand*>(cmd), area);
+      break;
+
+    case GPUBackendCommandType::DrawLine:
+      DrawLine(static_cast<const GPUBackendDrawLineCommand*>(cmd), area);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
+void GPU_SW_Backend::RasterizeTiles()
+{
+  // Each tile's commands are drawn in order by one thread, so the result is the same as drawing them serially.
+  const u32 tile_count = static_cast<u32>(m_batch_tiles.size());
+  for (;;)
+  {
+    const u32 index = m_next_batch_tile.fetch_add(1);
+    if (index >= tile_count)
+      break;
+
+    const u32 tile = m_batch_tiles[index];
+    const u32 tile_left = (tile % TILES_X) * TILE_WIDTH;
+    const u32 tile_top = (tile / TILES_X) * TILE_HEIGHT;
+    const Common::Rectangle<u32> area(std::max(tile_left, m_drawing_area.left), std::max(tile_top, m_drawing_area.top),
+                                      std::min(tile_left + TILE_WIDTH - 1, m_drawing_area.right),
+                                      std::min(tile_top + TILE_HEIGHT - 1, m_drawing_area.bottom));
+
+    for (const u32 offset : m_tile_bins[tile])
+      DrawBinnedCommand(reinterpret_cast<const GPUBackendDrawCommand*>(&m_batch_data[offset]), area);
+  }
+}
+
+void GPU_SW_Backend::StartWorkers(u32 thread_count)
+{
+  m_workers_shutdown = false;
+  for (u32 i = 0; i < thread_count; i++)
+    m_workers.emplace_back(&GPU_SW_Backend::WorkerThreadEntryPoint, this, m_worker_generation);
+
+  Log_InfoPrintf("Started %u software renderer worker threads.", thread_count);
+}
+
+void GPU_SW_Backend::StopWorkers()
+{
+  if (m_workers.empty())
+    return;
+
+  FlushRender();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_workers_shutdown = true;
+  }
+  m_worker_wake_cv.notify_all();
+
+  for (std::thread& thread : m_workers)
+    thread.join();
+  m_workers.clear();
+  Log_InfoPrint("Software renderer worker threads stopped.");
+}
+
+void GPU_SW_Backend::WorkerThreadEntryPoint(u32 generation)
+{
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  for (;;)
+  {
+    m_worker_wake_cv.wait(lock, [this, generation]() {
+      return m_workers_shutdown || m_worker_generation != generation;
+    });
+    if (m_workers_shutdown)
+      break;
+
+    generation = m_worker_generation;
+    lock.unlock();
+    RasterizeTiles();
+    lock.lock();
+
+    if (--m_workers_busy == 0)
+      m_worker_done_cv.notify_one();
+  }
+}
+
 GPU_SW_Backend::DrawLineFunction GPU_SW_Backend::GetDrawLineFunction(bool shading_enable, bool transparency_enable,
                                                                      bool dithering_enable)
 {
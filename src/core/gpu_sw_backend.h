@@ -1,7 +1,11 @@
 #pragma once
 #include "gpu_backend.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class GPU_SW_Backend final : public GPUBackend
@@ -11,7 +15,12 @@ public:
   ~GPU_SW_Backend() override;
 
   bool Initialize(bool force_thread) override;
+  void UpdateSettings() override;
   void Reset(bool clear_vram) override;
+  void Shutdown() override;
+
+  /// Disables the vectorized span shader, so its output can be compared against the scalar path.
+  void SetVectorSpansEnabled(bool enabled) { m_vector_spans_enabled = enabled; }
 
   ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
@@ -95,17 +104,58 @@ protected:
   void FlushRender() override;
   void DrawingAreaChanged() override;
 
+  /// Draws the primitive, clipped to area. Coordinates in area are inclusive, as with the drawing area.
+  void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& area);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& area);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& area);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Tile binning
+  //////////////////////////////////////////////////////////////////////////
+  enum : u32
+  {
+    TILE_WIDTH = 64,
+    TILE_HEIGHT = 32,
+    TILES_X = VRAM_WIDTH / TILE_WIDTH,
+    TILES_Y = VRAM_HEIGHT / TILE_HEIGHT,
+    TILE_COUNT = TILES_X * TILES_Y,
+    MAX_BATCH_COMMANDS = 4096,
+    MAX_BATCH_SIZE = 1024 * 1024,
+  };
+
+  ALWAYS_INLINE bool IsBinning() const { return !m_workers.empty(); }
+
+  /// Returns the area which the primitive can touch (right/bottom exclusive), or an invalid rectangle if it is clipped.
+  Common::Rectangle<u32> GetPolygonBounds(const GPUBackendDrawPolygonCommand* cmd) const;
+  Common::Rectangle<u32> GetLineBounds(const GPUBackendDrawLineCommand* cmd) const;
+  Common::Rectangle<u32> GetRectangleBounds(const GPUBackendDrawRectangleCommand* cmd) const;
+
+  /// Queues the command for the worker threads. Returns false if it must be drawn immediately instead, because it
+  /// samples from VRAM which it draws to itself.
+  bool BinCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& bounds);
+  void DrawBinnedCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& area);
+  void RasterizeTiles();
+
+  static u32 GetConfiguredWorkerCount();
+  void StartWorkers(u32 thread_count);
+  void StopWorkers();
+  void WorkerThreadEntryPoint(u32 generation);
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
+  /// Returns the texel at the specified texture coordinates, which must already have the texture window applied.
+  u16 FetchTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x, u8 texcoord_y) const;
+
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
   void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
                   u8 texcoord_y);
 
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& area);
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd,
+                                                         const Common::Rectangle<u32>& area);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -137,31 +187,66 @@ protected:
   template<bool shading_enable, bool texture_enable>
   void AddIDeltas_DY(i_group& ig, const i_deltas& idl, u32 count = 1);
 
+  /// Number of pixels shaded per iteration of ShadeSpanVector().
+  static constexpr u32 VECTOR_SPAN_PIXELS = 8;
+
+  /// Returns true if the span can be shaded with ShadeSpanVector(), i.e. it doesn't sample from VRAM it writes to.
+  template<bool texture_enable>
+  bool CanShadeSpanVector(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 count);
+
+  /// Shades count pixels starting at (x, y), where count is a multiple of VECTOR_SPAN_PIXELS. Produces the same result
+  /// as calling ShadePixel() for each pixel.
+  template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+           bool dithering_enable>
+  void ShadeSpanVector(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 count, const i_group& ig,
+                       const i_deltas& idl);
+
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
   void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                const i_deltas& idl);
+                const i_deltas& idl, const Common::Rectangle<u32>& area);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
   void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2,
+                    const Common::Rectangle<u32>& area);
 
   using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
-                                                        const GPUBackendDrawPolygonCommand::Vertex* v2);
+                                                        const GPUBackendDrawPolygonCommand::Vertex* v2,
+                                                        const Common::Rectangle<u32>& area);
   DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable, bool texture_enable, bool raw_texture_enable,
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
   void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                const GPUBackendDrawLineCommand::Vertex* p1);
+                const GPUBackendDrawLineCommand::Vertex* p1, const Common::Rectangle<u32>& area);
 
   using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
-                                                    const GPUBackendDrawLineCommand::Vertex* p1);
+                                                    const GPUBackendDrawLineCommand::Vertex* p1,
+                                                    const Common::Rectangle<u32>& area);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  // Commands are copied out of the FIFO, since the space is reused once the GPU thread moves on.
+  std::vector<u8> m_batch_data;
+  u32 m_batch_command_count = 0;
+  Common::Rectangle<u32> m_batch_bounds;
+  std::array<std::vector<u32>, TILE_COUNT> m_tile_bins;
+  std::vector<u32> m_batch_tiles;
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_wake_cv;
+  std::condition_variable m_worker_done_cv;
+  u32 m_worker_generation = 0;
+  u32 m_workers_busy = 0;
+  bool m_workers_shutdown = false;
+  std::atomic<u32> m_next_batch_tile{0};
+
+  bool m_vector_spans_enabled = true;
 };
@@ -14,6 +14,7 @@
 #include "gpu.h"
 #include "gte.h"
 #include "host_display.h"
+#include "mdec.h"
 #include "pgxp.h"
 #include "save_state_version.h"
 #include "spu.h"
@@ -142,6 +143,10 @@ void HostInterface::PauseSystem(bool paused)
   if (paused == System::IsPaused() || System::IsShutdown())
     return;
 
+  // queued samples have to be written out before output stops, otherwise the SPU render thread can block on it
+  if (paused)
+    g_spu.SyncRenderThread();
+
   System::SetState(paused ? System::State::Paused : System::State::Running);
   if (!paused)
     m_audio_stream->EmptyBuffers();
@@ -446,7 +451,7 @@ bool HostInterface::SaveState(const char* filename)
   if (!stream)
     return false;
 
-  const bool result = System::SaveState(stream.get());
+  const bool result = System::SaveState(stream.get(), 256, g_settings.save_state_compression);
   if (!result)
   {
     ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
@@ -482,6 +487,8 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Main", "PauseOnFocusLoss", false);
   si.SetBoolValue("Main", "PauseOnMenu", true);
   si.SetBoolValue("Main", "SaveStateOnExit", true);
+  si.SetStringValue("Main", "SaveStateCompression",
+                    Settings::GetSaveStateCompressionName(Settings::DEFAULT_SAVE_STATE_COMPRESSION));
   si.SetBoolValue("Main", "ConfirmPowerOff", true);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   si.SetBoolValue("Main", "ApplyGameSettings", true);
@@ -489,7 +496,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Main", "DisableAllEnhancements", false);
   si.SetBoolValue("Main", "RewindEnable", false);
   si.SetFloatValue("Main", "RewindFrequency", 10.0f);
-  si.SetIntValue("Main", "RewindSaveSlots", 10);
+  si.SetIntValue("Main", "RewindMemoryLimit", static_cast<int>(Settings::DEFAULT_REWIND_MEMORY_LIMIT));
   si.SetFloatValue("Main", "RunaheadFrameCount", 0);
 
   si.SetStringValue("CPU", "ExecutionMode", Settings::GetCPUExecutionModeName(Settings::DEFAULT_CPU_EXECUTION_MODE));
@@ -508,6 +515,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
   si.SetBoolValue("GPU", "PerSampleShading", false);
   si.SetBoolValue("GPU", "UseThread", true);
+  si.SetIntValue("GPU", "SoftwareRendererThreads", 1);
   si.SetBoolValue("GPU", "ThreadedPresentation", true);
   si.SetBoolValue("GPU", "TrueColor", false);
   si.SetBoolValue("GPU", "ScaledDithering", true);
@@ -525,6 +533,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("GPU", "PGXPPreserveProjFP", false);
   si.SetFloatValue("GPU", "PGXPTolerance", -1.0f);
   si.SetBoolValue("GPU", "PGXPDepthBuffer", false);
+  si.SetBoolValue("GPU", "PGXPShadowPaging", false);
   si.SetFloatValue("GPU", "PGXPDepthClearThreshold", Settings::DEFAULT_GPU_PGXP_DEPTH_THRESHOLD);
 
   si.SetStringValue("Display", "CropMode", Settings::GetDisplayCropModeName(Settings::DEFAULT_DISPLAY_CROP_MODE));
@@ -555,12 +564,15 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetFloatValue("Display", "MaxFPS", Settings::DEFAULT_DISPLAY_MAX_FPS);
 
   si.SetIntValue("CDROM", "ReadaheadSectors", Settings::DEFAULT_CDROM_READAHEAD_SECTORS);
+  si.SetIntValue("CDROM", "ReadCacheSize", static_cast<int>(Settings::DEFAULT_CDROM_READ_CACHE_SIZE));
   si.SetBoolValue("CDROM", "RegionCheck", false);
   si.SetBoolValue("CDROM", "LoadImageToRAM", false);
   si.SetBoolValue("CDROM", "MuteCDAudio", false);
   si.SetIntValue("CDROM", "ReadSpeedup", 1);
   si.SetIntValue("CDROM", "SeekSpeedup", 1);
 
+  si.SetBoolValue("MDEC", "UseThread", false);
+
   si.SetStringValue("Audio", "Backend", Settings::GetAudioBackendName(Settings::DEFAULT_AUDIO_BACKEND));
   si.SetIntValue("Audio", "OutputVolume", 100);
   si.SetIntValue("Audio", "FastForwardVolume", 100);
@@ -569,6 +581,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetIntValue("Audio", "OutputMuted", false);
   si.SetBoolValue("Audio", "Sync", true);
   si.SetBoolValue("Audio", "DumpOnBoot", false);
+  si.SetBoolValue("Audio", "SPUThread", false);
 
   si.SetStringValue("BIOS", "SearchDirectory", "");
   si.SetStringValue("BIOS", "PathNTSCU", "");
@@ -610,6 +623,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Debug", "ShowTimersState", false);
   si.SetBoolValue("Debug", "ShowMDECState", false);
   si.SetBoolValue("Debug", "ShowDMAState", false);
+  si.SetBoolValue("Debug", "ShowCodeCacheState", false);
 
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS));
   si.SetIntValue("Hacks", "DMAHaltTicks", static_cast<int>(Settings::DEFAULT_DMA_HALT_TICKS));
@@ -729,6 +743,7 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
                                Settings::GetAudioBackendName(g_settings.audio_backend));
       }
       DebugAssert(m_audio_stream);
+      g_spu.SyncRenderThread();
       m_audio_stream.reset();
       CreateAudioStream();
       m_audio_stream->PauseOutput(System::IsPaused());
@@ -751,7 +766,8 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
-         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache))
+         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_tiered != old_settings.cpu_recompiler_tiered))
     {
       AddOSDMessage(TranslateStdString("OSDMessage", "Recompiler options changed, flushing all blocks."), 5.0f);
       CPU::CodeCache::Flush();
@@ -766,6 +782,7 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_sw_threads != old_settings.gpu_sw_threads ||
         g_settings.gpu_use_software_renderer_for_readbacks != old_settings.gpu_use_software_renderer_for_readbacks ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
@@ -803,6 +820,7 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.gpu_pgxp_enable != old_settings.gpu_pgxp_enable ||
         (g_settings.gpu_pgxp_enable && (g_settings.gpu_pgxp_culling != old_settings.gpu_pgxp_culling ||
                                         g_settings.gpu_pgxp_vertex_cache != old_settings.gpu_pgxp_vertex_cache ||
+                                        g_settings.gpu_pgxp_shadow_paging != old_settings.gpu_pgxp_shadow_paging ||
                                         g_settings.gpu_pgxp_cpu != old_settings.gpu_pgxp_cpu)))
     {
       if (g_settings.IsUsingCodeCache())
@@ -824,6 +842,12 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
       g_cdrom.SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
 
+    if (g_settings.audio_spu_thread != old_settings.audio_spu_thread)
+      g_spu.UpdateSettings();
+
+    if (g_settings.mdec_use_thread != old_settings.mdec_use_thread)
+      g_mdec.UpdateSettings();
+
     if (g_settings.memory_card_types != old_settings.memory_card_types ||
         g_settings.memory_card_paths != old_settings.memory_card_paths ||
         (g_settings.memory_card_use_playlist_title != old_settings.memory_card_use_playlist_title &&
@@ -835,7 +859,7 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
 
     if (g_settings.rewind_enable != old_settings.rewind_enable ||
         g_settings.rewind_save_frequency != old_settings.rewind_save_frequency ||
-        g_settings.rewind_save_slots != old_settings.rewind_save_slots ||
+        g_settings.rewind_memory_limit != old_settings.rewind_memory_limit ||
         g_settings.runahead_frames != old_settings.runahead_frames)
     {
       System::UpdateMemorySaveStateSettings();
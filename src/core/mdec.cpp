@@ -1,10 +1,13 @@
 #include "mdec.h"
 #include "common/log.h"
+#include "common/mdec_transform.h"
 #include "common/state_wrapper.h"
 #include "cpu_core.h"
 #include "dma.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "profiler.h"
+#include "settings.h"
 #include "system.h"
 Log_SetChannel(MDEC);
 
@@ -21,10 +24,25 @@ void MDEC::Initialize()
     [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MDEC*>(param)->CopyOutBlock(); }, this, false);
   m_total_blocks_decoded = 0;
   Reset();
+
+  if (g_settings.mdec_use_thread)
+    StartWorkerThread();
+}
+
+void MDEC::UpdateSettings()
+{
+  if (m_use_worker_thread == g_settings.mdec_use_thread)
+    return;
+
+  if (g_settings.mdec_use_thread)
+    StartWorkerThread();
+  else
+    StopWorkerThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopWorkerThread();
   m_block_copy_out_event.reset();
 }
 
@@ -36,6 +54,8 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  SyncWorkerThread();
+
   sw.Do(&m_status.bits);
   sw.Do(&m_enable_dma_in);
   sw.Do(&m_enable_dma_out);
@@ -153,6 +173,7 @@ bool MDEC::HasPendingBlockCopyOut() const
 
 void MDEC::SoftReset()
 {
+  SyncWorkerThread();
   m_status.bits = 0;
   m_enable_dma_in = false;
   m_enable_dma_out = false;
@@ -232,6 +253,8 @@ void MDEC::WriteCommandRegister(u32 value)
 
 void MDEC::Execute()
 {
+  Profiler::ScopedSection profile(Profiler::Section::MDEC);
+
   for (;;)
   {
     switch (m_state)
@@ -297,6 +320,7 @@ void MDEC::Execute()
         if (m_remaining_halfwords == 0 && m_current_block != NUM_BLOCKS)
         {
           // expecting data, but nothing more will be coming. bail out
+          SyncWorkerThread();
           ResetDecoder();
           m_state = State::Idle;
           continue;
@@ -383,13 +407,11 @@ bool MDEC::DecodeMonoMacroblock()
   if (!rl_decode_block(m_blocks[0].data(), m_iq_y.data()))
     return false;
 
-  IDCT(m_blocks[0].data());
-
   Log_DebugPrintf("Decoded mono macroblock, %u words remaining", m_remaining_halfwords / 2);
   ResetDecoder();
   m_state = State::WritingMacroblock;
 
-  y_to_mono(m_blocks[0]);
+  QueueTransform(0, 1, TransformOutput::Mono);
 
   ScheduleBlockCopyOut(s_ticks_per_block[static_cast<u8>(m_status.data_output_depth)] * 6);
 
@@ -399,26 +421,33 @@ bool MDEC::DecodeMonoMacroblock()
 
 bool MDEC::DecodeColoredMacroblock()
 {
+  const u32 first_block = m_current_block;
   for (; m_current_block < NUM_BLOCKS; m_current_block++)
   {
     if (!rl_decode_block(m_blocks[m_current_block].data(), (m_current_block >= 2) ? m_iq_y.data() : m_iq_uv.data()))
-      return false;
+    {
+      // queue what we have so far, the rest follows when the data arrives
+      if (m_current_block != first_block)
+        QueueTransform(first_block, m_current_block, TransformOutput::None);
 
-    IDCT(m_blocks[m_current_block].data());
+      return false;
+    }
   }
 
   if (!m_data_out_fifo.IsEmpty())
+  {
+    if (first_block != NUM_BLOCKS)
+      QueueTransform(first_block, NUM_BLOCKS, TransformOutput::None);
+
     return false;
+  }
 
   // done decoding
   Log_DebugPrintf("Decoded colored macroblock, %u words remaining", m_remaining_halfwords / 2);
   ResetDecoder();
   m_state = State::WritingMacroblock;
 
-  yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
-  yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
-  yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
-  yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
+  QueueTransform(first_block, NUM_BLOCKS, TransformOutput::Colored);
   m_total_blocks_decoded += 4;
 
   ScheduleBlockCopyOut(s_ticks_per_block[static_cast<u8>(m_status.data_output_depth)] * 6);
@@ -435,9 +464,14 @@ void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 
 void MDEC::CopyOutBlock()
 {
+  Profiler::ScopedSection profile(Profiler::Section::MDEC);
+
   Assert(m_state == State::WritingMacroblock);
   m_block_copy_out_event->Deactivate();
 
+  // the modelled decode time is up, so the worker thread should have finished long ago
+  SyncWorkerThread();
+
   switch (m_status.data_output_depth)
   {
     case DataOutputDepth_4Bit:
@@ -475,61 +509,18 @@ void MDEC::CopyOutBlock()
     case DataOutputDepth_24Bit:
     {
       // pack tightly
-      u32 index = 0;
-      u32 state = 0;
-      u32 rgb = 0;
-      while (index < m_block_rgb.size())
-      {
-        switch (state)
-        {
-          case 0:
-            rgb = m_block_rgb[index++]; // RGB-
-            state = 1;
-            break;
-          case 1:
-            rgb |= (m_block_rgb[index] & 0xFF) << 24; // RGBR
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 8; // GB--
-            index++;
-            state = 2;
-            break;
-          case 2:
-            rgb |= m_block_rgb[index] << 16; // GBRG
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 16; // B---
-            index++;
-            state = 3;
-            break;
-          case 3:
-            rgb |= m_block_rgb[index] << 8; // BRGB
-            m_data_out_fifo.Push(rgb);
-            index++;
-            state = 0;
-            break;
-        }
-      }
-      break;
+      std::array<u32, 256 * 3 / 4> packed;
+      MDECTransform::PackRGB24(m_block_rgb.data(), packed.data(), static_cast<u32>(m_block_rgb.size()));
+      m_data_out_fifo.PushRange(packed.data(), static_cast<u32>(packed.size()));
     }
+    break;
 
     case DataOutputDepth_15Bit:
     {
-      const u16 a = ZeroExtend16(m_status.data_output_bit15.GetValue());
-      for (u32 i = 0; i < static_cast<u32>(m_block_rgb.size());)
-      {
-        u32 color = m_block_rgb[i++];
-        u16 r = Truncate16((color >> 3) & 0x1Fu);
-        u16 g = Truncate16((color >> 11) & 0x1Fu);
-        u16 b = Truncate16((color >> 19) & 0x1Fu);
-        const u16 color15a = r | (g << 5) | (b << 10) | (a << 15);
-
-        color = m_block_rgb[i++];
-        r = Truncate16((color >> 3) & 0x1Fu);
-        g = Truncate16((color >> 11) & 0x1Fu);
-        b = Truncate16((color >> 19) & 0x1Fu);
-        const u16 color15b = r | (g << 5) | (b << 10) | (a << 15);
-
-        m_data_out_fifo.Push(ZeroExtend32(color15a) | (ZeroExtend32(color15b) << 16));
-      }
+      std::array<u32, 256 / 2> packed;
+      MDECTransform::PackRGB15(m_block_rgb.data(), packed.data(), static_cast<u32>(m_block_rgb.size()),
+                               m_status.data_output_bit15 != 0);
+      m_data_out_fifo.PushRange(packed.data(), static_cast<u32>(packed.size()));
     }
     break;
 
@@ -545,6 +536,127 @@ void MDEC::CopyOutBlock()
   Execute();
 }
 
+void MDEC::TransformBlocks(u32 first_block, u32 last_block, TransformOutput output)
+{
+  for (u32 i = first_block; i < last_block; i++)
+    MDECTransform::IDCT(m_blocks[i].data(), m_scale_table.data());
+
+  switch (output)
+  {
+    case TransformOutput::Mono:
+      MDECTransform::YToMono(m_block_rgb.data(), m_blocks[0].data());
+      break;
+
+    case TransformOutput::Colored:
+      MDECTransform::YUVToRGB(m_block_rgb.data(), 0, 0, m_blocks[0].data(), m_blocks[1].data(), m_blocks[2].data());
+      MDECTransform::YUVToRGB(m_block_rgb.data(), 8, 0, m_blocks[0].data(), m_blocks[1].data(), m_blocks[3].data());
+      MDECTransform::YUVToRGB(m_block_rgb.data(), 0, 8, m_blocks[0].data(), m_blocks[1].data(), m_blocks[4].data());
+      MDECTransform::YUVToRGB(m_block_rgb.data(), 8, 8, m_blocks[0].data(), m_blocks[1].data(), m_blocks[5].data());
+      break;
+
+    default:
+      break;
+  }
+}
+
+void MDEC::QueueTransform(u32 first_block, u32 last_block, TransformOutput output)
+{
+  if (!m_use_worker_thread)
+  {
+    TransformBlocks(first_block, last_block, output);
+    return;
+  }
+
+  // only complete macroblocks are handed over, so there is one wakeup per macroblock
+  m_worker_batch.push_back(TransformJob{static_cast<u8>(first_block), static_cast<u8>(last_block), output});
+  if (output == TransformOutput::None)
+    return;
+
+  std::unique_lock lock(m_worker_mutex);
+  m_worker_queue.insert(m_worker_queue.end(), m_worker_batch.begin(), m_worker_batch.end());
+  m_worker_wake_cv.notify_one();
+  lock.unlock();
+
+  m_worker_batch.clear();
+  m_worker_thread_pending = true;
+}
+
+void MDEC::StartWorkerThread()
+{
+  m_worker_thread_shutdown = false;
+  m_worker_thread_busy = false;
+  m_use_worker_thread = true;
+  m_worker_thread = std::thread(&MDEC::WorkerThreadEntryPoint, this);
+  Log_InfoPrint("MDEC worker thread started.");
+}
+
+void MDEC::StopWorkerThread()
+{
+  if (!m_use_worker_thread)
+    return;
+
+  SyncWorkerThread();
+
+  {
+    std::unique_lock lock(m_worker_mutex);
+    m_worker_thread_shutdown = true;
+    m_worker_wake_cv.notify_one();
+  }
+
+  m_worker_thread.join();
+  m_use_worker_thread = false;
+  Log_InfoPrint("MDEC worker thread stopped.");
+}
+
+void MDEC::SyncWorkerThread()
+{
+  if (!m_worker_thread_pending && m_worker_batch.empty())
+    return;
+
+  if (m_worker_thread_pending)
+  {
+    std::unique_lock lock(m_worker_mutex);
+    m_worker_done_cv.wait(lock, [this]() { return !m_worker_thread_busy; });
+
+    // anything the worker hasn't picked up yet is quicker to transform here than to wait for
+    m_worker_batch.insert(m_worker_batch.begin(), m_worker_queue.begin(), m_worker_queue.end());
+    m_worker_queue.clear();
+    m_worker_thread_pending = false;
+  }
+
+  for (const TransformJob& job : m_worker_batch)
+    TransformBlocks(job.first_block, job.last_block, job.output);
+  m_worker_batch.clear();
+}
+
+void MDEC::WorkerThreadEntryPoint()
+{
+  std::vector<TransformJob> jobs;
+
+  std::unique_lock lock(m_worker_mutex);
+  for (;;)
+  {
+    m_worker_wake_cv.wait(lock, [this]() { return !m_worker_queue.empty() || m_worker_thread_shutdown; });
+    if (m_worker_queue.empty())
+      break;
+
+    jobs.swap(m_worker_queue);
+    m_worker_thread_busy = true;
+    lock.unlock();
+
+    {
+      Profiler::ScopedThreadSection profile(Profiler::Section::MDEC);
+      for (const TransformJob& job : jobs)
+        TransformBlocks(job.first_block, job.last_block, job.output);
+    }
+    jobs.clear();
+
+    lock.lock();
+    m_worker_thread_busy = false;
+    m_worker_done_cv.notify_one();
+  }
+}
+
 static constexpr std::array<u8, 64> zagzig = {{0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
                                                12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
                                                35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
@@ -620,76 +732,6 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
   return false;
 }
 
-void MDEC::IDCT(s16* blk)
-{
-  std::array<s64, 64> temp_buffer;
-  for (u32 x = 0; x < 8; x++)
-  {
-    for (u32 y = 0; y < 8; y++)
-    {
-      s64 sum = 0;
-      for (u32 u = 0; u < 8; u++)
-        sum += s32(blk[u * 8 + x]) * s32(m_scale_table[u * 8 + y]);
-      temp_buffer[x + y * 8] = sum;
-    }
-  }
-  for (u32 x = 0; x < 8; x++)
-  {
-    for (u32 y = 0; y < 8; y++)
-    {
-      s64 sum = 0;
-      for (u32 u = 0; u < 8; u++)
-        sum += s64(temp_buffer[u + y * 8]) * s32(m_scale_table[u * 8 + x]);
-
-      blk[x + y * 8] =
-        static_cast<s16>(std::clamp<s32>(SignExtendN<9, s32>((sum >> 32) + ((sum >> 31) & 1)), -128, 127));
-    }
-  }
-}
-
-void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                      const std::array<s16, 64>& Yblk)
-{
-  for (u32 y = 0; y < 8; y++)
-  {
-    for (u32 x = 0; x < 8; x++)
-    {
-      s16 R = Crblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
-      s16 B = Cbblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
-      s16 G = static_cast<s16>((-0.3437f * static_cast<float>(B)) + (-0.7143f * static_cast<float>(R)));
-
-      R = static_cast<s16>(1.402f * static_cast<float>(R));
-      B = static_cast<s16>(1.772f * static_cast<float>(B));
-
-      s16 Y = Yblk[x + y * 8];
-      R = static_cast<s16>(std::clamp(static_cast<int>(Y) + R, -128, 127));
-      G = static_cast<s16>(std::clamp(static_cast<int>(Y) + G, -128, 127));
-      B = static_cast<s16>(std::clamp(static_cast<int>(Y) + B, -128, 127));
-
-      // TODO: Signed output
-      R += 128;
-      G += 128;
-      B += 128;
-
-      m_block_rgb[(x + xx) + ((y + yy) * 16)] = ZeroExtend32(static_cast<u16>(R)) |
-                                                (ZeroExtend32(static_cast<u16>(G)) << 8) |
-                                                (ZeroExtend32(static_cast<u16>(B)) << 16);
-    }
-  }
-}
-
-void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
-{
-  for (u32 i = 0; i < 64; i++)
-  {
-    s16 Y = Yblk[i];
-    Y = SignExtendN<10, s16>(Y);
-    Y = std::clamp<s16>(Y, -128, 127);
-    Y += 128;
-    m_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
-  }
-}
-
 void MDEC::HandleSetQuantTableCommand()
 {
   DebugAssert(m_remaining_halfwords >= 32);
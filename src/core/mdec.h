@@ -3,7 +3,11 @@
 #include "common/fifo_queue.h"
 #include "types.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 class StateWrapper;
 
@@ -16,6 +20,7 @@ public:
   ~MDEC();
 
   void Initialize();
+  void UpdateSettings();
   void Shutdown();
   void Reset();
   bool DoState(StateWrapper& sw);
@@ -60,6 +65,21 @@ private:
     NoCommand
   };
 
+  enum class TransformOutput : u8
+  {
+    None,
+    Mono,
+    Colored
+  };
+
+  /// Transform of run-length decoded blocks, queued for the worker thread.
+  struct TransformJob
+  {
+    u8 first_block;
+    u8 last_block;
+    TransformOutput output;
+  };
+
   union StatusRegister
   {
     u32 bits;
@@ -114,12 +134,17 @@ private:
   void ScheduleBlockCopyOut(TickCount ticks);
   void CopyOutBlock();
 
+  /// IDCTs blocks [first_block, last_block) in place, then converts the macroblock to m_block_rgb.
+  void TransformBlocks(u32 first_block, u32 last_block, TransformOutput output);
+  void QueueTransform(u32 first_block, u32 last_block, TransformOutput output);
+
+  void StartWorkerThread();
+  void StopWorkerThread();
+  void SyncWorkerThread();
+  void WorkerThreadEntryPoint();
+
   // from nocash spec
   bool rl_decode_block(s16* blk, const u8* qt);
-  void IDCT(s16* blk);
-  void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                  const std::array<s16, 64>& Yblk);
-  void y_to_mono(const std::array<s16, 64>& Yblk);
 
   StatusRegister m_status = {};
   bool m_enable_dma_in = false;
@@ -146,6 +171,20 @@ private:
   std::unique_ptr<TimingEvent> m_block_copy_out_event;
 
   u32 m_total_blocks_decoded = 0;
+
+  // The worker thread owns m_blocks before m_current_block and m_block_rgb while a transform is pending. The CPU
+  // thread only run-length decodes into m_current_block until it syncs.
+  std::thread m_worker_thread;
+  bool m_use_worker_thread = false;
+  bool m_worker_thread_pending = false;
+  std::vector<TransformJob> m_worker_batch;
+
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_wake_cv;
+  std::condition_variable m_worker_done_cv;
+  std::vector<TransformJob> m_worker_queue;
+  bool m_worker_thread_busy = false;
+  bool m_worker_thread_shutdown = false;
 };
 
 extern MDEC g_mdec;
\ No newline at end of file
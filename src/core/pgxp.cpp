@@ -20,11 +20,16 @@
 
 #include "pgxp.h"
 #include "bus.h"
+#include "common/assert.h"
 #include "common/log.h"
 #include "cpu_core.h"
 #include "settings.h"
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cmath>
+#include <cstring>
+#include <vector>
 Log_SetChannel(PGXP);
 
 namespace PGXP {
@@ -35,7 +40,10 @@ enum : u32
   VERTEX_CACHE_HEIGHT = 0x800 * 2,
   VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
   PGXP_MEM_SIZE = (Bus::RAM_8MB_SIZE + CPU::DCACHE_SIZE) / 4,
-  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4
+  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
+  PGXP_MEM_INVALID_INDEX = 0xFFFFFFFFu,
+  PGXP_MEM_PAGES = (PGXP_MEM_SIZE + SHADOW_PAGE_SIZE - 1) / SHADOW_PAGE_SIZE,
+  VERTEX_CACHE_PAGES = VERTEX_CACHE_SIZE / SHADOW_PAGE_SIZE
 };
 
 #define NONE 0
@@ -50,20 +58,6 @@ enum : u32
 #define VALID_ALL (VALID_0 | VALID_1 | VALID_2 | VALID_3)
 #define INV_VALID_ALL (ALL ^ VALID_ALL)
 
-typedef struct PGXP_value_Tag
-{
-  float x;
-  float y;
-  float z;
-  union
-  {
-    unsigned int flags;
-    unsigned char compFlags[4];
-    unsigned short halfFlags[2];
-  };
-  unsigned int value;
-} PGXP_value;
-
 typedef union
 {
   struct
@@ -96,13 +90,14 @@ static double f16Sign(double in);
 static double f16Unsign(double in);
 static double f16Overflow(double in);
 
-static PGXP_value* GetPtr(u32 addr);
-static PGXP_value* ReadMem(u32 addr);
+static u32 GetMemIndex(u32 addr);
+static bool ReadMem(u32 addr, PGXP_value* value);
 
 static const PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, {0}, 0};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, {VALID_ALL}, 0};
 
-static PGXP_value CPU_reg[34];
+// GPR values live in the CPU state, so recompiled code can access them relative to the CPU pointer
+static PGXP_value (&CPU_reg)[NUM_CPU_REGS] = CPU::g_state.pgxp_gpr;
 static PGXP_value CP0_reg[32];
 #define CPU_Hi CPU_reg[32]
 #define CPU_Lo CPU_reg[33]
@@ -111,8 +106,102 @@ static PGXP_value CP0_reg[32];
 static PGXP_value GTE_data_reg[32];
 static PGXP_value GTE_ctrl_reg[32];
 
-static PGXP_value* Mem = nullptr;
-static PGXP_value* vertexCache = nullptr;
+// By default all of the pages are allocated up front in one block, so the page tables never change, and writes never
+// have to allocate. With shadow paging enabled, pages are only allocated when they're first written, and the blocks
+// are null.
+static std::array<ShadowPage*, PGXP_MEM_PAGES> s_mem_pages = {};
+static std::vector<ShadowPage*> s_vertex_cache_pages;
+static ShadowPage* s_mem_block = nullptr;
+static ShadowPage* s_vertex_cache_block = nullptr;
+static bool s_mem_page_allocation_failed = false;
+
+ALWAYS_INLINE_RELEASE static u8 PackFlags(u32 flags)
+{
+  DebugAssert((flags & INV_VALID_ALL) == 0);
+  return static_cast<u8>((flags & VALID_0) | ((flags >> 7) & 0x02) | ((flags >> 14) & 0x04) | ((flags >> 21) & 0x08));
+}
+
+ALWAYS_INLINE_RELEASE static u32 UnpackFlags(u8 flags)
+{
+  return (flags & 0x01) | ((flags & 0x02) << 7) | ((flags & 0x04) << 14) | ((flags & 0x08) << 21);
+}
+
+ALWAYS_INLINE_RELEASE static bool IsZeroValue(const PGXP_value& value)
+{
+  // compare bits, so -0.0 still needs a page
+  u32 bits[3];
+  std::memcpy(bits, &value.x, sizeof(bits));
+  return ((bits[0] | bits[1] | bits[2] | value.flags | value.value) == 0);
+}
+
+ALWAYS_INLINE_RELEASE static void ReadShadowValue(const ShadowPage* page, u32 index, PGXP_value* value)
+{
+  const u32 offset = index & SHADOW_PAGE_MASK;
+  value->x = page->x[offset];
+  value->y = page->y[offset];
+  value->z = page->z[offset];
+  value->flags = UnpackFlags(page->flags[offset]);
+  value->value = page->value[offset];
+}
+
+ALWAYS_INLINE_RELEASE static bool WriteShadowValue(ShadowPage** pages, u32 index, const PGXP_value& value)
+{
+  ShadowPage*& page = pages[index >> SHADOW_PAGE_SHIFT];
+  if (!page)
+  {
+    // all values in a new page are zero, so there's no need to allocate it to write another
+    if (IsZeroValue(value))
+      return true;
+
+    page = static_cast<ShadowPage*>(std::calloc(1, sizeof(ShadowPage)));
+    if (!page)
+      return false;
+  }
+
+  const u32 offset = index & SHADOW_PAGE_MASK;
+  page->x[offset] = value.x;
+  page->y[offset] = value.y;
+  page->z[offset] = value.z;
+  page->flags[offset] = PackFlags(value.flags);
+  page->value[offset] = value.value;
+  return true;
+}
+
+static bool AllocateShadowBlock(ShadowPage** pages, size_t count, ShadowPage** block)
+{
+  *block = static_cast<ShadowPage*>(std::calloc(count, sizeof(ShadowPage)));
+  if (!*block)
+    return false;
+
+  for (size_t i = 0; i < count; i++)
+    pages[i] = &(*block)[i];
+
+  return true;
+}
+
+static void FreeShadowPages(ShadowPage** pages, size_t count, ShadowPage** block)
+{
+  if (*block)
+  {
+    std::free(*block);
+    *block = nullptr;
+  }
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      std::free(pages[i]);
+  }
+
+  std::fill_n(pages, count, nullptr);
+}
+
+static void ClearShadowPages(ShadowPage** pages, size_t count, ShadowPage* block)
+{
+  if (block)
+    std::memset(block, 0, sizeof(ShadowPage) * count);
+  else
+    FreeShadowPages(pages, count, &block);
+}
 
 ALWAYS_INLINE_RELEASE void MakeValid(PGXP_value* pV, u32 psxV)
 {
@@ -155,33 +244,46 @@ ALWAYS_INLINE_RELEASE double f16Overflow(double in)
   return out;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE u32 GetMemIndex(u32 addr)
 {
   if ((addr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
-    return &Mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2)];
+    return PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2);
 
   const u32 paddr = (addr & CPU::PHYSICAL_MEMORY_ADDRESS_MASK);
   if (paddr < Bus::RAM_MIRROR_END)
-    return &Mem[(paddr & Bus::g_ram_mask) >> 2];
+    return (paddr & Bus::g_ram_mask) >> 2;
   else
-    return nullptr;
+    return PGXP_MEM_INVALID_INDEX;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* ReadMem(u32 addr)
+ALWAYS_INLINE_RELEASE bool ReadMem(u32 addr, PGXP_value* value)
 {
-  return GetPtr(addr);
+  const u32 index = GetMemIndex(addr);
+  if (index == PGXP_MEM_INVALID_INDEX)
+    return false;
+
+  const ShadowPage* page = s_mem_pages[index >> SHADOW_PAGE_SHIFT];
+  if (page)
+    ReadShadowValue(page, index, value);
+  else
+    *value = PGXP_value_invalid;
+
+  return true;
 }
 
 ALWAYS_INLINE_RELEASE void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value)
 {
-  PGXP_value* pMem = GetPtr(addr);
-  if (pMem != NULL)
+  const u32 index = GetMemIndex(addr);
+  ShadowPage* page = (index != PGXP_MEM_INVALID_INDEX) ? s_mem_pages[index >> SHADOW_PAGE_SHIFT] : nullptr;
+  if (page)
   {
-    Validate(pMem, value);
-    *dest = *pMem;
+    ReadShadowValue(page, index, dest);
+    Validate(dest, value);
+    page->flags[index & SHADOW_PAGE_MASK] = PackFlags(dest->flags);
     return;
   }
 
+  // unallocated pages are zero, which is the same as invalid
   *dest = PGXP_value_invalid;
 }
 
@@ -189,8 +291,8 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
 {
   u32 validMask = 0;
   psx_value val, mask;
-  PGXP_value* pMem = GetPtr(addr);
-  if (pMem != NULL)
+  const u32 index = GetMemIndex(addr);
+  if (index != PGXP_MEM_INVALID_INDEX)
   {
     mask.d = val.d = 0;
     // determine if high or low word
@@ -208,8 +310,17 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
     }
 
     // validate and copy whole value
-    MaskValidate(pMem, val.d, mask.d, validMask);
-    *dest = *pMem;
+    ShadowPage* page = s_mem_pages[index >> SHADOW_PAGE_SHIFT];
+    if (page)
+    {
+      ReadShadowValue(page, index, dest);
+      MaskValidate(dest, val.d, mask.d, validMask);
+      page->flags[index & SHADOW_PAGE_MASK] = PackFlags(dest->flags);
+    }
+    else
+    {
+      *dest = PGXP_value_invalid;
+    }
 
     // if high word then shift
     if ((addr % 4) == 2)
@@ -228,17 +339,27 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
   *dest = PGXP_value_invalid;
 }
 
-ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
+ALWAYS_INLINE_RELEASE static void WriteMemShadowValue(u32 index, const PGXP_value& value)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  // if a page can't be allocated, the value is dropped, and reads back as invalid
+  if (!WriteShadowValue(s_mem_pages.data(), index, value) && !s_mem_page_allocation_failed)
+  {
+    Log_ErrorPrint("Failed to allocate PGXP shadow memory page, values will be lost.");
+    s_mem_page_allocation_failed = true;
+  }
+}
 
-  if (pMem)
-    *pMem = *value;
+ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index != PGXP_MEM_INVALID_INDEX)
+    WriteMemShadowValue(index, *value);
 }
 
 ALWAYS_INLINE_RELEASE static void WriteMem16(const PGXP_value* src, u32 addr)
 {
-  PGXP_value* dest = GetPtr(addr);
+  PGXP_value temp;
+  PGXP_value* dest = ReadMem(addr, &temp) ? &temp : nullptr;
   psx_value* pVal = NULL;
 
   if (dest)
@@ -266,6 +387,7 @@ ALWAYS_INLINE_RELEASE static void WriteMem16(const PGXP_value* src, u32 addr)
     }
 
     // dest->valid = dest->valid && src->valid;
+    WriteMemShadowValue(GetMemIndex(addr), *dest);
   }
 }
 
@@ -277,28 +399,24 @@ void Initialize()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (!Mem)
-  {
-    Mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
-    if (!Mem)
-    {
-      std::fprintf(stderr, "Failed to allocate PGXP memory\n");
-      std::abort();
-    }
-  }
+  FreeShadowPages(s_mem_pages.data(), s_mem_pages.size(), &s_mem_block);
+  FreeShadowPages(s_vertex_cache_pages.data(), s_vertex_cache_pages.size(), &s_vertex_cache_block);
+  s_mem_page_allocation_failed = false;
+
+  if (!g_settings.gpu_pgxp_shadow_paging && !AllocateShadowBlock(s_mem_pages.data(), s_mem_pages.size(), &s_mem_block))
+    Panic("Failed to allocate PGXP memory");
 
-  if (g_settings.gpu_pgxp_vertex_cache && !vertexCache)
+  if (g_settings.gpu_pgxp_vertex_cache)
   {
-    vertexCache = static_cast<PGXP_value*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(PGXP_value)));
-    if (!vertexCache)
+    s_vertex_cache_pages.resize(VERTEX_CACHE_PAGES);
+    if (!g_settings.gpu_pgxp_shadow_paging &&
+        !AllocateShadowBlock(s_vertex_cache_pages.data(), s_vertex_cache_pages.size(), &s_vertex_cache_block))
     {
       Log_ErrorPrint("Failed to allocate memory for vertex cache, disabling.");
       g_settings.gpu_pgxp_vertex_cache = false;
+      s_vertex_cache_pages = {};
     }
   }
-
-  if (vertexCache)
-    std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
 }
 
 void Reset()
@@ -309,25 +427,15 @@ void Reset()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (Mem)
-    std::memset(Mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
-
-  if (vertexCache)
-    std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  ClearShadowPages(s_mem_pages.data(), s_mem_pages.size(), s_mem_block);
+  ClearShadowPages(s_vertex_cache_pages.data(), s_vertex_cache_pages.size(), s_vertex_cache_block);
 }
 
 void Shutdown()
 {
-  if (vertexCache)
-  {
-    std::free(vertexCache);
-    vertexCache = nullptr;
-  }
-  if (Mem)
-  {
-    std::free(Mem);
-    Mem = nullptr;
-  }
+  FreeShadowPages(s_vertex_cache_pages.data(), s_vertex_cache_pages.size(), &s_vertex_cache_block);
+  s_vertex_cache_pages = {};
+  FreeShadowPages(s_mem_pages.data(), s_mem_pages.size(), &s_mem_block);
 
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
@@ -336,6 +444,11 @@ void Shutdown()
   std::memset(CP0_reg, 0, sizeof(CP0_reg));
 }
 
+ShadowPage* const* GetRAMShadowPageTable()
+{
+  return s_mem_pages.data();
+}
+
 // Instruction register decoding
 #define op(_instr) (_instr >> 26) // The op part of the instruction register
 #define func(_instr) ((_instr)&0x3F) // The funct part of the instruction register
@@ -490,19 +603,32 @@ ALWAYS_INLINE_RELEASE void PGXP_CacheVertex(s16 sx, s16 sy, const PGXP_value& ve
   if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
   {
     // Write vertex into cache
-    vertexCache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)] = vertex;
+    if (!WriteShadowValue(s_vertex_cache_pages.data(), (sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800), vertex))
+    {
+      Log_ErrorPrint("Failed to allocate vertex cache page, disabling vertex cache.");
+      g_settings.gpu_pgxp_vertex_cache = false;
+      FreeShadowPages(s_vertex_cache_pages.data(), s_vertex_cache_pages.size(), &s_vertex_cache_block);
+      s_vertex_cache_pages = {};
+    }
   }
 }
 
-static ALWAYS_INLINE_RELEASE PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
+static ALWAYS_INLINE_RELEASE bool PGXP_GetCachedVertex(short sx, short sy, PGXP_value* vertex)
 {
   if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
   {
-    // Return pointer to cache entry
-    return &vertexCache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)];
+    // Copy cache entry
+    const u32 index = static_cast<u32>((sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800));
+    const ShadowPage* page = s_vertex_cache_pages[index >> SHADOW_PAGE_SHIFT];
+    if (page)
+      ReadShadowValue(page, index, vertex);
+    else
+      *vertex = PGXP_value_invalid;
+
+    return true;
   }
 
-  return nullptr;
+  return false;
 }
 
 static ALWAYS_INLINE_RELEASE float TruncateVertexPosition(float p)
@@ -524,7 +650,8 @@ static ALWAYS_INLINE_RELEASE bool IsWithinTolerance(float precise_x, float preci
 
 bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, float* out_x, float* out_y, float* out_w)
 {
-  const PGXP_value* vert = ReadMem(addr);
+  PGXP_value vert_value;
+  const PGXP_value* vert = ReadMem(addr, &vert_value) ? &vert_value : nullptr;
   if (vert && ((vert->flags & VALID_01) == VALID_01) && (vert->value == value))
   {
     // There is a value here with valid X and Y coordinates
@@ -545,7 +672,7 @@ bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, f
     const short psx_y = (short)(value >> 16);
 
     // Look in cache for valid vertex
-    vert = PGXP_GetCachedVertex(psx_x, psx_y);
+    vert = PGXP_GetCachedVertex(psx_x, psx_y, &vert_value) ? &vert_value : nullptr;
     if (vert && (vert->flags & VALID_01) == VALID_01)
     {
       *out_x = TruncateVertexPosition(vert->x) + static_cast<float>(xOffs);
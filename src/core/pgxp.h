@@ -23,6 +23,47 @@
 
 namespace PGXP {
 
+typedef struct PGXP_value_Tag
+{
+  float x;
+  float y;
+  float z;
+  union
+  {
+    unsigned int flags;
+    unsigned char compFlags[4];
+    unsigned short halfFlags[2];
+  };
+  unsigned int value;
+} PGXP_value;
+
+enum : u32
+{
+  // GPRs, followed by hi and lo
+  NUM_CPU_REGS = 34,
+
+  // one valid bit per component, in the low bit of each byte of the flags
+  VALUE_VALID_XY = 0x00000101,
+  VALUE_VALID_ALL = 0x01010101,
+
+  SHADOW_PAGE_SHIFT = 10,
+  SHADOW_PAGE_SIZE = 1u << SHADOW_PAGE_SHIFT,
+  SHADOW_PAGE_MASK = SHADOW_PAGE_SIZE - 1
+};
+
+// Shadow values for RAM and the vertex cache are stored in pages. Normally every page is allocated up front, but with
+// shadow paging enabled, a page is only allocated when something other than an all-zero (invalid) value is written to
+// it, so RAM which never holds tracked values costs nothing. Components are stored in separate arrays, with the four
+// validity flags packed into the low bits of a byte.
+struct ShadowPage
+{
+  float x[SHADOW_PAGE_SIZE];
+  float y[SHADOW_PAGE_SIZE];
+  float z[SHADOW_PAGE_SIZE];
+  u32 value[SHADOW_PAGE_SIZE];
+  u8 flags[SHADOW_PAGE_SIZE];
+};
+
 void Initialize();
 void Reset();
 void Shutdown();
@@ -42,6 +83,11 @@ void CPU_CTC2(u32 instr, u32 rdVal, u32 rtVal); // copy GPR reg to GTE ctrl reg
 void CPU_LWC2(u32 instr, u32 rtVal, u32 addr); // copy memory to GTE reg
 void CPU_SWC2(u32 instr, u32 rtVal, u32 addr); // copy GTE reg to memory
 
+/// Returns the shadow page table for RAM, indexed by physical address >> (SHADOW_PAGE_SHIFT + 2). Used by the
+/// recompiler to access shadow memory inline. The table never moves, but with shadow paging, pages are null until
+/// they're written.
+ShadowPage* const* GetRAMShadowPageTable();
+
 bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, float* out_x, float* out_y,
                       float* out_w);
 
@@ -0,0 +1,102 @@
+#include "profiler.h"
+#include <array>
+#include <atomic>
+
+namespace Profiler {
+
+static constexpr u32 NUM_SECTIONS = static_cast<u32>(Section::Count);
+
+static constexpr std::array<const char*, NUM_SECTIONS> s_section_names = {
+  {"cpu", "gpu", "gpu_backend", "spu", "cdrom", "mdec"}};
+
+std::atomic<bool> g_enabled{false};
+
+static Section s_current_section = Section::CPU;
+static Common::Timer::Value s_section_start_time = 0;
+static std::array<Common::Timer::Value, NUM_SECTIONS> s_section_times = {};
+static std::array<std::atomic<Common::Timer::Value>, NUM_SECTIONS> s_section_thread_times = {};
+
+const char* GetSectionName(Section section)
+{
+  return s_section_names[static_cast<u32>(section)];
+}
+
+static void UpdateCurrentSectionTime()
+{
+  const Common::Timer::Value current_time = Common::Timer::GetValue();
+  s_section_times[static_cast<u32>(s_current_section)] += current_time - s_section_start_time;
+  s_section_start_time = current_time;
+}
+
+void Enable()
+{
+  if (IsEnabled())
+    return;
+
+  Reset();
+  s_current_section = Section::CPU;
+  g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Disable()
+{
+  if (!IsEnabled())
+    return;
+
+  UpdateCurrentSectionTime();
+  g_enabled.store(false, std::memory_order_relaxed);
+}
+
+void Reset()
+{
+  s_section_times.fill(0);
+  for (std::atomic<Common::Timer::Value>& time : s_section_thread_times)
+    time.store(0, std::memory_order_relaxed);
+  s_section_start_time = Common::Timer::GetValue();
+}
+
+Section EnterSection(Section section)
+{
+  const Section previous = s_current_section;
+  if (previous != section)
+  {
+    UpdateCurrentSectionTime();
+    s_current_section = section;
+  }
+
+  return previous;
+}
+
+void LeaveSection(Section previous)
+{
+  if (previous == s_current_section)
+    return;
+
+  // sections which were entered before disabling still have to be left, but shouldn't count
+  if (IsEnabled())
+    UpdateCurrentSectionTime();
+
+  s_current_section = previous;
+}
+
+void AddThreadTime(Section section, Common::Timer::Value time)
+{
+  s_section_thread_times[static_cast<u32>(section)].fetch_add(time, std::memory_order_relaxed);
+}
+
+double GetSectionTime(Section section)
+{
+  Common::Timer::Value time = s_section_times[static_cast<u32>(section)];
+  if (IsEnabled() && section == s_current_section)
+    time += Common::Timer::GetValue() - s_section_start_time;
+
+  return Common::Timer::ConvertValueToMilliseconds(time);
+}
+
+double GetSectionThreadTime(Section section)
+{
+  return Common::Timer::ConvertValueToMilliseconds(
+    s_section_thread_times[static_cast<u32>(section)].load(std::memory_order_relaxed));
+}
+
+} // namespace Profiler
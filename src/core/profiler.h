@@ -0,0 +1,97 @@
+#pragma once
+#include "common/timer.h"
+#include "types.h"
+#include <atomic>
+
+// Lightweight host time accounting for the emulated subsystems, used by the benchmark mode of the regression test
+// runner. When disabled, sections cost a single branch on entry and exit.
+namespace Profiler {
+
+enum class Section : u8
+{
+  CPU,
+  GPU,
+  GPUBackend,
+  SPU,
+  CDROM,
+  MDEC,
+  Count
+};
+
+// Read from worker threads as well as the CPU thread. Nothing is ordered by it, so relaxed loads are enough.
+extern std::atomic<bool> g_enabled;
+
+ALWAYS_INLINE bool IsEnabled()
+{
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+const char* GetSectionName(Section section);
+
+/// Starts collecting timings. Time on the CPU thread which isn't in any other section is attributed to the CPU.
+void Enable();
+void Disable();
+
+/// Clears all collected times. The CPU thread stays in whichever section it's currently in.
+void Reset();
+
+/// Switches the CPU thread to the specified section, returning the section it was in before.
+Section EnterSection(Section section);
+void LeaveSection(Section previous);
+
+/// Adds time spent in a section on a worker thread, such as the GPU thread. Can be called from any thread.
+void AddThreadTime(Section section, Common::Timer::Value time);
+
+/// Returns the time spent in a section since the last reset, in milliseconds.
+double GetSectionTime(Section section);
+double GetSectionThreadTime(Section section);
+
+/// Attributes the CPU thread's time to a section for the lifetime of the object. Sections can nest, time is only
+/// counted towards the innermost one.
+class ScopedSection
+{
+public:
+  ALWAYS_INLINE ScopedSection(Section section) : m_active(IsEnabled())
+  {
+    if (m_active)
+      m_previous = EnterSection(section);
+  }
+
+  ALWAYS_INLINE ~ScopedSection()
+  {
+    if (m_active)
+      LeaveSection(m_previous);
+  }
+
+  ScopedSection(const ScopedSection&) = delete;
+  ScopedSection& operator=(const ScopedSection&) = delete;
+
+private:
+  Section m_previous = Section::CPU;
+  bool m_active;
+};
+
+/// Accumulates the lifetime of the object to a section on a worker thread.
+class ScopedThreadSection
+{
+public:
+  ALWAYS_INLINE ScopedThreadSection(Section section)
+    : m_start_time(IsEnabled() ? Common::Timer::GetValue() : 0), m_section(section)
+  {
+  }
+
+  ALWAYS_INLINE ~ScopedThreadSection()
+  {
+    if (m_start_time != 0)
+      AddThreadTime(m_section, Common::Timer::GetValue() - m_start_time);
+  }
+
+  ScopedThreadSection(const ScopedThreadSection&) = delete;
+  ScopedThreadSection& operator=(const ScopedThreadSection&) = delete;
+
+private:
+  Common::Timer::Value m_start_time;
+  Section m_section;
+};
+
+} // namespace Profiler
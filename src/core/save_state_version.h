@@ -16,6 +16,13 @@ struct SAVE_STATE_HEADER
     MAX_GAME_CODE_LENGTH = 32
   };
 
+  enum : u32
+  {
+    COMPRESSION_TYPE_NONE = 0,
+    COMPRESSION_TYPE_DEFLATE = 1,
+    COMPRESSION_TYPE_LZMA = 2
+  };
+
   u32 magic;
   u32 version;
   char title[MAX_TITLE_LENGTH];
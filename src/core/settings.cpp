@@ -153,6 +153,11 @@ void Settings::Load(SettingsInterface& si)
   pause_on_focus_loss = si.GetBoolValue("Main", "PauseOnFocusLoss", false);
   pause_on_menu = si.GetBoolValue("Main", "PauseOnMenu", true);
   save_state_on_exit = si.GetBoolValue("Main", "SaveStateOnExit", true);
+  save_state_compression =
+    ParseSaveStateCompressionName(
+      si.GetStringValue("Main", "SaveStateCompression", GetSaveStateCompressionName(DEFAULT_SAVE_STATE_COMPRESSION))
+        .c_str())
+      .value_or(DEFAULT_SAVE_STATE_COMPRESSION);
   confim_power_off = si.GetBoolValue("Main", "ConfirmPowerOff", true);
   load_devices_from_save_states = si.GetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   apply_game_settings = si.GetBoolValue("Main", "ApplyGameSettings", true);
@@ -160,7 +165,9 @@ void Settings::Load(SettingsInterface& si)
   disable_all_enhancements = si.GetBoolValue("Main", "DisableAllEnhancements", false);
   rewind_enable = si.GetBoolValue("Main", "RewindEnable", false);
   rewind_save_frequency = si.GetFloatValue("Main", "RewindFrequency", 10.0f);
-  rewind_save_slots = static_cast<u32>(si.GetIntValue("Main", "RewindSaveSlots", 10));
+  rewind_memory_limit = static_cast<u32>(
+    std::clamp<int>(si.GetIntValue("Main", "RewindMemoryLimit", DEFAULT_REWIND_MEMORY_LIMIT),
+                    MIN_REWIND_MEMORY_LIMIT, MAX_REWIND_MEMORY_LIMIT));
   runahead_frames = static_cast<u32>(si.GetIntValue("Main", "RunaheadFrameCount", 0));
 
   cpu_execution_mode =
@@ -174,6 +181,8 @@ void Settings::Load(SettingsInterface& si)
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_block_cache = si.GetBoolValue("CPU", "RecompilerBlockCache", false);
+  cpu_recompiler_tiered = si.GetBoolValue("CPU", "RecompilerTiered", false);
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
@@ -186,6 +195,7 @@ void Settings::Load(SettingsInterface& si)
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
   gpu_per_sample_shading = si.GetBoolValue("GPU", "PerSampleShading", false);
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_sw_threads = static_cast<u32>(std::max(si.GetIntValue("GPU", "SoftwareRendererThreads", 1), 1));
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
   gpu_threaded_presentation = si.GetBoolValue("GPU", "ThreadedPresentation", true);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", false);
@@ -210,6 +220,7 @@ void Settings::Load(SettingsInterface& si)
   gpu_pgxp_preserve_proj_fp = si.GetBoolValue("GPU", "PGXPPreserveProjFP", false);
   gpu_pgxp_tolerance = si.GetFloatValue("GPU", "PGXPTolerance", -1.0f);
   gpu_pgxp_depth_buffer = si.GetBoolValue("GPU", "PGXPDepthBuffer", false);
+  gpu_pgxp_shadow_paging = si.GetBoolValue("GPU", "PGXPShadowPaging", false);
   SetPGXPDepthClearThreshold(si.GetFloatValue("GPU", "PGXPDepthClearThreshold", DEFAULT_GPU_PGXP_DEPTH_THRESHOLD));
 
   display_crop_mode =
@@ -246,12 +257,16 @@ void Settings::Load(SettingsInterface& si)
   display_max_fps = si.GetFloatValue("Display", "MaxFPS", DEFAULT_DISPLAY_MAX_FPS);
 
   cdrom_readahead_sectors = static_cast<u8>(si.GetIntValue("CDROM", "ReadaheadSectors", DEFAULT_CDROM_READAHEAD_SECTORS));
+  cdrom_read_cache_size = static_cast<u32>(std::clamp<int>(
+    si.GetIntValue("CDROM", "ReadCacheSize", DEFAULT_CDROM_READ_CACHE_SIZE), 0, MAX_CDROM_READ_CACHE_SIZE));
   cdrom_region_check = si.GetBoolValue("CDROM", "RegionCheck", false);
   cdrom_load_image_to_ram = si.GetBoolValue("CDROM", "LoadImageToRAM", false);
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
   cdrom_read_speedup = si.GetIntValue("CDROM", "ReadSpeedup", 1);
   cdrom_seek_speedup = si.GetIntValue("CDROM", "SeekSpeedup", 1);
 
+  mdec_use_thread = si.GetBoolValue("MDEC", "UseThread", false);
+
   audio_backend =
     ParseAudioBackend(si.GetStringValue("Audio", "Backend", GetAudioBackendName(DEFAULT_AUDIO_BACKEND)).c_str())
       .value_or(DEFAULT_AUDIO_BACKEND);
@@ -262,6 +277,7 @@ void Settings::Load(SettingsInterface& si)
   audio_output_muted = si.GetBoolValue("Audio", "OutputMuted", false);
   audio_sync_enabled = si.GetBoolValue("Audio", "Sync", true);
   audio_dump_on_boot = si.GetBoolValue("Audio", "DumpOnBoot", false);
+  audio_spu_thread = si.GetBoolValue("Audio", "SPUThread", false);
 
   dma_max_slice_ticks = si.GetIntValue("Hacks", "DMAMaxSliceTicks", DEFAULT_DMA_MAX_SLICE_TICKS);
   dma_halt_ticks = si.GetIntValue("Hacks", "DMAHaltTicks", DEFAULT_DMA_HALT_TICKS);
@@ -322,6 +338,7 @@ void Settings::Load(SettingsInterface& si)
   debugging.show_timers_state = si.GetBoolValue("Debug", "ShowTimersState");
   debugging.show_mdec_state = si.GetBoolValue("Debug", "ShowMDECState");
   debugging.show_dma_state = si.GetBoolValue("Debug", "ShowDMAState");
+  debugging.show_code_cache_state = si.GetBoolValue("Debug", "ShowCodeCacheState");
 
   texture_replacements.enable_vram_write_replacements =
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
@@ -351,6 +368,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "PauseOnFocusLoss", pause_on_focus_loss);
   si.SetBoolValue("Main", "PauseOnMenu", pause_on_menu);
   si.SetBoolValue("Main", "SaveStateOnExit", save_state_on_exit);
+  si.SetStringValue("Main", "SaveStateCompression", GetSaveStateCompressionName(save_state_compression));
   si.SetBoolValue("Main", "ConfirmPowerOff", confim_power_off);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
   si.SetBoolValue("Main", "ApplyGameSettings", apply_game_settings);
@@ -358,7 +376,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "DisableAllEnhancements", disable_all_enhancements);
   si.SetBoolValue("Main", "RewindEnable", rewind_enable);
   si.SetFloatValue("Main", "RewindFrequency", rewind_save_frequency);
-  si.SetIntValue("Main", "RewindSaveSlots", rewind_save_slots);
+  si.SetIntValue("Main", "RewindMemoryLimit", static_cast<int>(rewind_memory_limit));
   si.SetIntValue("Main", "RunaheadFrameCount", runahead_frames);
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
@@ -368,6 +386,8 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerBlockCache", cpu_recompiler_block_cache);
+  si.SetBoolValue("CPU", "RecompilerTiered", cpu_recompiler_tiered);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
@@ -377,6 +397,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("GPU", "UseDebugDevice", gpu_use_debug_device);
   si.SetBoolValue("GPU", "PerSampleShading", gpu_per_sample_shading);
   si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetIntValue("GPU", "SoftwareRendererThreads", gpu_sw_threads);
   si.SetBoolValue("GPU", "ThreadedPresentation", gpu_threaded_presentation);
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", gpu_use_software_renderer_for_readbacks);
   si.SetBoolValue("GPU", "TrueColor", gpu_true_color);
@@ -395,6 +416,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("GPU", "PGXPPreserveProjFP", gpu_pgxp_preserve_proj_fp);
   si.SetFloatValue("GPU", "PGXPTolerance", gpu_pgxp_tolerance);
   si.SetBoolValue("GPU", "PGXPDepthBuffer", gpu_pgxp_depth_buffer);
+  si.SetBoolValue("GPU", "PGXPShadowPaging", gpu_pgxp_shadow_paging);
   si.SetFloatValue("GPU", "PGXPDepthClearThreshold", GetPGXPDepthClearThreshold());
 
   si.SetStringValue("Display", "CropMode", GetDisplayCropModeName(display_crop_mode));
@@ -426,12 +448,15 @@ void Settings::Save(SettingsInterface& si) const
   si.SetFloatValue("Display", "MaxFPS", display_max_fps);
 
   si.SetIntValue("CDROM", "ReadaheadSectors", cdrom_readahead_sectors);
+  si.SetIntValue("CDROM", "ReadCacheSize", static_cast<int>(cdrom_read_cache_size));
   si.SetBoolValue("CDROM", "RegionCheck", cdrom_region_check);
   si.SetBoolValue("CDROM", "LoadImageToRAM", cdrom_load_image_to_ram);
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
   si.SetIntValue("CDROM", "ReadSpeedup", cdrom_read_speedup);
   si.SetIntValue("CDROM", "SeekSpeedup", cdrom_seek_speedup);
 
+  si.SetBoolValue("MDEC", "UseThread", mdec_use_thread);
+
   si.SetStringValue("Audio", "Backend", GetAudioBackendName(audio_backend));
   si.SetIntValue("Audio", "OutputVolume", audio_output_volume);
   si.SetIntValue("Audio", "FastForwardVolume", audio_fast_forward_volume);
@@ -440,6 +465,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Audio", "OutputMuted", audio_output_muted);
   si.SetBoolValue("Audio", "Sync", audio_sync_enabled);
   si.SetBoolValue("Audio", "DumpOnBoot", audio_dump_on_boot);
+  si.SetBoolValue("Audio", "SPUThread", audio_spu_thread);
 
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", dma_max_slice_ticks);
   si.SetIntValue("Hacks", "DMAHaltTicks", dma_halt_ticks);
@@ -491,6 +517,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Debug", "ShowTimersState", debugging.show_timers_state);
   si.SetBoolValue("Debug", "ShowMDECState", debugging.show_mdec_state);
   si.SetBoolValue("Debug", "ShowDMAState", debugging.show_dma_state);
+  si.SetBoolValue("Debug", "ShowCodeCacheState", debugging.show_code_cache_state);
 
   si.SetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements",
                   texture_replacements.enable_vram_write_replacements);
@@ -981,3 +1008,34 @@ const char* Settings::GetMultitapModeDisplayName(MultitapMode mode)
 {
   return s_multitap_enable_mode_display_names[static_cast<size_t>(mode)];
 }
+
+static std::array<const char*, static_cast<u32>(SaveStateCompression::Count)> s_save_state_compression_names = {
+  {"None", "Deflate", "LZMA"}};
+static std::array<const char*, static_cast<u32>(SaveStateCompression::Count)>
+  s_save_state_compression_display_names = {{TRANSLATABLE("SaveStateCompression", "Uncompressed"),
+                                              TRANSLATABLE("SaveStateCompression", "Deflate (Fast)"),
+                                              TRANSLATABLE("SaveStateCompression", "LZMA (Smallest)")}};
+
+std::optional<SaveStateCompression> Settings::ParseSaveStateCompressionName(const char* str)
+{
+  u32 index = 0;
+  for (const char* name : s_save_state_compression_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<SaveStateCompression>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetSaveStateCompressionName(SaveStateCompression compression)
+{
+  return s_save_state_compression_names[static_cast<size_t>(compression)];
+}
+
+const char* Settings::GetSaveStateCompressionDisplayName(SaveStateCompression compression)
+{
+  return s_save_state_compression_display_names[static_cast<size_t>(compression)];
+}
@@ -80,6 +80,8 @@ struct Settings
   bool cpu_recompiler_memory_exceptions = false;
   bool cpu_recompiler_block_linking = true;
   bool cpu_recompiler_icache = false;
+  bool cpu_recompiler_block_cache = false;
+  bool cpu_recompiler_tiered = false;
   CPUFastmemMode cpu_fastmem_mode = CPUFastmemMode::Disabled;
 
   float emulation_speed = 1.0f;
@@ -93,6 +95,7 @@ struct Settings
   bool pause_on_focus_loss = false;
   bool pause_on_menu = true;
   bool save_state_on_exit = true;
+  SaveStateCompression save_state_compression = DEFAULT_SAVE_STATE_COMPRESSION;
   bool confim_power_off = true;
   bool load_devices_from_save_states = false;
   bool apply_game_settings = true;
@@ -101,7 +104,7 @@ struct Settings
 
   bool rewind_enable = false;
   float rewind_save_frequency = 10.0f;
-  u32 rewind_save_slots = 10;
+  u32 rewind_memory_limit = DEFAULT_REWIND_MEMORY_LIMIT;
   u32 runahead_frames = 0;
 
   GPURenderer gpu_renderer = GPURenderer::Software;
@@ -110,6 +113,7 @@ struct Settings
   u32 gpu_resolution_scale = 1;
   u32 gpu_multisamples = 1;
   bool gpu_use_thread = true;
+  u32 gpu_sw_threads = 1;
   bool gpu_use_software_renderer_for_readbacks = false;
   bool gpu_threaded_presentation = true;
   bool gpu_use_debug_device = false;
@@ -128,6 +132,7 @@ struct Settings
   bool gpu_pgxp_cpu = false;
   bool gpu_pgxp_preserve_proj_fp = false;
   bool gpu_pgxp_depth_buffer = false;
+  bool gpu_pgxp_shadow_paging = false;
   DisplayCropMode display_crop_mode = DisplayCropMode::None;
   DisplayAspectRatio display_aspect_ratio = DisplayAspectRatio::Auto;
   u16 display_aspect_ratio_custom_numerator = 0;
@@ -156,12 +161,15 @@ struct Settings
   float gpu_pgxp_depth_clear_threshold = 300.0f / 4096.0f;
 
   u8 cdrom_readahead_sectors = DEFAULT_CDROM_READAHEAD_SECTORS;
+  u32 cdrom_read_cache_size = DEFAULT_CDROM_READ_CACHE_SIZE;
   bool cdrom_region_check = false;
   bool cdrom_load_image_to_ram = false;
   bool cdrom_mute_cd_audio = false;
   u32 cdrom_read_speedup = 1;
   u32 cdrom_seek_speedup = 1;
 
+  bool mdec_use_thread = false;
+
   AudioBackend audio_backend = AudioBackend::Cubeb;
   s32 audio_output_volume = 100;
   s32 audio_fast_forward_volume = 100;
@@ -170,6 +178,7 @@ struct Settings
   bool audio_output_muted = false;
   bool audio_sync_enabled = true;
   bool audio_dump_on_boot = true;
+  bool audio_spu_thread = false;
 
   // timing hacks section
   TickCount dma_max_slice_ticks = 1000;
@@ -193,6 +202,7 @@ struct Settings
     mutable bool show_timers_state = false;
     mutable bool show_mdec_state = false;
     mutable bool show_dma_state = false;
+    mutable bool show_code_cache_state = false;
   } debugging;
 
   // texture replacements
@@ -349,6 +359,10 @@ struct Settings
   static const char* GetMultitapModeName(MultitapMode mode);
   static const char* GetMultitapModeDisplayName(MultitapMode mode);
 
+  static std::optional<SaveStateCompression> ParseSaveStateCompressionName(const char* str);
+  static const char* GetSaveStateCompressionName(SaveStateCompression compression);
+  static const char* GetSaveStateCompressionDisplayName(SaveStateCompression compression);
+
   // Default to D3D11 on Windows as it's more performant and at this point, less buggy.
 #ifdef _WIN32
   static constexpr GPURenderer DEFAULT_GPU_RENDERER = GPURenderer::HardwareD3D11;
@@ -383,7 +397,13 @@ struct Settings
   static constexpr DisplayCropMode DEFAULT_DISPLAY_CROP_MODE = DisplayCropMode::Overscan;
   static constexpr DisplayAspectRatio DEFAULT_DISPLAY_ASPECT_RATIO = DisplayAspectRatio::Auto;
 
+  static constexpr u32 DEFAULT_REWIND_MEMORY_LIMIT = 128; // megabytes
+  static constexpr u32 MIN_REWIND_MEMORY_LIMIT = 16;      // megabytes
+  static constexpr u32 MAX_REWIND_MEMORY_LIMIT = 16384;   // megabytes
+
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u32 DEFAULT_CDROM_READ_CACHE_SIZE = 4; // megabytes
+  static constexpr u32 MAX_CDROM_READ_CACHE_SIZE = 256;   // megabytes
 
   static constexpr ControllerType DEFAULT_CONTROLLER_1_TYPE = ControllerType::DigitalController;
   static constexpr ControllerType DEFAULT_CONTROLLER_2_TYPE = ControllerType::None;
@@ -391,6 +411,8 @@ struct Settings
   static constexpr MemoryCardType DEFAULT_MEMORY_CARD_2_TYPE = MemoryCardType::None;
   static constexpr MultitapMode DEFAULT_MULTITAP_MODE = MultitapMode::Disabled;
 
+  static constexpr SaveStateCompression DEFAULT_SAVE_STATE_COMPRESSION = SaveStateCompression::Deflate;
+
   static constexpr LOGLEVEL DEFAULT_LOG_LEVEL = LOGLEVEL_INFO;
 
   // Enable console logging by default on Linux platforms.
@@ -1,17 +1,32 @@
 #include "spu.h"
 #include "cdrom.h"
 #include "common/audio_stream.h"
+#include "common/bitutils.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/platform.h"
 #include "common/state_wrapper.h"
 #include "common/wav_writer.h"
 #include "dma.h"
 #include "host_interface.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "profiler.h"
 #include "system.h"
 Log_SetChannel(SPU);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define SPU_VECTOR_MIX 1
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define SPU_VECTOR_MIX 1
+#endif
+
 SPU g_spu;
 
 SPU::SPU() = default;
@@ -33,6 +48,9 @@ void SPU::Initialize()
   m_audio_stream = g_host_interface->GetAudioStream();
 
   Reset();
+
+  if (g_settings.audio_spu_thread)
+    StartRenderThread();
 }
 
 void SPU::CPUClockChanged()
@@ -44,8 +62,21 @@ void SPU::CPUClockChanged()
   UpdateEventInterval();
 }
 
+void SPU::UpdateSettings()
+{
+  if (m_use_render_thread == g_settings.audio_spu_thread)
+    return;
+
+  // queued samples are generated before the thread goes away
+  if (g_settings.audio_spu_thread)
+    StartRenderThread();
+  else
+    StopRenderThread();
+}
+
 void SPU::Shutdown()
 {
+  StopRenderThread();
   m_tick_event.reset();
   m_transfer_event.reset();
   m_dump_writer.reset();
@@ -54,6 +85,7 @@ void SPU::Shutdown()
 
 void SPU::Reset()
 {
+  SyncRenderThread();
   m_ticks_carry = 0;
 
   m_SPUCNT.bits = 0;
@@ -112,6 +144,9 @@ void SPU::Reset()
 
 bool SPU::DoState(StateWrapper& sw)
 {
+  SyncRenderThread();
+  UpdateCaptureBufferStatus();
+
   sw.Do(&m_ticks_carry);
   sw.Do(&m_SPUCNT.bits);
   sw.Do(&m_SPUSTAT.bits);
@@ -182,6 +217,12 @@ bool SPU::DoState(StateWrapper& sw)
 
 u16 SPU::ReadRegister(u32 offset)
 {
+  if (IsUsingRenderThread() && !IsControlRegister(offset))
+  {
+    GeneratePendingSamples();
+    SyncRenderThread();
+  }
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -257,6 +298,7 @@ u16 SPU::ReadRegister(u32 offset)
 
     case 0x1F801DAE - SPU_BASE:
       GeneratePendingSamples();
+      UpdateCaptureBufferStatus();
       Log_TracePrintf("SPU status register -> 0x%04X", ZeroExtend32(m_SPUCNT.bits));
       return m_SPUSTAT.bits;
 
@@ -304,139 +346,65 @@ u16 SPU::ReadRegister(u32 offset)
   }
 }
 
-void SPU::WriteRegister(u32 offset, u16 value)
+bool SPU::IsControlRegister(u32 offset)
 {
   switch (offset)
   {
-    case 0x1F801D80 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU main volume left <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_main_volume_left_reg.bits = value;
-      m_main_volume_left.Reset(m_main_volume_left_reg);
-      return;
-    }
-
-    case 0x1F801D82 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU main volume right <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_main_volume_right_reg.bits = value;
-      m_main_volume_right.Reset(m_main_volume_right_reg);
-      return;
-    }
-
-    case 0x1F801D84 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU reverb output volume left <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_reverb_registers.vLOUT = value;
-      return;
-    }
-
-    case 0x1F801D86 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU reverb output volume right <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_reverb_registers.vROUT = value;
-      return;
-    }
-
-    case 0x1F801D88 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU key on low <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_key_on_register = (m_key_on_register & 0xFFFF0000) | ZeroExtend32(value);
-    }
-    break;
-
-    case 0x1F801D8A - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU key on high <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_key_on_register = (m_key_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
-    }
-    break;
-
-    case 0x1F801D8C - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU key off low <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_key_off_register = (m_key_off_register & 0xFFFF0000) | ZeroExtend32(value);
-    }
-    break;
+    case 0x1F801DA4 - SPU_BASE: // IRQ address
+    case 0x1F801DA6 - SPU_BASE: // transfer address
+    case 0x1F801DA8 - SPU_BASE: // transfer data
+    case 0x1F801DAA - SPU_BASE: // SPUCNT
+    case 0x1F801DAC - SPU_BASE: // transfer control
+    case 0x1F801DB4 - SPU_BASE: // external volume left
+    case 0x1F801DB6 - SPU_BASE: // external volume right
+      return true;
 
-    case 0x1F801D8E - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU key off high <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_key_off_register = (m_key_off_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
-    }
-    break;
-
-    case 0x1F801D90 - SPU_BASE:
-    {
-      GeneratePendingSamples();
-      m_pitch_modulation_enable_register = (m_pitch_modulation_enable_register & 0xFFFF0000) | ZeroExtend32(value);
-      Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
-    }
-    break;
+    default:
+      return false;
+  }
+}
 
-    case 0x1F801D92 - SPU_BASE:
-    {
-      GeneratePendingSamples();
-      m_pitch_modulation_enable_register =
-        (m_pitch_modulation_enable_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
-      Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
-    }
-    break;
+bool SPU::IsRenderRegister(u32 offset)
+{
+  // voice registers, main/reverb volumes, key on/off, pitch modulation, noise and reverb enables
+  if (offset < (0x1F801D9C - SPU_BASE))
+    return true;
 
-    case 0x1F801D94 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_noise_mode_register = (m_noise_mode_register & 0xFFFF0000) | ZeroExtend32(value);
-    }
-    break;
+  return (offset == (0x1F801DA2 - SPU_BASE) || offset == (0x1F801DB0 - SPU_BASE) ||
+          offset == (0x1F801DB2 - SPU_BASE) ||
+          (offset >= (0x1F801DC0 - SPU_BASE) && offset < (0x1F801E00 - SPU_BASE)));
+}
 
-    case 0x1F801D96 - SPU_BASE:
+void SPU::WriteRegister(u32 offset, u16 value)
+{
+  if (IsRenderRegister(offset))
+  {
+    if (IsUsingRenderThread())
     {
-      Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
+      // The render thread applies the write in order with the samples either side of it.
       GeneratePendingSamples();
-      m_noise_mode_register = (m_noise_mode_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+      QueueRenderCommand(RenderCommandType::WriteRegister, offset, value, 0);
+      return;
     }
-    break;
 
-    case 0x1F801D98 - SPU_BASE:
+    // Voices which are off don't need to be brought up to date before their registers change.
+    if (offset >= (0x1F801D80 - SPU_BASE) || m_voices[offset / 0x10].IsOn() ||
+        (m_key_on_register & (1u << (offset / 0x10))))
     {
-      Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
-      m_reverb_on_register = (m_reverb_on_register & 0xFFFF0000) | ZeroExtend32(value);
     }
-    break;
 
-    case 0x1F801D9A - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_reverb_on_register = (m_reverb_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
-    }
-    break;
-
-    case 0x1F801DA2 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU reverb base address < 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_reverb_registers.mBASE = value;
-      m_reverb_base_address = ZeroExtend32(value << 2) & 0x3FFFFu;
-      m_reverb_current_address = m_reverb_base_address;
-    }
-    break;
+    WriteRenderRegister(offset, value);
+    return;
+  }
 
+  switch (offset)
+  {
     case 0x1F801DA4 - SPU_BASE:
     {
       Log_DebugPrintf("SPU IRQ address register <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
+      SyncRenderThread();
       m_irq_address = value;
 
       if (IsRAMIRQTriggerable())
@@ -473,6 +441,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
     {
       Log_DebugPrintf("SPU control register <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
+      SyncRenderThread();
 
       const SPUCNT new_value{value};
       if (new_value.ram_transfer_mode != m_SPUCNT.ram_transfer_mode &&
@@ -509,6 +478,10 @@ void SPU::WriteRegister(u32 offset, u16 value)
       m_SPUCNT.bits = new_value.bits;
       m_SPUSTAT.mode = m_SPUCNT.mode.GetValue();
 
+      // samples are generated on this thread while RAM IRQs are enabled, so nothing can be left queued
+      if (m_SPUCNT.irq9_enable)
+        SyncRenderThread();
+
       if (!m_SPUCNT.irq9_enable)
         m_SPUSTAT.irq9_flag = false;
       else if (IsRAMIRQTriggerable())
@@ -527,22 +500,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
       return;
     }
 
-    case 0x1F801DB0 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU left cd audio register <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_cd_audio_volume_left = value;
-    }
-    break;
-
-    case 0x1F801DB2 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU right cd audio register <- 0x%04X", ZeroExtend32(value));
-      GeneratePendingSamples();
-      m_cd_audio_volume_right = value;
-    }
-    break;
-
     case 0x1F801DB4 - SPU_BASE:
     {
       // External volumes aren't used, so don't bother syncing.
@@ -565,6 +522,143 @@ void SPU::WriteRegister(u32 offset, u16 value)
       return;
     }
 
+    default:
+    {
+      Log_DevPrintf("Unknown SPU register write: offset 0x%X (address 0x%08X) value 0x%04X", offset, offset | SPU_BASE,
+                    ZeroExtend32(value));
+      return;
+    }
+  }
+}
+
+void SPU::WriteRenderRegister(u32 offset, u16 value)
+{
+  switch (offset)
+  {
+    case 0x1F801D80 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU main volume left <- 0x%04X", ZeroExtend32(value));
+      m_main_volume_left_reg.bits = value;
+      m_main_volume_left.Reset(m_main_volume_left_reg);
+      return;
+    }
+
+    case 0x1F801D82 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU main volume right <- 0x%04X", ZeroExtend32(value));
+      m_main_volume_right_reg.bits = value;
+      m_main_volume_right.Reset(m_main_volume_right_reg);
+      return;
+    }
+
+    case 0x1F801D84 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU reverb output volume left <- 0x%04X", ZeroExtend32(value));
+      m_reverb_registers.vLOUT = value;
+      return;
+    }
+
+    case 0x1F801D86 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU reverb output volume right <- 0x%04X", ZeroExtend32(value));
+      m_reverb_registers.vROUT = value;
+      return;
+    }
+
+    case 0x1F801D88 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU key on low <- 0x%04X", ZeroExtend32(value));
+      m_key_on_register = (m_key_on_register & 0xFFFF0000) | ZeroExtend32(value);
+    }
+    break;
+
+    case 0x1F801D8A - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU key on high <- 0x%04X", ZeroExtend32(value));
+      m_key_on_register = (m_key_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+    }
+    break;
+
+    case 0x1F801D8C - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU key off low <- 0x%04X", ZeroExtend32(value));
+      m_key_off_register = (m_key_off_register & 0xFFFF0000) | ZeroExtend32(value);
+    }
+    break;
+
+    case 0x1F801D8E - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU key off high <- 0x%04X", ZeroExtend32(value));
+      m_key_off_register = (m_key_off_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+    }
+    break;
+
+    case 0x1F801D90 - SPU_BASE:
+    {
+      m_pitch_modulation_enable_register = (m_pitch_modulation_enable_register & 0xFFFF0000) | ZeroExtend32(value);
+      Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
+    }
+    break;
+
+    case 0x1F801D92 - SPU_BASE:
+    {
+      m_pitch_modulation_enable_register =
+        (m_pitch_modulation_enable_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+      Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
+    }
+    break;
+
+    case 0x1F801D94 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
+      m_noise_mode_register = (m_noise_mode_register & 0xFFFF0000) | ZeroExtend32(value);
+    }
+    break;
+
+    case 0x1F801D96 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
+      m_noise_mode_register = (m_noise_mode_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+    }
+    break;
+
+    case 0x1F801D98 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
+      m_reverb_on_register = (m_reverb_on_register & 0xFFFF0000) | ZeroExtend32(value);
+    }
+    break;
+
+    case 0x1F801D9A - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
+      m_reverb_on_register = (m_reverb_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+    }
+    break;
+
+    case 0x1F801DA2 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU reverb base address < 0x%04X", ZeroExtend32(value));
+      m_reverb_registers.mBASE = value;
+      m_reverb_base_address = ZeroExtend32(value << 2) & 0x3FFFFu;
+      m_reverb_current_address = m_reverb_base_address;
+    }
+    break;
+
+    case 0x1F801DB0 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU left cd audio register <- 0x%04X", ZeroExtend32(value));
+      m_cd_audio_volume_left = value;
+    }
+    break;
+
+    case 0x1F801DB2 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU right cd audio register <- 0x%04X", ZeroExtend32(value));
+      m_cd_audio_volume_right = value;
+    }
+    break;
+
     default:
     {
       if (offset < (0x1F801D80 - SPU_BASE))
@@ -577,7 +671,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
       {
         const u32 reg = (offset - (0x1F801DC0 - SPU_BASE)) / 2;
         Log_DebugPrintf("SPU reverb register %u <- 0x%04X", reg, value);
-        GeneratePendingSamples();
         m_reverb_registers.rev[reg] = value;
         return;
       }
@@ -612,9 +705,6 @@ void SPU::WriteVoiceRegister(u32 offset, u16 value)
   DebugAssert(voice_index < 24);
 
   Voice& voice = m_voices[voice_index];
-  if (voice.IsOn() || m_key_on_register & (1u << voice_index))
-    GeneratePendingSamples();
-
   switch (reg_index)
   {
     case 0x00: // volume left
@@ -752,7 +842,6 @@ void SPU::IncrementCaptureBufferPosition()
 {
   m_capture_buffer_position += sizeof(s16);
   m_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
-  m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
 }
 
 void ALWAYS_INLINE SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
@@ -775,6 +864,25 @@ void ALWAYS_INLINE SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
 
 void ALWAYS_INLINE SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
 {
+  if (IsUsingRenderThread())
+  {
+    // The render thread owns RAM, so the halfwords are written there, between the samples either side.
+    const u32 start_address = m_transfer_address;
+    const u32 payload_offset = static_cast<u32>(m_render_batch_payload.size());
+    while (ticks > 0 && !m_transfer_fifo.IsEmpty())
+    {
+      m_render_batch_payload.push_back(m_transfer_fifo.Pop());
+      m_transfer_address = (m_transfer_address + sizeof(u16)) & RAM_MASK;
+      ticks -= TRANSFER_TICKS_PER_HALFWORD;
+    }
+
+    const u32 count = static_cast<u32>(m_render_batch_payload.size()) - payload_offset;
+    if (count > 0)
+      QueueRenderCommand(RenderCommandType::WriteRAM, start_address, count, payload_offset);
+
+    return;
+  }
+
   while (ticks > 0 && !m_transfer_fifo.IsEmpty())
   {
     u16 value = m_transfer_fifo.Pop();
@@ -797,6 +905,9 @@ void SPU::ExecuteTransfer(TickCount ticks)
 
   if (mode == RAMTransferMode::DMARead)
   {
+    // capture buffers and reverb are written to RAM by the render thread
+    SyncRenderThread();
+
     while (ticks > 0 && !m_transfer_fifo.IsFull())
     {
       ExecuteFIFOReadFromRAM(ticks);
@@ -1018,8 +1129,21 @@ void SPU::GeneratePendingSamples()
   m_tick_event->InvokeEarly(force_exec);
 }
 
+std::array<u8, SPU::RAM_SIZE>& SPU::GetRAM()
+{
+  SyncRenderThread();
+  return m_ram;
+}
+
+void SPU::SetAudioStream(AudioStream* stream)
+{
+  SyncRenderThread();
+  m_audio_stream = stream;
+}
+
 bool SPU::StartDumpingAudio(const char* filename)
 {
+  SyncRenderThread();
   m_dump_writer.reset();
   m_dump_writer = std::make_unique<Common::WAVWriter>();
   if (!m_dump_writer->Open(filename, SAMPLE_RATE, 2))
@@ -1055,6 +1179,7 @@ bool SPU::StartDumpingAudio(const char* filename)
 
 bool SPU::StopDumpingAudio()
 {
+  SyncRenderThread();
   if (!m_dump_writer)
     return false;
 
@@ -1329,85 +1454,92 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
-s32 SPU::Voice::Interpolate() const
-{
-  static constexpr std::array<s16, 0x200> gauss = {{
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
-    0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
-    0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
-    0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
-    0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
-    0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
-    0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
-    0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
-    0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
-    0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
-    0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
-    0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
-    0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
-    0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
-    0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
-    0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
-    0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
-    0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
-    0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
-    0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
-    0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
-    0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
-    0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
-    0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
-    0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
-    0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
-    0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
-    0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
-    0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
-    0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
-    0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
-    0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
-    0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
-    0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
-    0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
-    0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
-    0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
-    0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
-    0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
-    0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
-    0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
-    0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
-    0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
-    0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
-    0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
-    0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
-    0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
-    0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
-    0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
-    0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
-    0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
-    0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
-    0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
-    0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
-    0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
-    0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
-    0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
-    0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
-    0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
-    0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
-    0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
-    0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
-  }};
-
-  const u8 i = counter.interpolation_index;
-  const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
-
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
-  return out >> 15;
+// Gaussian interpolation coefficients, indexed by the voice counter interpolation index.
+static constexpr std::array<s16, 0x200> s_gauss_table = {{
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
+  0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
+  0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
+  0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
+  0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
+  0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
+  0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
+  0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
+  0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
+  0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
+  0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
+  0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
+  0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
+  0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
+  0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
+  0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
+  0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
+  0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
+  0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
+  0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
+  0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
+  0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
+  0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
+  0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
+  0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
+  0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
+  0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
+  0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
+  0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
+  0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
+  0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
+  0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
+  0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
+  0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
+  0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
+  0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
+  0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
+  0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
+  0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
+  0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
+  0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
+  0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
+  0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
+  0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
+  0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
+  0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
+  0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
+  0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
+  0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
+  0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
+  0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
+  0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
+  0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
+  0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
+  0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
+  0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
+  0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
+  0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
+  0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
+  0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
+  0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
+  0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
+}};
+
+// The coefficients for each interpolation index, in the same order as the taps they're multiplied with.
+using GaussTaps = std::array<std::array<s16, 4>, 0x100>;
+static constexpr GaussTaps ComputeGaussTaps()
+{
+  GaussTaps taps = {};
+  for (u32 i = 0; i < 0x100; i++)
+  {
+    taps[i][0] = s_gauss_table[0x0FF - i];
+    taps[i][1] = s_gauss_table[0x1FF - i];
+    taps[i][2] = s_gauss_table[0x100 + i];
+    taps[i][3] = s_gauss_table[0x000 + i];
+  }
+
+  return taps;
 }
 
+static constexpr GaussTaps s_gauss_taps = ComputeGaussTaps();
+
 void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
 {
   u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
@@ -1435,24 +1567,17 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+u32 SPU::GetVoicesOnMask() const
 {
-  Voice& voice = m_voices[voice_index];
-  if (!voice.IsOn() && !m_SPUCNT.irq9_enable)
-  {
-    voice.last_volume = 0;
-
-#ifdef SPU_DUMP_ALL_VOICES
-    if (m_voice_dump_writers[voice_index])
-    {
-      const s16 dump_samples[2] = {0, 0};
-      m_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
-    }
-#endif
-
-    return {};
-  }
+  u32 mask = 0;
+  for (u32 i = 0; i < NUM_VOICES; i++)
+    mask |= BoolToUInt32(m_voices[i].IsOn()) << i;
+  return mask;
+}
 
+ALWAYS_INLINE_RELEASE bool SPU::PrepareVoiceMix(u32 voice_index)
+{
+  Voice& voice = m_voices[voice_index];
   if (!voice.has_samples)
   {
     ADPCMBlock block;
@@ -1468,24 +1593,205 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   }
 
   // skip interpolation when the volume is muted anyway
-  s32 volume;
-  if (voice.regs.adsr_volume != 0)
+  VoiceMixState& state = m_voice_mix_state;
+  if (voice.regs.adsr_volume == 0)
   {
-    // interpolate/sample and apply ADSR volume
-    s32 sample;
-    if (IsVoiceNoiseEnabled(voice_index))
-      sample = GetVoiceNoiseLevel();
-    else
-      sample = voice.Interpolate();
+    state.adsr_volume[voice_index] = 0;
+    state.output[voice_index] = 0;
+    return false;
+  }
+
+  // the four taps are contiguous in the decoded block
+  const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(voice.counter.sample_index.GetValue());
+  std::memcpy(state.samples[voice_index].data(), &voice.current_block_samples[s - 3], sizeof(s16) * 4);
+  state.gauss[voice_index] = s_gauss_taps[voice.counter.interpolation_index];
+  state.adsr_volume[voice_index] = voice.regs.adsr_volume;
+  state.left_volume[voice_index] = voice.left_volume.current_level;
+  state.right_volume[voice_index] = voice.right_volume.current_level;
+  return true;
+}
+
+#ifdef SPU_VECTOR_MIX
+
+#if defined(CPU_X64)
 
-    volume = ApplyVolume(sample, voice.regs.adsr_volume);
+// SSE2 has no 32-bit multiply, so do the even and odd lanes separately and recombine the low halves.
+ALWAYS_INLINE static __m128i MultiplyLow32(__m128i a, __m128i b)
+{
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+ALWAYS_INLINE static __m128i MaskFromBits(u32 bits)
+{
+  const __m128i lane_bits = _mm_set_epi32(8, 4, 2, 1);
+  return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<s32>(bits)), lane_bits), lane_bits);
+}
+
+ALWAYS_INLINE static s32 HorizontalAdd32(__m128i v)
+{
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+void SPU::MixVoices(VoiceMixState& state, u32 active_voices, u32 reverb_on, u32 noise_on, s16 noise_level,
+                    s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right)
+{
+  const __m128i noise = _mm_set1_epi32(noise_level);
+  __m128i left_acc = _mm_setzero_si128();
+  __m128i right_acc = _mm_setzero_si128();
+  __m128i reverb_left_acc = _mm_setzero_si128();
+  __m128i reverb_right_acc = _mm_setzero_si128();
+
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
+  {
+    if (((active_voices >> i) & 0xFu) == 0)
+      continue;
+
+    // each multiply-add gives the sums of the first and last pairs of taps for two voices
+    const __m128i taps_01 = _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&state.samples[i])),
+                                           _mm_load_si128(reinterpret_cast<const __m128i*>(&state.gauss[i])));
+    const __m128i taps_23 = _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&state.samples[i + 2])),
+                                           _mm_load_si128(reinterpret_cast<const __m128i*>(&state.gauss[i + 2])));
+    const __m128 taps_01f = _mm_castsi128_ps(taps_01);
+    const __m128 taps_23f = _mm_castsi128_ps(taps_23);
+    __m128i sample = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(taps_01f, taps_23f, _MM_SHUFFLE(2, 0, 2, 0))),
+                                   _mm_castps_si128(_mm_shuffle_ps(taps_01f, taps_23f, _MM_SHUFFLE(3, 1, 3, 1))));
+    sample = _mm_srai_epi32(sample, 15);
+
+    const __m128i noise_mask = MaskFromBits(noise_on >> i);
+    sample = _mm_or_si128(_mm_andnot_si128(noise_mask, sample), _mm_and_si128(noise_mask, noise));
+
+    const __m128i adsr_volume = _mm_load_si128(reinterpret_cast<const __m128i*>(&state.adsr_volume[i]));
+    const __m128i output = _mm_srai_epi32(MultiplyLow32(sample, adsr_volume), 15);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&state.output[i]), output);
+
+    const __m128i left_volume = _mm_load_si128(reinterpret_cast<const __m128i*>(&state.left_volume[i]));
+    const __m128i right_volume = _mm_load_si128(reinterpret_cast<const __m128i*>(&state.right_volume[i]));
+    const __m128i left = _mm_srai_epi32(MultiplyLow32(output, left_volume), 15);
+    const __m128i right = _mm_srai_epi32(MultiplyLow32(output, right_volume), 15);
+    left_acc = _mm_add_epi32(left_acc, left);
+    right_acc = _mm_add_epi32(right_acc, right);
+
+    const __m128i reverb_mask = MaskFromBits(reverb_on >> i);
+    reverb_left_acc = _mm_add_epi32(reverb_left_acc, _mm_and_si128(left, reverb_mask));
+    reverb_right_acc = _mm_add_epi32(reverb_right_acc, _mm_and_si128(right, reverb_mask));
   }
-  else
+
+  *left_sum = HorizontalAdd32(left_acc);
+  *right_sum = HorizontalAdd32(right_acc);
+  *reverb_in_left = HorizontalAdd32(reverb_left_acc);
+  *reverb_in_right = HorizontalAdd32(reverb_right_acc);
+}
+
+#elif defined(CPU_AARCH64)
+
+ALWAYS_INLINE static int32x4_t MaskFromBits(u32 bits)
+{
+  static constexpr u32 lane_bits[4] = {1, 2, 4, 8};
+  return vreinterpretq_s32_u32(vtstq_u32(vdupq_n_u32(bits), vld1q_u32(lane_bits)));
+}
+
+// Multiplies the four taps of two voices, and returns the sums of the first and last pairs of taps for each.
+ALWAYS_INLINE static int32x4_t MultiplyTaps(const s16* samples, const s16* gauss)
+{
+  const int16x8_t samples_vec = vld1q_s16(samples);
+  const int16x8_t gauss_vec = vld1q_s16(gauss);
+  return vpaddq_s32(vmull_s16(vget_low_s16(samples_vec), vget_low_s16(gauss_vec)),
+                    vmull_high_s16(samples_vec, gauss_vec));
+}
+
+void SPU::MixVoices(VoiceMixState& state, u32 active_voices, u32 reverb_on, u32 noise_on, s16 noise_level,
+                    s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right)
+{
+  const int32x4_t noise = vdupq_n_s32(noise_level);
+  int32x4_t left_acc = vdupq_n_s32(0);
+  int32x4_t right_acc = vdupq_n_s32(0);
+  int32x4_t reverb_left_acc = vdupq_n_s32(0);
+  int32x4_t reverb_right_acc = vdupq_n_s32(0);
+
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
   {
-    volume = 0;
+    if (((active_voices >> i) & 0xFu) == 0)
+      continue;
+
+    const int32x4_t taps_01 = MultiplyTaps(state.samples[i].data(), state.gauss[i].data());
+    const int32x4_t taps_23 = MultiplyTaps(state.samples[i + 2].data(), state.gauss[i + 2].data());
+    int32x4_t sample = vshrq_n_s32(vpaddq_s32(taps_01, taps_23), 15);
+    sample = vbslq_s32(vreinterpretq_u32_s32(MaskFromBits(noise_on >> i)), noise, sample);
+
+    const int32x4_t output = vshrq_n_s32(vmulq_s32(sample, vld1q_s32(&state.adsr_volume[i])), 15);
+    vst1q_s32(&state.output[i], output);
+
+    const int32x4_t left = vshrq_n_s32(vmulq_s32(output, vld1q_s32(&state.left_volume[i])), 15);
+    const int32x4_t right = vshrq_n_s32(vmulq_s32(output, vld1q_s32(&state.right_volume[i])), 15);
+    left_acc = vaddq_s32(left_acc, left);
+    right_acc = vaddq_s32(right_acc, right);
+
+    const int32x4_t reverb_mask = MaskFromBits(reverb_on >> i);
+    reverb_left_acc = vaddq_s32(reverb_left_acc, vandq_s32(left, reverb_mask));
+    reverb_right_acc = vaddq_s32(reverb_right_acc, vandq_s32(right, reverb_mask));
   }
 
-  voice.last_volume = volume;
+  *left_sum = vaddvq_s32(left_acc);
+  *right_sum = vaddvq_s32(right_acc);
+  *reverb_in_left = vaddvq_s32(reverb_left_acc);
+  *reverb_in_right = vaddvq_s32(reverb_right_acc);
+}
+
+#endif
+
+#else
+
+void SPU::MixVoices(VoiceMixState& state, u32 active_voices, u32 reverb_on, u32 noise_on, s16 noise_level,
+                    s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right)
+{
+  *left_sum = 0;
+  *right_sum = 0;
+  *reverb_in_left = 0;
+  *reverb_in_right = 0;
+
+  for (u32 mask = active_voices; mask != 0; mask &= (mask - 1))
+  {
+    const u32 i = CountTrailingZeros(mask);
+    s32 sample;
+    if ((noise_on >> i) & 1u)
+    {
+      sample = noise_level;
+    }
+    else
+    {
+      s32 out = s32(state.gauss[i][0]) * s32(state.samples[i][0]);
+      out += s32(state.gauss[i][1]) * s32(state.samples[i][1]);
+      out += s32(state.gauss[i][2]) * s32(state.samples[i][2]);
+      out += s32(state.gauss[i][3]) * s32(state.samples[i][3]);
+      sample = out >> 15;
+    }
+
+    const s32 output = ApplyVolume(sample, static_cast<s16>(state.adsr_volume[i]));
+    state.output[i] = output;
+
+    const s32 left = ApplyVolume(output, static_cast<s16>(state.left_volume[i]));
+    const s32 right = ApplyVolume(output, static_cast<s16>(state.right_volume[i]));
+    *left_sum += left;
+    *right_sum += right;
+    if ((reverb_on >> i) & 1u)
+    {
+      *reverb_in_left += left;
+      *reverb_in_right += right;
+    }
+  }
+}
+
+#endif
+
+ALWAYS_INLINE_RELEASE bool SPU::AdvanceVoice(u32 voice_index)
+{
+  Voice& voice = m_voices[voice_index];
+  voice.last_volume = m_voice_mix_state.output[voice_index];
 
   if (voice.adsr_phase != ADSRPhase::Off)
     voice.TickADSR();
@@ -1531,21 +1837,20 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     }
   }
 
-  // apply per-channel volume
-  const s32 left = ApplyVolume(volume, voice.left_volume.current_level);
-  const s32 right = ApplyVolume(volume, voice.right_volume.current_level);
   voice.left_volume.Tick();
   voice.right_volume.Tick();
 
 #ifdef SPU_DUMP_ALL_VOICES
   if (m_voice_dump_writers[voice_index])
   {
+    const s32 left = ApplyVolume(voice.last_volume, static_cast<s16>(m_voice_mix_state.left_volume[voice_index]));
+    const s32 right = ApplyVolume(voice.last_volume, static_cast<s16>(m_voice_mix_state.right_volume[voice_index]));
     const s16 dump_samples[2] = {static_cast<s16>(Clamp16(left)), static_cast<s16>(Clamp16(right))};
     m_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
   }
 #endif
 
-  return std::make_tuple(left, right);
+  return voice.IsOn();
 }
 
 void SPU::UpdateNoise()
@@ -1767,6 +2072,8 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
 
 void SPU::Execute(TickCount ticks)
 {
+  Profiler::ScopedSection profile(Profiler::Section::SPU);
+
   u32 remaining_frames;
   if (g_settings.cpu_overclock_active)
   {
@@ -1781,6 +2088,27 @@ void SPU::Execute(TickCount ticks)
     m_ticks_carry = (ticks + m_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
+  if (m_use_render_thread)
+  {
+    if (!m_SPUCNT.irq9_enable)
+    {
+      if (remaining_frames > 0)
+        QueueRenderFrames(remaining_frames);
+
+      return;
+    }
+
+    // RAM IRQs have to be raised at the right time, so generate the samples here instead.
+    SyncRenderThread();
+  }
+
+  RenderFrames(remaining_frames, nullptr);
+}
+
+void SPU::RenderFrames(u32 remaining_frames, const s16* cd_audio_frames)
+{
+  u32 voices_on = GetVoicesOnMask();
+  u32 cleared_voices_n = ALL_VOICES_MASK;
   while (remaining_frames > 0)
   {
     s16* output_frame_start;
@@ -1791,25 +2119,45 @@ void SPU::Execute(TickCount ticks)
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
     for (u32 i = 0; i < frames_in_this_batch; i++)
     {
-      s32 left_sum = 0;
-      s32 right_sum = 0;
-      s32 reverb_in_left = 0;
-      s32 reverb_in_right = 0;
-
-      u32 reverb_on_register = m_reverb_on_register;
+      // Voices which are off are skipped entirely, unless they can still trigger IRQs. Their output only needs to be
+      // cleared once when they stop, since it's never written while they're skipped.
+      const u32 active_voices = m_SPUCNT.irq9_enable ? ALL_VOICES_MASK : voices_on;
+      for (u32 mask = ~active_voices & cleared_voices_n; mask != 0; mask &= (mask - 1))
+      {
+        const u32 voice = CountTrailingZeros(mask);
+        m_voices[voice].last_volume = 0;
+        m_voice_mix_state.adsr_volume[voice] = 0;
+      }
+      cleared_voices_n = active_voices;
 
+#ifdef SPU_DUMP_ALL_VOICES
       for (u32 voice = 0; voice < NUM_VOICES; voice++)
       {
-        const auto [left, right] = SampleVoice(voice);
-        left_sum += left;
-        right_sum += right;
-
-        if (reverb_on_register & 1u)
+        if (!(active_voices & (1u << voice)) && m_voice_dump_writers[voice])
         {
-          reverb_in_left += left;
-          reverb_in_right += right;
+          const s16 dump_samples[2] = {0, 0};
+          m_voice_dump_writers[voice]->WriteFrames(dump_samples, 1);
         }
-        reverb_on_register >>= 1;
+      }
+#endif
+
+      u32 audible_voices = 0;
+      for (u32 mask = active_voices; mask != 0; mask &= (mask - 1))
+      {
+        const u32 voice = CountTrailingZeros(mask);
+        audible_voices |= BoolToUInt32(PrepareVoiceMix(voice)) << voice;
+      }
+
+      s32 left_sum, right_sum, reverb_in_left, reverb_in_right;
+      MixVoices(m_voice_mix_state, audible_voices, m_reverb_on_register, m_noise_mode_register, GetVoiceNoiseLevel(),
+                &left_sum, &right_sum, &reverb_in_left, &reverb_in_right);
+
+      // Has to be done in order, since pitch modulation uses the previous voice's output.
+      for (u32 mask = active_voices; mask != 0; mask &= (mask - 1))
+      {
+        const u32 voice = CountTrailingZeros(mask);
+        if (!AdvanceVoice(voice))
+          voices_on &= ~(1u << voice);
       }
 
       if (!m_SPUCNT.mute_n)
@@ -1821,8 +2169,18 @@ void SPU::Execute(TickCount ticks)
       // Update noise once per frame.
       UpdateNoise();
 
-      // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = g_cdrom.GetAudioFrame();
+      // Mix in CD audio. The render thread is given frames which were already pulled from the CDROM.
+      s16 cd_audio_left, cd_audio_right;
+      if (cd_audio_frames)
+      {
+        cd_audio_left = *(cd_audio_frames++);
+        cd_audio_right = *(cd_audio_frames++);
+      }
+      else
+      {
+        std::tie(cd_audio_left, cd_audio_right) = g_cdrom.GetAudioFrame();
+      }
+
       if (m_SPUCNT.cd_audio_enable)
       {
         const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), m_cd_audio_volume_left);
@@ -1879,6 +2237,7 @@ void SPU::Execute(TickCount ticks)
           {
             m_endx_register &= ~(1u << voice);
             m_voices[voice].KeyOn();
+            voices_on |= (1u << voice);
           }
           key_on_register >>= 1;
         }
@@ -1917,8 +2276,171 @@ void SPU::UpdateEventInterval()
   m_tick_event->Schedule(downcount);
 }
 
+void SPU::StartRenderThread()
+{
+  m_render_thread_shutdown = false;
+  m_render_thread_busy = false;
+  m_render_queued_frames = 0;
+  m_use_render_thread = true;
+  m_render_thread = std::thread(&SPU::RenderThreadEntryPoint, this);
+  Log_InfoPrint("SPU render thread started.");
+}
+
+void SPU::StopRenderThread()
+{
+  if (!m_use_render_thread)
+    return;
+
+  SyncRenderThread();
+
+  {
+    std::unique_lock lock(m_render_mutex);
+    m_render_thread_shutdown = true;
+    m_render_wake_cv.notify_one();
+  }
+
+  m_render_thread.join();
+  m_use_render_thread = false;
+  Log_InfoPrint("SPU render thread stopped.");
+}
+
+void SPU::SyncRenderThread()
+{
+  if (!m_render_thread_pending && m_render_batch.empty())
+    return;
+
+  FlushRenderCommands();
+
+  std::unique_lock lock(m_render_mutex);
+  m_render_done_cv.wait(lock, [this]() { return m_render_queue.empty() && !m_render_thread_busy; });
+  m_render_thread_pending = false;
+}
+
+void SPU::QueueRenderFrames(u32 frames)
+{
+  // CD audio is pulled now, since the CDROM keeps filling its FIFO on the CPU thread.
+  const u32 payload_offset = static_cast<u32>(m_render_batch_payload.size());
+  m_render_batch_payload.resize(payload_offset + frames * 2);
+  u16* cd_audio_frames = &m_render_batch_payload[payload_offset];
+  for (u32 i = 0; i < frames; i++)
+  {
+    const auto [cd_audio_left, cd_audio_right] = g_cdrom.GetAudioFrame();
+    *(cd_audio_frames++) = static_cast<u16>(cd_audio_left);
+    *(cd_audio_frames++) = static_cast<u16>(cd_audio_right);
+  }
+
+  // consecutive blocks of frames can be generated in one go, their CD audio is contiguous
+  if (!m_render_batch.empty() && m_render_batch.back().type == RenderCommandType::RenderFrames)
+    m_render_batch.back().param += frames;
+  else
+    m_render_batch.push_back(RenderCommand{RenderCommandType::RenderFrames, frames, 0, payload_offset});
+
+  m_render_batch_frames += frames;
+  if (m_render_batch_frames >= RENDER_THREAD_BATCH_FRAMES)
+    FlushRenderCommands();
+}
+
+void SPU::QueueRenderCommand(RenderCommandType type, u32 param, u32 value, u32 payload_offset)
+{
+  m_render_batch.push_back(RenderCommand{type, param, value, payload_offset});
+}
+
+void SPU::FlushRenderCommands()
+{
+  if (m_render_batch.empty())
+    return;
+
+  // Don't let the render thread fall more than a buffer behind, otherwise audio sync can't throttle emulation.
+  const u32 max_queued_frames = std::max(m_audio_stream->GetBufferSize(), RENDER_THREAD_BATCH_FRAMES);
+
+  std::unique_lock lock(m_render_mutex);
+  m_render_done_cv.wait(lock, [this, max_queued_frames]() { return m_render_queued_frames <= max_queued_frames; });
+
+  const u32 payload_base = static_cast<u32>(m_render_queue_payload.size());
+  for (const RenderCommand& cmd : m_render_batch)
+  {
+    m_render_queue.push_back(cmd);
+    m_render_queue.back().payload_offset += payload_base;
+  }
+  m_render_queue_payload.insert(m_render_queue_payload.end(), m_render_batch_payload.begin(),
+                                m_render_batch_payload.end());
+  m_render_queued_frames += m_render_batch_frames;
+  m_render_wake_cv.notify_one();
+  lock.unlock();
+
+  m_render_batch.clear();
+  m_render_batch_payload.clear();
+  m_render_batch_frames = 0;
+  m_render_thread_pending = true;
+}
+
+void SPU::ExecuteRenderCommands(const std::vector<RenderCommand>& commands, const std::vector<u16>& payload)
+{
+  for (const RenderCommand& cmd : commands)
+  {
+    switch (cmd.type)
+    {
+      case RenderCommandType::RenderFrames:
+        RenderFrames(cmd.param, reinterpret_cast<const s16*>(&payload[cmd.payload_offset]));
+        break;
+
+      case RenderCommandType::WriteRegister:
+        WriteRenderRegister(cmd.param, Truncate16(cmd.value));
+        break;
+
+      case RenderCommandType::WriteRAM:
+      {
+        for (u32 i = 0; i < cmd.value; i++)
+        {
+          const u32 address = (cmd.param + i * sizeof(u16)) & RAM_MASK;
+          std::memcpy(&m_ram[address], &payload[cmd.payload_offset + i], sizeof(u16));
+        }
+      }
+      break;
+    }
+  }
+}
+
+void SPU::RenderThreadEntryPoint()
+{
+  std::vector<RenderCommand> commands;
+  std::vector<u16> payload;
+
+  std::unique_lock lock(m_render_mutex);
+  for (;;)
+  {
+    m_render_wake_cv.wait(lock, [this]() { return !m_render_queue.empty() || m_render_thread_shutdown; });
+    if (m_render_queue.empty())
+      break;
+
+    commands.swap(m_render_queue);
+    payload.swap(m_render_queue_payload);
+    m_render_thread_busy = true;
+    lock.unlock();
+
+    u32 frames = 0;
+    for (const RenderCommand& cmd : commands)
+      frames += (cmd.type == RenderCommandType::RenderFrames) ? cmd.param : 0;
+
+    {
+      Profiler::ScopedThreadSection profile(Profiler::Section::SPU);
+      ExecuteRenderCommands(commands, payload);
+    }
+    commands.clear();
+    payload.clear();
+
+    lock.lock();
+    m_render_queued_frames -= frames;
+    m_render_thread_busy = false;
+    m_render_done_cv.notify_all();
+  }
+}
+
 void SPU::DrawDebugStateWindow()
 {
+  SyncRenderThread();
+  UpdateCaptureBufferStatus();
+
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
   static const ImVec4 inactive_color{0.4f, 0.4f, 0.4f, 1.0f};
   const float framebuffer_scale = ImGui::GetIO().DisplayFramebufferScale.x;
@@ -4,7 +4,11 @@
 #include "system.h"
 #include "types.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // Enable to dump all voices of the SPU audio individually.
 // #define SPU_DUMP_ALL_VOICES 1
@@ -31,6 +35,7 @@ public:
 
   void Initialize();
   void CPUClockChanged();
+  void UpdateSettings();
   void Shutdown();
   void Reset();
   bool DoState(StateWrapper& sw);
@@ -47,6 +52,9 @@ public:
   // Executes the SPU, generating any pending samples.
   void GeneratePendingSamples();
 
+  /// Waits for the render thread to generate all queued samples, if it is in use.
+  void SyncRenderThread();
+
   /// Returns true if currently dumping audio.
   ALWAYS_INLINE bool IsDumpingAudio() const { return static_cast<bool>(m_dump_writer); }
 
@@ -56,16 +64,16 @@ public:
   /// Stops dumping audio to file, if started.
   bool StopDumpingAudio();
 
-  /// Access to SPU RAM.
-  const std::array<u8, RAM_SIZE>& GetRAM() const { return m_ram; }
-  std::array<u8, RAM_SIZE>& GetRAM() { return m_ram; }
+  /// Access to SPU RAM. Waits for the render thread, since it writes reverb and capture data to RAM.
+  std::array<u8, RAM_SIZE>& GetRAM();
 
   /// Change output stream - used for runahead.
-  ALWAYS_INLINE void SetAudioStream(AudioStream* stream) { m_audio_stream = stream; }
+  void SetAudioStream(AudioStream* stream);
 
 private:
   static constexpr u32 SPU_BASE = 0x1F801C00;
   static constexpr u32 NUM_VOICES = 24;
+  static constexpr u32 ALL_VOICES_MASK = (1u << NUM_VOICES) - 1;
   static constexpr u32 NUM_VOICE_REGISTERS = 8;
   static constexpr u32 VOICE_ADDRESS_SHIFT = 3;
   static constexpr u32 NUM_SAMPLES_PER_ADPCM_BLOCK = 28;
@@ -79,6 +87,7 @@ private:
   static constexpr u32 NUM_REVERB_REGS = 32;
   static constexpr u32 FIFO_SIZE_IN_HALFWORDS = 32;
   static constexpr TickCount TRANSFER_TICKS_PER_HALFWORD = 16;
+  static constexpr u32 RENDER_THREAD_BATCH_FRAMES = 128;
 
   enum class RAMTransferMode : u8
   {
@@ -279,7 +288,6 @@ private:
     void ForceOff();
 
     void DecodeBlock(const ADPCMBlock& block);
-    s32 Interpolate() const;
 
     // Switches to the specified phase, filling in target.
     void UpdateADSREnvelope();
@@ -288,6 +296,17 @@ private:
     void TickADSR();
   };
 
+  /// Per-frame mixer inputs for each voice, stored as arrays over the voices so that several can be mixed at once.
+  struct alignas(16) VoiceMixState
+  {
+    std::array<std::array<s16, 4>, NUM_VOICES> samples; // interpolation taps, oldest first
+    std::array<std::array<s16, 4>, NUM_VOICES> gauss;   // interpolation coefficients for each tap
+    std::array<s32, NUM_VOICES> adsr_volume;             // zero for voices which are off
+    std::array<s32, NUM_VOICES> left_volume;
+    std::array<s32, NUM_VOICES> right_volume;
+    std::array<s32, NUM_VOICES> output; // interpolated sample with ADSR volume applied
+  };
+
   struct ReverbRegisters
   {
     s16 vLOUT;
@@ -325,6 +344,22 @@ private:
     };
   };
 
+  enum class RenderCommandType : u8
+  {
+    RenderFrames,
+    WriteRegister,
+    WriteRAM
+  };
+
+  /// Work recorded on the CPU thread, to be replayed in order by the render thread.
+  struct RenderCommand
+  {
+    RenderCommandType type;
+    u32 param;          // frame count, register offset, or RAM address
+    u32 value;          // register value, or halfword count
+    u32 payload_offset; // start of CD audio frames or RAM halfwords in the payload
+  };
+
   static constexpr s32 Clamp16(s32 value) { return (value < -0x8000) ? -0x8000 : (value > 0x7FFF) ? 0x7FFF : value; }
 
   static constexpr s32 ApplyVolume(s32 sample, s16 volume) { return (sample * s32(volume)) >> 15; }
@@ -345,6 +380,20 @@ private:
   }
   ALWAYS_INLINE s16 GetVoiceNoiseLevel() const { return static_cast<s16>(static_cast<u16>(m_noise_level)); }
 
+  /// Returns true if the register is only read or written by the CPU thread.
+  static bool IsControlRegister(u32 offset);
+
+  /// Returns true if the register only affects sample generation, so writes can be deferred to the render thread.
+  static bool IsRenderRegister(u32 offset);
+
+  ALWAYS_INLINE bool IsUsingRenderThread() const { return m_use_render_thread && !m_SPUCNT.irq9_enable; }
+
+  ALWAYS_INLINE void UpdateCaptureBufferStatus()
+  {
+    m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
+  }
+
+  void WriteRenderRegister(u32 offset, u16 value);
   u16 ReadVoiceRegister(u32 offset);
   void WriteVoiceRegister(u32 offset, u16 value);
 
@@ -357,7 +406,11 @@ private:
   void IncrementCaptureBufferPosition();
 
   void ReadADPCMBlock(u16 address, ADPCMBlock* block);
-  std::tuple<s32, s32> SampleVoice(u32 voice_index);
+  u32 GetVoicesOnMask() const;
+  bool PrepareVoiceMix(u32 voice_index);
+  bool AdvanceVoice(u32 voice_index);
+  static void MixVoices(VoiceMixState& state, u32 active_voices, u32 reverb_on, u32 noise_on, s16 noise_level,
+                        s32* left_sum, s32* right_sum, s32* reverb_in_left, s32* reverb_in_right);
 
   void UpdateNoise();
 
@@ -367,8 +420,17 @@ private:
   void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
   void Execute(TickCount ticks);
+  void RenderFrames(u32 remaining_frames, const s16* cd_audio_frames);
   void UpdateEventInterval();
 
+  void StartRenderThread();
+  void StopRenderThread();
+  void RenderThreadEntryPoint();
+  void QueueRenderFrames(u32 frames);
+  void QueueRenderCommand(RenderCommandType type, u32 param, u32 value, u32 payload_offset);
+  void FlushRenderCommands();
+  void ExecuteRenderCommands(const std::vector<RenderCommand>& commands, const std::vector<u16>& payload);
+
   void ExecuteFIFOWriteToRAM(TickCount& ticks);
   void ExecuteFIFOReadFromRAM(TickCount& ticks);
   void ExecuteTransfer(TickCount ticks);
@@ -423,11 +485,32 @@ private:
   s32 m_reverb_resample_buffer_position = 0;
 
   std::array<Voice, NUM_VOICES> m_voices{};
+  VoiceMixState m_voice_mix_state{};
 
   InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> m_transfer_fifo;
 
   std::array<u8, RAM_SIZE> m_ram{};
 
+  // Samples are generated on the render thread while RAM IRQs are disabled, since IRQs need exact timing.
+  std::thread m_render_thread;
+  bool m_use_render_thread = false;
+
+  // only accessed by the CPU thread, commands are batched here before being handed over
+  std::vector<RenderCommand> m_render_batch;
+  std::vector<u16> m_render_batch_payload;
+  u32 m_render_batch_frames = 0;
+  bool m_render_thread_pending = false;
+
+  // protected by the mutex
+  std::mutex m_render_mutex;
+  std::condition_variable m_render_wake_cv;
+  std::condition_variable m_render_done_cv;
+  std::vector<RenderCommand> m_render_queue;
+  std::vector<u16> m_render_queue_payload;
+  u32 m_render_queued_frames = 0;
+  bool m_render_thread_busy = false;
+  bool m_render_thread_shutdown = false;
+
 #ifdef SPU_DUMP_ALL_VOICES
   // +1 for reverb output
   std::array<std::unique_ptr<Common::WAVWriter>, NUM_VOICES + 1> m_voice_dump_writers;
@@ -4,6 +4,8 @@
 #include "cdrom.h"
 #include "cheats.h"
 #include "common/audio_stream.h"
+#include "common/byte_stream.h"
+#include "common/delta_compressor.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/iso_reader.h"
@@ -35,10 +37,12 @@
 #include "texture_replacements.h"
 #include "timers.h"
 #include "xxhash.h"
+#include <atomic>
 #include <cctype>
 #include <cinttypes>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <limits>
@@ -59,6 +63,10 @@ SystemBootParameters::SystemBootParameters(std::string filename_) : filename(std
 
 SystemBootParameters::~SystemBootParameters() = default;
 
+System::SaveStateBuffer::SaveStateBuffer() = default;
+
+System::SaveStateBuffer::~SaveStateBuffer() = default;
+
 namespace System {
 
 struct MemorySaveState
@@ -67,8 +75,33 @@ struct MemorySaveState
   std::unique_ptr<GrowableMemoryByteStream> state_stream;
 };
 
+/// Rewind states are stored compressed, as the difference from the most recent keyframe, which is itself a compressed
+/// full state. VRAM is included in the state at native resolution, so it is delta-compressed along with the rest.
+struct RewindKeyframe
+{
+  RewindKeyframe(std::vector<u8> data_, u32 size_);
+  ~RewindKeyframe();
+
+  std::vector<u8> data;
+  u32 size; // uncompressed
+};
+
+struct RewindState
+{
+  std::shared_ptr<const RewindKeyframe> keyframe;
+  std::vector<u8> delta; // empty if this state is the keyframe
+
+  // Hardware renderers only keep their upscaled VRAM texture for keyframe states, along with a compressed state which
+  // doesn't include VRAM. The other states rebuild VRAM from the native resolution copy.
+  std::unique_ptr<HostDisplayTexture> vram_texture;
+  std::vector<u8> texture_state;
+  u32 texture_state_size = 0;
+};
+
 static bool SaveMemoryState(MemorySaveState* mss);
+static bool SaveMemoryState(GrowableMemoryByteStream* stream, HostDisplayTexture** host_texture);
 static bool LoadMemoryState(const MemorySaveState& mss);
+static bool LoadMemoryState(ByteStream* stream, HostDisplayTexture* vram_texture);
 
 static bool LoadEXE(const char* filename);
 
@@ -85,6 +118,10 @@ static void DoRunFrame();
 static bool CreateGPU(GPURenderer renderer);
 
 static bool SaveRewindState();
+static bool SaveRewindKeyframeTexture(RewindState* rs);
+static void PushRewindState(RewindState rs);
+static void PopRewindState(bool oldest);
+static bool DecompressRewindState(const RewindState& rs);
 static void DoRewind();
 
 static void SaveRunaheadState();
@@ -133,7 +170,21 @@ static std::unique_ptr<CheatList> s_cheat_list;
 
 static bool s_memory_saves_enabled = false;
 
-static std::deque<MemorySaveState> s_rewind_states;
+static constexpr u32 REWIND_KEYFRAME_INTERVAL = 30;
+
+// Compressed sizes of everything held for rewind, which the frontend's settings UI reads from its own thread. These
+// are declared before the states, because keyframes update them when they're destroyed.
+static std::atomic<u32> s_rewind_state_count{0};
+static std::atomic<u64> s_rewind_ram_usage{0};
+static std::atomic<u64> s_rewind_vram_usage{0};
+
+static std::deque<RewindState> s_rewind_states;
+static std::unique_ptr<GrowableMemoryByteStream> s_rewind_scratch_stream;
+static DeltaCompressor s_rewind_compressor;
+static std::shared_ptr<const RewindKeyframe> s_rewind_keyframe;
+static std::vector<u8> s_rewind_keyframe_data; // uncompressed s_rewind_keyframe
+
+static u32 s_rewind_saves_since_keyframe = 0;
 static s32 s_rewind_load_frequency = -1;
 static s32 s_rewind_load_counter = -1;
 static s32 s_rewind_save_frequency = -1;
@@ -671,6 +722,8 @@ std::unique_ptr<CDImage> OpenCDImage(const char* path, Common::Error* error, boo
   if (!media)
     return {};
 
+  media->SetReadCacheSize(g_settings.cdrom_read_cache_size * 1024 * 1024);
+
   if (force_preload || g_settings.cdrom_load_image_to_ram)
   {
     if (media->HasSubImages() && media->GetSubImageCount() > 1)
@@ -882,6 +935,13 @@ bool Boot(const SystemBootParameters& params)
     BIOS::PatchBIOSFastBoot(Bus::g_bios, Bus::BIOS_SIZE, bios_hash);
   }
 
+  // Blocks are keyed by game and BIOS, since the BIOS code is included.
+  if (g_settings.cpu_recompiler_block_cache && g_settings.IsUsingCodeCache() && !s_running_game_code.empty())
+  {
+    CPU::CodeCache::LoadBlockCache(g_host_interface->GetUserDirectoryRelativePath(
+      "cache" FS_OSPATH_SEPARATOR_STR "blocks_%s_%s.bin", s_running_game_code.c_str(), bios_hash.ToString().c_str()));
+  }
+
   // Good to go.
   s_state = (g_settings.start_paused || params.override_start_paused.value_or(false)) ? State::Paused : State::Running;
   return true;
@@ -1349,15 +1409,35 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
       UpdatePerGameMemoryCards();
   }
 
-  if (header.data_compression_type != 0)
-  {
-    g_host_interface->ReportFormattedError("Unknown save state compression type %u", header.data_compression_type);
-    return false;
-  }
-
   if (!state->SeekAbsolute(header.offset_to_data))
     return false;
 
+  std::unique_ptr<GrowableMemoryByteStream> decompressed_state;
+  if (header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE)
+  {
+    BYTESTREAM_COMPRESSION_METHOD method;
+    if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_DEFLATE)
+      method = BYTESTREAM_COMPRESSION_METHOD_DEFLATE;
+    else if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_LZMA)
+      method = BYTESTREAM_COMPRESSION_METHOD_LZMA;
+    else
+    {
+      g_host_interface->ReportFormattedError("Unknown save state compression type %u", header.data_compression_type);
+      return false;
+    }
+
+    decompressed_state = ByteStream_CreateGrowableMemoryStream(nullptr, header.data_uncompressed_size);
+    if (!ByteStream_DecompressBytes(state, header.data_compressed_size, decompressed_state.get(),
+                                    header.data_uncompressed_size, method) ||
+        !decompressed_state->SeekAbsolute(0))
+    {
+      g_host_interface->ReportError("Failed to decompress save state data.");
+      return false;
+    }
+
+    state = decompressed_state.get();
+  }
+
   StateWrapper sw(state, StateWrapper::Mode::Read, header.version);
   if (!DoState(sw, nullptr, update_display, false))
     return false;
@@ -1369,31 +1449,25 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
   return true;
 }
 
-bool SaveState(ByteStream* state, u32 screenshot_size /* = 256 */)
+bool SaveState(ByteStream* state, u32 screenshot_size /* = 256 */,
+               SaveStateCompression compression /* = SaveStateCompression::None */)
+{
+  SaveStateBuffer buffer;
+  return SaveStateToBuffer(&buffer, screenshot_size) && WriteSaveStateBuffer(state, buffer, compression);
+}
+
+bool SaveStateToBuffer(SaveStateBuffer* buffer, u32 screenshot_size /* = 256 */)
 {
   if (IsShutdown())
     return false;
 
-  SAVE_STATE_HEADER header = {};
-
-  const u64 header_position = state->GetPosition();
-  if (!state->Write2(&header, sizeof(header)))
-    return false;
-
-  // fill in header
-  header.magic = SAVE_STATE_MAGIC;
-  header.version = SAVE_STATE_VERSION;
-  StringUtil::Strlcpy(header.title, s_running_game_title.c_str(), sizeof(header.title));
-  StringUtil::Strlcpy(header.game_code, s_running_game_code.c_str(), sizeof(header.game_code));
+  buffer->title = s_running_game_title;
+  buffer->game_code = s_running_game_code;
 
   if (g_cdrom.HasMedia())
   {
-    const std::string& media_filename = g_cdrom.GetMediaFileName();
-    header.offset_to_media_filename = static_cast<u32>(state->GetPosition());
-    header.media_filename_length = static_cast<u32>(media_filename.length());
-    header.media_subimage_index = g_cdrom.GetMedia()->HasSubImages() ? g_cdrom.GetMedia()->GetCurrentSubImage() : 0;
-    if (!media_filename.empty() && !state->Write2(media_filename.data(), header.media_filename_length))
-      return false;
+    buffer->media_filename = g_cdrom.GetMediaFileName();
+    buffer->media_subimage_index = g_cdrom.GetMedia()->HasSubImages() ? g_cdrom.GetMedia()->GetCurrentSubImage() : 0;
   }
 
   // save screenshot
@@ -1426,12 +1500,9 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 256 */)
         if (display->UsesLowerLeftOrigin())
           display->FlipTextureDataRGBA8(screenshot_width, screenshot_height, screenshot_buffer, screenshot_stride);
 
-        header.offset_to_screenshot = static_cast<u32>(state->GetPosition());
-        header.screenshot_width = screenshot_width;
-        header.screenshot_height = screenshot_height;
-        header.screenshot_size = static_cast<u32>(screenshot_buffer.size() * sizeof(u32));
-        if (!state->Write2(screenshot_buffer.data(), header.screenshot_size))
-          return false;
+        buffer->screenshot_width = screenshot_width;
+        buffer->screenshot_height = screenshot_height;
+        buffer->screenshot_data = std::move(screenshot_buffer);
       }
     }
     else
@@ -1443,20 +1514,92 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 256 */)
 
   // write data
   {
-    header.offset_to_data = static_cast<u32>(state->GetPosition());
+    if (!buffer->state_data)
+    {
+      buffer->state_data = ByteStream_CreateGrowableMemoryStream(nullptr, MAX_SAVE_STATE_SIZE);
+    }
+    else
+    {
+      buffer->state_data->SeekAbsolute(0);
+      buffer->state_data->Resize(0);
+    }
 
     g_gpu->RestoreGraphicsAPIState();
 
-    StateWrapper sw(state, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    StateWrapper sw(buffer->state_data.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
     const bool result = DoState(sw, nullptr, false, false);
 
     g_gpu->ResetGraphicsAPIState();
 
     if (!result)
       return false;
+  }
+
+  return true;
+}
+
+bool WriteSaveStateBuffer(ByteStream* state, const SaveStateBuffer& buffer, SaveStateCompression compression)
+{
+  SAVE_STATE_HEADER header = {};
+
+  const u64 header_position = state->GetPosition();
+  if (!state->Write2(&header, sizeof(header)))
+    return false;
+
+  // fill in header
+  header.magic = SAVE_STATE_MAGIC;
+  header.version = SAVE_STATE_VERSION;
+  StringUtil::Strlcpy(header.title, buffer.title.c_str(), sizeof(header.title));
+  StringUtil::Strlcpy(header.game_code, buffer.game_code.c_str(), sizeof(header.game_code));
+
+  if (!buffer.media_filename.empty())
+  {
+    header.offset_to_media_filename = static_cast<u32>(state->GetPosition());
+    header.media_filename_length = static_cast<u32>(buffer.media_filename.length());
+    header.media_subimage_index = buffer.media_subimage_index;
+    if (!state->Write2(buffer.media_filename.data(), header.media_filename_length))
+      return false;
+  }
 
-    header.data_compression_type = 0;
-    header.data_uncompressed_size = static_cast<u32>(state->GetPosition() - header.offset_to_data);
+  if (!buffer.screenshot_data.empty())
+  {
+    header.offset_to_screenshot = static_cast<u32>(state->GetPosition());
+    header.screenshot_width = buffer.screenshot_width;
+    header.screenshot_height = buffer.screenshot_height;
+    header.screenshot_size = static_cast<u32>(buffer.screenshot_data.size() * sizeof(u32));
+    if (!state->Write2(buffer.screenshot_data.data(), header.screenshot_size))
+      return false;
+  }
+
+  // write data
+  {
+    header.offset_to_data = static_cast<u32>(state->GetPosition());
+    header.data_uncompressed_size = static_cast<u32>(buffer.state_data->GetSize());
+
+    if (compression == SaveStateCompression::None)
+    {
+      header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
+      header.data_compressed_size = header.data_uncompressed_size;
+      if (!state->Write2(buffer.state_data->GetMemoryPointer(), header.data_uncompressed_size))
+        return false;
+    }
+    else
+    {
+      // read through a separate stream, so the buffer itself is left untouched
+      std::unique_ptr<ReadOnlyMemoryByteStream> data_stream =
+        ByteStream_CreateReadOnlyMemoryStream(buffer.state_data->GetMemoryPointer(), header.data_uncompressed_size);
+      const bool lzma = (compression == SaveStateCompression::LZMA);
+      header.data_compression_type =
+        lzma ? SAVE_STATE_HEADER::COMPRESSION_TYPE_LZMA : SAVE_STATE_HEADER::COMPRESSION_TYPE_DEFLATE;
+      header.data_compressed_size = ByteStream_CompressBytes(
+        data_stream.get(), header.data_uncompressed_size, state,
+        lzma ? BYTESTREAM_COMPRESSION_METHOD_LZMA : BYTESTREAM_COMPRESSION_METHOD_DEFLATE, lzma ? 5 : 6);
+      if (header.data_compressed_size == 0)
+        return false;
+
+      Log_DevPrintf("Compressed save state data from %u to %u bytes", header.data_uncompressed_size,
+                    header.data_compressed_size);
+    }
   }
 
   // re-write header
@@ -2292,16 +2435,22 @@ void SetCheatList(std::unique_ptr<CheatList> cheats)
   s_cheat_list = std::move(cheats);
 }
 
-void CalculateRewindMemoryUsage(u32 num_saves, u64* ram_usage, u64* vram_usage)
+void GetRewindMemoryUsage(u32* num_saves, u64* ram_usage, u64* vram_usage)
 {
-  *ram_usage = MAX_SAVE_STATE_SIZE * static_cast<u64>(num_saves);
-  *vram_usage = (VRAM_WIDTH * VRAM_HEIGHT * 4) * static_cast<u64>(std::max(g_settings.gpu_resolution_scale, 1u)) *
-                static_cast<u64>(g_settings.gpu_multisamples) * static_cast<u64>(num_saves);
+  *num_saves = s_rewind_state_count.load();
+  *ram_usage = s_rewind_ram_usage.load();
+  *vram_usage = s_rewind_vram_usage.load();
 }
 
 void ClearMemorySaveStates()
 {
   s_rewind_states.clear();
+  s_rewind_scratch_stream.reset();
+  s_rewind_keyframe.reset();
+  s_rewind_keyframe_data = {};
+  s_rewind_state_count.store(0);
+  s_rewind_ram_usage.store(0);
+  s_rewind_vram_usage.store(0);
   s_runahead_states.clear();
 }
 
@@ -2316,11 +2465,8 @@ void UpdateMemorySaveStateSettings()
     s_rewind_save_frequency = static_cast<s32>(std::ceil(g_settings.rewind_save_frequency * s_throttle_frequency));
     s_rewind_save_counter = 0;
 
-    u64 ram_usage, vram_usage;
-    CalculateRewindMemoryUsage(g_settings.rewind_save_slots, &ram_usage, &vram_usage);
-    Log_InfoPrintf(
-      "Rewind is enabled, saving every %d frames, with %u slots and %" PRIu64 "MB RAM and %" PRIu64 "MB VRAM usage",
-      std::max(s_rewind_save_frequency, 1), g_settings.rewind_save_slots, ram_usage / 1048576, vram_usage / 1048576);
+    Log_InfoPrintf("Rewind is enabled, saving every %d frames, keeping up to %uMB of compressed saves",
+                   std::max(s_rewind_save_frequency, 1), g_settings.rewind_memory_limit);
   }
   else
   {
@@ -2353,11 +2499,17 @@ void UpdateMemorySaveStateSettings()
 
 bool LoadMemoryState(const MemorySaveState& mss)
 {
-  mss.state_stream->SeekAbsolute(0);
+  return LoadMemoryState(mss.state_stream.get(), mss.vram_texture.get());
+}
+
+bool LoadMemoryState(ByteStream* stream, HostDisplayTexture* vram_texture)
+{
+  stream->SeekAbsolute(0);
 
-  StateWrapper sw(mss.state_stream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
-  HostDisplayTexture* host_texture = mss.vram_texture.get();
-  if (!DoState(sw, &host_texture, true, true))
+  // without a texture, VRAM is read from the state
+  StateWrapper sw(stream, StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  HostDisplayTexture* host_texture = vram_texture;
+  if (!DoState(sw, vram_texture ? &host_texture : nullptr, true, true))
   {
     g_host_interface->ReportError("Failed to load memory save state, resetting.");
     Reset();
@@ -2375,8 +2527,7 @@ bool SaveMemoryState(MemorySaveState* mss)
     mss->state_stream->SeekAbsolute(0);
 
   HostDisplayTexture* host_texture = mss->vram_texture.release();
-  StateWrapper sw(mss->state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
-  if (!DoState(sw, &host_texture, false, true))
+  if (!SaveMemoryState(mss->state_stream.get(), &host_texture))
   {
     Log_ErrorPrint("Failed to create rewind state.");
     delete host_texture;
@@ -2387,39 +2538,196 @@ bool SaveMemoryState(MemorySaveState* mss)
   return true;
 }
 
+bool SaveMemoryState(GrowableMemoryByteStream* stream, HostDisplayTexture** host_texture)
+{
+  stream->SeekAbsolute(0);
+
+  // without a texture, VRAM is written to the state
+  StateWrapper sw(stream, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  return DoState(sw, host_texture, false, true);
+}
+
+RewindKeyframe::RewindKeyframe(std::vector<u8> data_, u32 size_) : data(std::move(data_)), size(size_)
+{
+  s_rewind_ram_usage += data.size();
+}
+
+RewindKeyframe::~RewindKeyframe()
+{
+  s_rewind_ram_usage -= data.size();
+}
+
+static u64 GetRewindTextureSize(const HostDisplayTexture* texture)
+{
+  if (!texture)
+    return 0;
+
+  return static_cast<u64>(texture->GetWidth()) * static_cast<u64>(texture->GetHeight()) *
+         static_cast<u64>(texture->GetSamples()) *
+         static_cast<u64>(HostDisplay::GetDisplayPixelFormatSize(texture->GetFormat()));
+}
+
+void PushRewindState(RewindState rs)
+{
+  s_rewind_ram_usage += rs.delta.size() + rs.texture_state.size();
+  s_rewind_vram_usage += GetRewindTextureSize(rs.vram_texture.get());
+  s_rewind_states.push_back(std::move(rs));
+  s_rewind_state_count.store(static_cast<u32>(s_rewind_states.size()));
+}
+
+void PopRewindState(bool oldest)
+{
+  // the keyframe's size is removed by its destructor, once the last state using it is gone
+  const RewindState& rs = oldest ? s_rewind_states.front() : s_rewind_states.back();
+  s_rewind_ram_usage -= rs.delta.size() + rs.texture_state.size();
+  s_rewind_vram_usage -= GetRewindTextureSize(rs.vram_texture.get());
+  if (oldest)
+    s_rewind_states.pop_front();
+  else
+    s_rewind_states.pop_back();
+
+  s_rewind_state_count.store(static_cast<u32>(s_rewind_states.size()));
+}
+
 bool SaveRewindState()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Common::Timer save_timer;
 #endif
 
-  // try to reuse the frontmost slot
-  const u32 save_slots = g_settings.rewind_save_slots;
-  MemorySaveState mss;
-  while (s_rewind_states.size() >= save_slots)
+  if (!s_rewind_scratch_stream)
+    s_rewind_scratch_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+
+  if (!SaveMemoryState(s_rewind_scratch_stream.get(), nullptr))
   {
-    mss = std::move(s_rewind_states.front());
-    s_rewind_states.pop_front();
+    Log_ErrorPrint("Failed to create rewind state.");
+    return false;
   }
 
-  if (!SaveMemoryState(&mss))
-    return false;
+  const u8* state_data = s_rewind_scratch_stream->GetMemoryPointer();
+  const u32 state_size = static_cast<u32>(s_rewind_scratch_stream->GetPosition());
+
+  RewindState rs;
+  if (!s_rewind_keyframe || s_rewind_saves_since_keyframe >= REWIND_KEYFRAME_INTERVAL ||
+      s_rewind_keyframe->size != state_size)
+  {
+    std::vector<u8> keyframe;
+    if (!s_rewind_compressor.Compress(nullptr, state_data, state_size, &keyframe))
+      return false;
+
+    s_rewind_keyframe = std::make_shared<const RewindKeyframe>(std::move(keyframe), state_size);
+    s_rewind_keyframe_data.assign(state_data, state_data + state_size);
+    s_rewind_saves_since_keyframe = 0;
+
+    if (g_gpu->IsHardwareRenderer() && !SaveRewindKeyframeTexture(&rs))
+      return false;
+  }
+  else
+  {
+    if (!s_rewind_compressor.Compress(s_rewind_keyframe_data.data(), state_data, state_size, &rs.delta))
+      return false;
+
+    // Start a new keyframe early if the state has diverged far enough that deltas aren't saving much.
+    s_rewind_saves_since_keyframe++;
+    if (rs.delta.size() > (s_rewind_keyframe->data.size() / 2))
+      s_rewind_saves_since_keyframe = REWIND_KEYFRAME_INTERVAL;
+  }
 
-  s_rewind_states.push_back(std::move(mss));
+  rs.keyframe = s_rewind_keyframe;
+  PushRewindState(std::move(rs));
+
+  // Drop the oldest states until the rest fit in the memory limit, but always keep the one we just saved.
+  const u64 memory_limit = static_cast<u64>(g_settings.rewind_memory_limit) * 1048576;
+  while (s_rewind_states.size() > 1 && (s_rewind_ram_usage.load() + s_rewind_vram_usage.load()) > memory_limit)
+    PopRewindState(true);
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
-  Log_DevPrintf("Saved rewind state (%" PRIu64 " bytes, took %.4f ms)", s_rewind_states.back().state_stream->GetSize(),
-                save_timer.GetTimeMilliseconds());
+  Log_DevPrintf("Saved rewind state (%u bytes, %zu compressed, took %.4f ms), holding %zu states in %" PRIu64
+                "KB RAM and %" PRIu64 "KB VRAM",
+                state_size,
+                s_rewind_states.back().delta.empty() ? s_rewind_states.back().keyframe->data.size() :
+                                                       s_rewind_states.back().delta.size(),
+                save_timer.GetTimeMilliseconds(), s_rewind_states.size(), s_rewind_ram_usage.load() / 1024,
+                s_rewind_vram_usage.load() / 1024);
 #endif
 
   return true;
 }
 
+bool SaveRewindKeyframeTexture(RewindState* rs)
+{
+  // Keep the upscaled VRAM texture, and a second state without VRAM which is loaded along with it.
+  HostDisplayTexture* host_texture = nullptr;
+  if (!SaveMemoryState(s_rewind_scratch_stream.get(), &host_texture))
+  {
+    Log_ErrorPrint("Failed to create rewind state.");
+    delete host_texture;
+    return false;
+  }
+
+  rs->vram_texture.reset(host_texture);
+  rs->texture_state_size = static_cast<u32>(s_rewind_scratch_stream->GetPosition());
+  return s_rewind_compressor.Compress(nullptr, s_rewind_scratch_stream->GetMemoryPointer(), rs->texture_state_size,
+                                      &rs->texture_state);
+}
+
+bool DecompressRewindState(const RewindState& rs)
+{
+  // Deltas are usually relative to the same keyframe as the previous save or load, so keep it around uncompressed.
+  if (s_rewind_keyframe != rs.keyframe || s_rewind_keyframe_data.size() != rs.keyframe->size)
+  {
+    s_rewind_keyframe.reset();
+    s_rewind_keyframe_data.resize(rs.keyframe->size);
+    if (!s_rewind_compressor.Decompress(nullptr, rs.keyframe->data.data(), rs.keyframe->data.size(),
+                                        s_rewind_keyframe_data.data(), rs.keyframe->size))
+    {
+      Log_ErrorPrint("Failed to decompress rewind keyframe.");
+      return false;
+    }
+
+    s_rewind_keyframe = rs.keyframe;
+  }
+
+  if (!s_rewind_scratch_stream)
+    s_rewind_scratch_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+
+  GrowableMemoryByteStream* stream = s_rewind_scratch_stream.get();
+  if (rs.vram_texture)
+  {
+    stream->Resize(rs.texture_state_size);
+    if (!s_rewind_compressor.Decompress(nullptr, rs.texture_state.data(), rs.texture_state.size(),
+                                        stream->GetMemoryPointer(), rs.texture_state_size))
+    {
+      Log_ErrorPrint("Failed to decompress rewind state.");
+      return false;
+    }
+  }
+  else if (rs.delta.empty())
+  {
+    stream->Resize(rs.keyframe->size);
+    std::memcpy(stream->GetMemoryPointer(), s_rewind_keyframe_data.data(), rs.keyframe->size);
+  }
+  else
+  {
+    stream->Resize(rs.keyframe->size);
+    if (!s_rewind_compressor.Decompress(s_rewind_keyframe_data.data(), rs.delta.data(), rs.delta.size(),
+                                        stream->GetMemoryPointer(), rs.keyframe->size))
+    {
+      Log_ErrorPrint("Failed to decompress rewind state.");
+      return false;
+    }
+  }
+
+  // New deltas will be relative to this keyframe, which is still referenced by the remaining states.
+  s_rewind_saves_since_keyframe = 0;
+  return true;
+}
+
 bool LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true */)
 {
   while (skip_saves > 0 && !s_rewind_states.empty())
   {
-    s_rewind_states.pop_back();
+    PopRewindState(false);
     skip_saves--;
   }
 
@@ -2430,11 +2738,12 @@ bool LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true */)
   Common::Timer load_timer;
 #endif
 
-  if (!LoadMemoryState(s_rewind_states.back()))
+  const RewindState& rs = s_rewind_states.back();
+  if (!DecompressRewindState(rs) || !LoadMemoryState(s_rewind_scratch_stream.get(), rs.vram_texture.get()))
     return false;
 
   if (consume_state)
-    s_rewind_states.pop_back();
+    PopRewindState(false);
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Log_DevPrintf("Rewind load took %.4f ms", load_timer.GetTimeMilliseconds());
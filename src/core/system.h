@@ -7,8 +7,10 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class ByteStream;
+class GrowableMemoryByteStream;
 class CDImage;
 class StateWrapper;
 
@@ -148,8 +150,32 @@ bool Boot(const SystemBootParameters& params);
 void Reset();
 void Shutdown();
 
+/// Save state which has been captured in memory but not yet written out.
+struct SaveStateBuffer
+{
+  SaveStateBuffer();
+  ~SaveStateBuffer();
+
+  std::string title;
+  std::string game_code;
+  std::string media_filename;
+  u32 media_subimage_index = 0;
+  u32 screenshot_width = 0;
+  u32 screenshot_height = 0;
+  std::vector<u32> screenshot_data;
+  std::unique_ptr<GrowableMemoryByteStream> state_data;
+};
+
 bool LoadState(ByteStream* state, bool update_display = true);
-bool SaveState(ByteStream* state, u32 screenshot_size = 256);
+bool SaveState(ByteStream* state, u32 screenshot_size = 256,
+               SaveStateCompression compression = SaveStateCompression::None);
+
+/// Captures the system state and a screenshot into memory. The buffer can then be written with WriteSaveStateBuffer().
+bool SaveStateToBuffer(SaveStateBuffer* buffer, u32 screenshot_size = 256);
+
+/// Writes a captured state to a stream, compressing the state data if requested. This does not access the running
+/// system, so it can be called from any thread, and with the system paused or shut down.
+bool WriteSaveStateBuffer(ByteStream* state, const SaveStateBuffer& buffer, SaveStateCompression compression);
 
 /// Recreates the GPU component, saving/loading the state so it is preserved. Call when the GPU renderer changes.
 bool RecreateGPU(GPURenderer renderer, bool update_display = true);
@@ -233,7 +259,9 @@ void SetCheatList(std::unique_ptr<CheatList> cheats);
 //////////////////////////////////////////////////////////////////////////
 // Memory Save States (Rewind and Runahead)
 //////////////////////////////////////////////////////////////////////////
-void CalculateRewindMemoryUsage(u32 num_saves, u64* ram_usage, u64* vram_usage);
+/// Returns how many rewind states are held, and how much memory they use after compression. Safe to call from any
+/// thread.
+void GetRewindMemoryUsage(u32* num_saves, u64* ram_usage, u64* vram_usage);
 void ClearMemorySaveStates();
 void UpdateMemorySaveStateSettings();
 bool LoadRewindState(u32 skip_saves = 0, bool consume_state = true);
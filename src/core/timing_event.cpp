@@ -5,19 +5,36 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
+#include <algorithm>
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
-static TimingEvent* s_active_events_head;
-static TimingEvent* s_active_events_tail;
+// Active events are kept in a binary min-heap ordered by due time, with absolute times against the global tick counter.
+// Advancing time doesn't touch the events, and rescheduling one is O(log n). Events due at the same time run in the
+// order they were created, so the order doesn't depend on the history of the heap.
+static std::vector<TimingEvent*> s_active_events;
 static TimingEvent* s_current_event = nullptr;
-static u32 s_active_event_count = 0;
-static u32 s_global_tick_counter = 0;
+static s64 s_global_tick_counter = 0;
+static TickCount s_next_event_downcount = 0;
+static u32 s_next_event_order = 0;
+static u64 s_executed_event_count = 0;
 
 u32 GetGlobalTickCounter()
 {
-  return s_global_tick_counter;
+  return static_cast<u32>(s_global_tick_counter);
+}
+
+static void RebaseEvents(s64 new_global_tick_counter)
+{
+  const s64 delta = new_global_tick_counter - s_global_tick_counter;
+  for (TimingEvent* event : s_active_events)
+  {
+    event->m_next_run_time += delta;
+    event->m_last_run_time += delta;
+  }
+
+  s_global_tick_counter = new_global_tick_counter;
 }
 
 void Initialize()
@@ -27,12 +44,13 @@ void Initialize()
 
 void Reset()
 {
-  s_global_tick_counter = 0;
+  // active events keep their downcounts
+  RebaseEvents(0);
 }
 
 void Shutdown()
 {
-  Assert(s_active_event_count == 0);
+  Assert(s_active_events.empty());
 }
 
 std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
@@ -50,205 +68,135 @@ void UpdateCPUDowncount()
 {
   if (!CPU::g_state.frame_done && (!CPU::HasPendingInterrupt() || CPU::g_using_interpreter))
   {
-    CPU::g_state.downcount = s_active_events_head->GetDowncount();
+    CPU::g_state.downcount = s_next_event_downcount;
   }
 }
 
-TimingEvent** GetHeadEventPtr()
+const TickCount* GetNextEventDowncountPtr()
 {
-  return &s_active_events_head;
+  return &s_next_event_downcount;
 }
 
-static void SortEvent(TimingEvent* event)
+u64 GetExecutedEventCount()
 {
-  const TickCount event_downcount = event->m_downcount;
+  return s_executed_event_count;
+}
 
-  if (event->prev && event->prev->m_downcount > event_downcount)
-  {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_downcount > event_downcount)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_active_events_tail = event;
-
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_active_events_head);
-      s_active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_active_events_head;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (event->next && event_downcount > event->next->m_downcount)
-  {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_downcount > current->m_downcount)
-      current = current->next;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+static void UpdateNextEventDowncount()
+{
+  if (s_active_events.empty())
+    return;
 
-      if (current->prev)
-        current->prev->next = event;
-      else
-        s_active_events_head = event;
+  s_next_event_downcount = static_cast<TickCount>(s_active_events[0]->m_next_run_time - s_global_tick_counter);
+  UpdateCPUDowncount();
+}
 
-      current->prev = event;
-    }
-    else
-    {
-      // insert at back
-      DebugAssert(s_active_events_tail);
-      s_active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_active_events_tail;
-      s_active_events_tail = event;
-    }
-  }
+ALWAYS_INLINE static bool IsEarlierEvent(const TimingEvent* lhs, const TimingEvent* rhs)
+{
+  return (lhs->m_next_run_time < rhs->m_next_run_time ||
+          (lhs->m_next_run_time == rhs->m_next_run_time && lhs->m_order < rhs->m_order));
 }
 
-static void AddActiveEvent(TimingEvent* event)
+ALWAYS_INLINE static void SetHeapEvent(u32 index, TimingEvent* event)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_active_event_count++;
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
 
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_active_events_head;
-  while (next && event->m_downcount > next->m_downcount)
+static void SiftUp(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  while (index > 0)
   {
-    current = next;
-    next = next->next;
-  }
+    const u32 parent = (index - 1) / 2;
+    if (!IsEarlierEvent(event, s_active_events[parent]))
+      break;
 
-  if (!next)
-  {
-    // new tail
-    event->prev = s_active_events_tail;
-    if (s_active_events_tail)
-    {
-      s_active_events_tail->next = event;
-      s_active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_active_events_tail = event;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
-  {
-    // new head
-    event->next = s_active_events_head;
-    s_active_events_head->prev = event;
-    s_active_events_head = event;
-    UpdateCPUDowncount();
-  }
-  else
-  {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
+    SetHeapEvent(index, s_active_events[parent]);
+    index = parent;
   }
+
+  SetHeapEvent(index, event);
 }
 
-static void RemoveActiveEvent(TimingEvent* event)
+static void SiftDown(u32 index)
 {
-  DebugAssert(s_active_event_count > 0);
-
-  if (event->next)
-  {
-    event->next->prev = event->prev;
-  }
-  else
+  const u32 count = static_cast<u32>(s_active_events.size());
+  TimingEvent* event = s_active_events[index];
+  for (;;)
   {
-    s_active_events_tail = event->prev;
+    const u32 left = index * 2 + 1;
+    if (left >= count)
+      break;
+
+    const u32 right = left + 1;
+    const u32 child =
+      (right < count && IsEarlierEvent(s_active_events[right], s_active_events[left])) ? right : left;
+    if (!IsEarlierEvent(s_active_events[child], event))
+      break;
+
+    SetHeapEvent(index, s_active_events[child]);
+    index = child;
   }
 
-  if (event->prev)
-  {
-    event->prev->next = event->next;
-  }
+  SetHeapEvent(index, event);
+}
+
+static void SortEvent(TimingEvent* event)
+{
+  const u32 old_index = event->m_heap_index;
+  if (old_index > 0 && IsEarlierEvent(event, s_active_events[(old_index - 1) / 2]))
+    SiftUp(old_index);
   else
-  {
-    s_active_events_head = event->next;
-    if (s_active_events_head)
-      UpdateCPUDowncount();
-  }
+    SiftDown(old_index);
+
+  if (old_index == 0 || event->m_heap_index == 0)
+    UpdateNextEventDowncount();
+}
 
-  event->prev = nullptr;
-  event->next = nullptr;
+static void AddActiveEvent(TimingEvent* event)
+{
+  const u32 index = static_cast<u32>(s_active_events.size());
+  s_active_events.push_back(event);
+  event->m_heap_index = index;
+  SiftUp(index);
 
-  s_active_event_count--;
+  if (event->m_heap_index == 0)
+    UpdateNextEventDowncount();
 }
 
-static void SortEvents()
+static void RemoveActiveEvent(TimingEvent* event)
 {
-  std::vector<TimingEvent*> events;
-  events.reserve(s_active_event_count);
+  DebugAssert(!s_active_events.empty() && s_active_events[event->m_heap_index] == event);
 
-  TimingEvent* next = s_active_events_head;
-  while (next)
+  const u32 index = event->m_heap_index;
+  TimingEvent* last = s_active_events.back();
+  s_active_events.pop_back();
+  event->m_heap_index = 0;
+  if (last == event)
   {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
+    if (index == 0)
+      UpdateNextEventDowncount();
+
+    return;
   }
 
-  s_active_events_head = nullptr;
-  s_active_events_tail = nullptr;
-  s_active_event_count = 0;
+  // move the last event into the hole, it can go either way from there
+  SetHeapEvent(index, last);
+  SortEvent(last);
+}
+
+static void SortEvents()
+{
+  for (u32 i = static_cast<u32>(s_active_events.size()) / 2; i > 0; i--)
+    SiftDown(i - 1);
 
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+  UpdateNextEventDowncount();
 }
 
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  for (TimingEvent* event = s_active_events_head; event; event = event->next)
+  for (TimingEvent* event : s_active_events)
   {
     if (event->GetName().compare(name) == 0)
       return event;
@@ -265,48 +213,46 @@ void RunEvents()
   CPU::ResetPendingTicks();
   while (pending_ticks > 0)
   {
-    const TickCount time = std::min(pending_ticks, s_active_events_head->GetDowncount());
-    s_global_tick_counter += static_cast<u32>(time);
+    const TickCount time = std::min(pending_ticks, s_active_events[0]->GetDowncount());
+    s_global_tick_counter += time;
     pending_ticks -= time;
 
-    // Apply downcount to all events.
-    // This will result in a negative downcount for those events which are late.
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    // Now we can actually run the callbacks. Late events have a due time in the past.
+    while (s_active_events[0]->m_next_run_time <= s_global_tick_counter)
     {
-      event->m_downcount -= time;
-      event->m_time_since_last_run += time;
-    }
-
-    // Now we can actually run the callbacks.
-    while (s_active_events_head->m_downcount <= 0)
-    {
-      // move it to the end, since that'll likely be its new position
-      TimingEvent* event = s_active_events_head;
+      TimingEvent* event = s_active_events[0];
       s_current_event = event;
 
       // Factor late time into the time for the next invocation.
-      const TickCount ticks_late = -event->m_downcount;
-      const TickCount ticks_to_execute = event->m_time_since_last_run;
-      event->m_downcount += event->m_interval;
-      event->m_time_since_last_run = 0;
+      const TickCount ticks_late = static_cast<TickCount>(s_global_tick_counter - event->m_next_run_time);
+      const TickCount ticks_to_execute = static_cast<TickCount>(s_global_tick_counter - event->m_last_run_time);
+      event->m_next_run_time += event->m_interval;
+      event->m_last_run_time = s_global_tick_counter;
+
+      // Re-sort before running the callback, so it sees a valid heap if it reschedules events.
+      SiftDown(0);
+      s_executed_event_count++;
 
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
       event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
-      if (event->m_active)
-        SortEvent(event);
     }
   }
 
   s_current_event = nullptr;
-  UpdateCPUDowncount();
+  UpdateNextEventDowncount();
 }
 
 bool DoState(StateWrapper& sw)
 {
-  sw.Do(&s_global_tick_counter);
+  // Only the low 32 bits of the counter are stored, events are saved relative to it.
+  u32 global_tick_counter = static_cast<u32>(s_global_tick_counter);
+  sw.Do(&global_tick_counter);
 
   if (sw.IsReading())
   {
+    // Events which aren't in the state keep their current downcount.
+    RebaseEvents(static_cast<s64>(global_tick_counter));
+
     // Load timestamps for the clock events.
     // Any oneshot events should be recreated by the load state method, so we can fix up their times here.
     u32 event_count = 0;
@@ -331,9 +277,9 @@ bool DoState(StateWrapper& sw)
         continue;
       }
 
-      // Using reschedule is safe here since we call sort afterwards.
-      event->m_downcount = downcount;
-      event->m_time_since_last_run = time_since_last_run;
+      // Modifying the times directly is safe here since we re-sort afterwards.
+      event->m_next_run_time = s_global_tick_counter + downcount;
+      event->m_last_run_time = s_global_tick_counter - time_since_last_run;
       event->m_period = period;
       event->m_interval = interval;
     }
@@ -349,19 +295,25 @@ bool DoState(StateWrapper& sw)
   }
   else
   {
+    // Written in due order, which is what the old linked list did.
+    std::vector<TimingEvent*> events(s_active_events);
+    std::sort(events.begin(), events.end(), IsEarlierEvent);
 
-    sw.Do(&s_active_event_count);
+    u32 event_count = static_cast<u32>(events.size());
+    sw.Do(&event_count);
 
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (TimingEvent* event : events)
     {
+      TickCount downcount = event->GetDowncount();
+      TickCount time_since_last_run = static_cast<TickCount>(s_global_tick_counter - event->m_last_run_time);
       sw.Do(&event->m_name);
-      sw.Do(&event->m_downcount);
-      sw.Do(&event->m_time_since_last_run);
+      sw.Do(&downcount);
+      sw.Do(&time_since_last_run);
       sw.Do(&event->m_period);
       sw.Do(&event->m_interval);
     }
 
-    Log_DevPrintf("Wrote %u events to save state.", s_active_event_count);
+    Log_DevPrintf("Wrote %u events to save state.", event_count);
   }
 
   return !sw.HasError();
@@ -371,8 +323,8 @@ bool DoState(StateWrapper& sw)
 
 TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback,
                          void* callback_param)
-  : m_callback(callback), m_callback_param(callback_param), m_downcount(interval), m_time_since_last_run(0),
-    m_period(period), m_interval(interval), m_name(std::move(name))
+  : m_callback(callback), m_callback_param(callback_param), m_next_run_time(interval), m_last_run_time(0),
+    m_period(period), m_interval(interval), m_order(TimingEvents::s_next_event_order++), m_name(std::move(name))
 {
 }
 
@@ -382,14 +334,21 @@ TimingEvent::~TimingEvent()
     TimingEvents::RemoveActiveEvent(this);
 }
 
+TickCount TimingEvent::GetDowncount() const
+{
+  return static_cast<TickCount>(m_active ? (m_next_run_time - TimingEvents::s_global_tick_counter) : m_next_run_time);
+}
+
 TickCount TimingEvent::GetTicksSinceLastExecution() const
 {
-  return CPU::GetPendingTicks() + m_time_since_last_run;
+  const s64 time_since_last_run =
+    m_active ? (TimingEvents::s_global_tick_counter - m_last_run_time) : -m_last_run_time;
+  return CPU::GetPendingTicks() + static_cast<TickCount>(time_since_last_run);
 }
 
 TickCount TimingEvent::GetTicksUntilNextExecution() const
 {
-  return std::max(m_downcount - CPU::GetPendingTicks(), static_cast<TickCount>(0));
+  return std::max(GetDowncount() - CPU::GetPendingTicks(), static_cast<TickCount>(0));
 }
 
 void TimingEvent::Delay(TickCount ticks)
@@ -400,7 +359,7 @@ void TimingEvent::Delay(TickCount ticks)
     return;
   }
 
-  m_downcount += ticks;
+  m_next_run_time += ticks;
 
   DebugAssert(TimingEvents::s_current_event != this);
   TimingEvents::SortEvent(this);
@@ -408,22 +367,21 @@ void TimingEvent::Delay(TickCount ticks)
 
 void TimingEvent::Schedule(TickCount ticks)
 {
-  const TickCount pending_ticks = CPU::GetPendingTicks();
-  m_downcount = pending_ticks + ticks;
+  const s64 current_time = TimingEvents::s_global_tick_counter + CPU::GetPendingTicks();
+  m_next_run_time = current_time + ticks;
 
   if (!m_active)
   {
     // Event is going active, so we want it to only execute ticks from the current timestamp.
-    m_time_since_last_run = -pending_ticks;
+    m_last_run_time = current_time;
     m_active = true;
     TimingEvents::AddActiveEvent(this);
   }
   else
   {
-    // Event is already active, so we leave the time since last run alone, and just modify the downcount.
+    // Event is already active, so we leave the time since last run alone, and just modify the due time.
     // If this is a call from an IO handler for example, re-sort the event queue.
-    if (TimingEvents::s_current_event != this)
-      TimingEvents::SortEvent(this);
+    TimingEvents::SortEvent(this);
   }
 }
 
@@ -445,10 +403,9 @@ void TimingEvent::Reset()
   if (!m_active)
     return;
 
-  m_downcount = m_interval;
-  m_time_since_last_run = 0;
-  if (TimingEvents::s_current_event != this)
-    TimingEvents::SortEvent(this);
+  m_next_run_time = TimingEvents::s_global_tick_counter + m_interval;
+  m_last_run_time = TimingEvents::s_global_tick_counter;
+  TimingEvents::SortEvent(this);
 }
 
 void TimingEvent::InvokeEarly(bool force /* = false */)
@@ -456,16 +413,16 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
   if (!m_active)
     return;
 
-  const TickCount pending_ticks = CPU::GetPendingTicks();
-  const TickCount ticks_to_execute = m_time_since_last_run + pending_ticks;
+  const s64 current_time = TimingEvents::s_global_tick_counter + CPU::GetPendingTicks();
+  const TickCount ticks_to_execute = static_cast<TickCount>(current_time - m_last_run_time);
   if ((!force && ticks_to_execute < m_period) || ticks_to_execute <= 0)
     return;
 
-  m_downcount = pending_ticks + m_interval;
-  m_time_since_last_run -= ticks_to_execute;
+  m_next_run_time = current_time + m_interval;
+  m_last_run_time = current_time;
   m_callback(m_callback_param, ticks_to_execute, 0);
 
-  // Since we've changed the downcount, we need to re-sort the events.
+  // Since we've changed the due time, we need to re-sort the events.
   DebugAssert(TimingEvents::s_current_event != this);
   TimingEvents::SortEvent(this);
 }
@@ -476,9 +433,9 @@ void TimingEvent::Activate()
     return;
 
   // leave the downcount intact
-  const TickCount pending_ticks = CPU::GetPendingTicks();
-  m_downcount += pending_ticks;
-  m_time_since_last_run -= pending_ticks;
+  const s64 current_time = TimingEvents::s_global_tick_counter + CPU::GetPendingTicks();
+  m_next_run_time += current_time;
+  m_last_run_time += current_time;
 
   m_active = true;
   TimingEvents::AddActiveEvent(this);
@@ -489,9 +446,9 @@ void TimingEvent::Deactivate()
   if (!m_active)
     return;
 
-  const TickCount pending_ticks = CPU::GetPendingTicks();
-  m_downcount -= pending_ticks;
-  m_time_since_last_run += pending_ticks;
+  const s64 current_time = TimingEvents::s_global_tick_counter + CPU::GetPendingTicks();
+  m_next_run_time -= current_time;
+  m_last_run_time -= current_time;
 
   m_active = false;
   TimingEvents::RemoveActiveEvent(this);
@@ -24,7 +24,9 @@ public:
   // Returns the number of ticks between each event.
   ALWAYS_INLINE TickCount GetPeriod() const { return m_period; }
   ALWAYS_INLINE TickCount GetInterval() const { return m_interval; }
-  ALWAYS_INLINE TickCount GetDowncount() const { return m_downcount; }
+
+  // Ticks until the event is due, relative to the global tick counter (i.e. excluding pending time).
+  TickCount GetDowncount() const;
 
   // Includes pending time.
   TickCount GetTicksSinceLastExecution() const;
@@ -33,6 +35,8 @@ public:
   // Adds ticks to current execution.
   void Delay(TickCount ticks);
 
+  // Events due on the same tick always run in the order they were created, regardless of the order they were
+  // scheduled or activated in.
   void Schedule(TickCount ticks);
   void SetIntervalAndSchedule(TickCount ticks);
   void SetPeriodAndSchedule(TickCount ticks);
@@ -60,16 +64,18 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
-
   TimingEventCallback m_callback;
   void* m_callback_param;
 
-  TickCount m_downcount;
-  TickCount m_time_since_last_run;
+  // While active, the global tick count the event is next due at and was last run at. While inactive, they're kept
+  // relative to zero instead, so the event resumes with the same downcount and pending time when reactivated.
+  s64 m_next_run_time;
+  s64 m_last_run_time;
+
   TickCount m_period;
   TickCount m_interval;
+  u32 m_heap_index = 0;
+  u32 m_order;
   bool m_active = false;
 
   std::string m_name;
@@ -94,6 +100,10 @@ void RunEvents();
 
 void UpdateCPUDowncount();
 
-TimingEvent** GetHeadEventPtr();
+/// Ticks until the next event is due, read directly by the recompiler's dispatcher.
+const TickCount* GetNextEventDowncountPtr();
+
+/// Total number of event callbacks run, for benchmarking.
+u64 GetExecutedEventCount();
 
 } // namespace TimingEvents
\ No newline at end of file
@@ -166,6 +166,14 @@ enum class CPUFastmemMode
   Count
 };
 
+enum class SaveStateCompression : u8
+{
+  None,
+  Deflate,
+  LZMA,
+  Count
+};
+
 enum : size_t
 {
   HOST_PAGE_SIZE = 4096,
@@ -208,6 +208,8 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
 
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("PGXP Vertex Cache"), "GPU", "PGXPVertexCache",
                         false);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("PGXP Shadow Memory Paging"), "GPU",
+                        "PGXPShadowPaging", false);
   addFloatRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("PGXP Geometry Tolerance"), "GPU",
                            "PGXPTolerance", -1.0f, 100.0f, 0.25f, -1.0f);
   addFloatRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("PGXP Depth Clear Threshold"), "GPU",
@@ -223,6 +225,10 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
                        static_cast<u32>(CPUFastmemMode::Count), Settings::DEFAULT_CPU_FASTMEM_MODE);
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable Recompiler ICache"), "CPU",
                         "RecompilerICache", false);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable Recompiler Tiered Compilation"), "CPU",
+                        "RecompilerTiered", false);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable Persistent Block Cache"), "CPU",
+                        "RecompilerBlockCache", false);
 
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable VRAM Write Texture Replacement"),
                         "TextureReplacements", "EnableVRAMWriteReplacements", false);
@@ -249,15 +255,29 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
                          1000, Settings::DEFAULT_GPU_MAX_RUN_AHEAD);
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Use Debug Host GPU Device"), "GPU",
                         "UseDebugDevice", false);
+  addIntRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Software Renderer Threads"), "GPU",
+                         "SoftwareRendererThreads", 1, 64, 1);
 
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Increase Timer Resolution"), "Main",
                         "IncreaseTimerResolution", true);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Generate SPU Audio On Separate Thread"), "Audio",
+                        "SPUThread", false);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Decode MDEC Macroblocks On Separate Thread"),
+                        "MDEC", "UseThread", false);
 
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Allow Booting Without SBI File"), "CDROM",
                         "AllowBootingWithoutSBIFile", false);
+  addIntRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Compressed Image Cache Size (MB)"), "CDROM",
+                         "ReadCacheSize", 0, static_cast<int>(Settings::MAX_CDROM_READ_CACHE_SIZE),
+                         static_cast<int>(Settings::DEFAULT_CDROM_READ_CACHE_SIZE));
 
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Create Save State Backups"), "General",
                         "CreateSaveStateBackups", false);
+  addChoiceTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Save State Compression"), "Main",
+                       "SaveStateCompression", Settings::ParseSaveStateCompressionName,
+                       Settings::GetSaveStateCompressionName, Settings::GetSaveStateCompressionDisplayName,
+                       "SaveStateCompression", static_cast<u32>(SaveStateCompression::Count),
+                       Settings::DEFAULT_SAVE_STATE_COMPRESSION);
 
   dialog->registerWidgetHelp(m_ui.logLevel, tr("Log Level"), tr("Information"),
                              tr("Sets the verbosity of messages logged. Higher levels will log more messages."));
@@ -286,6 +306,7 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);       // Display FPS limit
   setChoiceTweakOption(m_ui.tweakOptionTable, i++, 0);         // Multisample antialiasing
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);    // PGXP vertex cache
+  setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);    // PGXP shadow memory paging
   setFloatRangeTweakOption(m_ui.tweakOptionTable, i++, -1.0f); // PGXP geometry tolerance
   setFloatRangeTweakOption(m_ui.tweakOptionTable, i++,
                            Settings::DEFAULT_GPU_PGXP_DEPTH_THRESHOLD);                 // PGXP depth clear threshold
@@ -293,6 +314,8 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                              // Recompiler block linking
   setChoiceTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Recompiler Icache
+  setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Recompiler tiered compilation
+  setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Persistent block cache
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // VRAM write texture replacement
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Preload texture replacements
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Dump replacable VRAM writes
@@ -310,7 +333,14 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                          static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD)); // GPU max run-ahead
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Use debug host GPU device
+  setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 1);                         // Software renderer threads
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Increase timer resolution
+  setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // SPU thread
+  setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // MDEC thread
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Allow booting without SBI file
+  setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
+                         static_cast<int>(Settings::DEFAULT_CDROM_READ_CACHE_SIZE)); // Compressed image cache size
   setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Create save state backups
+  setChoiceTweakOption(m_ui.tweakOptionTable, i++,
+                       Settings::DEFAULT_SAVE_STATE_COMPRESSION); // Save state compression
 }
\ No newline at end of file
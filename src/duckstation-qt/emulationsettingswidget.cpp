@@ -3,6 +3,7 @@
 #include "qtutils.h"
 #include "settingsdialog.h"
 #include "settingwidgetbinder.h"
+#include <QtCore/QTimer>
 #include <QtWidgets/QMessageBox>
 #include <limits>
 
@@ -15,7 +16,8 @@ EmulationSettingsWidget::EmulationSettingsWidget(QtHostInterface* host_interface
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.rewindEnable, "Main", "RewindEnable", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(m_host_interface, m_ui.rewindSaveFrequency, "Main", "RewindFrequency",
                                                 10.0f);
-  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindSaveSlots, "Main", "RewindSaveSlots", 10);
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindMemoryLimit, "Main", "RewindMemoryLimit",
+                                              static_cast<int>(Settings::DEFAULT_REWIND_MEMORY_LIMIT));
   SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.runaheadFrames, "Main", "RunaheadFrameCount", 0);
 
   QtUtils::FillComboBoxWithEmulationSpeeds(m_ui.emulationSpeed);
@@ -43,7 +45,7 @@ EmulationSettingsWidget::EmulationSettingsWidget(QtHostInterface* host_interface
   connect(m_ui.rewindEnable, &QCheckBox::stateChanged, this, &EmulationSettingsWidget::updateRewind);
   connect(m_ui.rewindSaveFrequency, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
           &EmulationSettingsWidget::updateRewind);
-  connect(m_ui.rewindSaveSlots, QOverload<int>::of(&QSpinBox::valueChanged), this,
+  connect(m_ui.rewindMemoryLimit, QOverload<int>::of(&QSpinBox::valueChanged), this,
           &EmulationSettingsWidget::updateRewind);
   connect(m_ui.runaheadFrames, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           &EmulationSettingsWidget::updateRewind);
@@ -63,11 +65,17 @@ EmulationSettingsWidget::EmulationSettingsWidget(QtHostInterface* host_interface
     m_ui.rewindEnable, tr("Rewinding"), tr("Unchecked"),
     tr("<b>Enable Rewinding:</b> Saves state periodically so you can rewind any mistakes while playing.<br> "
 	   "<b>Rewind Save Frequency:</b> How often a rewind state will be created. Higher frequencies have greater system requirements.<br> "
-	   "<b>Rewind Buffer Size:</b> How many saves will be kept for rewinding. Higher values have greater memory requirements."));
+	   "<b>Rewind Memory Limit:</b> How much memory rewind saves can use. Saves are compressed, so games which change less between saves can be rewound further."));
   dialog->registerWidgetHelp(
     m_ui.runaheadFrames, tr("Runahead"), tr("Disabled"),
     tr("Simulates the system ahead of time and rolls back/replays to reduce input lag. Very high system requirements."));
 
+  // the summary shows how much the running game's saves use, which changes as they're made
+  m_rewind_summary_timer = new QTimer(this);
+  m_rewind_summary_timer->setInterval(1000);
+  connect(m_rewind_summary_timer, &QTimer::timeout, this, &EmulationSettingsWidget::updateRewindSummary);
+  m_rewind_summary_timer->start();
+
   updateRewind();
 }
 
@@ -101,37 +109,47 @@ void EmulationSettingsWidget::updateRewind()
 {
   m_ui.rewindEnable->setEnabled(!runaheadEnabled());
 
-  if (m_ui.rewindEnable->isEnabled() && m_ui.rewindEnable->isChecked())
-  {
-    const u32 frames = static_cast<u32>(m_ui.rewindSaveSlots->value());
-    const float frequency = static_cast<float>(m_ui.rewindSaveFrequency->value());
-    const float duration =
-      ((frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : frequency) * static_cast<float>(frames);
+  const bool enabled = (m_ui.rewindEnable->isEnabled() && m_ui.rewindEnable->isChecked());
+  m_ui.rewindSaveFrequency->setEnabled(enabled);
+  m_ui.rewindMemoryLimit->setEnabled(enabled);
+  updateRewindSummary();
+}
 
-    u64 ram_usage, vram_usage;
-    System::CalculateRewindMemoryUsage(frames, &ram_usage, &vram_usage);
+void EmulationSettingsWidget::updateRewindSummary()
+{
+  if (!m_ui.rewindEnable->isEnabled())
+  {
+    m_ui.rewindSummary->setText(tr(
+      "Rewind is disabled because runahead is enabled. Runahead will significantly increase system requirements."));
+    return;
+  }
 
+  if (!m_ui.rewindEnable->isChecked())
+  {
     m_ui.rewindSummary->setText(
-      tr("Rewind for %n frame(s), lasting %1 second(s) will require up to %2MB of RAM and %3MB of VRAM.", "", frames)
-        .arg(duration)
-        .arg(ram_usage / 1048576)
-        .arg(vram_usage / 1048576));
-    m_ui.rewindSaveFrequency->setEnabled(true);
-    m_ui.rewindSaveSlots->setEnabled(true);
+      tr("Rewind is not enabled. Please note that enabling rewind may significantly increase system requirements."));
+    return;
   }
-  else
+
+  const u32 memory_limit = static_cast<u32>(m_ui.rewindMemoryLimit->value());
+  u32 num_saves;
+  u64 ram_usage, vram_usage;
+  System::GetRewindMemoryUsage(&num_saves, &ram_usage, &vram_usage);
+  if (num_saves == 0)
   {
-    if (!m_ui.rewindEnable->isEnabled())
-    {
-      m_ui.rewindSummary->setText(tr(
-        "Rewind is disabled because runahead is enabled. Runahead will significantly increase system requirements."));
-    }
-    else
-    {
-      m_ui.rewindSummary->setText(
-        tr("Rewind is not enabled. Please note that enabling rewind may significantly increase system requirements."));
-    }
-    m_ui.rewindSaveFrequency->setEnabled(false);
-    m_ui.rewindSaveSlots->setEnabled(false);
+    m_ui.rewindSummary->setText(
+      tr("Rewind will keep as many compressed saves as fit in %1MB of RAM and VRAM.").arg(memory_limit));
+    return;
   }
+
+  const float frequency = static_cast<float>(m_ui.rewindSaveFrequency->value());
+  const float duration =
+    ((frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : frequency) * static_cast<float>(num_saves);
+  m_ui.rewindSummary->setText(
+    tr("Rewind is holding %n save(s), lasting %1 second(s), in %2MB of RAM and %3MB of VRAM out of %4MB.", "",
+       static_cast<int>(num_saves))
+      .arg(duration)
+      .arg(ram_usage / 1048576)
+      .arg(vram_usage / 1048576)
+      .arg(memory_limit));
 }
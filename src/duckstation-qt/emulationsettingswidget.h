@@ -4,6 +4,7 @@
 
 #include "ui_emulationsettingswidget.h"
 
+class QTimer;
 class QtHostInterface;
 class SettingsDialog;
 
@@ -20,6 +21,7 @@ private Q_SLOTS:
   void onFastForwardSpeedIndexChanged(int index);
   void onTurboSpeedIndexChanged(int index);
   void updateRewind();
+  void updateRewindSummary();
 
 private:
   bool runaheadEnabled() { return m_ui.runaheadFrames->currentIndex() > 0; }
@@ -27,4 +29,5 @@ private:
   Ui::EmulationSettingsWidget m_ui;
 
   QtHostInterface* m_host_interface;
+  QTimer* m_rewind_summary_timer = nullptr;
 };
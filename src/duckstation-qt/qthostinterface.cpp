@@ -1378,6 +1378,9 @@ void QtHostInterface::saveState(const QString& filename, bool block_until_done /
 
   if (!System::IsShutdown())
     SaveState(filename.toUtf8().data());
+
+  if (block_until_done)
+    WaitForSaveStateWrites(filename.toUtf8().data());
 }
 
 void QtHostInterface::saveState(bool global, qint32 slot, bool block_until_done /* = false */)
@@ -1391,6 +1394,9 @@ void QtHostInterface::saveState(bool global, qint32 slot, bool block_until_done
 
   if (!System::IsShutdown())
     SaveState(global, slot);
+
+  if (block_until_done)
+    WaitForSaveStateWrites();
 }
 
 void QtHostInterface::undoLoadState()
@@ -5,17 +5,35 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/timer.h"
+#include "core/bus.h"
+#include "core/gpu.h"
+#include "core/profiler.h"
+#include "core/spu.h"
 #include "core/system.h"
+#include "core/timing_event.h"
 #include "frontend-common/game_database.h"
 #include "frontend-common/game_settings.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
 #include "regtest_host_display.h"
 #include "scmversion/scmversion.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cmath>
 #include <cstdio>
+#include <vector>
 Log_SetChannel(RegTestHostInterface);
 
 #ifdef _WIN32
+#include "common/windows_headers.h"
 #include "frontend-common/d3d11_host_display.h"
 #include "frontend-common/d3d12_host_display.h"
+#include <psapi.h>
+#else
+#include <sys/resource.h>
 #endif
 
 #include "frontend-common/opengl_host_display.h"
@@ -23,13 +41,62 @@ Log_SetChannel(RegTestHostInterface);
 
 static int s_frames_to_run = 60 * 60;
 static int s_frame_dump_interval = 0;
+static bool s_dump_audio = false;
+static std::string s_benchmark_filename;
+static bool s_hash_frames = false;
+static std::string s_hash_baseline_filename;
 static std::shared_ptr<SystemBootParameters> s_boot_parameters;
 static std::string s_dump_base_directory;
 static std::string s_dump_game_directory;
 static GPURenderer s_renderer_to_use = GPURenderer::Software;
+static bool s_pgxp_enable = false;
+static bool s_pgxp_cpu = false;
+static bool s_pgxp_vertex_cache = false;
+static bool s_pgxp_shadow_paging = false;
+static bool s_cpu_recompiler_tiered = false;
 static GameSettings::Database s_game_settings_db;
 static GameDatabase s_game_database;
 
+namespace {
+/// Hashes everything the SPU outputs, so that audio can be compared frame by frame.
+class HashingAudioStream final : public AudioStream
+{
+public:
+  HashingAudioStream() : m_state(XXH64_createState()) { XXH64_reset(m_state, 0); }
+  ~HashingAudioStream() override { XXH64_freeState(m_state); }
+
+  /// Returns the hash of the samples output since the last call.
+  u64 GetAndResetHash()
+  {
+    const u64 hash = XXH64_digest(m_state);
+    XXH64_reset(m_state, 0);
+    return hash;
+  }
+
+protected:
+  bool OpenDevice() override { return true; }
+  void PauseDevice(bool paused) override {}
+  void CloseDevice() override {}
+
+  void FramesAvailable() override
+  {
+    const u32 num_frames = GetSamplesAvailable();
+    m_read_buffer.resize(num_frames * m_channels);
+    ReadFrames(m_read_buffer.data(), num_frames, false);
+    XXH64_update(m_state, m_read_buffer.data(), m_read_buffer.size() * sizeof(SampleType));
+  }
+
+private:
+  XXH64_state_t* m_state;
+  std::vector<SampleType> m_read_buffer;
+};
+} // namespace
+
+static bool IsHashingFrames()
+{
+  return s_hash_frames || !s_hash_baseline_filename.empty();
+}
+
 RegTestHostInterface::RegTestHostInterface() = default;
 
 RegTestHostInterface::~RegTestHostInterface() = default;
@@ -192,6 +259,11 @@ void RegTestHostInterface::UpdateSettings()
   }
 
   HostInterface::FixIncompatibleSettings(true);
+
+  // the software renderer ignores the precise vertices, but all of the tracking still runs, which is what the PGXP
+  // options are for
+  if (s_pgxp_enable)
+    g_settings.gpu_pgxp_enable = true;
 }
 
 void RegTestHostInterface::LoadGameSettingsDatabase()
@@ -226,6 +298,22 @@ void RegTestHostInterface::InitializeSettings()
   si.SetStringValue("ControllerPorts", "MultitapMode", Settings::GetMultitapModeName(MultitapMode::Disabled));
   si.SetStringValue("Logging", "LogLevel", Settings::GetLogLevelName(LOGLEVEL_DEV));
   si.SetBoolValue("Logging", "LogToConsole", true);
+  si.SetBoolValue("GPU", "PGXPEnable", s_pgxp_enable);
+  si.SetBoolValue("GPU", "PGXPCPU", s_pgxp_cpu);
+  si.SetBoolValue("GPU", "PGXPVertexCache", s_pgxp_vertex_cache);
+  si.SetBoolValue("GPU", "PGXPShadowPaging", s_pgxp_shadow_paging);
+  si.SetBoolValue("CPU", "RecompilerTiered", s_cpu_recompiler_tiered);
+
+  // Benchmarks should only be limited by the emulator itself.
+  if (!s_benchmark_filename.empty())
+  {
+    si.SetFloatValue("Main", "EmulationSpeed", 0.0f);
+    si.SetBoolValue("Main", "SyncToHostRefreshRate", false);
+    si.SetBoolValue("Display", "VSync", false);
+    si.SetStringValue("Audio", "Backend", Settings::GetAudioBackendName(AudioBackend::Null));
+    si.SetBoolValue("Audio", "Sync", false);
+    si.SetBoolValue("Audio", "OutputMuted", true);
+  }
 
   HostInterface::LoadSettings(si);
 }
@@ -302,6 +390,9 @@ void RegTestHostInterface::ReleaseHostDisplay()
 
 std::unique_ptr<AudioStream> RegTestHostInterface::CreateAudioStream(AudioBackend backend)
 {
+  if (IsHashingFrames())
+    return std::make_unique<HashingAudioStream>();
+
   return AudioStream::CreateNullAudioStream();
 }
 
@@ -342,9 +433,24 @@ static void PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -version: Displays version information and exits.\n");
   std::fprintf(stderr, "  -dumpdir: Set frame dump base directory (will be dumped to basedir/gametitle).\n");
   std::fprintf(stderr, "  -dumpinterval: Dumps every N frames.\n");
+  std::fprintf(stderr, "  -dumpaudio: Dumps SPU output to audio.wav in the frame dump directory.\n");
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
+  std::fprintf(stderr, "  -benchmark <filename>: Runs without throttling or audio output, and writes frame\n"
+                       "    and per-subsystem timings to filename as JSON. Use a low log level for accurate\n"
+                       "    results.\n");
+  std::fprintf(stderr, "  -hashframes: Writes hashes of VRAM, the display, SPU output and RAM for every frame\n"
+                       "    to hashes.txt in the frame dump directory. The SPU is run up to the end of each\n"
+                       "    frame before hashing, so traces should only be compared with other traces.\n");
+  std::fprintf(stderr, "  -hashbaseline <filename>: Compares the hashes of every frame against a previously\n"
+                       "    written hashes.txt, and stops at the first frame which differs.\n");
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -pgxp: Enables PGXP with memory tracking. The software renderer doesn't use the\n"
+                       "    results, but still pays for the tracking.\n");
+  std::fprintf(stderr, "  -pgxpcpu: Enables PGXP with CPU instruction tracking.\n");
+  std::fprintf(stderr, "  -pgxpvertexcache: Enables the PGXP vertex cache.\n");
+  std::fprintf(stderr, "  -pgxppaging: Allocates PGXP shadow memory in pages when it's first written.\n");
+  std::fprintf(stderr, "  -tiered: Interprets blocks until they are hot, then compiles them to host code.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -398,6 +504,38 @@ static bool ParseCommandLineArgs(int argc, char* argv[])
 
         continue;
       }
+      else if (CHECK_ARG("-dumpaudio"))
+      {
+        s_dump_audio = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-benchmark"))
+      {
+        s_benchmark_filename = argv[++i];
+        if (s_benchmark_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid benchmark output filename specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-hashframes"))
+      {
+        s_hash_frames = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-hashbaseline"))
+      {
+        s_hash_baseline_filename = argv[++i];
+        if (s_hash_baseline_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid hash baseline filename specified.");
+          return false;
+        }
+
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-frames"))
       {
         s_frames_to_run = StringUtil::FromChars<int>(argv[++i]).value_or(-1);
@@ -433,6 +571,32 @@ static bool ParseCommandLineArgs(int argc, char* argv[])
         s_renderer_to_use = renderer.value();
         continue;
       }
+      else if (CHECK_ARG("-pgxp"))
+      {
+        s_pgxp_enable = true;
+        continue;
+      }
+      else if (CHECK_ARG("-pgxpcpu"))
+      {
+        s_pgxp_enable = true;
+        s_pgxp_cpu = true;
+        continue;
+      }
+      else if (CHECK_ARG("-pgxpvertexcache"))
+      {
+        s_pgxp_vertex_cache = true;
+        continue;
+      }
+      else if (CHECK_ARG("-pgxppaging"))
+      {
+        s_pgxp_shadow_paging = true;
+        continue;
+      }
+      else if (CHECK_ARG("-tiered"))
+      {
+        s_cpu_recompiler_tiered = true;
+        continue;
+      }
       else if (CHECK_ARG("--"))
       {
         no_more_args = true;
@@ -456,12 +620,346 @@ static bool ParseCommandLineArgs(int argc, char* argv[])
   return true;
 }
 
+static std::string GetAudioDumpFilename()
+{
+  return StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "audio.wav", s_dump_game_directory.c_str());
+}
+
+static u64 GetPeakRSS()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc = {};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return 0;
+
+  return static_cast<u64>(pmc.PeakWorkingSetSize);
+#else
+  struct rusage ru = {};
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+    return 0;
+
+#ifdef __APPLE__
+  // bytes on macOS, kilobytes everywhere else
+  return static_cast<u64>(ru.ru_maxrss);
+#else
+  return static_cast<u64>(ru.ru_maxrss) * 1024u;
+#endif
+#endif
+}
+
+static double GetFrameTimePercentile(const std::vector<double>& sorted_frame_times, double percentile)
+{
+  // nearest-rank
+  const size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<double>(sorted_frame_times.size())));
+  return sorted_frame_times[std::clamp<size_t>(rank, 1, sorted_frame_times.size()) - 1];
+}
+
+static bool WriteBenchmarkResults(std::vector<double> frame_times, double total_time, u64 executed_events)
+{
+  std::sort(frame_times.begin(), frame_times.end());
+  const double num_frames = static_cast<double>(frame_times.size());
+  const double fps = num_frames / (total_time / 1000.0);
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("version");
+  writer.String(g_scm_tag_str);
+  writer.Key("path");
+  writer.String(System::GetRunningPath().c_str());
+  writer.Key("code");
+  writer.String(System::GetRunningCode().c_str());
+  writer.Key("title");
+  writer.String(System::GetRunningTitle().c_str());
+  writer.Key("renderer");
+  writer.String(Settings::GetRendererName(g_settings.gpu_renderer));
+  writer.Key("cpu_execution_mode");
+  writer.String(Settings::GetCPUExecutionModeName(g_settings.cpu_execution_mode));
+  writer.Key("gpu_thread");
+  writer.Bool(g_settings.gpu_use_thread);
+  writer.Key("spu_thread");
+  writer.Bool(g_settings.audio_spu_thread);
+  writer.Key("mdec_thread");
+  writer.Bool(g_settings.mdec_use_thread);
+  writer.Key("pgxp");
+  writer.String(g_settings.gpu_pgxp_enable ? (g_settings.gpu_pgxp_cpu ? "cpu" : "memory") : "disabled");
+  writer.Key("pgxp_vertex_cache");
+  writer.Bool(g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_vertex_cache);
+  writer.Key("pgxp_shadow_paging");
+  writer.Bool(g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_shadow_paging);
+  writer.Key("frames");
+  writer.Uint64(static_cast<u64>(frame_times.size()));
+  writer.Key("total_time_ms");
+  writer.Double(total_time);
+  writer.Key("fps");
+  writer.Double(fps);
+  writer.Key("speed");
+  writer.Double(fps / static_cast<double>(System::GetThrottleFrequency()) * 100.0);
+
+  writer.Key("events");
+  writer.Uint64(executed_events);
+  writer.Key("events_per_second");
+  writer.Double(static_cast<double>(executed_events) / (total_time / 1000.0));
+
+  writer.Key("frame_time_ms");
+  writer.StartObject();
+  writer.Key("min");
+  writer.Double(frame_times.front());
+  writer.Key("average");
+  writer.Double(total_time / num_frames);
+  writer.Key("p50");
+  writer.Double(GetFrameTimePercentile(frame_times, 0.5));
+  writer.Key("p99");
+  writer.Double(GetFrameTimePercentile(frame_times, 0.99));
+  writer.Key("max");
+  writer.Double(frame_times.back());
+  writer.EndObject();
+
+  // Time on the CPU thread, each subsystem is only counted once. gpu_backend includes waiting for the GPU thread.
+  writer.Key("subsystem_time_ms");
+  writer.StartObject();
+  for (u32 i = 0; i < static_cast<u32>(Profiler::Section::Count); i++)
+  {
+    const Profiler::Section section = static_cast<Profiler::Section>(i);
+    writer.Key(Profiler::GetSectionName(section));
+    writer.Double(Profiler::GetSectionTime(section));
+  }
+  writer.EndObject();
+
+  // Time spent working on the GPU/SPU/MDEC threads.
+  writer.Key("thread_time_ms");
+  writer.StartObject();
+  writer.Key(Profiler::GetSectionName(Profiler::Section::GPUBackend));
+  writer.Double(Profiler::GetSectionThreadTime(Profiler::Section::GPUBackend));
+  writer.Key(Profiler::GetSectionName(Profiler::Section::SPU));
+  writer.Double(Profiler::GetSectionThreadTime(Profiler::Section::SPU));
+  writer.Key(Profiler::GetSectionName(Profiler::Section::MDEC));
+  writer.Double(Profiler::GetSectionThreadTime(Profiler::Section::MDEC));
+  writer.EndObject();
+
+  writer.Key("peak_rss_bytes");
+  writer.Uint64(GetPeakRSS());
+  writer.EndObject();
+
+  Log_InfoPrintf("Benchmark: %.0f frames in %.2f ms, %.2f FPS, p50 %.2f ms, p99 %.2f ms", num_frames, total_time, fps,
+                 GetFrameTimePercentile(frame_times, 0.5), GetFrameTimePercentile(frame_times, 0.99));
+  Log_InfoPrintf("  %" PRIu64 " events, %.0f events/s", executed_events,
+                 static_cast<double>(executed_events) / (total_time / 1000.0));
+  for (u32 i = 0; i < static_cast<u32>(Profiler::Section::Count); i++)
+  {
+    const Profiler::Section section = static_cast<Profiler::Section>(i);
+    Log_InfoPrintf("  %-12s %10.2f ms (%.1f%%)", Profiler::GetSectionName(section),
+                   Profiler::GetSectionTime(section), Profiler::GetSectionTime(section) / total_time * 100.0);
+  }
+
+  if (!FileSystem::WriteFileToString(s_benchmark_filename.c_str(),
+                                     std::string_view(buffer.GetString(), buffer.GetSize())))
+  {
+    Log_ErrorPrintf("Failed to write benchmark results to '%s'.", s_benchmark_filename.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote benchmark results to '%s'.", s_benchmark_filename.c_str());
+  return true;
+}
+
 static std::string GetFrameDumpFilename(int frame)
 {
   return StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "frame_%05d.png", s_dump_game_directory.c_str(),
                                          frame);
 }
 
+enum : u32
+{
+  FRAME_HASH_VRAM,
+  FRAME_HASH_DISPLAY,
+  FRAME_HASH_SPU,
+  FRAME_HASH_RAM,
+  NUM_FRAME_HASHES
+};
+
+using FrameHashes = std::array<u64, NUM_FRAME_HASHES>;
+
+static constexpr std::array<const char*, NUM_FRAME_HASHES> s_frame_hash_names = {{"vram", "display", "spu", "ram"}};
+
+static FileSystem::ManagedCFilePtr s_hash_trace_file(nullptr, [](std::FILE* fp) { std::fclose(fp); });
+static std::vector<FrameHashes> s_hash_baseline;
+
+static std::string GetHashTraceFilename()
+{
+  return StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "hashes.txt", s_dump_game_directory.c_str());
+}
+
+static bool OpenHashTrace()
+{
+  const std::string filename(GetHashTraceFilename());
+  s_hash_trace_file = FileSystem::OpenManagedCFile(filename.c_str(), "wb");
+  if (!s_hash_trace_file)
+  {
+    Log_ErrorPrintf("Failed to open hash trace '%s'.", filename.c_str());
+    return false;
+  }
+
+  std::fprintf(s_hash_trace_file.get(), "# frame");
+  for (const char* name : s_frame_hash_names)
+    std::fprintf(s_hash_trace_file.get(), " %s", name);
+  std::fprintf(s_hash_trace_file.get(), "\n");
+
+  Log_InfoPrintf("Writing frame hashes to '%s'.", filename.c_str());
+  return true;
+}
+
+static bool LoadHashBaseline()
+{
+  std::optional<std::string> data = FileSystem::ReadFileToString(s_hash_baseline_filename.c_str());
+  if (!data.has_value())
+  {
+    Log_ErrorPrintf("Failed to read hash baseline '%s'.", s_hash_baseline_filename.c_str());
+    return false;
+  }
+
+  std::string::size_type pos = 0;
+  while (pos < data->size())
+  {
+    std::string::size_type end = data->find('\n', pos);
+    if (end == std::string::npos)
+      end = data->size();
+
+    const std::string line(data->substr(pos, end - pos));
+    pos = end + 1;
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    // frames are stored in order, starting from one
+    int frame;
+    FrameHashes hashes;
+    if (std::sscanf(line.c_str(), "%d %" SCNx64 " %" SCNx64 " %" SCNx64 " %" SCNx64, &frame, &hashes[0], &hashes[1],
+                    &hashes[2], &hashes[3]) != 5 ||
+        frame != static_cast<int>(s_hash_baseline.size() + 1))
+    {
+      Log_ErrorPrintf("Malformed line in hash baseline: '%s'", line.c_str());
+      return false;
+    }
+
+    s_hash_baseline.push_back(hashes);
+  }
+
+  Log_InfoPrintf("Loaded %zu frame hashes from '%s'.", s_hash_baseline.size(), s_hash_baseline_filename.c_str());
+  return true;
+}
+
+static FrameHashes ComputeFrameHashes()
+{
+  FrameHashes hashes;
+  hashes[FRAME_HASH_VRAM] = XXH64(g_gpu->ReadbackVRAM(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16), 0);
+
+  std::vector<u32> display_buffer;
+  hashes[FRAME_HASH_DISPLAY] = g_host_interface->GetDisplay()->WriteDisplayTextureToBuffer(&display_buffer) ?
+                                 XXH64(display_buffer.data(), display_buffer.size() * sizeof(u32), 0) :
+                                 0;
+
+  // the SPU only catches up when its event fires or a register is accessed, so bring it to the end of the frame.
+  // otherwise the hash would cover whichever slices happened to run, rather than the frame. samples could still be in
+  // flight on the SPU thread after that.
+  g_spu.GeneratePendingSamples();
+  g_spu.SyncRenderThread();
+  hashes[FRAME_HASH_SPU] = static_cast<HashingAudioStream*>(g_host_interface->GetAudioStream())->GetAndResetHash();
+
+  hashes[FRAME_HASH_RAM] = XXH64(Bus::g_ram, Bus::g_ram_size, 0);
+  return hashes;
+}
+
+/// Records and/or verifies the hashes for a frame. Returns false if they differ from the baseline.
+static bool CheckFrameHashes(int frame)
+{
+  const FrameHashes hashes(ComputeFrameHashes());
+  if (s_hash_trace_file)
+  {
+    std::fprintf(s_hash_trace_file.get(), "%d", frame);
+    for (const u64 hash : hashes)
+      std::fprintf(s_hash_trace_file.get(), " %016" PRIx64, hash);
+    std::fprintf(s_hash_trace_file.get(), "\n");
+  }
+
+  if (s_hash_baseline_filename.empty())
+    return true;
+
+  if (static_cast<size_t>(frame) > s_hash_baseline.size())
+  {
+    // a shorter baseline only verifies the frames it has
+    if (static_cast<size_t>(frame) == s_hash_baseline.size() + 1)
+      Log_WarningPrintf("Hash baseline ends at frame %d, not verifying remaining frames.", frame - 1);
+
+    return true;
+  }
+
+  const FrameHashes& expected = s_hash_baseline[static_cast<size_t>(frame - 1)];
+  if (hashes == expected)
+    return true;
+
+  Log_ErrorPrintf("Frame %d differs from the hash baseline:", frame);
+  for (u32 i = 0; i < NUM_FRAME_HASHES; i++)
+  {
+    if (hashes[i] != expected[i])
+    {
+      Log_ErrorPrintf("  %-8s expected %016" PRIx64 ", got %016" PRIx64, s_frame_hash_names[i], expected[i],
+                      hashes[i]);
+    }
+    else
+    {
+      Log_ErrorPrintf("  %-8s matches", s_frame_hash_names[i]);
+    }
+  }
+
+  return false;
+}
+
+static bool RunFrames()
+{
+  const bool benchmark = !s_benchmark_filename.empty();
+  std::vector<double> frame_times;
+  if (benchmark)
+  {
+    frame_times.reserve(static_cast<size_t>(s_frames_to_run));
+    Profiler::Enable();
+  }
+
+  const u64 start_executed_events = TimingEvents::GetExecutedEventCount();
+  Common::Timer benchmark_timer;
+  for (int frame = 1; frame <= s_frames_to_run; frame++)
+  {
+    Common::Timer frame_timer;
+    System::RunFrame();
+
+    if (IsHashingFrames() && !CheckFrameHashes(frame))
+      return false;
+
+    if (s_frame_dump_interval > 0 && (s_frame_dump_interval == 1 || (frame % s_frame_dump_interval) == 0))
+    {
+      std::string dump_filename(GetFrameDumpFilename(frame));
+      g_host_interface->GetDisplay()->WriteDisplayTextureToFile(std::move(dump_filename));
+    }
+
+    {
+      Profiler::ScopedSection profile(Profiler::Section::GPUBackend);
+      g_host_interface->GetDisplay()->Render();
+    }
+
+    System::UpdatePerformanceCounters();
+
+    if (benchmark)
+      frame_times.push_back(frame_timer.GetTimeMilliseconds());
+  }
+
+  if (!benchmark)
+    return true;
+
+  const double total_time = benchmark_timer.GetTimeMilliseconds();
+  Profiler::Disable();
+  return WriteBenchmarkResults(std::move(frame_times), total_time,
+                               TimingEvents::GetExecutedEventCount() - start_executed_events);
+}
+
 int main(int argc, char* argv[])
 {
   Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_VERBOSE);
@@ -500,28 +998,53 @@ int main(int argc, char* argv[])
     Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
   }
 
-  Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
-
-  for (int frame = 1; frame <= s_frames_to_run; frame++)
+  if (s_dump_audio)
   {
-    System::RunFrame();
+    if (s_dump_base_directory.empty())
+    {
+      Log_ErrorPrint("Dump directory not specified.");
+      goto cleanup;
+    }
 
-    if (s_frame_dump_interval > 0 && (s_frame_dump_interval == 1 || (frame % s_frame_dump_interval) == 0))
+    const std::string audio_filename(GetAudioDumpFilename());
+    if (!g_spu.StartDumpingAudio(audio_filename.c_str()))
     {
-      std::string dump_filename(GetFrameDumpFilename(frame));
-      g_host_interface->GetDisplay()->WriteDisplayTextureToFile(std::move(dump_filename));
+      Log_ErrorPrintf("Failed to start dumping audio to '%s'.", audio_filename.c_str());
+      goto cleanup;
     }
 
-    g_host_interface->GetDisplay()->Render();
+    Log_InfoPrintf("Dumping audio to '%s'.", audio_filename.c_str());
+  }
 
-    System::UpdatePerformanceCounters();
+  if (s_hash_frames)
+  {
+    if (s_dump_base_directory.empty())
+    {
+      Log_ErrorPrint("Dump directory not specified.");
+      goto cleanup;
+    }
+
+    if (!OpenHashTrace())
+      goto cleanup;
   }
 
+  if (!s_hash_baseline_filename.empty() && !LoadHashBaseline())
+    goto cleanup;
+
+  Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
+  if (RunFrames())
+    result = 0;
+
+  if (s_dump_audio)
+    g_spu.StopDumpingAudio();
+
+  s_hash_trace_file.reset();
+
   Log_InfoPrintf("All done, shutting down system.");
   g_host_interface->DestroySystem();
 
-  Log_InfoPrintf("Exiting with success.");
-  result = 0;
+  if (result == 0)
+    Log_InfoPrintf("Exiting with success.");
 
 cleanup:
   delete g_host_interface;
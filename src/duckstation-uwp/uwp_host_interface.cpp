@@ -468,7 +468,10 @@ void UWPHostInterface::OnSuspending(const IInspectable&,
   {
     RunLater([this]() {
       if (ShouldSaveResumeState())
+      {
         SaveResumeSaveState();
+        WaitForSaveStateWrites();
+      }
 
       m_was_running_on_suspend.store(System::IsRunning());
       PauseSystem(true);
@@ -34,6 +34,7 @@
 #include "input_overlay_ui.h"
 #include "save_state_selector_ui.h"
 #include "scmversion/scmversion.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -121,6 +122,8 @@ bool CommonHostInterface::Initialize()
 
 void CommonHostInterface::Shutdown()
 {
+  StopSaveStateThread();
+
   s_input_overlay_ui.reset();
 
   HostInterface::Shutdown();
@@ -788,6 +791,8 @@ bool CommonHostInterface::SaveUndoLoadState()
 
 bool CommonHostInterface::LoadState(const char* filename)
 {
+  WaitForSaveStateWrites(filename);
+
   const bool system_was_valid = System::IsValid();
   if (system_was_valid)
     SaveUndoLoadState();
@@ -829,8 +834,121 @@ bool CommonHostInterface::SaveState(bool global, s32 slot)
   }
 
   std::string save_path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(code.c_str(), slot);
-  RenameCurrentSaveStateToBackup(save_path.c_str());
-  return SaveState(save_path.c_str());
+  return QueueSaveState(save_path.c_str(), GetBoolSettingValue("General", "CreateSaveStateBackups", false));
+}
+
+bool CommonHostInterface::SaveState(const char* filename)
+{
+  return QueueSaveState(filename, false);
+}
+
+bool CommonHostInterface::QueueSaveState(const char* filename, bool create_backup)
+{
+  std::unique_ptr<System::SaveStateBuffer> buffer = std::make_unique<System::SaveStateBuffer>();
+  if (!System::SaveStateToBuffer(buffer.get()))
+  {
+    ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(m_save_state_mutex);
+
+  // Saving to a file which is still waiting to be written replaces the older state, rather than writing it twice.
+  auto iter = std::find_if(m_pending_save_states.begin(), m_pending_save_states.end(),
+                           [filename](const PendingSaveState& pss) { return pss.filename == filename; });
+  if (iter != m_pending_save_states.end())
+  {
+    iter->buffer = std::move(buffer);
+    iter->compression = g_settings.save_state_compression;
+    iter->create_backup |= create_backup;
+  }
+  else
+  {
+    m_pending_save_states.push_back(
+      PendingSaveState{filename, std::move(buffer), g_settings.save_state_compression, create_backup});
+  }
+
+  if (!m_save_state_thread.joinable())
+  {
+    m_save_state_thread_shutdown = false;
+    m_save_state_thread = std::thread(&CommonHostInterface::SaveStateThreadEntryPoint, this);
+  }
+
+  m_save_state_queued_cv.notify_one();
+  return true;
+}
+
+void CommonHostInterface::SaveStateThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_mutex);
+  for (;;)
+  {
+    m_save_state_queued_cv.wait(lock,
+                                [this]() { return !m_pending_save_states.empty() || m_save_state_thread_shutdown; });
+
+    // Everything queued is written before shutting down.
+    if (m_pending_save_states.empty())
+      break;
+
+    PendingSaveState pss = std::move(m_pending_save_states.front());
+    m_pending_save_states.pop_front();
+    m_writing_save_state_filename = pss.filename;
+    lock.unlock();
+
+    if (pss.create_backup)
+      RenameCurrentSaveStateToBackup(pss.filename.c_str());
+
+    std::unique_ptr<ByteStream> stream = FileSystem::OpenFile(
+      pss.filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                              BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+    if (stream && System::WriteSaveStateBuffer(stream.get(), *pss.buffer, pss.compression) && stream->Commit())
+    {
+      AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "State saved to '%s'."), pss.filename.c_str());
+    }
+    else
+    {
+      Log_ErrorPrintf("Failed to write save state to '%s'", pss.filename.c_str());
+      AddFormattedOSDMessage(15.0f, TranslateString("OSDMessage", "Saving state to '%s' failed."),
+                             pss.filename.c_str());
+      if (stream)
+        stream->Discard();
+    }
+
+    // Free the buffer before waking any waiters, they may be about to exit.
+    stream.reset();
+    pss.buffer.reset();
+
+    lock.lock();
+    m_writing_save_state_filename.clear();
+    m_save_state_written_cv.notify_all();
+  }
+}
+
+void CommonHostInterface::WaitForSaveStateWrites(const char* filename /* = nullptr */)
+{
+  std::unique_lock<std::mutex> lock(m_save_state_mutex);
+  m_save_state_written_cv.wait(lock, [this, filename]() {
+    if (!filename)
+      return (m_pending_save_states.empty() && m_writing_save_state_filename.empty());
+
+    return (m_writing_save_state_filename != filename &&
+            std::none_of(m_pending_save_states.begin(), m_pending_save_states.end(),
+                         [filename](const PendingSaveState& pss) { return pss.filename == filename; }));
+  });
+}
+
+void CommonHostInterface::StopSaveStateThread()
+{
+  if (!m_save_state_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_save_state_mutex);
+    m_save_state_thread_shutdown = true;
+    m_save_state_queued_cv.notify_one();
+  }
+
+  m_save_state_thread.join();
 }
 
 bool CommonHostInterface::CanResumeSystemFromFile(const char* filename)
@@ -887,6 +1005,9 @@ bool CommonHostInterface::ResumeSystemFromState(const char* filename, bool boot_
 
 bool CommonHostInterface::ResumeSystemFromMostRecentState()
 {
+  // The newest resume state may not exist on disk yet.
+  WaitForSaveStateWrites();
+
   const std::string path = GetMostRecentResumeSaveStatePath();
   if (path.empty())
   {
@@ -1293,7 +1414,7 @@ void CommonHostInterface::DrawEnhancementsOverlay()
   text.AppendString(Settings::GetConsoleRegionName(System::GetRegion()));
 
   if (g_settings.rewind_enable)
-    text.AppendFormattedString(" RW=%g/%u", g_settings.rewind_save_frequency, g_settings.rewind_save_slots);
+    text.AppendFormattedString(" RW=%g/%uMB", g_settings.rewind_save_frequency, g_settings.rewind_memory_limit);
   if (g_settings.IsRunaheadEnabled())
     text.AppendFormattedString(" RA=%u", g_settings.runahead_frames);
 
@@ -1545,6 +1666,8 @@ void CommonHostInterface::DrawDebugWindows()
     g_mdec.DrawDebugStateWindow();
   if (g_settings.debugging.show_dma_state)
     g_dma.DrawDebugStateWindow();
+  if (g_settings.debugging.show_code_cache_state)
+    CPU::CodeCache::DrawDebugStateWindow();
 }
 
 bool CommonHostInterface::IsCheevosChallengeModeActive() const
@@ -3062,9 +3185,6 @@ std::string CommonHostInterface::GetGlobalSaveStateFileName(s32 slot) const
 
 void CommonHostInterface::RenameCurrentSaveStateToBackup(const char* filename)
 {
-  if (!GetBoolSettingValue("General", "CreateSaveStateBackups", false))
-    return;
-
   if (!FileSystem::FileExists(filename))
     return;
 
@@ -3171,6 +3291,7 @@ CommonHostInterface::GetExtendedSaveStateInfo(const char* game_code, s32 slot)
 {
   const bool global = (!game_code || game_code[0] == 0);
   std::string path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(game_code, slot);
+  WaitForSaveStateWrites(path.c_str());
 
   FILESYSTEM_STAT_DATA sd;
   if (!FileSystem::StatFile(path.c_str(), &sd))
@@ -3215,6 +3336,8 @@ std::optional<CommonHostInterface::ExtendedSaveStateInfo> CommonHostInterface::G
 
 void CommonHostInterface::DeleteSaveStates(const char* game_code, bool resume)
 {
+  WaitForSaveStateWrites();
+
   const std::vector<SaveStateInfo> states(GetAvailableSaveStates(game_code));
   for (const SaveStateInfo& si : states)
   {
@@ -3402,6 +3525,7 @@ void CommonHostInterface::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.debugging.show_timers_state = false;
     g_settings.debugging.show_mdec_state = false;
     g_settings.debugging.show_dma_state = false;
+    g_settings.debugging.show_code_cache_state = false;
     g_settings.debugging.dump_cpu_to_vram_copies = false;
     g_settings.debugging.dump_vram_to_cpu_copies = false;
   }
@@ -4,12 +4,15 @@
 #include "core/controller.h"
 #include "core/host_interface.h"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -20,6 +23,10 @@ struct GameDatabaseEntry;
 
 class ControllerInterface;
 
+namespace System {
+struct SaveStateBuffer;
+}
+
 namespace FrontendCommon {
 class SaveStateSelectorUI;
 
@@ -98,7 +105,9 @@ public:
     std::vector<u32> screenshot_data;
   };
 
-  using HostInterface::SaveState;
+  /// Saves the current emulation state to the specified filename. The state is captured immediately, and written to the
+  /// file in the background.
+  bool SaveState(const char* filename);
 
   /// Returns the name of the frontend.
   virtual const char* GetFrontendName() const = 0;
@@ -188,6 +197,9 @@ public:
   /// Saves the current emulation state to a file. Specifying a slot of -1 saves the "resume" save state.
   bool SaveState(bool global, s32 slot);
 
+  /// Blocks until the specified save state file has been written, or all files if filename is null.
+  void WaitForSaveStateWrites(const char* filename = nullptr);
+
   /// Returns true if the specified file/disc image is resumable.
   bool CanResumeSystemFromFile(const char* filename);
 
@@ -416,6 +428,11 @@ protected:
   /// Moves the current save state file to a backup name, if it exists.
   void RenameCurrentSaveStateToBackup(const char* filename);
 
+  /// Captures the current state, and queues it to be written on the save state thread.
+  bool QueueSaveState(const char* filename, bool create_backup);
+  void SaveStateThreadEntryPoint();
+  void StopSaveStateThread();
+
   /// Sets the base path for the user directory. Can be overridden by platform/frontend/command line.
   virtual void SetUserDirectory();
 
@@ -574,6 +591,22 @@ private:
   // temporary save state, created when loading, used to undo load state
   std::unique_ptr<ByteStream> m_undo_load_state;
 
+  // save states waiting to be written to disk
+  struct PendingSaveState
+  {
+    std::string filename;
+    std::unique_ptr<System::SaveStateBuffer> buffer;
+    SaveStateCompression compression;
+    bool create_backup;
+  };
+  std::thread m_save_state_thread;
+  std::mutex m_save_state_mutex;
+  std::condition_variable m_save_state_queued_cv;
+  std::condition_variable m_save_state_written_cv;
+  std::deque<PendingSaveState> m_pending_save_states;
+  std::string m_writing_save_state_filename;
+  bool m_save_state_thread_shutdown = false;
+
 #ifdef WITH_DISCORD_PRESENCE
   // discord rich presence
   bool m_discord_presence_enabled = false;
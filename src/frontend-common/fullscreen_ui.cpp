@@ -1563,6 +1563,16 @@ void DrawSettingsWindow()
           settings_changed = true;
         }
 
+        s32 read_cache_size = static_cast<s32>(s_settings_copy.cdrom_read_cache_size);
+        if (RangeButton("Compressed Image Cache Size",
+                        "Memory used to keep decompressed data from compressed images, and to decompress ahead of "
+                        "reads. Applied when a disc is next opened.",
+                        &read_cache_size, 0, static_cast<s32>(Settings::MAX_CDROM_READ_CACHE_SIZE), 1, "%d MB"))
+        {
+          s_settings_copy.cdrom_read_cache_size = static_cast<u32>(read_cache_size);
+          settings_changed = true;
+        }
+
         settings_changed |=
           ToggleButton("Enable Region Check", "Simulates the region check present in original, unmodified consoles.",
                        &s_settings_copy.cdrom_region_check);
@@ -1640,11 +1650,12 @@ void DrawSettingsWindow()
           "Rewind Save Frequency",
           "How often a rewind state will be created. Higher frequencies have greater system requirements.",
           &s_settings_copy.rewind_save_frequency, 0.0f, 3600.0f, 0.1f, "%.2f Seconds", s_settings_copy.rewind_enable);
-        settings_changed |=
-          RangeButton("Rewind Save Frequency",
-                      "How many saves will be kept for rewinding. Higher values have greater memory requirements.",
-                      reinterpret_cast<s32*>(&s_settings_copy.rewind_save_slots), 1, 10000, 1, "%d Frames",
-                      s_settings_copy.rewind_enable);
+        settings_changed |= RangeButton(
+          "Rewind Memory Limit",
+          "How much memory rewind saves can use. Saves are compressed, so games which change less between saves "
+          "can be rewound further.",
+          reinterpret_cast<s32*>(&s_settings_copy.rewind_memory_limit), Settings::MIN_REWIND_MEMORY_LIMIT,
+          Settings::MAX_REWIND_MEMORY_LIMIT, 16, "%d MB", s_settings_copy.rewind_enable);
 
         TinyString summary;
         if (!s_settings_copy.IsRunaheadEnabled())
@@ -1683,16 +1694,25 @@ void DrawSettingsWindow()
         }
         else if (s_settings_copy.rewind_enable)
         {
-          const float duration = ((s_settings_copy.rewind_save_frequency <= std::numeric_limits<float>::epsilon()) ?
-                                    (1.0f / 60.0f) :
-                                    s_settings_copy.rewind_save_frequency) *
-                                 static_cast<float>(s_settings_copy.rewind_save_slots);
-
+          u32 num_saves;
           u64 ram_usage, vram_usage;
-          System::CalculateRewindMemoryUsage(s_settings_copy.rewind_save_slots, &ram_usage, &vram_usage);
-          rewind_summary.Format("Rewind for %u frames, lasting %.2f seconds will require up to %" PRIu64
-                                "MB of RAM and %" PRIu64 "MB of VRAM.",
-                                s_settings_copy.rewind_save_slots, duration, ram_usage / 1048576, vram_usage / 1048576);
+          System::GetRewindMemoryUsage(&num_saves, &ram_usage, &vram_usage);
+          if (System::IsValid() && num_saves > 0)
+          {
+            const float duration = ((s_settings_copy.rewind_save_frequency <= std::numeric_limits<float>::epsilon()) ?
+                                      (1.0f / 60.0f) :
+                                      s_settings_copy.rewind_save_frequency) *
+                                   static_cast<float>(num_saves);
+            rewind_summary.Format("Rewind is holding %u saves, lasting %.2f seconds, in %" PRIu64
+                                  "MB of RAM and %" PRIu64 "MB of VRAM out of %uMB.",
+                                  num_saves, duration, ram_usage / 1048576, vram_usage / 1048576,
+                                  s_settings_copy.rewind_memory_limit);
+          }
+          else
+          {
+            rewind_summary.Format("Rewind will keep as many compressed saves as fit in %uMB of RAM and VRAM.",
+                                  s_settings_copy.rewind_memory_limit);
+          }
         }
         else
         {
@@ -2101,6 +2121,10 @@ void DrawSettingsWindow()
             settings_changed |= ToggleButton("Threaded Rendering",
                                              "Uses a second thread for drawing graphics. Speed boost, and safe to use.",
                                              &s_settings_copy.gpu_use_thread);
+            settings_changed |=
+              RangeButton("Rendering Threads",
+                          "Splits drawing into tiles which are rendered in parallel. Output is identical to one thread.",
+                          reinterpret_cast<s32*>(&s_settings_copy.gpu_sw_threads), 1, 64, 1, "%d Threads");
           }
           break;
 
@@ -2321,6 +2345,10 @@ void DrawSettingsWindow()
           "Resampling",
           "When running outside of 100% speed, resamples audio from the target speed instead of dropping frames.",
           &s_settings_copy.audio_resampling);
+        settings_changed |= ToggleButton("Generate Audio On Separate Thread",
+                                         "Records SPU register writes and generates samples in batches on another "
+                                         "thread. Falls back to the emulation thread while SPU IRQs are enabled.",
+                                         &s_settings_copy.audio_spu_thread);
 
         EndMenuButtons();
       }
@@ -2501,10 +2529,20 @@ void DrawSettingsWindow()
                                                       "Allows loading protected games without subchannel information.",
                                                       "CDROM", "AllowBootingWithoutSBIFile", false);
 
+        settings_changed |= ToggleButton("Decode MDEC Macroblocks On Separate Thread",
+                                         "Transforms decoded FMV macroblocks on another thread while the CPU "
+                                         "continues, and waits for the result when it is due to be output.",
+                                         &s_settings_copy.mdec_use_thread);
+
         settings_changed |= ToggleButtonForNonSetting("Create Save State Backups",
                                                       "Renames existing save states when saving to a backup file.",
                                                       "General", "CreateSaveStateBackups", false);
 
+        settings_changed |= EnumChoiceButton(
+          "Save State Compression", "Compresses save states written to disk. LZMA is smaller but slower to save.",
+          &s_settings_copy.save_state_compression, &Settings::GetSaveStateCompressionDisplayName,
+          SaveStateCompression::Count);
+
         MenuHeading("Display Settings");
         settings_changed |=
           ToggleButton("Show Status Indicators", "Shows persistent icons when turbo is active or when paused.",
@@ -2560,6 +2598,14 @@ void DrawSettingsWindow()
           "Enable Recompiler Block Linking",
           "Performance enhancement - jumps directly between blocks instead of returning to the dispatcher.",
           &s_settings_copy.cpu_recompiler_block_linking);
+        settings_changed |= ToggleButton(
+          "Enable Tiered Recompilation",
+          "Interprets blocks at first, and only compiles frequently-executed blocks to host code.",
+          &s_settings_copy.cpu_recompiler_tiered);
+        settings_changed |= ToggleButton(
+          "Enable Persistent Block Cache",
+          "Remembers compiled blocks between sessions, and precompiles them on boot to reduce stuttering.",
+          &s_settings_copy.cpu_recompiler_block_cache);
         settings_changed |= EnumChoiceButton("Recompiler Fast Memory Access",
                                              "Avoids calls to C++ code, significantly speeding up the recompiler.",
                                              &s_settings_copy.cpu_fastmem_mode, &Settings::GetCPUFastmemModeDisplayName,
@@ -4028,6 +4074,7 @@ void DrawDebugDebugMenu()
   settings_changed |= ImGui::MenuItem("Show Timers State", nullptr, &debug_settings.show_timers_state);
   settings_changed |= ImGui::MenuItem("Show MDEC State", nullptr, &debug_settings.show_mdec_state);
   settings_changed |= ImGui::MenuItem("Show DMA State", nullptr, &debug_settings.show_dma_state);
+  settings_changed |= ImGui::MenuItem("Show Code Cache State", nullptr, &debug_settings.show_code_cache_state);
 
   if (settings_changed)
   {
@@ -4042,6 +4089,7 @@ void DrawDebugDebugMenu()
     debug_settings_copy.show_timers_state = debug_settings.show_timers_state;
     debug_settings_copy.show_mdec_state = debug_settings.show_mdec_state;
     debug_settings_copy.show_dma_state = debug_settings.show_dma_state;
+    debug_settings_copy.show_code_cache_state = debug_settings.show_code_cache_state;
     s_host_interface->RunLater(SaveAndApplySettings);
   }
 }
@@ -13,11 +13,18 @@
 #include "core/psf_loader.h"
 #include "core/settings.h"
 #include "core/system.h"
+#include "xxhash.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <cstring>
 #include <ctime>
+#include <limits>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <tinyxml2.h>
 #include <utility>
 Log_SetChannel(GameList);
@@ -234,39 +241,100 @@ bool GameList::GetGameListEntry(const std::string& path, GameListEntry* entry)
 
 bool GameList::GetGameListEntryFromCache(const std::string& path, GameListEntry* entry)
 {
-  auto iter = m_cache_map.find(path);
-  if (iter == m_cache_map.end())
+  if (!m_cache_stream)
     return false;
 
-  *entry = std::move(iter->second);
-  m_cache_map.erase(iter);
-  return true;
+  const u32 offset = FindCacheRecord(m_cache_header.entry_table_offset, m_cache_header.entry_table_size, path);
+  if (offset == 0)
+    return false;
+
+  if (!m_cache_stream->SeekAbsolute(offset) || !ReadEntryFromCache(m_cache_stream.get(), entry))
+  {
+    Log_WarningPrintf("Game list cache entry for '%s' is corrupted", path.c_str());
+    return false;
+  }
+
+  // the hash matched, but the path may not
+  return (entry->path == path);
+}
+
+bool GameList::GetDirectoryEntryFromCache(const std::string& path, CacheDirectoryEntry* entry)
+{
+  if (!m_cache_stream)
+    return false;
+
+  const u32 offset = FindCacheRecord(m_cache_header.directory_table_offset, m_cache_header.directory_table_size, path);
+  if (offset == 0)
+    return false;
+
+  if (!m_cache_stream->SeekAbsolute(offset) || !ReadDirectoryFromCache(m_cache_stream.get(), entry))
+  {
+    Log_WarningPrintf("Game list cache directory '%s' is corrupted", path.c_str());
+    return false;
+  }
+
+  return (entry->path == path);
 }
 
 void GameList::LoadCache()
 {
+  CloseCacheFile();
   if (m_cache_filename.empty())
     return;
 
-  std::unique_ptr<ByteStream> stream =
-    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  m_cache_file = FileSystem::MapFileReadOnly(m_cache_filename.c_str());
+  if (!m_cache_file)
     return;
 
-  if (!LoadEntriesFromCache(stream.get()))
+  const u64 file_size = m_cache_file->GetSize();
+  const auto table_fits = [file_size](u32 offset, u32 size) {
+    return (size == 0 || ((size & (size - 1)) == 0 && offset >= sizeof(CacheHeader) &&
+                          (static_cast<u64>(offset) + static_cast<u64>(size) * sizeof(CacheTableSlot)) <= file_size));
+  };
+
+  CacheHeader& header = m_cache_header;
+  if (file_size >= sizeof(CacheHeader))
+    std::memcpy(&header, m_cache_file->GetData(), sizeof(header));
+
+  if (file_size < sizeof(CacheHeader) || file_size > std::numeric_limits<u32>::max() ||
+      header.signature != GAME_LIST_CACHE_SIGNATURE || header.version != GAME_LIST_CACHE_VERSION ||
+      !table_fits(header.entry_table_offset, header.entry_table_size) ||
+      !table_fits(header.directory_table_offset, header.directory_table_size))
   {
     Log_WarningPrintf("Deleting corrupted cache file '%s'", m_cache_filename.c_str());
-    stream.reset();
-    m_cache_map.clear();
+    CloseCacheFile();
     DeleteCacheFile();
     return;
   }
+
+  m_cache_stream = ByteStream_CreateReadOnlyMemoryStream(m_cache_file->GetData(), static_cast<u32>(file_size));
+}
+
+u32 GameList::FindCacheRecord(u32 table_offset, u32 table_size, const std::string& path) const
+{
+  if (table_size == 0)
+    return 0;
+
+  const u64 hash = XXH64(path.data(), path.size(), 0);
+  const u8* table = m_cache_file->GetData() + table_offset;
+  const u32 mask = table_size - 1;
+  for (u32 i = 0, index = static_cast<u32>(hash) & mask; i < table_size; i++, index = (index + 1) & mask)
+  {
+    CacheTableSlot slot;
+    std::memcpy(&slot, table + index * sizeof(CacheTableSlot), sizeof(slot));
+    if (slot.record_offset == 0)
+      break;
+    else if (slot.path_hash == hash)
+      return slot.record_offset;
+  }
+
+  return 0;
 }
 
 static bool ReadString(ByteStream* stream, std::string* dest)
 {
   u32 size;
-  if (!stream->Read2(&size, sizeof(size)))
+  if (!stream->Read2(&size, sizeof(size)) || size > (stream->GetSize() - stream->GetPosition()))
     return false;
 
   dest->resize(size);
@@ -312,86 +380,57 @@ static bool WriteU64(ByteStream* stream, u64 dest)
   return stream->Write2(&dest, sizeof(u64));
 }
 
-bool GameList::LoadEntriesFromCache(ByteStream* stream)
+bool GameList::ReadEntryFromCache(ByteStream* stream, GameListEntry* entry)
 {
-  u32 file_signature, file_version;
-  if (!ReadU32(stream, &file_signature) || !ReadU32(stream, &file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  u8 type;
+  u8 region;
+  u8 compatibility_rating;
+
+  if (!ReadU8(stream, &type) || !ReadU8(stream, &region) || !ReadString(stream, &entry->path) ||
+      !ReadString(stream, &entry->code) || !ReadString(stream, &entry->title) || !ReadString(stream, &entry->genre) ||
+      !ReadString(stream, &entry->publisher) || !ReadString(stream, &entry->developer) ||
+      !ReadU64(stream, &entry->total_size) || !ReadU64(stream, &entry->last_modified_time) ||
+      !ReadU64(stream, &entry->release_date) || !ReadU32(stream, &entry->supported_controllers) ||
+      !ReadU8(stream, &entry->min_players) || !ReadU8(stream, &entry->max_players) ||
+      !ReadU8(stream, &entry->min_blocks) || !ReadU8(stream, &entry->max_blocks) ||
+      !ReadU8(stream, &compatibility_rating) || region >= static_cast<u8>(DiscRegion::Count) ||
+      type >= static_cast<u8>(GameListEntryType::Count) ||
+      compatibility_rating >= static_cast<u8>(GameListCompatibilityRating::Count))
   {
-    Log_WarningPrintf("Game list cache is corrupted");
     return false;
   }
 
-  while (stream->GetPosition() != stream->GetSize())
-  {
-    std::string path;
-    GameListEntry ge;
-
-    u8 type;
-    u8 region;
-    u8 compatibility_rating;
-
-    if (!ReadU8(stream, &type) || !ReadU8(stream, &region) || !ReadString(stream, &path) ||
-        !ReadString(stream, &ge.code) || !ReadString(stream, &ge.title) || !ReadString(stream, &ge.genre) ||
-        !ReadString(stream, &ge.publisher) || !ReadString(stream, &ge.developer) || !ReadU64(stream, &ge.total_size) ||
-        !ReadU64(stream, &ge.last_modified_time) || !ReadU64(stream, &ge.release_date) ||
-        !ReadU32(stream, &ge.supported_controllers) || !ReadU8(stream, &ge.min_players) ||
-        !ReadU8(stream, &ge.max_players) || !ReadU8(stream, &ge.min_blocks) || !ReadU8(stream, &ge.max_blocks) ||
-        !ReadU8(stream, &compatibility_rating) || region >= static_cast<u8>(DiscRegion::Count) ||
-        type >= static_cast<u8>(GameListEntryType::Count) ||
-        compatibility_rating >= static_cast<u8>(GameListCompatibilityRating::Count))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted");
-      return false;
-    }
-
-    ge.path = path;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<GameListEntryType>(type);
-    ge.compatibility_rating = static_cast<GameListCompatibilityRating>(compatibility_rating);
-
-    if (!ge.settings.LoadFromStream(stream))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted (settings)");
-      return false;
-    }
-
-    auto iter = m_cache_map.find(ge.path);
-    if (iter != m_cache_map.end())
-      iter->second = std::move(ge);
-    else
-      m_cache_map.emplace(std::move(path), std::move(ge));
-  }
-
-  return true;
+  entry->region = static_cast<DiscRegion>(region);
+  entry->type = static_cast<GameListEntryType>(type);
+  entry->compatibility_rating = static_cast<GameListCompatibilityRating>(compatibility_rating);
+  return entry->settings.LoadFromStream(stream);
 }
 
-bool GameList::OpenCacheForWriting()
+bool GameList::ReadDirectoryFromCache(ByteStream* stream, CacheDirectoryEntry* entry)
 {
-  if (m_cache_filename.empty())
+  u32 file_count, subdirectory_count;
+  if (!ReadString(stream, &entry->path) || !ReadU64(stream, &entry->last_modified_time) ||
+      !ReadU32(stream, &file_count))
+  {
     return false;
+  }
 
-  Assert(!m_cache_write_stream);
-  m_cache_write_stream =
-    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
-                                                     BYTESTREAM_OPEN_APPEND | BYTESTREAM_OPEN_STREAMED);
-  if (!m_cache_write_stream || !m_cache_write_stream->SeekToEnd())
+  entry->files.clear();
+  for (u32 i = 0; i < file_count; i++)
   {
-    m_cache_write_stream.reset();
-    return false;
+    CacheFileEntry& fe = entry->files.emplace_back();
+    if (!ReadString(stream, &fe.path) || !ReadU64(stream, &fe.last_modified_time))
+      return false;
   }
 
-  if (m_cache_write_stream->GetPosition() == 0)
+  if (!ReadU32(stream, &subdirectory_count))
+    return false;
+
+  entry->subdirectories.clear();
+  for (u32 i = 0; i < subdirectory_count; i++)
   {
-    // new cache file, write header
-    if (!WriteU32(m_cache_write_stream.get(), GAME_LIST_CACHE_SIGNATURE) ||
-        !WriteU32(m_cache_write_stream.get(), GAME_LIST_CACHE_VERSION))
-    {
-      Log_ErrorPrintf("Failed to write game list cache header");
-      m_cache_write_stream.reset();
-      FileSystem::DeleteFile(m_cache_filename.c_str());
+    if (!ReadString(stream, &entry->subdirectories.emplace_back()))
       return false;
-    }
   }
 
   return true;
@@ -421,45 +460,110 @@ bool GameList::WriteEntryToCache(const GameListEntry* entry, ByteStream* stream)
   return result;
 }
 
-void GameList::FlushCacheFileStream()
+bool GameList::WriteDirectoryToCache(const CacheDirectoryEntry* entry, ByteStream* stream)
 {
-  if (!m_cache_write_stream)
-    return;
-
-  m_cache_write_stream->Flush();
+  bool result = true;
+  result &= WriteString(stream, entry->path);
+  result &= WriteU64(stream, entry->last_modified_time);
+  result &= WriteU32(stream, static_cast<u32>(entry->files.size()));
+  for (const CacheFileEntry& fe : entry->files)
+  {
+    result &= WriteString(stream, fe.path);
+    result &= WriteU64(stream, fe.last_modified_time);
+  }
+  result &= WriteU32(stream, static_cast<u32>(entry->subdirectories.size()));
+  for (const std::string& subdirectory : entry->subdirectories)
+    result &= WriteString(stream, subdirectory);
+  return result;
 }
 
-void GameList::CloseCacheFileStream()
+void GameList::CloseCacheFile()
 {
-  if (!m_cache_write_stream)
-    return;
-
-  m_cache_write_stream->Commit();
-  m_cache_write_stream.reset();
+  m_cache_stream.reset();
+  m_cache_file.reset();
+  m_cache_header = {};
 }
 
 void GameList::RewriteCacheFile()
 {
-  CloseCacheFileStream();
-  DeleteCacheFile();
-  if (OpenCacheForWriting())
-  {
-    for (const auto& it : m_entries)
+  CloseCacheFile();
+  if (m_cache_filename.empty())
+    return;
+
+  // records first, then the tables, which are sized to stay at most half full
+  std::unique_ptr<GrowableMemoryByteStream> memory_stream = ByteStream_CreateGrowableMemoryStream();
+  ByteStream* stream = memory_stream.get();
+  CacheHeader header = {};
+  header.signature = GAME_LIST_CACHE_SIGNATURE;
+  header.version = GAME_LIST_CACHE_VERSION;
+  header.entry_count = static_cast<u32>(m_entries.size());
+  header.directory_count = static_cast<u32>(m_directories.size());
+
+  bool result = stream->Write2(&header, sizeof(header));
+
+  const auto write_records = [stream, &result](const auto& records, const auto& write_record, u32* table_offset,
+                                                u32* table_size) {
+    std::vector<std::pair<u64, u32>> hashes;
+    hashes.reserve(records.size());
+    for (const auto& record : records)
     {
-      if (!WriteEntryToCache(&it, m_cache_write_stream.get()))
-      {
-        Log_ErrorPrintf("Failed to write '%s' to new cache file", it.title.c_str());
-        break;
-      }
+      hashes.emplace_back(XXH64(record.path.data(), record.path.size(), 0), static_cast<u32>(stream->GetPosition()));
+      result &= write_record(&record, stream);
+    }
+
+    if (records.empty())
+      return;
+
+    u32 size = 1;
+    while (size < (records.size() * 2))
+      size *= 2;
+
+    std::vector<CacheTableSlot> table(size);
+    for (const auto& [hash, offset] : hashes)
+    {
+      u32 index = static_cast<u32>(hash) & (size - 1);
+      while (table[index].record_offset != 0)
+        index = (index + 1) & (size - 1);
+
+      table[index].path_hash = hash;
+      table[index].record_offset = offset;
     }
 
-    CloseCacheFileStream();
+    // align the table so it can be read in place
+    while ((stream->GetPosition() % alignof(CacheTableSlot)) != 0)
+      result &= WriteU8(stream, 0);
+
+    *table_offset = static_cast<u32>(stream->GetPosition());
+    *table_size = size;
+    result &= stream->Write2(table.data(), static_cast<u32>(table.size() * sizeof(CacheTableSlot)));
+  };
+  write_records(m_entries, &GameList::WriteEntryToCache, &header.entry_table_offset, &header.entry_table_size);
+  write_records(m_directories, &GameList::WriteDirectoryToCache, &header.directory_table_offset,
+                &header.directory_table_size);
+
+  result &= stream->SeekAbsolute(0) && stream->Write2(&header, sizeof(header));
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to serialize game list cache");
+    return;
+  }
+
+  std::unique_ptr<ByteStream> file_stream =
+    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                     BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                     BYTESTREAM_OPEN_STREAMED);
+  if (!file_stream || !file_stream->Write2(memory_stream->GetMemoryPointer(), static_cast<u32>(memory_stream->GetSize())) ||
+      !file_stream->Commit())
+  {
+    Log_ErrorPrintf("Failed to write game list cache '%s'", m_cache_filename.c_str());
+    if (file_stream)
+      file_stream->Discard();
   }
 }
 
 void GameList::DeleteCacheFile()
 {
-  Assert(!m_cache_write_stream);
+  CloseCacheFile();
   if (!FileSystem::FileExists(m_cache_filename.c_str()))
     return;
 
@@ -469,78 +573,179 @@ void GameList::DeleteCacheFile()
     Log_WarningPrintf("Failed to delete game list cache '%s'", m_cache_filename.c_str());
 }
 
-void GameList::ScanDirectory(const char* path, bool recursive, ProgressCallback* progress)
+const GameList::CacheDirectoryEntry& GameList::GetDirectoryEntry(const std::string& path)
+{
+  auto iter = m_directory_map.find(path);
+  if (iter != m_directory_map.end())
+    return m_directories[iter->second];
+
+  FILESYSTEM_STAT_DATA sd;
+  const u64 modified_time = FileSystem::StatFile(path.c_str(), &sd) ? sd.ModificationTime.AsUnixTimestamp() : 0;
+
+  CacheDirectoryEntry de;
+  if (modified_time == 0 || !GetDirectoryEntryFromCache(path, &de) || de.last_modified_time != modified_time)
+  {
+    de.path = path;
+
+    // timestamps only have a resolution of one second, so a directory which was changed very recently could change
+    // again without its timestamp moving. don't trust the listing for those until they've settled.
+    const u64 current_time = static_cast<u64>(Timestamp::Now().AsUnixTimestamp());
+    de.last_modified_time = (modified_time != 0 && (modified_time + 1) < current_time) ? modified_time : 0;
+    de.files.clear();
+    de.subdirectories.clear();
+
+    FileSystem::FindResultsArray files;
+    FileSystem::FindFiles(path.c_str(), "*",
+                          FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_HIDDEN_FILES, &files);
+    for (FILESYSTEM_FIND_DATA& ffd : files)
+    {
+      if (ffd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
+        de.subdirectories.push_back(std::move(ffd.FileName));
+      else if (IsScannableFilename(ffd.FileName))
+        de.files.push_back({std::move(ffd.FileName), static_cast<u64>(ffd.ModificationTime.AsUnixTimestamp())});
+    }
+
+    m_cache_dirty = true;
+  }
+
+  m_directory_map.emplace(path, m_directories.size());
+  return m_directories.emplace_back(std::move(de));
+}
+
+void GameList::ScanDirectory(const char* path, bool recursive, std::vector<CacheFileEntry>* files_to_scan,
+                             ProgressCallback* progress)
 {
   Log_DevPrintf("Scanning %s%s", path, recursive ? " (recursively)" : "");
 
   progress->PushState();
   progress->SetFormattedStatusText("Scanning directory '%s'%s...", path, recursive ? " (recursively)" : "");
 
-  FileSystem::FindResultsArray files;
-  FileSystem::FindFiles(path, "*",
-                        recursive ? (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE) :
-                                    (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES),
-                        &files);
-
-  progress->SetProgressRange(static_cast<u32>(files.size()));
-  progress->SetProgressValue(0);
-
-  for (FILESYSTEM_FIND_DATA& ffd : files)
+  std::vector<std::string> directories;
+  directories.emplace_back(path);
+  while (!directories.empty())
   {
-    progress->IncrementProgressValue();
+    const std::string directory(std::move(directories.back()));
+    directories.pop_back();
 
-    if (!IsScannableFilename(ffd.FileName) || IsPathExcluded(ffd.FileName) || GetEntryForPath(ffd.FileName.c_str()))
-      continue;
+    // the reference is only valid until the next directory is visited, since m_directories can grow
+    const CacheDirectoryEntry& de = GetDirectoryEntry(directory);
+    for (const CacheFileEntry& fe : de.files)
+    {
+      if (IsPathExcluded(fe.path) || !m_scanned_paths.insert(fe.path).second)
+        continue;
 
-    const u64 modified_time = ffd.ModificationTime.AsUnixTimestamp();
-    if (AddFileFromCache(ffd.FileName, modified_time))
-      continue;
+      if (!AddFileFromCache(fe.path, fe.last_modified_time))
+        files_to_scan->push_back(fe);
+    }
 
-    // ownership of fp is transferred
-    progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(ffd.FileName).c_str());
-    ScanFile(std::move(ffd.FileName), modified_time);
+    if (recursive)
+      directories.insert(directories.end(), de.subdirectories.rbegin(), de.subdirectories.rend());
   }
 
-  progress->SetProgressValue(static_cast<u32>(files.size()));
   progress->PopState();
 }
 
 bool GameList::AddFileFromCache(const std::string& path, u64 timestamp)
 {
-  if (std::any_of(m_entries.begin(), m_entries.end(),
-                  [&path](const GameListEntry& other) { return other.path == path; }))
-  {
-    // already exists
-    return true;
-  }
-
   GameListEntry entry;
   if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != timestamp)
     return false;
 
   m_entries.push_back(std::move(entry));
+  m_cache_entries_used++;
   return true;
 }
 
-bool GameList::ScanFile(std::string path, u64 timestamp)
+bool GameList::ScanFile(std::string path, u64 timestamp, GameListEntry* entry)
 {
   Log_DevPrintf("Scanning '%s'...", path.c_str());
 
-  GameListEntry entry;
-  if (!GetGameListEntry(path, &entry))
+  if (!GetGameListEntry(path, entry))
     return false;
 
-  entry.path = std::move(path);
-  entry.last_modified_time = timestamp;
+  entry->path = std::move(path);
+  entry->last_modified_time = timestamp;
+  return true;
+}
+
+void GameList::ScanFiles(const std::vector<CacheFileEntry>& files, ProgressCallback* progress)
+{
+  if (files.empty())
+    return;
+
+  // GetGameListEntry() only reads from these once they're loaded, so they can be shared by the workers.
+  LoadDatabase();
+  if (!m_compatibility_list_load_tried)
+    LoadCompatibilityList();
+  if (!m_game_settings_load_tried)
+    LoadGameSettings();
+
+  const u32 count = static_cast<u32>(files.size());
+  progress->PushState();
+  progress->SetFormattedStatusText("Scanning %u files...", count);
+  progress->SetProgressRange(count);
+  progress->SetProgressValue(0);
+
+  // opening images is mostly waiting on I/O, so use more threads than there are cores on smaller machines
+  const u32 thread_count = std::min(count, std::clamp(std::thread::hardware_concurrency(), 4u, 16u));
+  Log_InfoPrintf("Scanning %u files with %u threads", count, thread_count);
+
+  std::vector<GameListEntry> entries(count);
+  std::unique_ptr<bool[]> entry_valid = std::make_unique<bool[]>(count);
+  std::atomic<u32> next_index{0};
+  std::atomic_bool cancelled{false};
+  std::mutex mutex;
+  std::condition_variable cv;
+  u32 completed = 0;
+
+  const auto worker = [&]() {
+    for (;;)
+    {
+      const u32 index = next_index.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count || cancelled.load(std::memory_order_relaxed))
+        break;
+
+      entry_valid[index] = ScanFile(files[index].path, files[index].last_modified_time, &entries[index]);
+
+      std::unique_lock lock(mutex);
+      completed++;
+      cv.notify_one();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (u32 i = 0; i < thread_count; i++)
+    threads.emplace_back(worker);
 
-  if (m_cache_write_stream || OpenCacheForWriting())
   {
-    if (!WriteEntryToCache(&entry, m_cache_write_stream.get()))
-      Log_WarningPrintf("Failed to write entry '%s' to cache", entry.path.c_str());
+    std::unique_lock lock(mutex);
+    while (completed < count)
+    {
+      cv.wait_for(lock, std::chrono::milliseconds(100));
+      progress->SetProgressValue(completed);
+      if (progress->IsCancelled())
+      {
+        cancelled.store(true, std::memory_order_relaxed);
+        break;
+      }
+    }
   }
 
-  m_entries.push_back(std::move(entry));
-  return true;
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (u32 i = 0; i < count; i++)
+  {
+    if (!entry_valid[i])
+      continue;
+
+    m_entries.push_back(std::move(entries[i]));
+    m_cache_dirty = true;
+  }
+
+  progress->SetProgressValue(count);
+  progress->PopState();
 }
 
 void GameList::AddDirectory(std::string path, bool recursive)
@@ -636,23 +841,37 @@ void GameList::Refresh(bool invalidate_cache, bool invalidate_database, Progress
     ClearDatabase();
 
   m_entries.clear();
+  m_directories.clear();
+  m_cache_entries_used = 0;
+  m_cache_dirty = !m_cache_stream;
 
   if (!m_search_directories.empty())
   {
-    progress->SetProgressRange(static_cast<u32>(m_search_directories.size()));
+    progress->SetProgressRange(static_cast<u32>(m_search_directories.size()) + 1);
     progress->SetProgressValue(0);
 
+    // find everything first, so the files which aren't in the cache can be scanned in parallel
+    std::vector<CacheFileEntry> files_to_scan;
     for (u32 i = 0; i < static_cast<u32>(m_search_directories.size()); i++)
     {
       const DirectoryEntry& de = m_search_directories[i];
-      ScanDirectory(de.path.c_str(), de.recursive, progress);
+      ScanDirectory(de.path.c_str(), de.recursive, &files_to_scan, progress);
       progress->SetProgressValue(i + 1);
     }
+
+    ScanFiles(files_to_scan, progress);
+    progress->SetProgressValue(static_cast<u32>(m_search_directories.size()) + 1);
   }
 
-  // don't need unused cache entries
-  CloseCacheFileStream();
-  m_cache_map.clear();
+  // unused records are dropped by rewriting the cache
+  m_cache_dirty |= (m_cache_entries_used != m_cache_header.entry_count ||
+                    m_directories.size() != m_cache_header.directory_count);
+  m_directory_map.clear();
+  m_scanned_paths.clear();
+  if (m_cache_dirty)
+    RewriteCacheFile();
+  else
+    CloseCacheFile();
 
   // we don't need to keep the db around anymore, it's quick enough to re-parse if needed anyway
   ClearDatabase();
@@ -8,11 +8,16 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class ByteStream;
 class ProgressCallback;
 
+namespace FileSystem {
+class MappedFile;
+}
+
 class SettingsInterface;
 
 enum class GameListEntryType
@@ -135,10 +140,47 @@ private:
   enum : u32
   {
     GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-    GAME_LIST_CACHE_VERSION = 31
+    GAME_LIST_CACHE_VERSION = 32
+  };
+
+  /// Cache files start with this header, followed by the entry and directory records, and the hash tables which
+  /// index them by path. The file is mapped rather than read, and records are only parsed when they're looked up.
+  struct CacheHeader
+  {
+    u32 signature;
+    u32 version;
+    u32 entry_count;
+    u32 entry_table_offset;
+    u32 entry_table_size;
+    u32 directory_count;
+    u32 directory_table_offset;
+    u32 directory_table_size;
+  };
+
+  /// Open-addressed hash table slot, keyed by the XXH64 of the record's path. Empty slots have a zero offset.
+  struct CacheTableSlot
+  {
+    u64 path_hash;
+    u32 record_offset;
+    u32 reserved;
+  };
+
+  struct CacheFileEntry
+  {
+    std::string path;
+    u64 last_modified_time;
+  };
+
+  /// Listing of the scannable files and subdirectories of a directory. While the directory's modification time is
+  /// unchanged, files can't have been added, removed or renamed, so the listing is reused instead of searching again.
+  struct CacheDirectoryEntry
+  {
+    std::string path;
+    u64 last_modified_time;
+    std::vector<CacheFileEntry> files;
+    std::vector<std::string> subdirectories;
   };
 
-  using CacheMap = std::unordered_map<std::string, GameListEntry>;
   using CompatibilityMap = std::unordered_map<std::string, GameListCompatibilityEntry>;
 
   class RedumpDatVisitor;
@@ -151,16 +193,21 @@ private:
 
   bool GetGameListEntry(const std::string& path, GameListEntry* entry);
   bool GetGameListEntryFromCache(const std::string& path, GameListEntry* entry);
-  void ScanDirectory(const char* path, bool recursive, ProgressCallback* progress);
+  bool GetDirectoryEntryFromCache(const std::string& path, CacheDirectoryEntry* entry);
+  const CacheDirectoryEntry& GetDirectoryEntry(const std::string& path);
+  void ScanDirectory(const char* path, bool recursive, std::vector<CacheFileEntry>* files_to_scan,
+                     ProgressCallback* progress);
   bool AddFileFromCache(const std::string& path, u64 timestamp);
-  bool ScanFile(std::string path, u64 timestamp);
+  bool ScanFile(std::string path, u64 timestamp, GameListEntry* entry);
+  void ScanFiles(const std::vector<CacheFileEntry>& files, ProgressCallback* progress);
 
   void LoadCache();
-  bool LoadEntriesFromCache(ByteStream* stream);
-  bool OpenCacheForWriting();
-  bool WriteEntryToCache(const GameListEntry* entry, ByteStream* stream);
-  void FlushCacheFileStream();
-  void CloseCacheFileStream();
+  u32 FindCacheRecord(u32 table_offset, u32 table_size, const std::string& path) const;
+  static bool ReadEntryFromCache(ByteStream* stream, GameListEntry* entry);
+  static bool ReadDirectoryFromCache(ByteStream* stream, CacheDirectoryEntry* entry);
+  static bool WriteEntryToCache(const GameListEntry* entry, ByteStream* stream);
+  static bool WriteDirectoryToCache(const CacheDirectoryEntry* entry, ByteStream* stream);
+  void CloseCacheFile();
   void RewriteCacheFile();
   void DeleteCacheFile();
 
@@ -174,11 +221,19 @@ private:
   void LoadGameSettings();
 
   EntryList m_entries;
-  CacheMap m_cache_map;
+  std::vector<CacheDirectoryEntry> m_directories;
   GameDatabase m_database;
   CompatibilityMap m_compatibility_list;
   GameSettings::Database m_game_settings;
-  std::unique_ptr<ByteStream> m_cache_write_stream;
+
+  // only valid while refreshing
+  std::unique_ptr<FileSystem::MappedFile> m_cache_file;
+  std::unique_ptr<ByteStream> m_cache_stream;
+  CacheHeader m_cache_header = {};
+  std::unordered_map<std::string, size_t> m_directory_map;
+  std::unordered_set<std::string> m_scanned_paths;
+  u32 m_cache_entries_used = 0;
+  bool m_cache_dirty = false;
 
   std::vector<DirectoryEntry> m_search_directories;
   std::vector<std::string> m_excluded_paths;